@@ -0,0 +1,526 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  CAN Interface API, Version 3 (for CAN-over-Serial-Line Interfaces)
+ *
+ *  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  This file is part of SerialCAN.
+ *
+ *  SerialCAN is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version). You can
+ *  choose between one of them if you use SerialCAN in whole or in part.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  SerialCAN IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF SerialCAN, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  SerialCAN is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  SerialCAN is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with SerialCAN.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        SerialCAN_Defines.h
+ *
+ *  @brief       CAN API V3 for generic CAN Interfaces - Definitions and Options
+ *
+ *  @author      $Author: eris $
+ *
+ *  @version     $Rev: 1398 $
+ *
+ *  @addtogroup  can_api
+ *  @{
+ */
+#ifndef CANAPI_SERIALCAN_H_INCLUDED
+#define CANAPI_SERIALCAN_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*  -----------  includes  ------------------------------------------------
+ */
+
+#include <stdint.h>                     /* C99 header for sized integer types */
+#include <stdbool.h>                    /* C99 header for boolean type */
+#include "CANAPI_Types.h"               /* CAN API data types and defines */
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+/** @name  Compiler Switches
+ *  @brief Options for conditional compilation.
+ *  @{ */
+/** @note  Set define OPTION_CAN_2_0_ONLY to a non-zero value to compile
+ *         with CAN 2.0 frame format only (e.g. in the build environment).
+ */
+#ifndef OPTION_DISABLED
+#define OPTION_DISABLED  0  /**< if a define is not defined, it is automatically set to 0 */
+#endif
+#if (OPTION_CANAPI_DLLEXPORT != 0)
+#define SERIALCANAPI  __declspec(dllexport)
+#elif (OPTION_CANAPI_DLLIMPORT != 0)
+#define SERIALCANAPI  __declspec(dllimport)
+#else
+#define SERIALCANAPI  extern
+#endif
+/** @} */
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+/** @name  CAN API Interfaces
+ *  @brief Serial line interfaces
+ *  @{ */
+#define CANSIO_BOARDS               0  /**< number of serial line interfaces */
+/** @} */
+
+/** @name  Protocol option
+ *  @brief SLCAN protocol option
+ *  @{ */
+#define CANSIO_LAWICEL           0x00U  /**< Lawicel SLCAN protocol */
+#define CANSIO_CANABLE           0x01U  /**< CANable SLCAN protocol */
+#define CANSIO_AUTO              0xFFU  /**< auto detect (not realized yet) */
+#define CANSIO_SLCAN    CANSIO_LAWICEL  /**< Lawicel SLCAN protocol (default) */
+ /** @} */
+
+ /** @name  Baud rate option
+  *  @brief Baud rate in bits per second
+  *  @note  CBAUDEX compatible (e.g. Linux)
+  *  @{ */
+#define CANSIO_BD57600          57600U  /**< 57.6 kBd */
+#define CANSIO_BD115200        115200U  /**< 115.2 kBd */
+#define CANSIO_BD230400        230400U  /**< 230.4 kBd */
+#define CANSIO_BD460800        460800U  /**< 460.8 kBd */
+#define CANSIO_BD500000        500000U  /**< 500.0 kBd */
+#define CANSIO_BD576000        576000U  /**< 576.0 kBd */
+#define CANSIO_BD921600        921600U  /**< 921.6 kBd */
+#define CANSIO_BD1000000      1000000U  /**< 1.000 MBd */
+#define CANSIO_BD1152000      1152000U  /**< 1.152 MBd */
+#define CANSIO_BD1500000      1500000U  /**< 1.500 MBd */
+#define CANSIO_BD2000000      2000000U  /**< 2.000 MBd */
+#define CANSIO_BD2500000      2500000U  /**< 2.500 MBd */
+#define CANSIO_BD3000000      3000000U  /**< 3.000 MBd */
+/** @} */                   
+
+/** @name  Data size option
+ *  @brief Number of data bits (5, 6, 7, 8)
+ *  @{ */
+#define CANSIO_5DATABITS            5U  /**< 5 bits per data byte */
+#define CANSIO_6DATABITS            6U  /**< 6 bits per data byte */
+#define CANSIO_7DATABITS            7U  /**< 7 bits per data byte */
+#define CANSIO_8DATABITS            8U  /**< 8 bits per data byte */
+/** @} */
+
+/** @name  Parity option
+ *  @brief Parity bit (None, Even, Odd)
+ *  @{ */
+#define CANSIO_NOPARITY             0U  /**< no parity */
+#define CANSIO_ODDPARITY            1U  /**< odd parity */
+#define CANSIO_EVENPARITY           2U  /**< even parity */
+/** @} */
+
+/** @name  Stop bit option
+ *  @brief Number of stop bits (1 or 2)
+ *  @{ */
+#define CANSIO_1STOPBIT             1U  /**< 1 stop bit */
+#define CANSIO_2STOPBITS            2U  /**< 2 stop bits */
+/** @} */
+
+/** @name  Queue overflow policy
+ *  @brief Handling of received messages when the receive queue is full
+ *  @{ */
+#define CANSIO_DROP_NEWEST       0x00U  /**< drop the received message (default) */
+#define CANSIO_DROP_OLDEST       0x01U  /**< drop the oldest message in the queue */
+#define CANSIO_BOUNDED_BLOCK     0x02U  /**< block the reception for a bounded time */
+/** @} */
+
+/** @name  Data reduction
+ *  @brief Which received messages are put into the receive queue (can be combined)
+ *  @{ */
+#define CANSIO_REDUCE_OFF        0x00U  /**< all received messages (default) */
+#define CANSIO_REDUCE_CHANGE_ONLY 0x01U /**< only when the payload or DLC has changed */
+#define CANSIO_REDUCE_DECIMATE   0x02U  /**< at most N messages per second and identifier */
+/** @} */
+
+/** @name  Latest-value mailbox
+ *  @brief Identifier flag for function can_read_latest
+ *  @{ */
+#define CANSIO_XTD_ID       0x80000000U  /**< flag for 29-bit identifiers */
+/** @} */
+
+/** @name  Time-out in microseconds
+ *  @brief Time-out value for functions can_read_us and can_write_us
+ *  @{ */
+#define CANSIO_INFINITE_US   UINT64_MAX  /**< infinite time-out (blocking operation) */
+/** @} */
+
+/** @name  Replay speed
+ *  @brief Speed factor (in [%] of the original timing) for function can_replay
+ *  @{ */
+#define CANSIO_REPLAY_ASAP           0U  /**< as fast as possible (no timing) */
+#define CANSIO_REPLAY_ORIGINAL     100U  /**< original timing of the trace */
+/** @} */
+
+/** @name  Flight recorder
+ *  @brief Trigger events for property SLCAN_RECORDER_EVENTS (can be combined)
+ *  @{ */
+#define CANSIO_TRIGGER_PATTERN   0x01U  /**< message matching the trigger pattern */
+#define CANSIO_TRIGGER_ERROR     0x02U  /**< error frame */
+#define CANSIO_TRIGGER_STATUS    0x04U  /**< bus status change (with SLCAN_STATUS_POLLING) */
+/** @} */
+
+/** @name  Packet capture
+ *  @brief Content of the pcapng file for property SLCAN_CAPTURE_TYPE
+ *  @{ */
+#define CANSIO_CAPTURE_SERIAL    0x00U  /**< raw serial data (link-layer type USER0) */
+#define CANSIO_CAPTURE_SOCKETCAN 0x01U  /**< decoded messages (link-layer type CAN_SOCKETCAN) */
+/** @} */
+
+/** @name  Trace file type
+ *  @brief Additional trace file formats for property CANPROP_SET_TRACE_TYPE
+ *  @{ */
+#define CANSIO_TRACE_TYPE_CANDUMP 0x81U /**< candump log format (.log) */
+#define CANSIO_TRACE_TYPE_ASC    0x82U  /**< Vector ASCII log format (.asc) */
+/** @} */
+
+/** @name  CAN API Property Value
+ *  @brief SLCAN parameter to be read or written
+ *  @{ */
+#define SLCAN_DEVICE_ID          0x00U  /**< device id number */
+#define SLCAN_SERIAL_NUMBER      0x01U  /**< device serial number */
+#define SLCAN_HARDWARE_VERSION   0x02U  /**< device hardware version */
+#define SLCAN_FIRMWARE_VERSION   0x03U  /**< device firmware version */
+#define SLCAN_CLOCK_FREQUENCY    0x05U  /**< CAN clock frequency (in [Hz]) */
+#define SLCAN_DEVICE_REFRESH     0x06U  /**< re-read the device identity (serial number and versions) */
+#define SLCAN_RCV_QUEUE_SIZE     0x10U  /**< receive queue size (1..16777216 messages) */
+#define SLCAN_RCV_QUEUE_POLICY   0x11U  /**< receive queue overflow policy (CANSIO_xyz) */
+#define SLCAN_RCV_QUEUE_TIMEOUT  0x12U  /**< max. blocking time (in [ms]) with CANSIO_BOUNDED_BLOCK */
+#define SLCAN_RCV_DROPPED_NEWEST 0x13U  /**< number of received messages dropped (CANSIO_DROP_NEWEST) */
+#define SLCAN_RCV_DROPPED_OLDEST 0x14U  /**< number of oldest messages dropped (CANSIO_DROP_OLDEST) */
+#define SLCAN_RCV_DROPPED_EXPIRED 0x15U /**< number of received messages dropped (CANSIO_BOUNDED_BLOCK) */
+#define SLCAN_RCV_SPILL_FOLDER   0x16U  /**< folder for the spill file of the receive queue (char[]) */
+#define SLCAN_RCV_SPILL_SIZE     0x17U  /**< spill file size (0..268435456 messages, 0 = off) */
+#define SLCAN_RCV_MAILBOX        0x18U  /**< latest-value mailbox (0 = off, 1 = on) */
+#define SLCAN_RCV_REDUCTION      0x19U  /**< data reduction of received messages (CANSIO_REDUCE_xyz) */
+#define SLCAN_RCV_DECIMATION     0x1AU  /**< decimation rate (1..65535 messages per second and identifier) */
+#define SLCAN_RCV_SUPPRESSED     0x1BU  /**< number of received messages suppressed by the data reduction */
+#define SLCAN_RCV_SPILL_THRESHOLD 0x1CU /**< number of messages in memory at which spilling starts (0 = queue full) */
+#define SLCAN_STATUS_POLLING     0x20U  /**< status polling interval (in [ms], 0 = off) */
+#define SLCAN_RECORDER_ACTIVE    0x30U  /**< flight recorder (0 = off, 1 = on) */
+#define SLCAN_RECORDER_FRAMES    0x31U  /**< pre-trigger window (1..16777216 messages) */
+#define SLCAN_RECORDER_TIME      0x32U  /**< pre-trigger window (in [ms], 0 = messages only) */
+#define SLCAN_RECORDER_POST_FRAMES 0x33U /**< post-trigger window (0..16777216 messages, 0 = time only) */
+#define SLCAN_RECORDER_POST_TIME 0x34U  /**< post-trigger window (in [ms], 0 = messages only) */
+#define SLCAN_RECORDER_EVENTS    0x35U  /**< trigger events (CANSIO_TRIGGER_xyz) */
+#define SLCAN_RECORDER_PATTERN   0x36U  /**< trigger pattern (can_trigger_pattern_t) */
+#define SLCAN_RECORDER_TRIGGER   0x37U  /**< trigger a dump of the flight recorder (NULL) */
+#define SLCAN_RECORDER_DUMPS     0x38U  /**< number of dumps written */
+#define SLCAN_RECORDER_IGNORED   0x39U  /**< number of triggers ignored (dump in progress) */
+#define SLCAN_RECORDER_FILE      0x3AU  /**< name of the last dump file (char[]) */
+#define SLCAN_CAPTURE_ACTIVE     0x40U  /**< packet capture into a pcapng file (0 = off, 1 = on) */
+#define SLCAN_CAPTURE_TYPE       0x41U  /**< content of the pcapng file (CANSIO_CAPTURE_xyz) */
+#define SLCAN_CAPTURE_FILE       0x42U  /**< name of the current or last pcapng file (char[]) */
+#define SLCAN_CAPTURE_DROPPED    0x43U  /**< number of packets dropped (ring full or write error) */
+// TODO: define more or all parameters
+// ...
+/** @} */
+
+/** @name  CAN API Library ID
+ *  @brief Library ID and dynamic library names
+ *  @{ */
+#define SLCAN_LIB_ID             900    /**< library ID (CAN/COP API V1 compatible) */
+#if defined(_WIN32) || defined (_WIN64)
+#define SLCAN_LIB_DRIVER        "(driverless)"
+#define SLCAN_LIB_WRAPPER       "u3canslc.dll"
+#elif defined(__linux__)
+#define SLCAN_LIB_DRIVER        "(driverless)"
+#define SLCAN_LIB_WRAPPER       "libuvcanslc.so"
+#elif defined(__APPLE__)
+#define SLCAN_LIB_DRIVER        "(driverless)"
+#define SLCAN_LIB_WRAPPER       "libUVCANSLC.dylib"
+#elif defined(__CYGWIN__)
+#define SLCAN_LIB_DRIVER        "(driverless)"
+#define SLCAN_LIB_WRAPPER       "libuvcanslc.so"
+#else
+#error Platform not supported
+#endif
+ /** @} */
+
+ /** @name  Miscellaneous
+  *  @brief More or less useful stuff
+  *  @{ */
+#define SLCAN_LIB_VENDOR        "(unknown)"
+#define SLCAN_LIB_WEBSITE       "http://info.cern.ch/hypertext/WWW/TheProject.html"
+#define SLCAN_LIB_HAZARD_NOTE   "If you connect your CAN device to a real CAN network when using this library,\n" \
+                                "you might damage your application."
+  /** @} */
+
+  /*  -----------  types  --------------------------------------------------
+ */
+
+/** @brief SerialCAN port attributes
+ */
+typedef struct can_sio_attr_t_ {        /* serial port attributes: */
+    uint32_t baudrate;                  /**<  baud rate (in [bps]) */
+    uint8_t  bytesize;                  /**<  number fo data bits (5, 6, 7, 8) */
+    uint8_t  parity;                    /**<  parity bit (None, Even, Odd) */
+    uint8_t  stopbits;                  /**<  number of stop bits (1 or 2) */
+    uint8_t  protocol;                  /**<  protocol (defaul: Lawicel) */
+} can_sio_attr_t;
+
+/** @brief SerialCAN port parameters
+ */
+typedef struct can_sio_param_t_ {       /* device parameters: */
+    char* name;                         /**< name of the serial port device */
+    can_sio_attr_t attr;                /**< serial communication attributes*/
+} can_sio_param_t;
+
+/** @brief SerialCAN reception handler (see can_callback)
+ */
+typedef void (*can_rx_handler_t)(const can_message_t *message, void *context);
+
+/** @brief SerialCAN status handler (see can_status_callback)
+ */
+typedef void (*can_status_handler_t)(uint8_t status, void *context);
+
+/** @brief SerialCAN trigger pattern of the flight recorder (see SLCAN_RECORDER_PATTERN)
+ *
+ *  @remarks     A message matches when all bits selected by the masks are equal.
+ *               The identifier has flag CANSIO_XTD_ID for 29-bit identifiers.
+ */
+typedef struct can_trigger_pattern_t_ { /* trigger pattern: */
+    uint32_t id;                        /**< CAN identifier (with flag CANSIO_XTD_ID) */
+    uint32_t id_mask;                   /**< mask for the identifier (and the flag) */
+    uint8_t data[8];                    /**< payload */
+    uint8_t data_mask[8];               /**< mask for the payload (within the DLC) */
+} can_trigger_pattern_t;
+
+/** @brief SerialCAN replay statistics (see can_replay)
+ */
+typedef struct can_replay_stats_t_ {    /* replay statistics: */
+    uint64_t records;                   /**< number of records in the trace file */
+    uint64_t sent;                      /**< number of messages transmitted */
+    uint64_t failed;                    /**< number of messages not transmitted */
+    uint64_t skipped;                   /**< number of records skipped (e.g. error frames) */
+    uint64_t duration;                  /**< duration of the replay (in [usec]) */
+    uint32_t mean;                      /**< mean timing error (in [usec]) */
+    uint32_t p50;                       /**< 50th percentile of the timing error (in [usec]) */
+    uint32_t p90;                       /**< 90th percentile of the timing error (in [usec]) */
+    uint32_t p99;                       /**< 99th percentile of the timing error (in [usec]) */
+    uint32_t p999;                      /**< 99.9th percentile of the timing error (in [usec]) */
+    uint32_t max;                       /**< maximum timing error (in [usec]) */
+} can_replay_stats_t;
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       reads the latest message received with the given identifier
+ *               from the latest-value mailbox of the CAN interface.
+ *
+ *  @remarks     The mailbox must be enabled by property SLCAN_RCV_MAILBOX
+ *               before the CAN controller is started. The function does not
+ *               wait and does not remove the message from the mailbox or
+ *               from the receive queue.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   id      - CAN identifier (with flag CANSIO_XTD_ID for 29-bit)
+ *  @param[out]  message - the latest message received with this identifier
+ *                         (with its time of reception)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT  - library not initialized
+ *  @retval      CANERR_HANDLE   - invalid interface handle
+ *  @retval      CANERR_NULLPTR  - null-pointer assignment
+ *  @retval      CANERR_ILLPARA  - invalid identifier
+ *  @retval      CANERR_OFFLINE  - CAN controller not started
+ *  @retval      CANERR_NOTSUPP  - mailbox not enabled
+ *  @retval      CANERR_RX_EMPTY - no message received with this identifier
+ */
+SERIALCANAPI int can_read_latest(int handle, uint32_t id, can_message_t *message);
+
+
+/** @brief       transmits a message over the CAN bus, with a time-out in
+ *               microseconds (see can_write).
+ *
+ *  @remarks     The SLCAN protocol has no transmit queue; the message is sent
+ *               synchronously and the time-out bounds the wait for the device's
+ *               acknowledge. It is rounded up to full milliseconds. A device
+ *               without acknowledge (CANable) waits until the bytes are sent.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   message - pointer to the message to send
+ *  @param[in]   timeout - time to wait for the acknowledge of the message:
+ *                              0 means the default time-out (1000ms),
+ *                              CANSIO_INFINITE_US means blocking write, and
+ *                              any other value means the time to wait in [us]
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - illegal data length code
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_TX_BUSY   - transmitter busy
+ *  @retval      others           - vendor-specific
+ */
+SERIALCANAPI int can_write_us(int handle, const can_message_t *message, uint64_t timeout);
+
+
+/** @brief       read one message from the message queue of the CAN interface, if
+ *               any message was received, with a time-out in microseconds (see
+ *               can_read).
+ *
+ *  @remarks     The time-out is measured on a monotonic clock; it is not affected
+ *               by adjustments of the system time (e.g. by NTP).
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[out]  message - pointer to a message buffer
+ *  @param[in]   timeout - time to wait for the reception of a message:
+ *                              0 means the function returns immediately,
+ *                              CANSIO_INFINITE_US means blocking read, and
+ *                              any other value means the time to wait in [us]
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_RX_EMPTY  - message queue empty
+ *  @retval      CANERR_ERR_FRAME - error frame received
+ *  @retval      others           - vendor-specific
+ */
+SERIALCANAPI int can_read_us(int handle, can_message_t *message, uint64_t timeout);
+
+
+/** @brief       installs a handler that is called for each received message
+ *               directly by the reception thread of the CAN interface, instead
+ *               of putting the message into the receive queue (can_read).
+ *
+ *  @remarks     The handler runs in the context of the reception thread. It must
+ *               not block and should return as fast as possible, because no data
+ *               is read from the serial port until it returns. It must not call
+ *               can_exit, can_start or can_reset for this interface.
+ *
+ *  @note        The handler can only be changed when the CAN controller is not
+ *               started. A null-pointer removes the handler.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   handler - reception handler (or NULL)
+ *  @param[in]   context - pointer passed to the handler (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT  - library not initialized
+ *  @retval      CANERR_HANDLE   - invalid interface handle
+ *  @retval      CANERR_ONLINE   - CAN controller already started
+ */
+SERIALCANAPI int can_callback(int handle, can_rx_handler_t handler, void *context);
+
+
+/** @brief       installs a handler that is called when the bus status of the
+ *               CAN interface changes (bus off, warning level, bus error or
+ *               message lost), as detected by the status polling.
+ *
+ *  @remarks     The status polling is enabled by property SLCAN_STATUS_POLLING
+ *               before the CAN controller is started. While it is enabled,
+ *               can_status returns the status of the last poll without any
+ *               serial I/O.
+ *
+ *  @remarks     The handler runs in the context of the polling thread. It must
+ *               not call can_exit, can_start or can_reset for this interface.
+ *
+ *  @note        The handler can only be changed when the CAN controller is not
+ *               started. A null-pointer removes the handler.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   handler - status handler (or NULL)
+ *  @param[in]   context - pointer passed to the handler (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT  - library not initialized
+ *  @retval      CANERR_HANDLE   - invalid interface handle
+ *  @retval      CANERR_ONLINE   - CAN controller already started
+ *  @retval      CANERR_NOTSUPP  - not supported (e.g. by a subscriber)
+ */
+SERIALCANAPI int can_status_callback(int handle, can_status_handler_t handler, void *context);
+
+
+/** @brief       transmits the messages of a recorded trace file over the CAN
+ *               bus, with the original timing of the recording or scaled by
+ *               the given speed factor.
+ *
+ *  @remarks     Only trace files in binary format (CANPARA_TRACE_TYPE_BINARY)
+ *               can be replayed. Error frames in the trace are skipped.
+ *
+ *  @remarks     Each message is transmitted at an absolute deadline relative
+ *               to the start of the replay, so the timing errors do not add up.
+ *               The timing error is the delay between the deadline and the
+ *               transmission of the message (for speed CANSIO_REPLAY_ASAP
+ *               there is no timing and the timing error is not measured).
+ *
+ *  @note        The function blocks until all messages are transmitted. It
+ *               can be aborted by can_kill (or by can_reset or can_exit).
+ *
+ *  @param[in]   handle   - handle of the CAN interface
+ *  @param[in]   filename - name of the trace file
+ *  @param[in]   speed    - speed factor in [%] (e.g. 50 for half speed, 200 for
+ *                          double speed or CANSIO_REPLAY_ASAP)
+ *  @param[out]  stats    - replay statistics (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT  - library not initialized
+ *  @retval      CANERR_HANDLE   - invalid interface handle
+ *  @retval      CANERR_NULLPTR  - null-pointer assignment
+ *  @retval      CANERR_ILLPARA  - invalid trace file
+ *  @retval      CANERR_OFFLINE  - CAN controller not started
+ *  @retval      CANERR_NOTSUPP  - not supported (e.g. by a subscriber)
+ *  @retval      CANERR_RESOURCE - resource allocation failed
+ *  @retval      CANERR_VENDOR   - aborted or file error (errno)
+ */
+SERIALCANAPI int can_replay(int handle, const char *filename, uint16_t speed, can_replay_stats_t *stats);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* CANAPI_SERIALCAN_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de, Homepage: https://www.uv-software.de/
+ */
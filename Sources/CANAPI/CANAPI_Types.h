@@ -465,6 +465,9 @@ extern "C" {
 #define CANPARA_TRACE_SIZE_10KB      10240L /**< trace file: size factor(in [KB]) */
 /* - -  message formatter - - - - - - - - - - - - - - - - - - - - - - - */
 #define CANPARA_FORMAT_DEFAULT       0  /**< message formatter output (default) */
+#define CANPARA_FORMAT_CANDUMP       1  /**< message formatter output: candump log (-l) */
+#define CANPARA_FORMAT_ASC           2  /**< message formatter output: Vector ASCII log */
+#define CANPARA_FORMAT_CSV           3  /**< message formatter output: comma-separated values */
 /* - -  formatter option: ON or OFF - - - - - - - - - - - - - - - - - - */
 #define CANPARA_OPTION_OFF           0  /**< formatter option: OFF (false, no, 0) */
 #define CANPARA_OPTION_ON            1  /**< formatter option: ON (true, yes, !0) */
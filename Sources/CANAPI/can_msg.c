@@ -105,44 +105,52 @@
 /*  -----------  types  --------------------------------------------------
  */
 
+typedef struct output_t_ {              /* output cursor: */
+    char  *buffer;                      /*   caller's buffer (or NULL) */
+    size_t length;                      /*   size of the buffer (incl. '\0') */
+    size_t count;                       /*   number of characters emitted */
+} output_t;
+
 
 /*  -----------  prototypes  ---------------------------------------------
  */
 
-static void format_time(char *string, const msg_message_t *message);
-static void format_id(char *string, const msg_message_t *message);
-static void format_dlc(char *string, const msg_message_t *message);
-static void format_data(char *string, const msg_message_t *message, int ascii, int indent);
-static void format_ascii(char *string, const msg_message_t *message);
-static void format_data_byte(char *string, unsigned char data);
-static void format_data_ascii(char *string, unsigned char data);
-static void format_fill_byte(char *string);
+static void format_message(output_t *out, msg_fmt_options_t *options, const msg_message_t *message,
+                           msg_direction_t direction, msg_counter_t counter, msg_channel_t channel);
+static void format_candump(output_t *out, msg_fmt_options_t *options, const msg_message_t *message,
+                           msg_channel_t channel);
+static void format_asc(output_t *out, msg_fmt_options_t *options, const msg_message_t *message,
+                       msg_direction_t direction, msg_channel_t channel);
+static void format_csv(output_t *out, msg_fmt_options_t *options, const msg_message_t *message,
+                       msg_direction_t direction, msg_channel_t channel);
+static void format_asc_date(output_t *out, const char *prefix);
+static void format_time(output_t *out, msg_fmt_options_t *options, const msg_message_t *message);
+static void time_difference(msg_fmt_options_t *options, const msg_message_t *message, struct timespec *difftime);
+static void format_seconds(output_t *out, const struct timespec *time, int width, char pad, int digits);
+static void format_id(output_t *out, const msg_fmt_options_t *options, const msg_message_t *message);
+static void format_flags(output_t *out, const msg_message_t *message);
+static void format_dlc(output_t *out, const msg_fmt_options_t *options, const msg_message_t *message);
+static void format_data(output_t *out, const msg_fmt_options_t *options, const msg_message_t *message, int ascii, int indent);
+static void format_ascii(output_t *out, const msg_fmt_options_t *options, const msg_message_t *message);
+static void format_data_byte(output_t *out, const msg_fmt_options_t *options, unsigned char data);
+static void format_hex_byte(output_t *out, unsigned char data);
+static void format_data_ascii(output_t *out, const msg_fmt_options_t *options, unsigned char data);
+static void format_fill_byte(output_t *out, const msg_fmt_options_t *options);
+static void format_separator(output_t *out, const msg_fmt_options_t *options, const char *spaces);
+
+static void put_char(output_t *out, char c);
+static void put_number(output_t *out, uint64_t value, int negative, unsigned base, int width, char pad);
+static void put_string(output_t *out, const char *string);
+static void put_unsigned(output_t *out, uint64_t value, unsigned base, int width, char pad);
+static void put_signed(output_t *out, int64_t value, int width, char pad);
+static int put_end(output_t *out);
 
 
 /*  -----------  variables  ----------------------------------------------
  */
 
-static struct {                         /* format option: */
-    msg_fmt_timestamp_t  time_stamp;    /*   time-stamp {ZERO, ABS, REL} */
-    msg_fmt_option_t     time_usec;     /*   time-stamp in usec {OFF, ON} */
-    msg_fmt_time_t       time_format;   /*   time format {TIME, SEC, DJD} */
-    msg_fmt_number_t     id;            /*   identifier {HEX, DEC, OCT, BIN} */
-    msg_fmt_option_t     id_xtd;        /*   extended identifier {OFF, ON} */
-    msg_fmt_number_t     dlc;           /*   DLC/length {HEX, DEC, OCT, BIN} */
-    msg_fmt_canfd_t      dlc_format;    /*   CAN FD format {DLC, LENGTH} */
-    int                  dlc_brackets;  /*   DLC in brackets {'\0', '(', '['} */
-    msg_fmt_option_t     flags;         /*   message flags {ON, OFF} */
-    msg_fmt_number_t     data;          /*   message data {HEX, DEC, OCT, BIN} */
-    msg_fmt_option_t     ascii;         /*   data as ASCII {ON, OFF} */
-    int                  ascii_subst;   /*   substitute for non-printables */
-    msg_fmt_option_t     channel;       /*   message source {OFF, ON} */
-    msg_fmt_option_t     counter;       /*   message counter {ON, OFF} */
-    msg_fmt_separator_t  separator;     /*   separator {SPACES, TABS} */
-    msg_fmt_wraparound_t wraparound;    /*   wraparound {NO, 8, 16, 32, 64} */
-    msg_fmt_option_t     end_of_line;   /*   end-of-line character {ON, OFF} */
-    char                 rx_prompt[6+1];/*   prompt for received messages */
-    char                 tx_prompt[6+1];/*   prompt for sent messages */
-}   msg_option = {
+static msg_fmt_options_t msg_option = { /* format option (legacy API): */
+                        .format = MSG_FORMAT_DEFAULT,
                         .time_stamp = MSG_FMT_TIMESTAMP_ZERO,
                         .time_usec = MSG_FMT_OPTION_OFF,
                         .time_format = MSG_FMT_TIME_SEC,
@@ -163,188 +171,171 @@ static struct {                         /* format option: */
                         .rx_prompt = "",
                         .tx_prompt = ""
 };
-static msg_format_t msg_format = MSG_FORMAT_DEFAULT;
 static char msg_string[MSG_STRING_LENGTH] = "";
 static const unsigned char dlc_table[16] = {
     0U,1U,2U,3U,4U,5U,6U,7U,8U,12U,16U,20U,24U,32U,48U,64U
 };
+static const char digits[16] = {
+    '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'
+};
 
 
 /*  -----------  functions  ----------------------------------------------
  */
 
+int msg_format_message_r(char *buffer, size_t length, msg_fmt_options_t *options,
+                         const msg_message_t *message, msg_direction_t direction,
+                         msg_counter_t counter, msg_channel_t channel)
+{
+    output_t out = { buffer, length, 0U };
+
+    if (!options || !message || (!buffer && length)) {
+        errno = EINVAL;
+        return -1;
+    }
+    format_message(&out, options, message, direction, counter, channel);
+
+    return put_end(&out);
+}
+
+int msg_format_header_r(char *buffer, size_t length, const msg_fmt_options_t *options)
+{
+    output_t out = { buffer, length, 0U };
+
+    if (!options || (!buffer && length)) {
+        errno = EINVAL;
+        return -1;
+    }
+    switch (options->format) {
+    case MSG_FORMAT_ASC:
+        format_asc_date(&out, "date ");
+        put_string(&out, "base hex  timestamps ");
+        put_string(&out, (options->time_stamp == MSG_FMT_TIMESTAMP_RELATIVE) ? "relative\n" : "absolute\n");
+        put_string(&out, "no internal events logged\n");
+        format_asc_date(&out, "Begin Triggerblock ");
+        break;
+    case MSG_FORMAT_CSV:
+        put_string(&out, "time,dir,channel,id,xtd,rtr,fdf,brs,esi,err,dlc,data\n");
+        break;
+    default:
+        break;
+    }
+    return put_end(&out);
+}
+
+int msg_format_footer_r(char *buffer, size_t length, const msg_fmt_options_t *options)
+{
+    output_t out = { buffer, length, 0U };
+
+    if (!options || (!buffer && length)) {
+        errno = EINVAL;
+        return -1;
+    }
+    switch (options->format) {
+    case MSG_FORMAT_ASC:
+        put_string(&out, "End TriggerBlock\n");
+        break;
+    default:
+        break;
+    }
+    return put_end(&out);
+}
+
+int msg_get_fmt_options(msg_fmt_options_t *options)
+{
+    if (!options)
+        return 0;
+
+    memcpy(options, &msg_option, sizeof(msg_fmt_options_t));
+    memset(&options->reference, 0, sizeof(options->reference));
+    memset(&options->cache, 0, sizeof(options->cache));
+    return 1;
+}
+
 char *msg_format_message(const msg_message_t *message, msg_direction_t direction,
                                msg_counter_t counter, msg_channel_t channel)
 {
-    char tmp_string[MSG_STRING_LENGTH];
-
-    memset(msg_string, 0, sizeof(msg_string));
+    output_t out = { msg_string, sizeof(msg_string), 0U };
 
     if (message) {
-        /* prompt (optional) */
-        if (strlen(msg_option.tx_prompt) && (direction == MSG_TX_MESSAGE)) {
-            strcat(msg_string, msg_option.tx_prompt);
-            strcat(msg_string, (msg_option.separator == MSG_FMT_SEPARATOR_TABS) ? "\t" : " ");
-        }
-        else if (strlen(msg_option.rx_prompt)) { /* defaults to MSG_DIRECTION_RX_MSG */
-            strcat(msg_string, msg_option.rx_prompt);
-            strcat(msg_string, (msg_option.separator == MSG_FMT_SEPARATOR_TABS) ? "\t" : " ");
-        }
-        /* counter (optional) */
-        if ((msg_option.counter != MSG_FMT_OPTION_OFF) && ((msg_option.separator == MSG_FMT_SEPARATOR_TABS))) {
-            sprintf(tmp_string, "%" PRIu64 "\t", counter);
-            strcat(msg_string, tmp_string);
-        }
-        else if (msg_option.counter != MSG_FMT_OPTION_OFF) { /* defaults to MSG_FMT_SEPARATOR_SPACES */
-            sprintf(tmp_string, "%-7" PRIu64 "  ", counter);
-            strcat(msg_string, tmp_string);
-        }
-        /* time-stamp (abs/rel/zero) (hhmmss/sec/DJD).(msec/usec) */
-        format_time(tmp_string, message);
-        strcat(msg_string, tmp_string);
-        strcat(msg_string, (msg_option.separator == MSG_FMT_SEPARATOR_TABS) ? "\t" : "  ");
-
-        /* channel (optional) */
-        if ((msg_option.channel != MSG_FMT_OPTION_OFF) && (msg_option.separator == MSG_FMT_SEPARATOR_TABS)) {
-            sprintf(tmp_string, "%i\t", channel);
-            strcat(msg_string, tmp_string);
-        }
-        else if (msg_option.channel != MSG_FMT_OPTION_OFF) { /* defaults to MSG_FMT_SEPARATOR_SPACES */
-            sprintf(tmp_string, "%-2i  ", channel);
-            strcat(msg_string, tmp_string);
-        }
-        /* identifier (hex/dec/oct) */
-        format_id(tmp_string, message);
-        strcat(msg_string, tmp_string);
-        strcat(msg_string, (msg_option.separator == MSG_FMT_SEPARATOR_TABS) ? "\t" : "  ");
-
-        /* flags (optional) */
-        if (msg_option.flags != MSG_FMT_OPTION_OFF) {
-#if (OPTION_CAN_2_0_ONLY == 0)
-            if (!message->sts) {
-                strcat(msg_string, message->xtd ? "X" : "S");
-                strcat(msg_string, message->fdf ? "F" : "-");
-                strcat(msg_string, message->brs ? "B" : "-");
-                strcat(msg_string, message->esi ? "E" : "-");
-                strcat(msg_string, message->rtr ? "R" : "-");
-            }
-            else {
-                strcat(msg_string, "Error");
-            }
-#else
-            if (!message->sts) {
-                strcat(msg_string, message->xtd ? "X" : "S");
-                strcat(msg_string, message->rtr ? "R" : "-");
-            }
-            else {
-                strcat(msg_string, "E!");
-            }
-#endif
-            strcat(msg_string, (msg_option.separator == MSG_FMT_SEPARATOR_TABS) ? "\t" : " ");  /* only one space! */
-        }
-        /* dlc/length (hex/dec/oct) */
-        format_dlc(tmp_string, message);
-        strcat(msg_string, tmp_string);
-
-        /* data (hex/dec/oct) plus ascii (optional) */
-        if (message->dlc && !message->rtr) {
-            strcat(msg_string, (msg_option.separator == MSG_FMT_SEPARATOR_TABS) ? "\t" : "  ");
-            format_data(tmp_string, message, (msg_option.ascii == MSG_FMT_OPTION_OFF) ? 0 : 1, (int)strlen(msg_string));
-            strcat(msg_string, tmp_string);
-        }
-        /* end-of-line (optional) */
-        if (msg_option.end_of_line) {
-            strcat(msg_string, "\n");
-        }
+        format_message(&out, &msg_option, message, direction, counter, channel);
     }
+    (void)put_end(&out);
     return msg_string;
 }
 
 char *msg_format_time(const msg_message_t *message)
 {
-    memset(msg_string, 0, sizeof(msg_string));
+    output_t out = { msg_string, sizeof(msg_string), 0U };
 
     if (message) {
         /* time-stamp (abs/rel/zero) (hhmmss/sec/DJD).(msec/usec) */
-        format_time(msg_string, message);
+        format_time(&out, &msg_option, message);
     }
+    (void)put_end(&out);
     return msg_string;
 }
 
 char *msg_format_id(const msg_message_t *message)
 {
-    memset(msg_string, 0, sizeof(msg_string));
+    output_t out = { msg_string, sizeof(msg_string), 0U };
 
     if (message) {
         /* identifier (hex/dec/oct) */
-        format_id(msg_string, message);
+        format_id(&out, &msg_option, message);
     }
+    (void)put_end(&out);
     return msg_string;
 }
 
 char *msg_format_flags(const msg_message_t *message)
 {
-    memset(msg_string, 0, sizeof(msg_string));
+    output_t out = { msg_string, sizeof(msg_string), 0U };
 
     if (message) {
-#if (OPTION_CAN_2_0_ONLY == 0)
-        if (!message->sts) {
-            strcat(msg_string, message->xtd ? "X" : "S");
-            strcat(msg_string, message->fdf ? "F" : "-");
-            strcat(msg_string, message->brs ? "B" : "-");
-            strcat(msg_string, message->esi ? "E" : "-");
-            strcat(msg_string, message->rtr ? "R" : "-");
-        }
-        else {
-            strcat(msg_string, "Error");
-        }
-#else
-        if (!message->sts) {
-            strcat(msg_string, message->xtd ? "X" : "S");
-            strcat(msg_string, message->rtr ? "R" : "-");
-        }
-        else {
-            strcat(msg_string, "E!");
-        }
-#endif
+        format_flags(&out, message);
     }
+    (void)put_end(&out);
     return msg_string;
 }
 
 char *msg_format_dlc(const msg_message_t *message)
 {
-    memset(msg_string, 0, sizeof(msg_string));
+    output_t out = { msg_string, sizeof(msg_string), 0U };
 
     if (message) {
         /* dlc/length (hex/dec/oct) */
-        format_dlc(msg_string, message);
+        format_dlc(&out, &msg_option, message);
     }
+    (void)put_end(&out);
     return msg_string;
 }
 
 char *msg_format_data(const msg_message_t *message)
 {
-    memset(msg_string, 0, sizeof(msg_string));
+    output_t out = { msg_string, sizeof(msg_string), 0U };
 
     if (message) {
         /* data (hex/dec/oct) */
         if (message->dlc) {
-            format_data(msg_string, message, 0, 0);
+            format_data(&out, &msg_option, message, 0, 0);
         }
     }
+    (void)put_end(&out);
     return msg_string;
 }
 
 char *msg_format_ascii(const msg_message_t *message)
 {
-    memset(msg_string, 0, sizeof(msg_string));
+    output_t out = { msg_string, sizeof(msg_string), 0U };
 
     if (message) {
         /* data (hex/dec/oct) */
         if (message->dlc) {
-            format_ascii(msg_string, message);
+            format_ascii(&out, &msg_option, message);
         }
     }
+    (void)put_end(&out);
     return msg_string;
 }
 
@@ -356,7 +347,10 @@ int msg_set_format(msg_format_t format)
 
     switch (format) {
     case MSG_FORMAT_DEFAULT:
-        msg_format = format;
+    case MSG_FORMAT_CANDUMP:
+    case MSG_FORMAT_ASC:
+    case MSG_FORMAT_CSV:
+        msg_option.format = format;
         break;
     default:
         rc = 0;
@@ -686,196 +680,517 @@ int msg_set_fmt_tx_prompt(const char *option)
 /*  -----------  local functions  ----------------------------------------
  */
 
-static void format_time(char *string, const msg_message_t *message)
+static void format_message(output_t *out, msg_fmt_options_t *options, const msg_message_t *message,
+                           msg_direction_t direction, msg_counter_t counter, msg_channel_t channel)
+{
+    assert(out);
+    assert(options);
+    assert(message);
+
+    /* formats for other tools (no formatter options except time-stamp and end-of-line) */
+    switch (options->format) {
+    case MSG_FORMAT_CANDUMP:
+        format_candump(out, options, message, channel);
+        goto end_of_line;
+    case MSG_FORMAT_ASC:
+        format_asc(out, options, message, direction, channel);
+        goto end_of_line;
+    case MSG_FORMAT_CSV:
+        format_csv(out, options, message, direction, channel);
+        goto end_of_line;
+    default:
+        break;
+    }
+    /* prompt (optional) */
+    if (options->tx_prompt[0] && (direction == MSG_TX_MESSAGE)) {
+        put_string(out, options->tx_prompt);
+        format_separator(out, options, " ");
+    }
+    else if (options->rx_prompt[0]) { /* defaults to MSG_DIRECTION_RX_MSG */
+        put_string(out, options->rx_prompt);
+        format_separator(out, options, " ");
+    }
+    /* counter (optional) */
+    if ((options->counter != MSG_FMT_OPTION_OFF) && ((options->separator == MSG_FMT_SEPARATOR_TABS))) {
+        put_unsigned(out, counter, 10U, 0, ' ');
+        put_char(out, '\t');
+    }
+    else if (options->counter != MSG_FMT_OPTION_OFF) { /* defaults to MSG_FMT_SEPARATOR_SPACES */
+        put_unsigned(out, counter, 10U, 7, '-');
+        put_string(out, "  ");
+    }
+    /* time-stamp (abs/rel/zero) (hhmmss/sec/DJD).(msec/usec) */
+    format_time(out, options, message);
+    format_separator(out, options, "  ");
+
+    /* channel (optional) */
+    if ((options->channel != MSG_FMT_OPTION_OFF) && (options->separator == MSG_FMT_SEPARATOR_TABS)) {
+        put_signed(out, channel, 0, ' ');
+        put_char(out, '\t');
+    }
+    else if (options->channel != MSG_FMT_OPTION_OFF) { /* defaults to MSG_FMT_SEPARATOR_SPACES */
+        put_signed(out, channel, 2, '-');
+        put_string(out, "  ");
+    }
+    /* identifier (hex/dec/oct) */
+    format_id(out, options, message);
+    format_separator(out, options, "  ");
+
+    /* flags (optional) */
+    if (options->flags != MSG_FMT_OPTION_OFF) {
+        format_flags(out, message);
+        format_separator(out, options, " ");  /* only one space! */
+    }
+    /* dlc/length (hex/dec/oct) */
+    format_dlc(out, options, message);
+
+    /* data (hex/dec/oct) plus ascii (optional) */
+    if (message->dlc && !message->rtr) {
+        format_separator(out, options, "  ");
+        format_data(out, options, message, (options->ascii == MSG_FMT_OPTION_OFF) ? 0 : 1, (int)out->count);
+    }
+end_of_line:
+    /* end-of-line (optional) */
+    if (options->end_of_line) {
+        put_char(out, '\n');
+    }
+}
+
+/*  candump log format (cf. candump -l):
+ *    (1697123456.123456) can0 123#1122334455667788
+ *    (1697123456.123456) can0 12345678#R
+ *    (1697123456.123456) can0 123##1112233  (CAN FD, flags: BRS = 1, ESI = 2)
+ *    (1697123456.123456) can0 20000000#0000000000000000  (error frame)
+ */
+static void format_candump(output_t *out, msg_fmt_options_t *options, const msg_message_t *message,
+                           msg_channel_t channel)
 {
-    static msg_timestamp_t laststamp = { 0, 0 };
-    static int first = 1;
+    struct timespec difftime;
+    int i, length = DLC2LEN(message->dlc);
+
+    assert(out);
+    assert(options);
+    assert(message);
 
+    time_difference(options, message, &difftime);
+    put_char(out, '(');
+    format_seconds(out, &difftime, 10, '0', 6);
+    put_string(out, ") can");
+    put_signed(out, channel, 0, ' ');
+    put_char(out, ' ');
+    if (message->sts) {
+        put_string(out, "20000000#");
+        for (i = 0; i < length; i++)
+            format_hex_byte(out, message->data[i]);
+        return;
+    }
+    put_unsigned(out, message->id, 16U, message->xtd ? 8 : 3, '0');
+    put_char(out, '#');
+#if (OPTION_CAN_2_0_ONLY == 0)
+    if (message->fdf) {
+        put_char(out, '#');
+        put_char(out, digits[(message->brs ? 0x1U : 0x0U) | (message->esi ? 0x2U : 0x0U)]);
+    }
+    else
+#endif
+    if (message->rtr) {
+        put_char(out, 'R');
+        if (message->dlc)
+            put_char(out, digits[message->dlc & 0xFU]);
+        return;
+    }
+    for (i = 0; i < length; i++)
+        format_hex_byte(out, message->data[i]);
+}
+
+/*  Vector ASCII log format (channel numbers start with 1):
+ *       0.012345 1  123             Rx   d 8 11 22 33 44 55 66 77 88
+ *       0.012345 1  12345678x       Tx   r 8
+ *       0.012345 CANFD   1 Rx   123 1 0 9 12 11 22 33 44 55 66 77 88 99 AA BB CC
+ *       0.012345 1  ErrorFrame
+ */
+static void format_asc(output_t *out, msg_fmt_options_t *options, const msg_message_t *message,
+                       msg_direction_t direction, msg_channel_t channel)
+{
     struct timespec difftime;
-    struct tm tm; time_t t;
-    char   timestring[25];
-    double djd;
+    int i, length = DLC2LEN(message->dlc);
+    size_t start;
 
-    assert(string);
+    assert(out);
+    assert(options);
     assert(message);
 
-    switch (msg_option.time_stamp) {
-    case MSG_FMT_TIMESTAMP_RELATIVE:
-    case MSG_FMT_TIMESTAMP_ZERO:
-        if (first) { /* first time-stamp received */
-            first = 0;
-            laststamp.tv_sec = message->timestamp.tv_sec;
-            laststamp.tv_nsec = message->timestamp.tv_nsec;
-        }
-        difftime.tv_sec = message->timestamp.tv_sec - laststamp.tv_sec;
-        difftime.tv_nsec = message->timestamp.tv_nsec - laststamp.tv_nsec;
-        if (difftime.tv_nsec < 0) {
-            difftime.tv_sec -= 1;
-            difftime.tv_nsec += 1000000000;
-        }
-        if (difftime.tv_sec < 0) { /* FIXME: why shouldn't it be negative? */
-            difftime.tv_sec = 0;
-            difftime.tv_nsec = 0;
+    time_difference(options, message, &difftime);
+    format_seconds(out, &difftime, 4, ' ', 6);
+    put_char(out, ' ');
+    if (message->sts) {
+        put_signed(out, (int64_t)channel + 1, 0, ' ');
+        put_string(out, "  ErrorFrame");
+        return;
+    }
+#if (OPTION_CAN_2_0_ONLY == 0)
+    if (message->fdf) {
+        put_string(out, "CANFD ");
+        put_signed(out, (int64_t)channel + 1, 3, ' ');
+        put_string(out, (direction == MSG_TX_MESSAGE) ? " Tx   " : " Rx   ");
+        put_unsigned(out, message->id, 16U, 0, '0');
+        if (message->xtd)
+            put_char(out, 'x');
+        put_string(out, message->brs ? " 1" : " 0");
+        put_string(out, message->esi ? " 1 " : " 0 ");
+        put_char(out, digits[message->dlc & 0xFU]);
+        put_char(out, ' ');
+        put_unsigned(out, (uint64_t)length, 10U, 2, ' ');
+        for (i = 0; i < length; i++) {
+            put_char(out, ' ');
+            format_hex_byte(out, message->data[i]);
         }
-        if (msg_option.time_stamp == MSG_FMT_TIMESTAMP_RELATIVE) { /* update for delta calculation */
-            laststamp.tv_sec = message->timestamp.tv_sec;
-            laststamp.tv_nsec = message->timestamp.tv_nsec;
+        return;
+    }
+#endif
+    put_signed(out, (int64_t)channel + 1, 0, ' ');
+    put_string(out, "  ");
+    start = out->count;
+    put_unsigned(out, message->id, 16U, 0, '0');
+    if (message->xtd)
+        put_char(out, 'x');
+    while ((out->count - start) < 15U)
+        put_char(out, ' ');
+    put_string(out, (direction == MSG_TX_MESSAGE) ? " Tx   " : " Rx   ");
+    put_char(out, message->rtr ? 'r' : 'd');
+    put_char(out, ' ');
+    put_char(out, digits[message->dlc & 0xFU]);
+    if (!message->rtr) {
+        for (i = 0; i < length; i++) {
+            put_char(out, ' ');
+            format_hex_byte(out, message->data[i]);
         }
-        t = (time_t)difftime.tv_sec;
-        tm = *gmtime(&t);
-        break;
-    case MSG_FMT_TIMESTAMP_ABSOLUTE:
-    default:
-        difftime.tv_sec = message->timestamp.tv_sec;
-        difftime.tv_nsec = message->timestamp.tv_nsec;
-        t = (time_t)message->timestamp.tv_sec;
-        tm = *localtime(&t);
-        break;
     }
-    switch (msg_option.time_format) {
+}
+
+/*  comma-separated values (time in seconds, identifier and data in hex):
+ *    time,dir,channel,id,xtd,rtr,fdf,brs,esi,err,dlc,data
+ *    1697123456.123456789,Rx,0,123,0,0,0,0,0,0,2,1122
+ */
+static void format_csv(output_t *out, msg_fmt_options_t *options, const msg_message_t *message,
+                       msg_direction_t direction, msg_channel_t channel)
+{
+    struct timespec difftime;
+    int i, length = DLC2LEN(message->dlc);
+
+    assert(out);
+    assert(options);
+    assert(message);
+
+    time_difference(options, message, &difftime);
+    format_seconds(out, &difftime, 0, '0', 9);
+    put_string(out, (direction == MSG_TX_MESSAGE) ? ",Tx," : ",Rx,");
+    put_signed(out, channel, 0, ' ');
+    put_char(out, ',');
+    put_unsigned(out, message->id, 16U, 0, '0');
+    put_string(out, message->xtd ? ",1" : ",0");
+    put_string(out, message->rtr ? ",1" : ",0");
+#if (OPTION_CAN_2_0_ONLY == 0)
+    put_string(out, message->fdf ? ",1" : ",0");
+    put_string(out, message->brs ? ",1" : ",0");
+    put_string(out, message->esi ? ",1" : ",0");
+#else
+    put_string(out, ",0,0,0");
+#endif
+    put_string(out, message->sts ? ",1," : ",0,");
+    put_unsigned(out, message->dlc, 10U, 0, '0');
+    put_char(out, ',');
+    if (!message->rtr) {
+        for (i = 0; i < length; i++)
+            format_hex_byte(out, message->data[i]);
+    }
+}
+
+static void format_asc_date(output_t *out, const char *prefix)
+{
+    char string[64];
+    struct tm tm;
+    time_t now = time(NULL);
+
+    memset(&tm, 0, sizeof(struct tm));
+#if !defined(_WIN32) && !defined(_WIN64)
+    (void)localtime_r(&now, &tm);
+#else
+    (void)localtime_s(&tm, &now);
+#endif
+    /* note: only used for the file header, so strftime is fine here */
+    if (strftime(string, sizeof(string), "%a %b %d %H:%M:%S.000 %Y", &tm) > 0) {
+        put_string(out, prefix);
+        put_string(out, string);
+        put_char(out, '\n');
+    }
+}
+
+static void format_time(output_t *out, msg_fmt_options_t *options, const msg_message_t *message)
+{
+    struct timespec difftime;
+    struct tm tm; time_t t;
+    uint64_t days, fraction;
+    output_t text;
+    int local;
+
+    assert(out);
+    assert(options);
+    assert(message);
+
+    time_difference(options, message, &difftime);
+
+    switch (options->time_format) {
     case MSG_FMT_TIME_HHMMSS:
-        strftime(timestring, 24, "%H:%M:%S", &tm); // TODO: tm > 24h (?)
-        if (msg_option.time_usec)
-            sprintf(string, "%s.%06li", timestring, (long)difftime.tv_nsec / 1000L);
+        /* note: most messages are in the same second as the previous one,
+         *       so 'hh:mm:ss.' is only converted and rendered once a second */
+        local = (options->time_stamp == MSG_FMT_TIMESTAMP_ABSOLUTE) ? 1 : 0;
+        if (!options->cache.valid || (options->cache.second != (int64_t)difftime.tv_sec) ||
+            (options->cache.local != local)) {
+            /* note: gmtime/localtime are not reentrant, use the _r/_s variants */
+            memset(&tm, 0, sizeof(struct tm));
+            t = (time_t)difftime.tv_sec;
+#if !defined(_WIN32) && !defined(_WIN64)
+            if (local)
+                (void)localtime_r(&t, &tm);
+            else
+                (void)gmtime_r(&t, &tm);
+#else
+            if (local)
+                (void)localtime_s(&tm, &t);
+            else
+                (void)gmtime_s(&tm, &t);
+#endif
+            text.buffer = options->cache.text;
+            text.length = sizeof(options->cache.text);
+            text.count = 0U;
+            put_unsigned(&text, (uint64_t)tm.tm_hour, 10U, 2, '0');  // TODO: tm > 24h (?)
+            put_char(&text, ':');
+            put_unsigned(&text, (uint64_t)tm.tm_min, 10U, 2, '0');
+            put_char(&text, ':');
+            put_unsigned(&text, (uint64_t)tm.tm_sec, 10U, 2, '0');
+            put_char(&text, '.');
+            (void)put_end(&text);
+            options->cache.second = (int64_t)difftime.tv_sec;
+            options->cache.local = local;
+            options->cache.valid = 1;
+        }
+        put_string(out, options->cache.text);
+        if (options->time_usec)
+            put_unsigned(out, (uint64_t)difftime.tv_nsec / 1000U, 10U, 6, '0');
         else/* resolution is 0.1 milliseconds! */
-            sprintf(string, "%s.%04li", timestring, (long)difftime.tv_nsec / 100000L);
+            put_unsigned(out, (uint64_t)difftime.tv_nsec / 100000U, 10U, 4, '0');
         break;
     case MSG_FMT_TIME_DJD:
-        if (!msg_option.time_usec)  /* round to milliseconds resolution */
+        if (!options->time_usec)  /* round to milliseconds resolution */
             difftime.tv_nsec = ((difftime.tv_nsec + 500000L) / 1000000L) * 1000000L;
-        djd = (double)difftime.tv_sec / (double)86400;
-        djd += (double)difftime.tv_nsec / (double)86400000000000;
-        if (msg_option.time_usec)
-            sprintf(string, "%1.12lf", djd);
-        else
-            sprintf(string, "%1.9lf", djd);
+        /* days and fraction of the day (in nanoseconds) as integers, no floating point */
+        days = (difftime.tv_sec > 0) ? (uint64_t)difftime.tv_sec / 86400U : 0U;
+        fraction = (difftime.tv_sec > 0) ? ((uint64_t)difftime.tv_sec % 86400U) * 1000000000U : 0U;
+        fraction += (uint64_t)difftime.tv_nsec;
+        if (options->time_usec) {  /* 12 digits: ns * 10^12 / (86400 * 10^9), rounded */
+            fraction = ((fraction * 10U) + 432U) / 864U;
+            days += fraction / 1000000000000U;
+            fraction %= 1000000000000U;
+        }
+        else {  /* 9 digits: ns * 10^9 / (86400 * 10^9), rounded */
+            fraction = (fraction + 43200U) / 86400U;
+            days += fraction / 1000000000U;
+            fraction %= 1000000000U;
+        }
+        put_unsigned(out, days, 10U, 1, '0');
+        put_char(out, '.');
+        put_unsigned(out, fraction, 10U, options->time_usec ? 12 : 9, '0');
         break;
     case MSG_FMT_TIME_SEC:
     default:
-        if (msg_option.time_usec)
-            sprintf(string, "%3li.%06li", (long)difftime.tv_sec, (long)difftime.tv_nsec / 1000L);
+        if (options->time_usec)
+            format_seconds(out, &difftime, 3, ' ', 6);
         else/* resolution is 0.1 milliseconds! */
-            sprintf(string, "%3li.%04li", (long)difftime.tv_sec, (long)difftime.tv_nsec / 100000L);
+            format_seconds(out, &difftime, 3, ' ', 4);
         break;
     }
 }
 
-static void format_id(char *string, const msg_message_t *message)
+
+static void time_difference(msg_fmt_options_t *options, const msg_message_t *message, struct timespec *difftime)
 {
-    assert(string);
+    assert(options);
     assert(message);
+    assert(difftime);
+
+    switch (options->time_stamp) {
+    case MSG_FMT_TIMESTAMP_RELATIVE:
+    case MSG_FMT_TIMESTAMP_ZERO:
+        if (!options->reference.valid) { /* first time-stamp received */
+            options->reference.valid = 1;
+            options->reference.stamp.tv_sec = message->timestamp.tv_sec;
+            options->reference.stamp.tv_nsec = message->timestamp.tv_nsec;
+        }
+        difftime->tv_sec = message->timestamp.tv_sec - options->reference.stamp.tv_sec;
+        difftime->tv_nsec = message->timestamp.tv_nsec - options->reference.stamp.tv_nsec;
+        if (difftime->tv_nsec < 0) {
+            difftime->tv_sec -= 1;
+            difftime->tv_nsec += 1000000000;
+        }
+        if (difftime->tv_sec < 0) { /* FIXME: why shouldn't it be negative? */
+            difftime->tv_sec = 0;
+            difftime->tv_nsec = 0;
+        }
+        if (options->time_stamp == MSG_FMT_TIMESTAMP_RELATIVE) { /* update for delta calculation */
+            options->reference.stamp.tv_sec = message->timestamp.tv_sec;
+            options->reference.stamp.tv_nsec = message->timestamp.tv_nsec;
+        }
+        break;
+    case MSG_FMT_TIMESTAMP_ABSOLUTE:
+    default:
+        difftime->tv_sec = message->timestamp.tv_sec;
+        difftime->tv_nsec = message->timestamp.tv_nsec;
+        break;
+    }
+}
 
-    string[0] = '\0';
-    switch (msg_option.id) {
+static void format_seconds(output_t *out, const struct timespec *time, int width, char pad, int digits)
+{
+    static const uint32_t divisor[10] = {
+        1000000000U, 100000000U, 10000000U, 1000000U, 100000U, 10000U, 1000U, 100U, 10U, 1U
+    };
+    assert(out);
+    assert(time);
+    assert((0 <= digits) && (digits <= 9));
+
+    /* <seconds>.<fraction> with the given number of digits (truncated) */
+    put_signed(out, (int64_t)time->tv_sec, width, pad);
+    put_char(out, '.');
+    put_unsigned(out, (uint64_t)time->tv_nsec / divisor[digits], 10U, digits, '0');
+}
+
+static void format_id(output_t *out, const msg_fmt_options_t *options, const msg_message_t *message)
+{
+    assert(out);
+    assert(options);
+    assert(message);
+
+    switch (options->id) {
     case MSG_FMT_NUMBER_DEC:
-        if (!msg_option.id_xtd)
-            sprintf(string, "%-4" PRIu32, message->id);
-        else
-            sprintf(string, "%-9" PRIu32, message->id);
+        put_unsigned(out, message->id, 10U, !options->id_xtd ? 4 : 9, '-');
         break;
     case MSG_FMT_NUMBER_OCT:
-        if (!msg_option.id_xtd)
-            sprintf(string, "%04" PRIo32, message->id);
-        else
-            sprintf(string, "%010" PRIo32, message->id);
+        put_unsigned(out, message->id, 8U, !options->id_xtd ? 4 : 10, '0');
         break;
     case MSG_FMT_NUMBER_HEX:
     default:
-        if (!msg_option.id_xtd)
-            sprintf(string, "%03" PRIX32, message->id);
-        else
-            sprintf(string, "%08" PRIX32, message->id);
+        put_unsigned(out, message->id, 16U, !options->id_xtd ? 3 : 8, '0');
         break;
     }
 }
 
-static void format_dlc(char *string, const msg_message_t *message)
+static void format_flags(output_t *out, const msg_message_t *message)
+{
+    assert(out);
+    assert(message);
+
+#if (OPTION_CAN_2_0_ONLY == 0)
+    if (!message->sts) {
+        put_char(out, message->xtd ? 'X' : 'S');
+        put_char(out, message->fdf ? 'F' : '-');
+        put_char(out, message->brs ? 'B' : '-');
+        put_char(out, message->esi ? 'E' : '-');
+        put_char(out, message->rtr ? 'R' : '-');
+    }
+    else {
+        put_string(out, "Error");
+    }
+#else
+    if (!message->sts) {
+        put_char(out, message->xtd ? 'X' : 'S');
+        put_char(out, message->rtr ? 'R' : '-');
+    }
+    else {
+        put_string(out, "E!");
+    }
+#endif
+}
+
+static void format_dlc(output_t *out, const msg_fmt_options_t *options, const msg_message_t *message)
 {
-    assert(string);
+    assert(out);
+    assert(options);
     assert(message);
 
-    unsigned char length = (msg_option.dlc_format == MSG_FMT_CANFD_DLC) ? message->dlc : DLC2LEN(message->dlc);
+    unsigned char length = (options->dlc_format == MSG_FMT_CANFD_DLC) ? message->dlc : DLC2LEN(message->dlc);
     char pre = '\0', post = '\0';
     int blank = 0;
 
-    string[0] = '\0';
-    switch (msg_option.dlc_brackets) {
+    switch (options->dlc_brackets) {
     case '(': pre = '('; post = ')'; break;
     case '[': pre = '['; post = ']'; break;
     default: break;
     }
-    switch (msg_option.dlc) {
+    if (pre && post)
+        put_char(out, pre);
+    switch (options->dlc) {
     case MSG_FMT_NUMBER_DEC:
-        if (pre && post)
-            sprintf(string, "%c%u%c", pre, length, post);
-        else
-            sprintf(string, "%u", length);
+        put_unsigned(out, length, 10U, 0, ' ');
         blank = length >= 10 ? 0 : 1;
         break;
     case MSG_FMT_NUMBER_OCT:
-        if (pre && post)
-            sprintf(string, "%c%02o%c", pre, length, post);
-        else
-            sprintf(string, "%02o", length);
+        put_unsigned(out, length, 8U, 2, '0');
         blank = length >= 64 ? 0 : 1;
         break;
     case MSG_FMT_NUMBER_HEX:
     default:
-        if (pre && post)
-            sprintf(string, "%c%X%c", pre, length, post);
-        else
-            sprintf(string, "%X", length);
+        put_unsigned(out, length, 16U, 0, '0');
         break;
     }
+    if (pre && post)
+        put_char(out, post);
 #if (OPTION_CAN_2_0_ONLY == 0)
     if (message->fdf && blank)
-        strcat(string, " ");
+        put_char(out, ' ');
 #else
     (void)blank;  /* to avoid compiler warnings */
 #endif
 }
 
-static void format_data(char *string, const msg_message_t *message, int ascii, int indent)
+static void format_data(output_t *out, const msg_fmt_options_t *options, const msg_message_t *message, int ascii, int indent)
 {
-    assert(string);
+    assert(out);
+    assert(options);
     assert(message);
 
     int length = DLC2LEN(message->dlc);
     int i, j, col, wraparound;
-    char datastring[8];
 
-    string[0] = '\0';
 #if (OPTION_CAN_2_0_ONLY == 0)
-    if (msg_option.wraparound == MSG_FMT_WRAPAROUND_NO)
+    if (options->wraparound == MSG_FMT_WRAPAROUND_NO)
         wraparound = message->fdf ? (int)MSG_FMT_WRAPAROUND_64 : (int)MSG_FMT_WRAPAROUND_8;
     else
-        wraparound = (int)msg_option.wraparound;
+        wraparound = (int)options->wraparound;
 #else
     wraparound = (int)MSG_FMT_WRAPAROUND_8;
 #endif
     for (i = 0, j = 0, col = 0; i < length; i++) {
-        format_data_byte(datastring, message->data[i]);
-        strcat(string, datastring);
+        format_data_byte(out, options, message->data[i]);
         if ((i + 1) < length) {
             if ((col + 1) == wraparound) {
                 if (ascii) {
-                    strcat(string, msg_option.separator == MSG_FMT_SEPARATOR_TABS ? "\t" : "  ");
-                    for (col = 0; col < (int)msg_option.wraparound; j++, col++) {
-                        format_data_ascii(datastring, message->data[j]);
-                        strcat(string, datastring);
+                    format_separator(out, options, "  ");
+                    for (col = 0; col < (int)options->wraparound; j++, col++) {
+                        format_data_ascii(out, options, message->data[j]);
                     }
                 }
-                strcat(string, "\n");
-                if (msg_option.separator != MSG_FMT_SEPARATOR_TABS) {
+                put_char(out, '\n');
+                if (options->separator != MSG_FMT_SEPARATOR_TABS) {
                     for (col = 0; col < indent; col++)
-                        strcat(string, " ");
+                        put_char(out, ' ');
                 }
                 else
-                    strcat(string, "\t");
+                    put_char(out, '\t');
                 col = 0;
             }
             else {
-                strcat(string, " ");
+                put_char(out, ' ');
                 col++;
             }
         }
@@ -884,97 +1199,178 @@ static void format_data(char *string, const msg_message_t *message, int ascii, i
     }
     if (ascii) {
         if ((col < wraparound) && (i != 0)) {
-            strcat(string, " ");
+            put_char(out, ' ');
             for (; col < wraparound; col++) {
-                format_fill_byte(datastring);
-                strcat(string, datastring);
+                format_fill_byte(out, options);
                 if ((col + 1) != wraparound)
-                    strcat(string, " ");
+                    put_char(out, ' ');
             }
         }
-        strcat(string, msg_option.separator == MSG_FMT_SEPARATOR_TABS ? "\t" : "  ");
+        format_separator(out, options, "  ");
         for (; j < length; j++) {
-            format_data_ascii(datastring, message->data[j]);
-            strcat(string, datastring);
+            format_data_ascii(out, options, message->data[j]);
         }
     }
 }
 
-static void format_ascii(char *string, const msg_message_t *message)
+static void format_ascii(output_t *out, const msg_fmt_options_t *options, const msg_message_t *message)
 {
-    assert(string);
+    assert(out);
+    assert(options);
     assert(message);
 
     int length = DLC2LEN(message->dlc);
     int i, col, wraparound;
-    char datastring[8];
 
-    string[0] = '\0';
 #if (OPTION_CAN_2_0_ONLY == 0)
-    if (msg_option.wraparound == MSG_FMT_WRAPAROUND_NO)
+    if (options->wraparound == MSG_FMT_WRAPAROUND_NO)
         wraparound = message->fdf ? (int)MSG_FMT_WRAPAROUND_64 : (int)MSG_FMT_WRAPAROUND_8;
     else
-        wraparound = (int)msg_option.wraparound;
+        wraparound = (int)options->wraparound;
 #else
     wraparound = (int)MSG_FMT_WRAPAROUND_8;
 #endif
     for (i = 0, col = 0; i < length; i++) {
-        format_data_ascii(datastring, message->data[i]);
-        strcat(string, datastring);
+        format_data_ascii(out, options, message->data[i]);
         if ((i + 1) < length) {
             if ((col + 1) == wraparound) {
-                strcat(string, "\n");
+                put_char(out, '\n');
                 col = 0;
             }
             else {
-                strcat(string, " ");
+                put_char(out, ' ');
                 col++;
             }
         }
     }
 }
 
-static void format_data_byte(char *string, unsigned char data)
+static void format_data_byte(output_t *out, const msg_fmt_options_t *options, unsigned char data)
 {
-    assert(string);
+    assert(out);
+    assert(options);
 
-    switch (msg_option.data) {
+    switch (options->data) {
     case MSG_FMT_NUMBER_DEC:
-        sprintf(string, "%-3u", data);
+        put_unsigned(out, data, 10U, 3, '-');
         break;
     case MSG_FMT_NUMBER_OCT:
-        sprintf(string, "%03o", data);
+        put_unsigned(out, data, 8U, 3, '0');
         break;
     case MSG_FMT_NUMBER_HEX:
     default:
-        sprintf(string, "%02X", data);
+        format_hex_byte(out, data);
         break;
     }
 }
 
-static void format_fill_byte(char *string)
+static void format_hex_byte(output_t *out, unsigned char data)
+{
+    assert(out);
+
+    put_char(out, digits[data >> 4]);
+    put_char(out, digits[data & 0xFU]);
+}
+
+static void format_fill_byte(output_t *out, const msg_fmt_options_t *options)
 {
-    assert(string);
+    assert(out);
+    assert(options);
 
-    switch (msg_option.data) {
+    switch (options->data) {
     case MSG_FMT_NUMBER_DEC:
-        sprintf(string, "   ");
+        put_string(out, "   ");
         break;
     case MSG_FMT_NUMBER_OCT:
-        sprintf(string, "   ");
+        put_string(out, "   ");
         break;
     case MSG_FMT_NUMBER_HEX:
     default:
-        sprintf(string, "  ");
+        put_string(out, "  ");
         break;
     }
 }
 
-static void format_data_ascii(char *string, unsigned char data)
+static void format_data_ascii(output_t *out, const msg_fmt_options_t *options, unsigned char data)
 {
-    assert(string);
+    assert(out);
+    assert(options);
 
-    sprintf(string, "%c", isprint((int)data) ? (char)data : (char)msg_option.ascii_subst);
+    put_char(out, isprint((int)data) ? (char)data : (char)options->ascii_subst);
+}
+
+static void format_separator(output_t *out, const msg_fmt_options_t *options, const char *spaces)
+{
+    assert(out);
+    assert(options);
+
+    if (options->separator == MSG_FMT_SEPARATOR_TABS)
+        put_char(out, '\t');
+    else
+        put_string(out, spaces);
+}
+
+/* note: characters beyond the end of the buffer are counted, but not written */
+static void put_char(output_t *out, char c)
+{
+    if ((out->count + 1U) < out->length)
+        out->buffer[out->count] = c;
+    out->count++;
+}
+
+static void put_string(output_t *out, const char *string)
+{
+    while (*string)
+        put_char(out, *string++);
+}
+
+/* pad: '0' or ' ' right-justified, '-' left-justified with spaces (like printf) */
+static void put_number(output_t *out, uint64_t value, int negative, unsigned base, int width, char pad)
+{
+    char string[24];  /* 64-bit value in octal */
+    int n = 0, i;
+
+    do {
+        string[n++] = digits[value % base];
+        value /= base;
+    } while (value);
+
+    if (negative && (pad == '0'))
+        put_char(out, '-');
+    if (negative)
+        width--;
+    if (pad != '-') {
+        for (i = n; i < width; i++)
+            put_char(out, pad);
+    }
+    if (negative && (pad != '0'))
+        put_char(out, '-');
+    for (i = n; i > 0; i--)
+        put_char(out, string[i - 1]);
+    if (pad == '-') {
+        for (i = n; i < width; i++)
+            put_char(out, ' ');
+    }
+}
+
+static void put_unsigned(output_t *out, uint64_t value, unsigned base, int width, char pad)
+{
+    put_number(out, value, 0, base, width, pad);
+}
+
+static void put_signed(output_t *out, int64_t value, int width, char pad)
+{
+    if (value < 0)
+        put_number(out, (uint64_t)0 - (uint64_t)value, 1, 10U, width, pad);
+    else
+        put_number(out, (uint64_t)value, 0, 10U, width, pad);
+}
+
+static int put_end(output_t *out)
+{
+    if (out->length)
+        out->buffer[(out->count < out->length) ? out->count : (out->length - 1U)] = '\0';
+    return (int)out->count;
 }
 
 /** @}
@@ -74,6 +74,7 @@ extern "C" {
 #include <stdbool.h>                    /*   C99 header for boolean type */
 #include <time.h>                       /*   for structure 'timespec' */
 #endif
+#include <stddef.h>                     /* for type 'size_t' */
 
 /*  -----------  options  ------------------------------------------------
  */
@@ -129,6 +130,9 @@ extern "C" {
  *  @brief Values which can be used as property value (argument)
  *  @{ */
 #define CANPARA_FORMAT_DEFAULT       0  /**< message formatter output (default) */
+#define CANPARA_FORMAT_CANDUMP       1  /**< message formatter output: candump log (-l) */
+#define CANPARA_FORMAT_ASC           2  /**< message formatter output: Vector ASCII log */
+#define CANPARA_FORMAT_CSV           3  /**< message formatter output: comma-separated values */
  /* - -  formatter option: ON or OFF - - - - - - - - - - - - - - - - - - */
 #define CANPARA_OPTION_OFF           0  /**< formatter option: OFF (false, no, 0) */
 #define CANPARA_OPTION_ON            1  /**< formatter option: ON (true, yes, !0) */
@@ -169,7 +173,10 @@ extern "C" {
 /** @brief       CAN Message Format (output)
  */
 typedef enum msg_format_t_ {
-    MSG_FORMAT_DEFAULT = CANPARA_FORMAT_DEFAULT
+    MSG_FORMAT_DEFAULT = CANPARA_FORMAT_DEFAULT,
+    MSG_FORMAT_CANDUMP = CANPARA_FORMAT_CANDUMP,
+    MSG_FORMAT_ASC     = CANPARA_FORMAT_ASC,
+    MSG_FORMAT_CSV     = CANPARA_FORMAT_CSV
 } msg_format_t;
 
 /** @brief       Formatter Option: ON or OFF
@@ -280,6 +287,41 @@ typedef enum msg_direction_t_ {
     MSG_TX_MESSAGE = 1
 } msg_direction_t;
 
+/** @brief       Formatter Options (for the reentrant formatter)
+ */
+typedef struct msg_fmt_options_t_ {
+    msg_format_t         format;        /**< output format {DEFAULT, CANDUMP, ASC, CSV} */
+    msg_fmt_timestamp_t  time_stamp;    /**< time-stamp {ZERO, ABS, REL} */
+    msg_fmt_option_t     time_usec;     /**< time-stamp in usec {OFF, ON} */
+    msg_fmt_time_t       time_format;   /**< time format {TIME, SEC, DJD} */
+    msg_fmt_number_t     id;            /**< identifier {HEX, DEC, OCT} */
+    msg_fmt_option_t     id_xtd;        /**< extended identifier {OFF, ON} */
+    msg_fmt_number_t     dlc;           /**< DLC/length {HEX, DEC, OCT} */
+    msg_fmt_canfd_t      dlc_format;    /**< CAN FD format {DLC, LENGTH} */
+    int                  dlc_brackets;  /**< DLC in brackets {'\0', '(', '['} */
+    msg_fmt_option_t     flags;         /**< message flags {ON, OFF} */
+    msg_fmt_number_t     data;          /**< message data {HEX, DEC, OCT} */
+    msg_fmt_option_t     ascii;         /**< data as ASCII {ON, OFF} */
+    int                  ascii_subst;   /**< substitute for non-printables */
+    msg_fmt_option_t     channel;       /**< message source {OFF, ON} */
+    msg_fmt_option_t     counter;       /**< message counter {ON, OFF} */
+    msg_fmt_separator_t  separator;     /**< separator {SPACES, TABS} */
+    msg_fmt_wraparound_t wraparound;    /**< wraparound {NO, 8, 16, 32, 64} */
+    msg_fmt_option_t     end_of_line;   /**< end-of-line character {ON, OFF} */
+    char                 rx_prompt[6+1];/**< prompt for received messages */
+    char                 tx_prompt[6+1];/**< prompt for sent messages */
+    struct {                            /*   time-stamp reference (ZERO, REL): */
+        msg_timestamp_t  stamp;         /**< first resp. last time-stamp */
+        int              valid;         /**< flag: reference is set */
+    } reference;                        /**< (updated by the formatter) */
+    struct {                            /*   time-stamp cache (TIME): */
+        int64_t          second;        /**< second of the rendered text */
+        int              local;         /**< flag: local time (ABS) */
+        int              valid;         /**< flag: cache is valid */
+        char             text[9+1];     /**< rendered text 'hh:mm:ss.' */
+    } cache;                            /**< (updated by the formatter) */
+} msg_fmt_options_t;
+
 
 /*  -----------  variables  ----------------------------------------------
  */
@@ -297,6 +339,55 @@ typedef enum msg_direction_t_ {
 char *msg_format_message(const msg_message_t *message, msg_direction_t direction,
                                msg_counter_t counter, msg_channel_t channel);
 
+/** @brief       formats a CAN message into a caller-supplied buffer (reentrant).
+ *
+ *  @remarks     The function uses no static data and does not allocate memory,
+ *               so it can be called from several threads, each with its own
+ *               buffer and formatter options. The time-stamp reference for the
+ *               formats ZERO and REL is kept in the formatter options, as well
+ *               as the rendered time of day of the last second (format TIME).
+ *
+ *  @param[out]  buffer    - buffer for the zero-terminated string
+ *  @param[in]   length    - size of the buffer (in bytes)
+ *  @param[in]   options   - formatter options (see msg_get_fmt_options)
+ *  @param[in]   message   - CAN message to be formatted
+ *  @param[in]   direction - message direction (RX or TX)
+ *  @param[in]   counter   - message counter
+ *  @param[in]   channel   - message source
+ *
+ *  @returns     number of characters (without the terminating zero), that would
+ *               have been written if the buffer had been large enough (like
+ *               snprintf), or a negative value on error (errno is set).
+ */
+int msg_format_message_r(char *buffer, size_t length, msg_fmt_options_t *options,
+                         const msg_message_t *message, msg_direction_t direction,
+                         msg_counter_t counter, msg_channel_t channel);
+
+/** @brief       formats the file header of the selected output format (e.g.
+ *               date and time base for ASC or the column names for CSV).
+ *
+ *  @param[out]  buffer  - buffer for the zero-terminated string
+ *  @param[in]   length  - size of the buffer (in bytes)
+ *  @param[in]   options - formatter options (see msg_get_fmt_options)
+ *
+ *  @returns     number of characters (without the terminating zero), that would
+ *               have been written if the buffer had been large enough (zero if
+ *               the output format has no header), or a negative value on error.
+ */
+int msg_format_header_r(char *buffer, size_t length, const msg_fmt_options_t *options);
+
+/** @brief       formats the file footer of the selected output format (ASC).
+ *
+ *  @param[out]  buffer  - buffer for the zero-terminated string
+ *  @param[in]   length  - size of the buffer (in bytes)
+ *  @param[in]   options - formatter options (see msg_get_fmt_options)
+ *
+ *  @returns     number of characters (without the terminating zero), that would
+ *               have been written if the buffer had been large enough (zero if
+ *               the output format has no footer), or a negative value on error.
+ */
+int msg_format_footer_r(char *buffer, size_t length, const msg_fmt_options_t *options);
+
 /** @brief       ...
  *
  *  @param[in]   message - ...
@@ -345,7 +436,16 @@ char *msg_format_data(const msg_message_t *message);
  */
 char *msg_format_ascii(const msg_message_t *message);
 
-/** @brief       set message output format {DEFAULT, ...}.
+/** @brief       get the current formatter options (e.g. for the reentrant
+ *               formatter); the time-stamp reference and cache are reset.
+ *
+ *  @param[out]  options - formatter options
+ *
+ *  @returns     non-zero value on success, otherwise 0.
+ */
+int msg_get_fmt_options(msg_fmt_options_t *options);
+
+/** @brief       set message output format {DEFAULT, CANDUMP, ASC, CSV}.
  *
  *  @param[in]   format - ...
  *
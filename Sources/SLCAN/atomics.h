@@ -0,0 +1,112 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'atomics'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        atomics.h
+ *
+ *  @brief       Atomic operations for the lock-free parts of the SLCAN modules.
+ *
+ *  @remarks     With GCC and Clang the macros map to the '__atomic' built-ins.
+ *               With MSVC they map to the Interlocked functions and to the
+ *               ReadAcquire/WriteRelease intrinsics, because plain volatile
+ *               accesses are only ordered with option /volatile:ms, which is
+ *               not the default on ARM.
+ *
+ *  @note        This header is for internal use only.
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @defgroup    atomics Atomic Operations
+ *  @{
+ */
+#ifndef ATOMICS_H_INCLUDED
+#define ATOMICS_H_INCLUDED
+
+#include <stdint.h>
+#include <stdbool.h>
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#endif
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#if defined(_WIN32) || defined(_WIN64)
+#define LOAD_ACQUIRE(ptr)  (uint32_t)ReadAcquire((volatile LONG*)(ptr))
+#define STORE_RELEASE(ptr,val)  WriteRelease((volatile LONG*)(ptr), (LONG)(val))
+#define LOAD_POINTER(ptr)  ReadPointerAcquire((PVOID volatile*)(ptr))
+#define STORE_POINTER(ptr,val)  WritePointerRelease((PVOID volatile*)(ptr), (PVOID)(val))
+#define INCREMENT(ptr)  (void)InterlockedIncrement((volatile LONG*)(ptr))
+#define DECREMENT(ptr)  (void)InterlockedDecrement((volatile LONG*)(ptr))
+#define COMPARE_EXCHANGE(ptr,old,val)  (InterlockedCompareExchange((volatile LONG*)(ptr), (LONG)(val), (LONG)(old)) == (LONG)(old))
+#define LOAD_64(ptr)  (uint64_t)InterlockedCompareExchange64((volatile LONG64*)(ptr), 0, 0)
+#define STORE_64(ptr,val)  (void)InterlockedExchange64((volatile LONG64*)(ptr), (LONG64)(val))
+#define INCREMENT_64(ptr)  (void)InterlockedIncrement64((volatile LONG64*)(ptr))
+#define MEMORY_FENCE()  MemoryBarrier()
+#else
+#define LOAD_ACQUIRE(ptr)  __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(ptr,val)  __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#define LOAD_POINTER(ptr)  __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define STORE_POINTER(ptr,val)  __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#define INCREMENT(ptr)  (void)__atomic_add_fetch((ptr), 1U, __ATOMIC_SEQ_CST)
+#define DECREMENT(ptr)  (void)__atomic_sub_fetch((ptr), 1U, __ATOMIC_SEQ_CST)
+#define COMPARE_EXCHANGE(ptr,old,val)  __sync_bool_compare_and_swap((ptr), (old), (val))
+#define LOAD_64(ptr)  __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define STORE_64(ptr,val)  __atomic_store_n((ptr), (uint64_t)(val), __ATOMIC_RELAXED)
+#define INCREMENT_64(ptr)  (void)__atomic_fetch_add((ptr), 1U, __ATOMIC_RELAXED)
+#define MEMORY_FENCE()  __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+#endif /* ATOMICS_H_INCLUDED */
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
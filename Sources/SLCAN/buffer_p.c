@@ -81,7 +81,13 @@
 #define ENTER_CRITICAL_SECTION(buf)  assert(0 == pthread_mutex_lock(&buf->wait.mutex))
 #define LEAVE_CRITICAL_SECTION(buf)  assert(0 == pthread_mutex_unlock(&buf->wait.mutex))
 
-#define GET_TIME(ts)  do{ clock_gettime(CLOCK_REALTIME, &ts); } while(0)
+/* note: macOS does not support another clock for condition variables */
+#if !defined(__APPLE__)
+#define BUFFER_CLOCK  CLOCK_MONOTONIC
+#else
+#define BUFFER_CLOCK  CLOCK_REALTIME
+#endif
+#define GET_TIME(ts)  do{ clock_gettime(BUFFER_CLOCK, &ts); } while(0)
 #define ADD_TIME(ts,to)  do{ ts.tv_sec += (time_t)(to / 1000U); \
                              ts.tv_nsec += (long)(to % 1000U) * (long)1000000; \
                              if (ts.tv_nsec >= (long)1000000000) { \
@@ -124,6 +130,7 @@ typedef struct object_t_ {
 
 buffer_t buffer_create(size_t size) {
     object_t *object = (object_t*)NULL;
+    pthread_condattr_t attr;
 
     /* reset errno variable */
     errno = 0;
@@ -143,14 +150,20 @@ buffer_t buffer_create(size_t size) {
         }
         object->maxbytes = size;
         object->nbytes = 0;
-        /* create a mutex and a waitable condition */
+        /* create a mutex and a waitable condition (on the buffer clock) */
+        (void)pthread_condattr_init(&attr);
+#if !defined(__APPLE__)
+        (void)pthread_condattr_setclock(&attr, BUFFER_CLOCK);
+#endif
         if ((pthread_mutex_init(&object->wait.mutex, NULL) < 0) ||
-            (pthread_cond_init(&object->wait.cond, NULL)) < 0) {
+            (pthread_cond_init(&object->wait.cond, &attr)) < 0) {
             /* errno set */
+            (void)pthread_condattr_destroy(&attr);
             free(object->data);
             free(object);
             return NULL;
         }
+        (void)pthread_condattr_destroy(&attr);
         object->wait.flag = false;
     }
     return (buffer_t)object;
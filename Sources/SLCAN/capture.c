@@ -0,0 +1,522 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'capture'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        capture.c
+ *
+ *  @brief       Packet capture of the SLCAN traffic into a pcapng file.
+ *
+ *  @remarks     The writer thread is realized by the 'poller' module, so
+ *               only the lock of the producers depends on the platform.
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @addtogroup  capture
+ *  @{
+ */
+#include "capture.h"
+#include "poller.h"
+#include "atomics.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <assert.h>
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define RING_SIZE  16384U               /* slots (power of two) */
+#define RING_MASK  (RING_SIZE - 1U)
+#define BUFFER_SIZE  262144U            /* output buffer (written in one chunk) */
+#define WRITE_INTERVAL  10U             /* writer thread: every 10ms */
+#define WRITE_CHUNK  (BUFFER_SIZE / 4U) /* write when a quarter is filled */
+#define WRITE_LATENCY  50U              /* or at the latest after 50 polls */
+#define NAME_SUFFIX  8U                 /* extension '.pcapng' */
+#define CACHE_LINE  64U
+
+#define PCAPNG_SHB  0x0A0D0D0AU         /* section header block */
+#define PCAPNG_IDB  0x00000001U         /* interface description block */
+#define PCAPNG_EPB  0x00000006U         /* enhanced packet block */
+#define PCAPNG_MAGIC  0x1A2B3C4DU       /* byte-order magic (host byte order) */
+#define PCAPNG_TSRESOL  9U              /* option 'if_tsresol': 10^-9 s */
+#define PCAPNG_INBOUND  0x00000001U     /* option 'epb_flags': inbound */
+#define PCAPNG_OUTBOUND  0x00000002U    /* option 'epb_flags': outbound */
+#define SHB_SIZE  28U                   /* w/o options */
+#define IDB_SIZE  32U                   /* with option 'if_tsresol' */
+#define EPB_SIZE(len)  (28U + (((len) + 3U) & ~3U) + 16U)  /* with option 'epb_flags' */
+
+#define SOCKETCAN_EFF_FLAG  0x80000000U /* extended frame format */
+#define SOCKETCAN_RTR_FLAG  0x40000000U /* remote transmission request */
+#define SOCKETCAN_ERR_FLAG  0x20000000U /* error frame */
+#define SOCKETCAN_MTU  16U              /* struct can_frame */
+
+#if defined(_WIN32) || defined(_WIN64)
+#define INIT_LOCK(obj)  InitializeSRWLock(&(obj)->lock)
+#define FREE_LOCK(obj)  while (0)
+#define LOCK(obj)  AcquireSRWLockExclusive(&(obj)->lock)
+#define UNLOCK(obj)  ReleaseSRWLockExclusive(&(obj)->lock)
+#else
+#define INIT_LOCK(obj)  (void)pthread_mutex_init(&(obj)->lock, NULL)
+#define FREE_LOCK(obj)  (void)pthread_mutex_destroy(&(obj)->lock)
+#define LOCK(obj)  (void)pthread_mutex_lock(&(obj)->lock)
+#define UNLOCK(obj)  (void)pthread_mutex_unlock(&(obj)->lock)
+#endif
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef struct slot_t_ {                /* captured packet: */
+    uint64_t time;                      /* - time-stamp (in [ns] since the epoch) */
+    uint8_t length;                     /* - number of bytes (0..CAPTURE_SNAPLEN) */
+    uint8_t dir;                        /* - direction (CAPTURE_RX or CAPTURE_TX) */
+    uint8_t __res[6];                   /* - (reserved) */
+    uint8_t data[CAPTURE_SNAPLEN];      /* - packet data */
+} slot_t;
+
+typedef struct object_t_ {
+#if defined(_WIN32) || defined(_WIN64)
+    SRWLOCK lock;                       /* - producer lock (one producer at a time) */
+#else
+    pthread_mutex_t lock;               /* - producer lock (one producer at a time) */
+#endif
+    uint64_t dropped;                   /* - number of dropped packets (producers) */
+    uint32_t tail;                      /* - write position (producers) */
+    uint8_t __pad1[CACHE_LINE - 12U];
+    uint32_t head;                      /* - read position (writer thread) */
+    uint8_t __pad2[CACHE_LINE - 4U];
+    slot_t *slots;                      /* - the ring (preallocated) */
+    uint16_t linktype;                  /* - link-layer type */
+    poller_t writer;                    /* - writer thread */
+    FILE *file;                         /* - capture file */
+    char *filename;                     /* - path and name (with extension) */
+    uint8_t *buffer;                    /* - output buffer */
+    size_t used;                        /* - bytes in the output buffer */
+    uint64_t pending;                   /* - packets in the output buffer */
+    uint32_t polls;                     /* - polls since the last write */
+    uint64_t written;                   /* - number of written packets */
+    uint64_t lost;                      /* - number of lost packets (write error) */
+    int error;                          /* - first write error (errno) */
+} object_t;
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static void writer(void *arg);
+static void write_packets(object_t *object, bool final);
+static void write_buffer(object_t *object);
+static int write_header(object_t *object);
+static size_t format_packet(const slot_t *slot, uint8_t *block);
+static void put_uint16(uint8_t *buffer, uint16_t value);
+static void put_uint32(uint8_t *buffer, uint32_t value);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+capture_t capture_create(const char *basename, uint16_t linktype) {
+    object_t *object = (object_t*)NULL;
+    int res;
+
+    /* reset errno variable */
+    errno = 0;
+    /* sanity check */
+    if (!basename || !basename[0]) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if ((linktype != CAPTURE_SERIAL) && (linktype != CAPTURE_SOCKETCAN)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    /* C language constructor */
+    if ((object = (object_t*)calloc(1, sizeof(object_t))) == NULL) {
+        /* errno set */
+        return NULL;
+    }
+    if (((object->filename = (char*)malloc(strlen(basename) + NAME_SUFFIX)) == NULL) ||
+        ((object->slots = (slot_t*)calloc(RING_SIZE, sizeof(slot_t))) == NULL) ||
+        ((object->buffer = (uint8_t*)malloc(BUFFER_SIZE)) == NULL)) {
+        /* errno set */
+        free(object->slots);
+        free(object->filename);
+        free(object);
+        return NULL;
+    }
+    strcpy(object->filename, basename);
+    strcat(object->filename, ".pcapng");
+    object->linktype = linktype;
+    INIT_LOCK(object);
+    /* open the capture file and write the file header */
+    if (((object->file = fopen(object->filename, "wb")) == NULL) ||
+        (write_header(object) < 0)) {
+        res = errno;
+        if (object->file)
+            (void)fclose(object->file);
+        FREE_LOCK(object);
+        free(object->buffer);
+        free(object->slots);
+        free(object->filename);
+        free(object);
+        errno = res;
+        return NULL;
+    }
+    /* start the writer thread */
+    if ((object->writer = poller_create(writer, (void*)object, WRITE_INTERVAL)) == NULL) {
+        res = errno;
+        (void)fclose(object->file);
+        FREE_LOCK(object);
+        free(object->buffer);
+        free(object->slots);
+        free(object->filename);
+        free(object);
+        errno = res;
+        return NULL;
+    }
+    return (capture_t)object;
+}
+
+int capture_destroy(capture_t capture) {
+    object_t *object = (object_t*)capture;
+    int res = 0;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* stop the writer thread and write all pending packets */
+    (void)poller_destroy(object->writer);
+    write_packets(object, true);
+    if (object->file && (fclose(object->file) != 0) && !object->error)
+        object->error = errno;
+    if (object->error) {
+        errno = object->error;
+        res = -1;
+    }
+    /* C language destructor */
+    FREE_LOCK(object);
+    free(object->buffer);
+    free(object->slots);
+    free(object->filename);
+    free(object);
+    return res;
+}
+
+int capture_put(capture_t capture, const uint8_t *buffer, size_t nbytes, uint64_t time, uint8_t dir) {
+    object_t *object = (object_t*)capture;
+    slot_t *slot;
+    uint32_t tail;
+    size_t needed;
+    size_t length;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!buffer || (object->linktype != CAPTURE_SERIAL)) {
+        errno = EINVAL;
+        return -1;
+    }
+    needed = (nbytes + CAPTURE_SNAPLEN - 1U) / CAPTURE_SNAPLEN;
+    /* note: the producers are serialized, the writer thread owns the read position */
+    LOCK(object);
+    tail = object->tail;
+    if (((size_t)(tail - LOAD_ACQUIRE(&object->head)) + needed) > RING_SIZE) {
+        STORE_64(&object->dropped, object->dropped + 1U);
+        UNLOCK(object);
+        errno = ENOSPC;
+        return -1;
+    }
+    while (nbytes > 0U) {
+        length = (nbytes < CAPTURE_SNAPLEN) ? nbytes : CAPTURE_SNAPLEN;
+        slot = &object->slots[tail & RING_MASK];
+        slot->time = time;
+        slot->length = (uint8_t)length;
+        slot->dir = dir & CAPTURE_TX;
+        memcpy(slot->data, buffer, length);
+        buffer += length;
+        nbytes -= length;
+        tail++;
+    }
+    STORE_RELEASE(&object->tail, tail);
+    UNLOCK(object);
+    return 0;
+}
+
+int capture_put_frame(capture_t capture, const tracer_record_t *record) {
+    object_t *object = (object_t*)capture;
+    slot_t *slot;
+    uint32_t tail;
+    uint32_t can_id;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!record || (object->linktype != CAPTURE_SOCKETCAN)) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* note: the producers are serialized, the writer thread owns the read position */
+    LOCK(object);
+    tail = object->tail;
+    if ((uint32_t)(tail - LOAD_ACQUIRE(&object->head)) >= RING_SIZE) {
+        STORE_64(&object->dropped, object->dropped + 1U);
+        UNLOCK(object);
+        errno = ENOSPC;
+        return -1;
+    }
+    /* struct can_frame: identifier with flags in network byte order, DLC and payload */
+    can_id = record->can_id & ((record->can_id & TRACER_XTD_FRAME) ? 0x1FFFFFFFU : 0x7FFU);
+    if (record->can_id & TRACER_XTD_FRAME)
+        can_id |= SOCKETCAN_EFF_FLAG;
+    if (record->can_id & TRACER_RTR_FRAME)
+        can_id |= SOCKETCAN_RTR_FLAG;
+    if (record->can_id & TRACER_ERR_FRAME)
+        can_id |= SOCKETCAN_ERR_FLAG;
+    slot = &object->slots[tail & RING_MASK];
+    slot->time = record->time;
+    slot->length = (uint8_t)SOCKETCAN_MTU;
+    slot->dir = record->dir & CAPTURE_TX;
+    slot->data[0] = (uint8_t)(can_id >> 24);
+    slot->data[1] = (uint8_t)(can_id >> 16);
+    slot->data[2] = (uint8_t)(can_id >> 8);
+    slot->data[3] = (uint8_t)can_id;
+    slot->data[4] = (record->can_dlc < 8U) ? record->can_dlc : 8U;
+    slot->data[5] = slot->data[6] = slot->data[7] = 0U;
+    memcpy(&slot->data[8], record->data, 8U);
+    STORE_RELEASE(&object->tail, tail + 1U);
+    UNLOCK(object);
+    return 0;
+}
+
+int capture_filename(capture_t capture, char *buffer, size_t length) {
+    object_t *object = (object_t*)capture;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!buffer || !length) {
+        errno = EINVAL;
+        return -1;
+    }
+    strncpy(buffer, object->filename, length);
+    buffer[length - 1U] = '\0';
+    return 0;
+}
+
+int capture_status(capture_t capture, uint64_t *written, uint64_t *dropped) {
+    object_t *object = (object_t*)capture;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (written)
+        *written = LOAD_64(&object->written);
+    if (dropped)
+        *dropped = LOAD_64(&object->dropped) + LOAD_64(&object->lost);
+    return 0;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static void writer(void *arg) {
+    object_t *object = (object_t*)arg;
+
+    assert(object);
+    write_packets(object, false);
+}
+
+/*  ---  writer thread  ---
+ *
+ *  The packets are formatted as enhanced packet blocks into the output
+ *  buffer. A slot is released as soon as its packet has been formatted.
+ *  The output buffer is written in one chunk when a quarter of it is
+ *  filled, at the latest after WRITE_LATENCY polls, and when the capture
+ *  is destroyed.
+ */
+static void write_packets(object_t *object, bool final) {
+    uint32_t tail = LOAD_ACQUIRE(&object->tail);
+    const slot_t *slot;
+
+    while (object->head != tail) {
+        slot = &object->slots[object->head & RING_MASK];
+        if ((object->used + EPB_SIZE(CAPTURE_SNAPLEN)) > BUFFER_SIZE)
+            write_buffer(object);
+        object->used += format_packet(slot, &object->buffer[object->used]);
+        object->pending += 1U;
+        STORE_RELEASE(&object->head, object->head + 1U);
+    }
+    if (final || (object->used >= WRITE_CHUNK) || (++object->polls >= WRITE_LATENCY))
+        write_buffer(object);
+}
+
+static void write_buffer(object_t *object) {
+    if (object->used) {
+        if (object->file && (fwrite(object->buffer, 1U, object->used, object->file) == object->used)) {
+            STORE_64(&object->written, object->written + object->pending);
+        } else {
+            if (!object->error)
+                object->error = object->file ? errno : EBADF;
+            STORE_64(&object->lost, object->lost + object->pending);
+        }
+    }
+    object->used = 0U;
+    object->pending = 0U;
+    object->polls = 0U;
+}
+
+/*  ---  pcapng file format  ---
+ *
+ *  The file starts with a section header block (byte-order magic, version
+ *  1.0, unknown section length) and one interface description block (the
+ *  link-layer type, the snapshot length and option 'if_tsresol' for time-
+ *  stamps in nanoseconds). Each packet is an enhanced packet block with a
+ *  64-bit time-stamp and option 'epb_flags' for its direction. All fields
+ *  are in host byte order; blocks are padded to 32 bits.
+ */
+static int write_header(object_t *object) {
+    uint8_t header[SHB_SIZE + IDB_SIZE];
+    uint8_t *block;
+
+    /* note: the output buffer is written in one chunk (no stdio buffering) */
+    (void)setvbuf(object->file, NULL, _IONBF, 0U);
+    memset(header, 0, sizeof(header));
+    /* section header block */
+    block = &header[0];
+    put_uint32(&block[0], PCAPNG_SHB);
+    put_uint32(&block[4], SHB_SIZE);
+    put_uint32(&block[8], PCAPNG_MAGIC);
+    put_uint16(&block[12], 1U);         /* major version */
+    put_uint16(&block[14], 0U);         /* minor version */
+    memset(&block[16], 0xFF, 8U);       /* section length: unknown */
+    put_uint32(&block[24], SHB_SIZE);
+    /* interface description block */
+    block = &header[SHB_SIZE];
+    put_uint32(&block[0], PCAPNG_IDB);
+    put_uint32(&block[4], IDB_SIZE);
+    put_uint16(&block[8], object->linktype);
+    put_uint16(&block[10], 0U);         /* (reserved) */
+    put_uint32(&block[12], (object->linktype == CAPTURE_SOCKETCAN) ? SOCKETCAN_MTU : CAPTURE_SNAPLEN);
+    put_uint16(&block[16], 9U);         /* option 'if_tsresol' (length 1) */
+    put_uint16(&block[18], 1U);
+    block[20] = (uint8_t)PCAPNG_TSRESOL;
+    put_uint32(&block[24], 0U);         /* option 'opt_endofopt' */
+    put_uint32(&block[28], IDB_SIZE);
+    return (fwrite(header, 1U, sizeof(header), object->file) == sizeof(header)) ? 0 : -1;
+}
+
+static size_t format_packet(const slot_t *slot, uint8_t *block) {
+    size_t size = EPB_SIZE(slot->length);
+    size_t padded = ((size_t)slot->length + 3U) & ~(size_t)3U;
+    uint8_t *option = &block[28U + padded];
+
+    put_uint32(&block[0], PCAPNG_EPB);
+    put_uint32(&block[4], (uint32_t)size);
+    put_uint32(&block[8], 0U);          /* interface id */
+    put_uint32(&block[12], (uint32_t)(slot->time >> 32));
+    put_uint32(&block[16], (uint32_t)slot->time);
+    put_uint32(&block[20], (uint32_t)slot->length);  /* captured length */
+    put_uint32(&block[24], (uint32_t)slot->length);  /* original length */
+    memcpy(&block[28], slot->data, slot->length);
+    memset(&block[28U + slot->length], 0, padded - slot->length);
+    put_uint16(&option[0], 2U);         /* option 'epb_flags' (length 4) */
+    put_uint16(&option[2], 4U);
+    put_uint32(&option[4], (slot->dir == CAPTURE_TX) ? PCAPNG_OUTBOUND : PCAPNG_INBOUND);
+    put_uint32(&option[8], 0U);         /* option 'opt_endofopt' */
+    put_uint32(&option[12], (uint32_t)size);
+    return size;
+}
+
+static void put_uint16(uint8_t *buffer, uint16_t value) {
+    /* note: host byte order (the reader checks the byte-order magic) */
+    memcpy(buffer, &value, sizeof(uint16_t));
+}
+
+static void put_uint32(uint8_t *buffer, uint32_t value) {
+    /* note: host byte order (the reader checks the byte-order magic) */
+    memcpy(buffer, &value, sizeof(uint32_t));
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,247 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'capture'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        capture.h
+ *
+ *  @brief       Packet capture of the SLCAN traffic into a pcapng file.
+ *
+ *  @remarks     The producers (e.g. the reception thread and the transmitting
+ *               threads) put the captured packets into a preallocated ring of
+ *               fixed-size slots; larger packets are split into several slots.
+ *               A writer thread drains the ring periodically, formats the
+ *               packets as pcapng blocks into a large buffer and writes it to
+ *               the capture file in one chunk. The producers never wait for
+ *               the writer thread; when the ring is full the packet is dropped
+ *               and counted.
+ *
+ *  @remarks     The capture file has one interface of the given link-layer
+ *               type with a time-stamp resolution of nanoseconds. The direction
+ *               of a packet is stored in its flags (inbound or outbound), so
+ *               the file can be opened with Wireshark.
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @defgroup    capture Packet Capture (pcapng)
+ *  @{
+ */
+#ifndef CAPTURE_H_INCLUDED
+#define CAPTURE_H_INCLUDED
+
+#include "tracer.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+/** @name  Link-layer Type
+ *  @brief Content of the captured packets (pcapng link-layer type)
+ *  @{ */
+#define CAPTURE_SERIAL     147U         /**< raw serial data (LINKTYPE_USER0) */
+#define CAPTURE_SOCKETCAN  227U         /**< SocketCAN frames (LINKTYPE_CAN_SOCKETCAN) */
+/** @} */
+
+/** @name  Capture Direction
+ *  @brief Direction of a captured packet
+ *  @{ */
+#define CAPTURE_RX         0x00U        /**< received data (inbound) */
+#define CAPTURE_TX         0x01U        /**< transmitted data (outbound) */
+/** @} */
+
+#define CAPTURE_SNAPLEN    48U          /**< max. packet size (larger ones are split) */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef void *capture_t;                /**< capture (opaque data type) */
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief       creates a capture, opens the capture file, writes the file
+ *               header and starts the writer thread (constructor).
+ *
+ *  @param[in]   basename  - path and name of the capture file (w/o extension)
+ *  @param[in]   linktype  - link-layer type (CAPTURE_SERIAL or CAPTURE_SOCKETCAN)
+ *
+ *  @returns     pointer to a capture instance if successful, or NULL on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EINVAL   - invalid argument (basename or link-layer type)
+ *  @retval      ENOMEM   - out of memory (insufficient storage space)
+ *  @retval      'errno'  - error code from called system functions:
+ *                          'fopen', 'fwrite', etc.
+ */
+extern capture_t capture_create(const char *basename, uint16_t linktype);
+
+
+/** @brief       stops the writer thread, writes all pending packets and
+ *               closes the capture file (destructor).
+ *
+ *  @remarks     The producers must not call 'capture_put' or 'capture_put_frame'
+ *               during or after the call of this function.
+ *
+ *  @param[in]   capture  - pointer to a capture instance
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid capture instance)
+ *  @retval      'errno'  - error code from called system functions:
+ *                          'fwrite', 'fclose', etc.
+ */
+extern int capture_destroy(capture_t capture);
+
+
+/** @brief       puts a chunk of raw data into the ring (link-layer type
+ *               CAPTURE_SERIAL).
+ *
+ *  @remarks     The function can be called by several producers. It does not
+ *               wait for the writer thread; the ring is locked only briefly.
+ *
+ *  @param[in]   capture  - pointer to a capture instance
+ *  @param[in]   buffer   - the data to be captured
+ *  @param[in]   nbytes   - number of bytes (split into packets of at most
+ *                          CAPTURE_SNAPLEN bytes)
+ *  @param[in]   time     - time-stamp (in [ns] since the epoch)
+ *  @param[in]   dir      - direction (CAPTURE_RX or CAPTURE_TX)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid capture instance)
+ *  @retval      EINVAL   - invalid argument (buffer or link-layer type)
+ *  @retval      ENOSPC   - no space left (data dropped)
+ */
+extern int capture_put(capture_t capture, const uint8_t *buffer, size_t nbytes, uint64_t time, uint8_t dir);
+
+
+/** @brief       puts a CAN message as SocketCAN frame into the ring (link-layer
+ *               type CAPTURE_SOCKETCAN).
+ *
+ *  @remarks     The function can be called by several producers. It does not
+ *               wait for the writer thread; the ring is locked only briefly.
+ *
+ *  @param[in]   capture  - pointer to a capture instance
+ *  @param[in]   record   - the message to be captured (with time-stamp and
+ *                          direction, see tracer_record_t)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid capture instance)
+ *  @retval      EINVAL   - invalid argument (record or link-layer type)
+ *  @retval      ENOSPC   - no space left (message dropped)
+ */
+extern int capture_put_frame(capture_t capture, const tracer_record_t *record);
+
+
+/** @brief       returns the file name of the capture file.
+ *
+ *  @param[in]   capture  - pointer to a capture instance
+ *  @param[out]  buffer   - buffer for the file name (zero-terminated)
+ *  @param[in]   length   - size of the buffer (in [byte])
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid capture instance)
+ *  @retval      EINVAL   - invalid argument (buffer or length)
+ */
+extern int capture_filename(capture_t capture, char *buffer, size_t length);
+
+
+/** @brief       returns the number of written and dropped packets.
+ *
+ *  @param[in]   capture  - pointer to a capture instance
+ *  @param[out]  written  - number of packets written to the capture file (optional)
+ *  @param[out]  dropped  - number of packets dropped (ring full or write error)
+ *                          (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid capture instance)
+ */
+extern int capture_status(capture_t capture, uint64_t *written, uint64_t *dropped);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* CAPTURE_H_INCLUDED */
+
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
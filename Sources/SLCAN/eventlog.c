@@ -0,0 +1,564 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'eventlog'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        eventlog.c
+ *
+ *  @brief       Deferred formatting of debug messages into the log file.
+ *
+ *  @remarks     The writer thread is realized by the 'poller' module, so
+ *               only the atomic operations depend on the platform.
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @addtogroup  eventlog
+ *  @{
+ */
+#include "eventlog.h"
+#include "logger.h"
+#include "poller.h"
+#include "timer.h"
+#include "atomics.h"
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <time.h>
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#endif
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define RING_SIZE  4096U                /* slots (power of two) */
+#define RING_MASK  (RING_SIZE - 1U)
+#define PAYLOAD_SIZE  104U              /* arguments of a record (slot of 128 bytes) */
+#define BUFFER_SIZE  65536U             /* output buffer (written in one chunk) */
+#define LINE_SIZE  512U                 /* max. length of a rendered record */
+#define SPEC_SIZE  64U                  /* max. length of a conversion specification */
+#define WRITE_INTERVAL  10U             /* writer thread: every 10ms */
+#define CACHE_LINE  64U
+
+#define LEN_NONE  0                     /* length modifier: (none) */
+#define LEN_CHAR  1                     /* length modifier: 'hh' */
+#define LEN_SHORT  2                    /* length modifier: 'h' */
+#define LEN_LONG  3                     /* length modifier: 'l' */
+#define LEN_LLONG  4                    /* length modifier: 'll' */
+#define LEN_SIZE  5                     /* length modifier: 'z' */
+#define LEN_INTMAX  6                   /* length modifier: 'j' */
+#define LEN_PTRDIFF  7                  /* length modifier: 't' */
+#define LEN_LDOUBLE  8                  /* length modifier: 'L' */
+
+#define INTEGERS  "diuoxX"              /* conversions of integers */
+#define SUPPORTED  "diuoxXcpeEfFgGaAs"  /* conversions with an argument */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef struct slot_t_ {                /* debug message: */
+    uint32_t seq;                       /* - sequence number (lap of the ring) */
+    uint8_t length;                     /* - number of bytes (0..PAYLOAD_SIZE) */
+    uint8_t __res[3];                   /* - (reserved) */
+    uint64_t time;                      /* - time-stamp (in [ns] since the epoch) */
+    const char *format;                 /* - format string (identifier) */
+    uint8_t payload[PAYLOAD_SIZE];      /* - arguments (64-bit values and strings) */
+} slot_t;
+
+typedef struct spec_t_ {                /* conversion specification: */
+    const char *begin;                  /* - the leading '%' */
+    const char *modifier;               /* - the length modifier (if any) */
+    const char *end;                    /* - behind the conversion specifier */
+    char conversion;                    /* - conversion specifier (or '\0') */
+    int length;                         /* - length modifier (LEN_xyz) */
+    int stars;                          /* - width and/or precision as argument */
+} spec_t;
+
+typedef struct object_t_ {
+    uint32_t tail;                      /* - write position (producers) */
+    uint32_t active;                    /* - writer thread running */
+    uint64_t dropped;                   /* - number of dropped records (producers) */
+    uint8_t __pad1[CACHE_LINE - 16U];
+    uint32_t head;                      /* - read position (writer thread) */
+    uint8_t __pad2[CACHE_LINE - 4U];
+    poller_t writer;                    /* - writer thread */
+    uint64_t written;                   /* - number of written records */
+    uint64_t reported;                  /* - number of reported drops */
+    size_t used;                        /* - bytes in the output buffer */
+    char buffer[BUFFER_SIZE];           /* - output buffer */
+} object_t;
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static void writer(void *arg);
+static void write_records(void);
+static void write_buffer(void);
+static size_t format_record(const slot_t *slot, char *line);
+static size_t format_time(uint64_t time, char *line);
+static const char *parse_spec(const char *format, spec_t *spec);
+static bool put_value(slot_t *slot, uint64_t value);
+static bool get_value(const slot_t *slot, size_t *offset, uint64_t *value);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+/* note: the ring is allocated statically and zero-initialized; a slot is
+ *       free for position 'pos' when its sequence number equals the lap
+ *       (pos & ~RING_MASK), and it holds a record when it equals lap + 1.
+ */
+static slot_t slots[RING_SIZE];
+static object_t eventlog;
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int evlog_start(void) {
+    /* reset errno variable */
+    errno = 0;
+    /* sanity check */
+    if (eventlog.writer) {
+        errno = EALREADY;
+        return -1;
+    }
+    /* start the writer thread */
+    eventlog.used = 0U;
+    eventlog.reported = LOAD_64(&eventlog.dropped);
+    if ((eventlog.writer = poller_create(writer, NULL, WRITE_INTERVAL)) == NULL) {
+        /* errno set */
+        return -1;
+    }
+    STORE_RELEASE(&eventlog.active, 1U);
+    return 0;
+}
+
+int evlog_stop(void) {
+    /* sanity check */
+    errno = 0;
+    if (!eventlog.writer) {
+        errno = EBADF;
+        return -1;
+    }
+    /* stop the writer thread and write all pending records */
+    STORE_RELEASE(&eventlog.active, 0U);
+    (void)poller_destroy(eventlog.writer);
+    eventlog.writer = NULL;
+    write_records();
+    return 0;
+}
+
+int evlog_write(const char *format, ...) {
+    struct timespec now;
+    slot_t *slot;
+    spec_t spec;
+    uint32_t pos, seq;
+    uint64_t value;
+    const char *str;
+    size_t n;
+    va_list args;
+
+    /* note: without a log file this is the only cost of a debug message */
+    if (!LOAD_ACQUIRE(&eventlog.active)) {
+        errno = EBADF;
+        return -1;
+    }
+    if (!format) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* reserve a slot (lock-free, several producers) */
+    pos = LOAD_ACQUIRE(&eventlog.tail);
+    for (;;) {
+        slot = &slots[pos & RING_MASK];
+        seq = LOAD_ACQUIRE(&slot->seq);
+        if (seq == (pos & ~RING_MASK)) {
+            if (COMPARE_EXCHANGE(&eventlog.tail, pos, pos + 1U))
+                break;
+        } else if ((int32_t)(seq - (pos & ~RING_MASK)) < 0) {
+            INCREMENT_64(&eventlog.dropped);
+            errno = ENOSPC;
+            return -1;
+        }
+        pos = LOAD_ACQUIRE(&eventlog.tail);
+    }
+    /* store the time-stamp, the format string and the raw arguments */
+    now = timer_get_time();
+    slot->time = ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+    slot->format = format;
+    slot->length = 0U;
+    va_start(args, format);
+    while ((format = parse_spec(format, &spec)) != NULL) {
+        bool stored = true;
+        for (; spec.stars > 0; spec.stars--)
+            stored = stored && put_value(slot, (uint64_t)(int64_t)va_arg(args, int));
+        switch (spec.conversion) {
+        case 'd': case 'i':
+            switch (spec.length) {
+            case LEN_LONG: value = (uint64_t)(int64_t)va_arg(args, long); break;
+            case LEN_LLONG: value = (uint64_t)(int64_t)va_arg(args, long long); break;
+            case LEN_SIZE: value = (uint64_t)va_arg(args, size_t); break;
+            case LEN_INTMAX: value = (uint64_t)va_arg(args, intmax_t); break;
+            case LEN_PTRDIFF: value = (uint64_t)(int64_t)va_arg(args, ptrdiff_t); break;
+            case LEN_CHAR: value = (uint64_t)(int64_t)(signed char)va_arg(args, int); break;
+            case LEN_SHORT: value = (uint64_t)(int64_t)(short)va_arg(args, int); break;
+            default: value = (uint64_t)(int64_t)va_arg(args, int); break;
+            }
+            stored = stored && put_value(slot, value);
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            switch (spec.length) {
+            case LEN_LONG: value = (uint64_t)va_arg(args, unsigned long); break;
+            case LEN_LLONG: value = (uint64_t)va_arg(args, unsigned long long); break;
+            case LEN_SIZE: value = (uint64_t)va_arg(args, size_t); break;
+            case LEN_INTMAX: value = (uint64_t)va_arg(args, uintmax_t); break;
+            case LEN_PTRDIFF: value = (uint64_t)va_arg(args, ptrdiff_t); break;
+            case LEN_CHAR: value = (uint64_t)(unsigned char)va_arg(args, unsigned int); break;
+            case LEN_SHORT: value = (uint64_t)(unsigned short)va_arg(args, unsigned int); break;
+            default: value = (uint64_t)va_arg(args, unsigned int); break;
+            }
+            stored = stored && put_value(slot, value);
+            break;
+        case 'c':
+            stored = stored && put_value(slot, (uint64_t)va_arg(args, int));
+            break;
+        case 'p':
+            stored = stored && put_value(slot, (uint64_t)(uintptr_t)va_arg(args, void*));
+            break;
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A': {
+            double real = (spec.length == LEN_LDOUBLE) ? (double)va_arg(args, long double) : va_arg(args, double);
+            memcpy(&value, &real, sizeof(value));
+            stored = stored && put_value(slot, value);
+            break;
+        }
+        case 's':
+            /* note: the string is copied (truncated to the remaining space) */
+            if ((str = va_arg(args, const char*)) == NULL)
+                str = "(null)";
+            if ((stored = stored && (slot->length < PAYLOAD_SIZE))) {
+                n = strlen(str);
+                if (n > (PAYLOAD_SIZE - slot->length - 1U))
+                    n = PAYLOAD_SIZE - slot->length - 1U;
+                memcpy(&slot->payload[slot->length], str, n);
+                slot->payload[slot->length + n] = '\0';
+                slot->length += (uint8_t)(n + 1U);
+            }
+            break;
+        case '%':
+            break;
+        default:
+            /* note: unsupported conversion ('n' or invalid), ignore the rest */
+            stored = false;
+            break;
+        }
+        if (!stored)
+            break;
+    }
+    va_end(args);
+    /* hand the slot over to the writer thread */
+    STORE_RELEASE(&slot->seq, (pos & ~RING_MASK) + 1U);
+    return 0;
+}
+
+int evlog_status(uint64_t *written, uint64_t *dropped) {
+    errno = 0;
+    if (written)
+        *written = LOAD_64(&eventlog.written);
+    if (dropped)
+        *dropped = LOAD_64(&eventlog.dropped);
+    return 0;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static void writer(void *arg) {
+    (void)arg;
+    write_records();
+}
+
+/*  ---  writer thread  ---
+ *
+ *  The records are rendered as text lines into the output buffer. A slot
+ *  is released as soon as its record has been rendered. The output buffer
+ *  is written in one chunk into the log file at the end of each poll (or
+ *  when it is filled), followed by a note when records have been dropped.
+ */
+static void write_records(void) {
+    slot_t *slot;
+    uint32_t lap;
+    uint64_t dropped;
+
+    for (;;) {
+        slot = &slots[eventlog.head & RING_MASK];
+        lap = eventlog.head & ~RING_MASK;
+        if (LOAD_ACQUIRE(&slot->seq) != (lap + 1U))
+            break;
+        if ((eventlog.used + LINE_SIZE) > BUFFER_SIZE)
+            write_buffer();
+        eventlog.used += format_record(slot, &eventlog.buffer[eventlog.used]);
+        STORE_64(&eventlog.written, eventlog.written + 1U);
+        STORE_RELEASE(&slot->seq, lap + RING_SIZE);
+        eventlog.head += 1U;
+    }
+    dropped = LOAD_64(&eventlog.dropped);
+    if (dropped != eventlog.reported) {
+        if ((eventlog.used + LINE_SIZE) > BUFFER_SIZE)
+            write_buffer();
+        eventlog.used += (size_t)snprintf(&eventlog.buffer[eventlog.used], LINE_SIZE,
+                                          "+++ %" PRIu64 " debug message(s) dropped\n", dropped - eventlog.reported);
+        eventlog.reported = dropped;
+    }
+    write_buffer();
+}
+
+static void write_buffer(void) {
+    if (eventlog.used)
+        (void)log_write(eventlog.buffer, eventlog.used);
+    eventlog.used = 0U;
+}
+
+/*  ---  rendering of a record  ---
+ *
+ *  The format string is parsed again and each conversion specification is
+ *  passed to 'snprintf' with its stored argument. Integers are always passed
+ *  as 'long long' (the length modifier is replaced by 'll'), a width or a
+ *  precision given as argument ('*') is inserted as number. Arguments that
+ *  did not fit into the record are shown as '?'.
+ */
+static size_t format_record(const slot_t *slot, char *line) {
+    char spec_str[SPEC_SIZE];
+    const char *format = slot->format;
+    const char *next;
+    const char *ptr;
+    size_t offset = 0U;
+    size_t n, size;
+    uint64_t value;
+    double real;
+    spec_t spec;
+    bool missing = false;
+    int res = 0;
+
+    n = format_time(slot->time, line);
+    while (format && *format && (n < (LINE_SIZE - 2U))) {
+        /* literal text up to the next conversion specification */
+        next = parse_spec(format, &spec);
+        size = next ? (size_t)(spec.begin - format) : strlen(format);
+        if (size > (LINE_SIZE - 2U - n))
+            size = LINE_SIZE - 2U - n;
+        memcpy(&line[n], format, size);
+        n += size;
+        if (!next)
+            break;
+        format = next;
+        if (spec.conversion == '%') {
+            line[n++] = '%';
+            continue;
+        }
+        if (!spec.conversion || !strchr(SUPPORTED, spec.conversion))
+            break;
+        /* rebuild the conversion specification (w/o '*' and length modifier) */
+        size = 0U;
+        for (ptr = spec.begin; ptr < spec.modifier && (size < (SPEC_SIZE - 24U)); ptr++) {
+            if (*ptr == '*') {
+                if (!missing && !get_value(slot, &offset, &value))
+                    missing = true;
+                size += (size_t)snprintf(&spec_str[size], SPEC_SIZE - size, "%i", missing ? 0 : (int)(int64_t)value);
+            } else {
+                spec_str[size++] = *ptr;
+            }
+        }
+        if (strchr(INTEGERS, spec.conversion)) {
+            spec_str[size++] = 'l';
+            spec_str[size++] = 'l';
+        }
+        spec_str[size++] = spec.conversion;
+        spec_str[size] = '\0';
+        /* render the argument (or '?' when it is not in the record) */
+        if (!missing && (spec.conversion == 's')) {
+            if (offset < slot->length) {
+                res = snprintf(&line[n], LINE_SIZE - 1U - n, spec_str, (const char*)&slot->payload[offset]);
+                offset += strlen((const char*)&slot->payload[offset]) + 1U;
+            } else {
+                missing = true;
+            }
+        } else if (!missing && get_value(slot, &offset, &value)) {
+            switch (spec.conversion) {
+            case 'd': case 'i':
+                res = snprintf(&line[n], LINE_SIZE - 1U - n, spec_str, (long long)(int64_t)value);
+                break;
+            case 'u': case 'o': case 'x': case 'X':
+                res = snprintf(&line[n], LINE_SIZE - 1U - n, spec_str, (unsigned long long)value);
+                break;
+            case 'c':
+                res = snprintf(&line[n], LINE_SIZE - 1U - n, spec_str, (int)value);
+                break;
+            case 'p':
+                res = snprintf(&line[n], LINE_SIZE - 1U - n, spec_str, (void*)(uintptr_t)value);
+                break;
+            default:
+                memcpy(&real, &value, sizeof(real));
+                res = snprintf(&line[n], LINE_SIZE - 1U - n, spec_str, real);
+                break;
+            }
+        } else {
+            missing = true;
+        }
+        if (missing)
+            res = snprintf(&line[n], LINE_SIZE - 1U - n, "?");
+        if (res > 0)
+            n += ((size_t)res < (LINE_SIZE - 2U - n)) ? (size_t)res : (LINE_SIZE - 2U - n);
+    }
+    /* one line per record */
+    if (line[n - 1U] != '\n')
+        line[n++] = '\n';
+    line[n] = '\0';
+    return n;
+}
+
+static size_t format_time(uint64_t time, char *line) {
+    time_t sec = (time_t)(time / 1000000000U);
+    unsigned int usec = (unsigned int)((time % 1000000000U) / 1000U);
+    struct tm tm;
+
+    /* note: same prefix as 'log_printf', followed by the time of day */
+#if !defined(_WIN32) && !defined(_WIN64)
+    if (localtime_r(&sec, &tm) == NULL)
+#else
+    if (localtime_s(&tm, &sec) != 0)
+#endif
+        memset(&tm, 0, sizeof(tm));
+    return (size_t)snprintf(line, LINE_SIZE, "+++ (%02i:%02i:%02i.%06u) ", tm.tm_hour, tm.tm_min, tm.tm_sec, usec);
+}
+
+/*  ---  conversion specification  ---
+ *
+ *  %[flags][width][.precision][length]conversion, with width and precision
+ *  as number or '*'. Returns the position behind the specification, or NULL
+ *  when the format string does not contain any further specification.
+ */
+static const char *parse_spec(const char *format, spec_t *spec) {
+    const char *ptr;
+
+    if ((ptr = strchr(format, '%')) == NULL)
+        return NULL;
+    memset(spec, 0, sizeof(spec_t));
+    spec->begin = ptr++;
+    while (*ptr && strchr("-+ #0", *ptr))
+        ptr++;
+    if (*ptr == '*') {
+        spec->stars++;
+        ptr++;
+    }
+    while ((*ptr >= '0') && (*ptr <= '9'))
+        ptr++;
+    if (*ptr == '.') {
+        ptr++;
+        if (*ptr == '*') {
+            spec->stars++;
+            ptr++;
+        }
+        while ((*ptr >= '0') && (*ptr <= '9'))
+            ptr++;
+    }
+    spec->modifier = ptr;
+    switch (*ptr) {
+    case 'h':
+        spec->length = (ptr[1] == 'h') ? LEN_CHAR : LEN_SHORT;
+        ptr += (ptr[1] == 'h') ? 2 : 1;
+        break;
+    case 'l':
+        spec->length = (ptr[1] == 'l') ? LEN_LLONG : LEN_LONG;
+        ptr += (ptr[1] == 'l') ? 2 : 1;
+        break;
+    case 'z': ptr++; spec->length = LEN_SIZE; break;
+    case 'j': ptr++; spec->length = LEN_INTMAX; break;
+    case 't': ptr++; spec->length = LEN_PTRDIFF; break;
+    case 'L': ptr++; spec->length = LEN_LDOUBLE; break;
+    default: break;
+    }
+    spec->conversion = *ptr;
+    spec->end = *ptr ? ptr + 1 : ptr;
+    return spec->end;
+}
+
+static bool put_value(slot_t *slot, uint64_t value) {
+    if ((slot->length + sizeof(uint64_t)) > PAYLOAD_SIZE)
+        return false;
+    memcpy(&slot->payload[slot->length], &value, sizeof(uint64_t));
+    slot->length += (uint8_t)sizeof(uint64_t);
+    return true;
+}
+
+static bool get_value(const slot_t *slot, size_t *offset, uint64_t *value) {
+    if ((*offset + sizeof(uint64_t)) > slot->length)
+        return false;
+    memcpy(value, &slot->payload[*offset], sizeof(uint64_t));
+    *offset += sizeof(uint64_t);
+    return true;
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,177 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'eventlog'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        eventlog.h
+ *
+ *  @brief       Deferred formatting of debug messages into the log file.
+ *
+ *  @remarks     The producers (e.g. the reception thread and the calling
+ *               threads) store a record with the format string (its address
+ *               serves as identifier), the raw arguments and a time-stamp
+ *               into a preallocated ring of fixed-size slots. The producers
+ *               reserve a slot with an atomic operation; they never wait for
+ *               each other or for the writer thread. When the ring is full
+ *               the record is dropped and counted.
+ *
+ *  @remarks     A writer thread drains the ring periodically, renders the
+ *               records as text lines and writes them in one chunk into the
+ *               log file (see module 'logger'). The event log is started
+ *               and stopped together with the log file.
+ *
+ *  @remarks     Supported are the conversions of 'printf' for integers,
+ *               characters, pointers, floating-point numbers and strings.
+ *               Strings are copied into the record (long ones truncated);
+ *               all other arguments are stored as 64-bit values.
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @defgroup    eventlog Deferred Logging of Debug Messages
+ *  @{
+ */
+#ifndef EVENTLOG_H_INCLUDED
+#define EVENTLOG_H_INCLUDED
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief       starts the writer thread of the event log.
+ *
+ *  @remarks     The ring is allocated statically, so records can be put
+ *               into it from any thread without synchronization with the
+ *               start and the stop of the event log.
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EALREADY - event log already started
+ *  @retval      'errno'  - error code from called system functions
+ */
+extern int evlog_start(void);
+
+
+/** @brief       stops the writer thread and writes all pending records into
+ *               the log file.
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EBADF    - event log not started
+ */
+extern int evlog_stop(void);
+
+
+/** @brief       puts a debug message into the ring (formatted later by the
+ *               writer thread).
+ *
+ *  @remarks     The function can be called by several producers. It neither
+ *               formats the message nor waits for a lock.
+ *
+ *  @remarks     The format string must remain valid until the record has been
+ *               written, e.g. a string literal.
+ *
+ *  @param[in]   format  - format string (see printf)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EBADF    - event log not started
+ *  @retval      ENOSPC   - no space left (message dropped)
+ */
+extern int evlog_write(const char *format, ...);
+
+
+/** @brief       returns the number of written and dropped records.
+ *
+ *  @param[out]  written  - number of records written to the log file (optional)
+ *  @param[out]  dropped  - number of records dropped (ring full) (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ */
+extern int evlog_status(uint64_t *written, uint64_t *dropped);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* EVENTLOG_H_INCLUDED */
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
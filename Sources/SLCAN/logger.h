@@ -85,7 +85,7 @@
 extern "C" {
 #endif
 
-/** @brief       opens a file for logging.
+/** @brief       opens a file for logging and starts the event log.
  * 
  *  @param[in]   pathname - a pathname naming a file, or NULL
  *                          to write to stadard output stream
@@ -95,7 +95,7 @@ extern "C" {
 extern int log_init(const char *pathname/* = NULL, flags = 0*/);
 
 
-/** @brief       closes a open log file.
+/** @brief       stops the event log and closes a open log file.
  * 
  *  @returns     0 if successful, or a negative value on error
  */
@@ -142,6 +142,19 @@ extern int log_async(const uint8_t *buffer, size_t nbytes);
 extern int log_printf(const char *format, ...);
 
 
+/** @brief       writes a string of already formatted lines into the log file.
+ *
+ *  @remarks     This function is used by the writer thread of the event log
+ *               (see module 'eventlog'), which renders the debug messages.
+ *
+ *  @param[in]   buffer - pointer to a buffer containing the text lines
+ *  @param[in]   length - number of characters to be written
+ *
+ *  @returns     number of characters written, or a negative value on error
+ */
+extern int log_write(const char *buffer, size_t length);
+
+
 #ifdef __cplusplus
 }
 #endif
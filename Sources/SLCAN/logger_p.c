@@ -59,6 +59,7 @@
  *  @{
  */
 #include "logger.h"
+#include "eventlog.h"
 
 #include <inttypes.h>
 #include <string.h>
@@ -158,6 +159,9 @@ int log_init(const char *pathname/*, flags*/)
     char *str = ctime(&now);
     str[strlen(str)-1] = '\0';
     fprintf(logger, "+++ uv-software Logger (%s) +++\n", str);
+
+    /* start the event log (deferred debug messages) */
+    (void)evlog_start();
     return 0;
 }
 
@@ -169,6 +173,9 @@ int log_exit(void)
         errno = EBADF;
         return -1;
     }
+    /* stop the event log (all pending debug messages are written) */
+    (void)evlog_stop();
+
     /* kill the logging thread and release all resources */
     if (pthread_cancel(thread) == 0) {
 #if (1)
@@ -264,6 +271,30 @@ int log_printf(const char *format, ...)
     return res;
 }
 
+int log_write(const char *buffer, size_t length)
+{
+    size_t res;
+
+    /* sanity check */
+    errno = 0;
+    if (!logger) {
+        errno = EBADF;
+        return -1;
+    }
+    /* enter critical section */
+    assert(pthread_mutex_lock(&mutex) == 0);
+
+    /* write the text lines into the log file */
+    res = fwrite(buffer, 1, length, logger);
+    fflush(logger);
+
+    /* leave critical section */
+    assert(pthread_mutex_unlock(&mutex) == 0);
+
+    /* return the number of characters written */
+    return (int)res;
+}
+
 static void *logging(void *arg)
 {
     uint8_t buffer[LOG_BUF_SIZE];
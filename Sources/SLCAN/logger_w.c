@@ -59,6 +59,7 @@
  *  @{
  */
 #include "logger.h"
+#include "eventlog.h"
 
 #include <inttypes.h>
 #include <string.h>
@@ -164,6 +165,9 @@ int log_init(const char *pathname/*, flags*/)
     ctime_s(str, 26, &now);
     str[strlen(str)-1] = '\0';
     fprintf(logger, "+++ uv-software Logger (%s) +++\n", str);
+
+    /* start the event log (deferred debug messages) */
+    (void)evlog_start();
     return 0;
 }
 
@@ -175,6 +179,9 @@ int log_exit(void)
         errno = EBADF;
         return -1;
     }
+    /* stop the event log (all pending debug messages are written) */
+    (void)evlog_stop();
+
     /* kill the logging thread and release all resources */
     running = 0;
     (void)CancelIoEx(hPipo, NULL);  // to cancel ReadPipe
@@ -277,6 +284,33 @@ int log_printf(const char *format, ...)
     return res;
 }
 
+int log_write(const char *buffer, size_t length)
+{
+    size_t res;
+
+    /* sanity check */
+    errno = 0;
+    if (!logger) {
+        errno = EBADF;
+        return -1;
+    }
+    /* enter critical section */
+    if (WaitForSingleObject(hMutex, INFINITE) != WAIT_OBJECT_0) {
+        errno = ENODEV;
+        return -1;
+    }
+
+    /* write the text lines into the log file */
+    res = fwrite(buffer, 1, length, logger);
+    fflush(logger);
+
+    /* leave critical section */
+    (void)ReleaseMutex(hMutex);
+
+    /* return the number of characters written */
+    return (int)res;
+}
+
 static DWORD WINAPI logging(LPVOID lpParam)
 {
     uint8_t buffer[LOG_BUF_SIZE];
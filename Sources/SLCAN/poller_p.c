@@ -0,0 +1,242 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'poller'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        poller.c
+ *
+ *  @brief       Periodic polling thread.
+ *
+ *  @remarks     POSIX compatible variant (e.g. Linux, macOS)
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @addtogroup  poller
+ *  @{
+ */
+#include "poller.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <assert.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define ENTER_CRITICAL_SECTION(pol)  (void)pthread_mutex_lock(&pol->mutex)
+#define LEAVE_CRITICAL_SECTION(pol)  (void)pthread_mutex_unlock(&pol->mutex)
+
+/* note: macOS does not support another clock for condition variables */
+#if !defined(__APPLE__)
+#define POLLER_CLOCK  CLOCK_MONOTONIC
+#else
+#define POLLER_CLOCK  CLOCK_REALTIME
+#endif
+#define GET_TIME(ts)  do{ clock_gettime(POLLER_CLOCK, &ts); } while(0)
+#define ADD_TIME(ts,to)  do{ ts.tv_sec += (time_t)(to / 1000U); \
+                             ts.tv_nsec += (long)(to % 1000U) * (long)1000000; \
+                             if (ts.tv_nsec >= (long)1000000000) { \
+                                 ts.tv_nsec %= (long)1000000000; \
+                                 ts.tv_sec += (time_t)1; \
+                             } } while(0)
+#define BEFORE(t1,t2)  (((t1).tv_sec < (t2).tv_sec) || \
+                        (((t1).tv_sec == (t2).tv_sec) && ((t1).tv_nsec < (t2).tv_nsec)))
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef struct object_t_ {
+    poller_func_t function;
+    void *arg;
+    uint32_t interval;
+    bool running;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} object_t;
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static void *polling(void *arg);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+poller_t poller_create(poller_func_t function, void *arg, uint32_t interval) {
+    object_t *object = (object_t*)NULL;
+    pthread_condattr_t attr;
+    int res;
+
+    /* reset errno variable */
+    errno = 0;
+    /* sanity check */
+    if (!function || !interval) {
+        errno = EINVAL;
+        return NULL;
+    }
+    /* C language constructor */
+    if ((object = (object_t*)malloc(sizeof(object_t))) != NULL) {
+        (void)memset(object, 0x00, sizeof(object_t));
+        object->function = function;
+        object->arg = arg;
+        object->interval = interval;
+        object->running = true;
+        /* create a mutex and a waitable condition (on the polling clock) */
+        if ((res = pthread_condattr_init(&attr)) != 0) {
+            free(object);
+            errno = res;
+            return NULL;
+        }
+#if !defined(__APPLE__)
+        (void)pthread_condattr_setclock(&attr, POLLER_CLOCK);
+#endif
+        if ((res = pthread_mutex_init(&object->mutex, NULL)) != 0) {
+            (void)pthread_condattr_destroy(&attr);
+            free(object);
+            errno = res;
+            return NULL;
+        }
+        if ((res = pthread_cond_init(&object->cond, &attr)) != 0) {
+            (void)pthread_condattr_destroy(&attr);
+            (void)pthread_mutex_destroy(&object->mutex);
+            free(object);
+            errno = res;
+            return NULL;
+        }
+        (void)pthread_condattr_destroy(&attr);
+        /* start the polling thread */
+        if ((res = pthread_create(&object->thread, NULL, polling, (void*)object)) != 0) {
+            (void)pthread_cond_destroy(&object->cond);
+            (void)pthread_mutex_destroy(&object->mutex);
+            free(object);
+            errno = res;
+            return NULL;
+        }
+    }
+    return (poller_t)object;
+}
+
+int poller_destroy(poller_t poller) {
+    object_t *object = (object_t*)poller;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* the polling function cannot wait for itself */
+    if (pthread_equal(pthread_self(), object->thread)) {
+        errno = EDEADLK;
+        return -1;
+    }
+    /* stop the polling thread and wait for its termination */
+    ENTER_CRITICAL_SECTION(object);
+    object->running = false;
+    (void)pthread_cond_signal(&object->cond);
+    LEAVE_CRITICAL_SECTION(object);
+    (void)pthread_join(object->thread, NULL);
+    /* destroy mutex and condition */
+    (void)pthread_mutex_destroy(&object->mutex);
+    (void)pthread_cond_destroy(&object->cond);
+    /* C language destructor */
+    free(object);
+    return 0;
+}
+
+static void *polling(void *arg) {
+    object_t *object = (object_t*)arg;
+    struct timespec next, now;
+
+    assert(object);
+
+    GET_TIME(next);
+    ENTER_CRITICAL_SECTION(object);
+    while (object->running) {
+        LEAVE_CRITICAL_SECTION(object);
+        object->function(object->arg);
+        ENTER_CRITICAL_SECTION(object);
+        /* next period (fixed rate, missed periods are skipped) */
+        ADD_TIME(next, object->interval);
+        GET_TIME(now);
+        if (BEFORE(next, now))
+            next = now;
+        /* wait until the period has expired or the poller is stopped */
+        while (object->running) {
+            if (pthread_cond_timedwait(&object->cond, &object->mutex, &next) == ETIMEDOUT)
+                break;
+        }
+    }
+    LEAVE_CRITICAL_SECTION(object);
+    return NULL;
+}
+
+/** @}
+ */
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
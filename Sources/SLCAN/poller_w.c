@@ -0,0 +1,198 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'poller'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        poller.c
+ *
+ *  @brief       Periodic polling thread.
+ *
+ *  @remarks     Windows compatible variant (_WIN32 and _WIN64)
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @addtogroup  poller
+ *  @{
+ */
+#include "poller.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <Windows.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef struct object_t_ {
+    poller_func_t function;
+    void *arg;
+    uint32_t interval;
+    DWORD dwThreadId;
+    HANDLE hThread;
+    HANDLE hEvent;
+} object_t;
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static DWORD WINAPI polling(LPVOID lpParam);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+poller_t poller_create(poller_func_t function, void *arg, uint32_t interval) {
+    object_t *object = (object_t*)NULL;
+
+    /* reset errno variable */
+    errno = 0;
+    /* sanity check */
+    if (!function || !interval) {
+        errno = EINVAL;
+        return NULL;
+    }
+    /* C language constructor */
+    if ((object = (object_t*)malloc(sizeof(object_t))) != NULL) {
+        (void)memset(object, 0x00, sizeof(object_t));
+        object->function = function;
+        object->arg = arg;
+        object->interval = interval;
+        /* create an event to stop the polling thread (manual reset) */
+        if ((object->hEvent = CreateEvent(
+            NULL,             // default security attributes
+            TRUE,             // manual-reset event
+            FALSE,            // initial state is nonsignaled
+            NULL)) == NULL) {
+            errno = ENODEV;
+            free(object);
+            return NULL;
+        }
+        /* start the polling thread */
+        if ((object->hThread = CreateThread(
+            NULL,             // default security attributes
+            0,                // use default stack size
+            polling,          // thread function name
+            (LPVOID)object,   // argument to thread function
+            0,                // use default creation flags
+            &object->dwThreadId)) == NULL) {
+            errno = ENODEV;
+            (void)CloseHandle(object->hEvent);
+            free(object);
+            return NULL;
+        }
+    }
+    return (poller_t)object;
+}
+
+int poller_destroy(poller_t poller) {
+    object_t *object = (object_t*)poller;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* the polling function cannot wait for itself */
+    if (GetCurrentThreadId() == object->dwThreadId) {
+        errno = EDEADLK;
+        return -1;
+    }
+    /* stop the polling thread and wait for its termination */
+    (void)SetEvent(object->hEvent);
+    (void)WaitForSingleObject(object->hThread, INFINITE);
+    (void)CloseHandle(object->hThread);
+    (void)CloseHandle(object->hEvent);
+    /* C language destructor */
+    free(object);
+    return 0;
+}
+
+static DWORD WINAPI polling(LPVOID lpParam) {
+    object_t *object = (object_t*)lpParam;
+    ULONGLONG next, now;
+
+    assert(object);
+
+    next = GetTickCount64();
+    do {
+        object->function(object->arg);
+        /* next period (fixed rate, missed periods are skipped) */
+        next += (ULONGLONG)object->interval;
+        now = GetTickCount64();
+        if (next < now)
+            next = now;
+        /* wait until the period has expired or the poller is stopped */
+    } while (WaitForSingleObject(object->hEvent, (DWORD)(next - now)) == WAIT_TIMEOUT);
+    return 0;
+}
+
+/** @}
+ */
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
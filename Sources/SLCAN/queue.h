@@ -54,7 +54,14 @@
  *               A consumer thread waits until at least one element is available
  *               in the queue and dequeues it, or returns when a time-out occurs.
  *
- *  @note        When the queue is full no further data element will be enqueued.
+ *  @note        When the queue is full the configured overflow policy applies:
+ *               the new element is dropped (default), the oldest element is
+ *               dropped, or the producer is blocked for a bounded time.
+ *
+ *  @note        The memory for the data elements is allocated on demand in
+ *               chunks of 1024 elements, when an element is enqueued into
+ *               a chunk for the first time. Allocated chunks are kept until
+ *               the queue is resized or destroyed.
  *
  *  @author      $Author: quaoar $
  *
@@ -78,6 +85,16 @@
 /*  -----------  defines  ------------------------------------------------
  */
 
+/** @name  Overflow Policy
+ *  @brief What happens when an element is enqueued into a full queue
+ *  @{ */
+#define QUEUE_DROP_NEWEST    0x00U      /**< drop the new element (default) */
+#define QUEUE_DROP_OLDEST    0x01U      /**< drop the oldest element in the queue */
+#define QUEUE_BOUNDED_BLOCK  0x02U      /**< block the producer for a bounded time */
+/** @} */
+
+#define QUEUE_INFINITE_US  UINT64_MAX   /**< blocking read (time-out in [us]) */
+
 
 /*  -----------  types  --------------------------------------------------
  */
@@ -128,7 +145,8 @@ extern int queue_destroy(queue_t queue);
 
 
 /** @brief       removes all enqueued elements from the queue and reset the
- *               overflow indicator and the overflow counter.
+ *               overflow indicator, the overflow and drop counters and the
+ *               high-water mark.
  *
  *  @param[in]   queue  - pointer to a queue instance
  *
@@ -158,6 +176,12 @@ extern int queue_clear(queue_t queue);
  *
  *  @retval      -20  - when the queue is full (CAN API compatible)
  *
+ *  @remarks     With policy QUEUE_DROP_OLDEST the element is always enqueued,
+ *               but the overflow indicator is set when the oldest element had
+ *               to be dropped. With policy QUEUE_BOUNDED_BLOCK the function may
+ *               block the caller for the configured time.
+ *               @see queue_policy
+ *
  *  @note        System variable 'errno' will be set in case of an error.
  *
  *  @retval      EFAULT  - bad address (invalid queue instance)
@@ -191,6 +215,36 @@ extern int queue_enqueue(queue_t queue, const void *element, size_t nbytes);
 extern int queue_dequeue(queue_t queue, void *element, size_t maxbytes, uint16_t timeout);
 
 
+/** @brief       dequeues one element from the queue, if any (with a time-out
+ *               in microseconds).
+ *
+ *  @param[in]   queue    - pointer to a queue instance
+ *  @param[out]  element  - pointer to an array into which the element is copied
+ *  @param[in]   maxbytes - maximum number of bytes to be copied from the queue
+ *  @param[in]   timeout  - time to wait for elements available in the queue:
+ *                               0 means the function returns immediately,
+ *                               QUEUE_INFINITE_US means blocking read, and any
+ *                               other value means the time to wait in [us]
+ *
+ *  @returns     the number of bytes copied from the queue if successful, or
+ *               a negative value on error.
+ *
+ *  @retval      -30  - when the queue is empty (CAN API compatible)
+ *
+ *  @note        The time-out is measured on a monotonic clock (if available),
+ *               it is not affected by adjustments of the system time. On
+ *               Windows it is rounded up to full milliseconds.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT    - bad address (invalid queue instance)
+ *  @retval      EINVAL    - invalid argument (element or maxbytes)
+ *  @retval      ENOMSG    - no data available (queue empty)
+ *  @retval      ETIMEDOUT - time-out occurred (blocking read)
+ */
+extern int queue_dequeue_us(queue_t queue, void *element, size_t maxbytes, uint64_t timeout);
+
+
 /** @brief       returns true when an overflow has occurred.
  *
  *  @remarks     The overflow indicator can be reset by a call of 'queue_clear'.
@@ -208,6 +262,144 @@ extern int queue_dequeue(queue_t queue, void *element, size_t maxbytes, uint16_t
 extern bool queue_overflow(queue_t queue, uint64_t *counter);
 
 
+/** @brief       sets the overflow policy of the queue.
+ *
+ *  @remarks     With policy QUEUE_BOUNDED_BLOCK the function 'queue_enqueue'
+ *               waits at most 'timeout' milliseconds for a free element, and
+ *               drops the new element when the time has expired.
+ *
+ *  @param[in]   queue    - pointer to a queue instance
+ *  @param[in]   policy   - overflow policy (QUEUE_DROP_NEWEST, QUEUE_DROP_OLDEST
+ *                          or QUEUE_BOUNDED_BLOCK)
+ *  @param[in]   timeout  - maximum blocking time in milliseconds (1..65534),
+ *                          only used with policy QUEUE_BOUNDED_BLOCK
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid queue instance)
+ *  @retval      EINVAL   - invalid argument (policy or timeout)
+ */
+extern int queue_policy(queue_t queue, uint8_t policy, uint16_t timeout);
+
+
+/** @brief       retrieves the number of dropped elements by overflow policy.
+ *
+ *  @remarks     The sum of the three counters is equal to the overflow counter.
+ *               @see queue_overflow
+ *
+ *  @param[in]   queue    - pointer to a queue instance
+ *  @param[out]  newest   - number of new elements dropped (optional)
+ *  @param[out]  oldest   - number of oldest elements dropped (optional)
+ *  @param[out]  expired  - number of new elements dropped after the blocking
+ *                          time has expired (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid queue instance)
+ */
+extern int queue_drops(queue_t queue, uint64_t *newest, uint64_t *oldest, uint64_t *expired);
+
+
+/** @brief       attaches a spill file to the queue (or detaches it).
+ *
+ *  @remarks     When the queue is full, or has reached the spill threshold
+ *               (see 'queue_threshold'), further elements are written into a
+ *               memory-mapped file instead of being dropped. Once spilling has
+ *               started, all elements are written into the spill file until it
+ *               is empty again, so the elements are dequeued in order.
+ *               The overflow policy applies when the spill file is full, too.
+ *
+ *  @remarks     The file is created with a unique name in the given folder and
+ *               removed immediately (POSIX) or when it is closed (Windows).
+ *               Elements in a previous spill file are taken over, first into
+ *               memory and then into the new spill file; elements that do not
+ *               fit are counted as dropped (newest, see 'queue_drops').
+ *
+ *  @param[in]   queue    - pointer to a queue instance
+ *  @param[in]   folder   - folder for the spill file (NULL for '/var/tmp' on
+ *                          POSIX systems or the temp. folder on Windows)
+ *  @param[in]   numElem  - maximum number of elements in the spill file, or
+ *                          0 to detach the spill file
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid queue instance)
+ *  @retval      EINVAL   - invalid argument (spill file too large)
+ *  @retval      'errno'  - error code from called system functions:
+ *                          'mkstemp', 'ftruncate', 'mmap'
+ */
+extern int queue_spill(queue_t queue, const char *folder, size_t numElem);
+
+
+/** @brief       sets the number of elements in memory at which spilling starts.
+ *
+ *  @remarks     The threshold is only effective with an attached spill file.
+ *               Memory above the threshold is not used then, so that the
+ *               elements are dequeued in order.
+ *               The pages of the spill file are touched ahead of time by the
+ *               producer (outside of the lock) when the threshold comes near.
+ *
+ *  @param[in]   queue    - pointer to a queue instance
+ *  @param[in]   numElem  - number of elements in memory at which spilling
+ *                          starts, or 0 to spill when the queue is full
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid queue instance)
+ */
+extern int queue_threshold(queue_t queue, size_t numElem);
+
+
+/** @brief       changes the maximum number of elements in the queue.
+ *
+ *  @remarks     All enqueued elements are removed from the queue, and the
+ *               overflow indicator, the overflow counter and the high-water
+ *               mark are reset (like 'queue_clear').
+ *               @see queue_clear
+ *
+ *  @param[in]   queue    - pointer to a queue instance
+ *  @param[in]   numElem  - new maximum number of elements in the queue
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid queue instance)
+ *  @retval      EINVAL   - invalid argument (numElem)
+ *  @retval      ENOMEM   - out of memory (insufficient storage space)
+ */
+extern int queue_resize(queue_t queue, size_t numElem);
+
+
+/** @brief       retrieves the capacity, the fill level and the high-water mark
+ *               of the queue (including the spill file, if any).
+ *
+ *  @remarks     The high-water mark is the maximum number of elements the queue
+ *               has hold since its creation or the last call of 'queue_clear'.
+ *               @see queue_clear
+ *
+ *  @param[in]   queue  - pointer to a queue instance
+ *  @param[out]  size   - maximum number of elements in the queue (optional)
+ *  @param[out]  used   - number of elements currently in the queue (optional)
+ *  @param[out]  high   - maximum number of elements the queue has hold (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid queue instance)
+ */
+extern int queue_status(queue_t queue, size_t *size, size_t *used, size_t *high);
+
+
 /** @brief       signals waiting objects, if any.
  *
  *  @param[in]   queue  - pointer to a queue instance
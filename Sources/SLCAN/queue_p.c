@@ -60,6 +60,7 @@
  */
 #include "queue.h"
 
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <limits.h>
@@ -68,6 +69,9 @@
 #include <unistd.h>
 #include <pthread.h>
 #include <time.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sched.h>
 
 
 /*  -----------  options  ------------------------------------------------
@@ -79,13 +83,38 @@
 
 #define MIN(x,y)  ((x) < (y) ? (x) : (y))
 
-#define GET_TIME(ts)  do{ clock_gettime(CLOCK_REALTIME, &ts); } while(0)
-#define ADD_TIME(ts,to)  do{ ts.tv_sec += (time_t)(to / 1000U); \
-                             ts.tv_nsec += (long)(to % 1000U) * (long)1000000; \
+/* note: '/tmp' is a RAM-based file system (tmpfs) on many systems */
+#define SPILL_FOLDER  "/var/tmp"  /* default folder for spill files */
+#define SPILL_PREFIX  "queue-XXXXXX"
+
+#define CHUNK_ELEMS  1024U  /* number of elements per chunk (allocated on demand) */
+#define NUM_CHUNKS(n)  (((n) + CHUNK_ELEMS - 1U) / CHUNK_ELEMS)
+#define ELEMENT(que,idx)  (&(que)->chunks[(idx) / CHUNK_ELEMS][((idx) % CHUNK_ELEMS) * (que)->elemSize])
+#define SPILLED(que,idx)  (&(que)->spill.map[(idx) * (que)->elemSize])
+#define SPILL_LEVEL(que)  ((((que)->spill.size != 0U) && ((que)->spill.threshold != 0U) && \
+                            ((que)->spill.threshold < (que)->size)) ? (que)->spill.threshold : (que)->size)
+#define IS_FULL(que)  (((que)->used >= SPILL_LEVEL(que)) && ((que)->spill.used >= (que)->spill.size))
+
+#define SPILL_AHEAD  65536U  /* bytes of the spill file touched ahead of the tail */
+#define SPILL_PAGE  4096U  /* step for touching the pages (not above the page size) */
+#define TOUCH_PAGE(ptr)  (void)__atomic_fetch_add((uint32_t*)(ptr), 0U, __ATOMIC_RELAXED)
+#define ENTER_TOUCHING(que)  (void)__atomic_add_fetch(&(que)->spill.touching, 1U, __ATOMIC_ACQ_REL)
+#define LEAVE_TOUCHING(que)  (void)__atomic_sub_fetch(&(que)->spill.touching, 1U, __ATOMIC_RELEASE)
+#define WAIT_TOUCHING(que)  do{ while (__atomic_load_n(&(que)->spill.touching, __ATOMIC_ACQUIRE)) \
+                                    (void)sched_yield(); } while(0)
+
+/* note: macOS does not support another clock for condition variables,
+ *       there the remaining time is waited for (see 'timed_wait')
+ */
+#define QUEUE_CLOCK  CLOCK_MONOTONIC
+#define GET_TIME(ts)  do{ clock_gettime(QUEUE_CLOCK, &ts); } while(0)
+#define ADD_TIME(ts,to)  do{ ts.tv_sec += (time_t)(to / 1000000U); \
+                             ts.tv_nsec += (long)(to % 1000000U) * (long)1000; \
                              if (ts.tv_nsec >= (long)1000000000) { \
                                  ts.tv_nsec %= (long)1000000000; \
                                  ts.tv_sec += (time_t)1; \
                              } } while(0)
+#define TO_USEC(ms)  (((ms) != 65535U) ? ((uint64_t)(ms) * 1000U) : UINT64_MAX)
 
 #define ENTER_CRITICAL_SECTION(que)  assert(0 == pthread_mutex_lock(&que->wait.mutex))
 #define LEAVE_CRITICAL_SECTION(que)  assert(0 == pthread_mutex_unlock(&que->wait.mutex))
@@ -94,8 +123,11 @@
                                             assert(0 == pthread_cond_signal(&que->wait.cond)); } while(0)
 #define WAIT_CONDITION_INFINITE(que,res)  do{ que->wait.flag = false; \
                                               res = pthread_cond_wait(&que->wait.cond, &que->wait.mutex); } while(0)
+#define SIGNAL_SPACE_CONDITION(que)  do{ if (que->policy.waiting) \
+                                           assert(0 == pthread_cond_signal(&que->wait.space)); } while(0)
+#define WAIT_SPACE_TIMEOUT(que,abs)  (timed_wait(&que->wait.space, &que->wait.mutex, &abs))
 #define WAIT_CONDITION_TIMEOUT(que,abs,res)  do{ que->wait.flag = false; \
-                                                 res = pthread_cond_timedwait(&que->wait.cond, &que->wait.mutex, &abs); } while(0)
+                                                 res = timed_wait(&que->wait.cond, &que->wait.mutex, &abs); } while(0)
 
 /*  -----------  types  --------------------------------------------------
  */
@@ -105,16 +137,36 @@ typedef struct object_t_ {
     size_t used;
     size_t head;
     size_t tail;
-    uint8_t *queueElem;
+    size_t high;
+    uint8_t **chunks;
     size_t elemSize;
     struct cond_wait_t {
         pthread_mutex_t mutex;
         pthread_cond_t cond;
+        pthread_cond_t space;
         bool flag;
     } wait;
+    struct spill_t {
+        uint8_t *map;
+        size_t size;
+        size_t used;
+        size_t head;
+        size_t tail;
+        size_t threshold;
+        size_t touched;
+        uint32_t touching;
+    } spill;
+    struct policy_t {
+        uint8_t mode;
+        uint16_t timeout;
+        uint32_t waiting;
+    } policy;
     struct overflow_t {
         bool flag;
         uint64_t counter;
+        uint64_t newest;
+        uint64_t oldest;
+        uint64_t expired;
     } ovfl;
 } object_t;
 
@@ -124,6 +176,17 @@ typedef struct object_t_ {
 
 static bool enqueue_element(object_t *queue, const void *element, size_t nbytes);
 static bool dequeue_element(object_t *queue, void *element, size_t maxbytes);
+static void wait_cleanup(void *arg);
+static int timed_wait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *absTime);
+static bool put_element(object_t *queue, const void *element, size_t nbytes);
+static void drop_element(object_t *queue);
+static uint8_t *map_spill_file(const char *folder, size_t length);
+static void unmap_spill_file(uint8_t *map, size_t length);
+static size_t touch_ahead(object_t *queue, uint8_t **addr);
+static void touch_pages(uint8_t *addr, size_t length);
+static void move_spilled(object_t *queue, struct spill_t *spill);
+static bool alloc_chunk(object_t *queue, size_t index);
+static void free_chunks(uint8_t **chunks, size_t numElem);
 
 
 /*  -----------  variables  ----------------------------------------------
@@ -135,6 +198,7 @@ static bool dequeue_element(object_t *queue, void *element, size_t maxbytes);
 
 queue_t queue_create(size_t numElem, size_t elemSize) {
     object_t *object = (object_t*)NULL;
+    pthread_condattr_t attr;
 
     /* reset errno variable */
     errno = 0;
@@ -146,8 +210,9 @@ queue_t queue_create(size_t numElem, size_t elemSize) {
     /* C language constructor */
     if ((object = (object_t*)malloc(sizeof(object_t))) != NULL) {
         bzero(object, sizeof(object_t));
-        /* create a fixed size queue for data exchenage */
-        if ((object->queueElem = malloc(numElem * elemSize)) == NULL) {
+        /* create a fixed size queue for data exchenage
+         * note: the elements are allocated on demand in chunks */
+        if ((object->chunks = (uint8_t**)calloc(NUM_CHUNKS(numElem), sizeof(uint8_t*))) == NULL) {
             /* errno set */
             free(object);
             return NULL;
@@ -157,16 +222,27 @@ queue_t queue_create(size_t numElem, size_t elemSize) {
         object->used = 0;
         object->head = 0;
         object->tail = 0;
+        object->high = 0;
         object->ovfl.flag = false;
         object->ovfl.counter = 0U;
-        /* create a mutex and a waitable condition */
+        object->policy.mode = QUEUE_DROP_NEWEST;
+        object->policy.timeout = 0U;
+        object->policy.waiting = 0U;
+        /* create a mutex and waitable conditions (on the queue clock) */
+        (void)pthread_condattr_init(&attr);
+#if !defined(__APPLE__)
+        (void)pthread_condattr_setclock(&attr, QUEUE_CLOCK);
+#endif
         if ((pthread_mutex_init(&object->wait.mutex, NULL) < 0) ||
-            (pthread_cond_init(&object->wait.cond, NULL)) < 0) {
+            (pthread_cond_init(&object->wait.cond, &attr) < 0) ||
+            (pthread_cond_init(&object->wait.space, &attr) < 0)) {
             /* errno set */
-            free(object->queueElem);
+            (void)pthread_condattr_destroy(&attr);
+            free(object->chunks);
             free(object);
             return NULL;
         }
+        (void)pthread_condattr_destroy(&attr);
         object->wait.flag = false;
     }
     return (object_t*)object;
@@ -184,9 +260,12 @@ int queue_destroy(queue_t queue) {
     /* destroy mutex and condition */
     (void)pthread_mutex_destroy(&object->wait.mutex);
     (void)pthread_cond_destroy(&object->wait.cond);
+    (void)pthread_cond_destroy(&object->wait.space);
     /* destroy the message queue */
-    if (object->queueElem)
-        free(object->queueElem);
+    if (object->chunks)
+        free_chunks(object->chunks, object->size);
+    if (object->spill.map)
+        unmap_spill_file(object->spill.map, object->spill.size * object->elemSize);
     /* C language destructor */
     free(object);
     return 0;
@@ -222,12 +301,20 @@ int queue_clear(queue_t queue) {
     }
     /* remove elements from queue, if any */
     ENTER_CRITICAL_SECTION(object);
-    res = (int)object->used;
+    res = (int)(object->used + object->spill.used);
     object->used = 0;
     object->head = 0;
     object->tail = 0;
+    object->high = 0;
+    object->spill.used = 0;
+    object->spill.head = 0;
+    object->spill.tail = 0;
     object->ovfl.flag = false;
     object->ovfl.counter = 0U;
+    object->ovfl.newest = 0U;
+    object->ovfl.oldest = 0U;
+    object->ovfl.expired = 0U;
+    SIGNAL_SPACE_CONDITION(object);
     LEAVE_CRITICAL_SECTION(object);
     /* return number of elements removed */
     return res;
@@ -253,9 +340,183 @@ bool queue_overflow(queue_t queue, uint64_t *counter) {
     return res;
 }
 
+int queue_policy(queue_t queue, uint8_t policy, uint16_t timeout) {
+    object_t *object = (object_t*)queue;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if ((policy != QUEUE_DROP_NEWEST) &&
+        (policy != QUEUE_DROP_OLDEST) &&
+        (policy != QUEUE_BOUNDED_BLOCK)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if ((policy == QUEUE_BOUNDED_BLOCK) && ((timeout == 0U) || (timeout == 65535U))) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* set overflow policy (effective with the next element) */
+    ENTER_CRITICAL_SECTION(object);
+    object->policy.mode = policy;
+    object->policy.timeout = (policy == QUEUE_BOUNDED_BLOCK) ? timeout : 0U;
+    LEAVE_CRITICAL_SECTION(object);
+    return 0;
+}
+
+int queue_drops(queue_t queue, uint64_t *newest, uint64_t *oldest, uint64_t *expired) {
+    object_t *object = (object_t*)queue;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* get drop counters from queue */
+    ENTER_CRITICAL_SECTION(object);
+    if (newest)
+        *newest = object->ovfl.newest;
+    if (oldest)
+        *oldest = object->ovfl.oldest;
+    if (expired)
+        *expired = object->ovfl.expired;
+    LEAVE_CRITICAL_SECTION(object);
+    return 0;
+}
+
+int queue_spill(queue_t queue, const char *folder, size_t numElem) {
+    object_t *object = (object_t*)queue;
+    uint8_t *map = NULL;
+    struct spill_t previous;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (numElem > (SIZE_MAX / object->elemSize)) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* create and map a new spill file (optional) */
+    if (numElem && ((map = map_spill_file(folder, numElem * object->elemSize)) == NULL)) {
+        /* errno set */
+        return -1;
+    }
+    /* exchange the spill files and take over all spilled elements */
+    ENTER_CRITICAL_SECTION(object);
+    previous = object->spill;
+    object->spill.map = map;
+    object->spill.size = numElem;
+    object->spill.used = 0;
+    object->spill.head = 0;
+    object->spill.tail = 0;
+    object->spill.touched = 0;
+    move_spilled(object, &previous);
+    SIGNAL_SPACE_CONDITION(object);
+    LEAVE_CRITICAL_SECTION(object);
+    /* release the previous spill file (when no longer touched) */
+    if (previous.map) {
+        WAIT_TOUCHING(object);
+        unmap_spill_file(previous.map, previous.size * object->elemSize);
+    }
+    return 0;
+}
+
+int queue_threshold(queue_t queue, size_t numElem) {
+    object_t *object = (object_t*)queue;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* set the spill threshold (effective with the next element) */
+    ENTER_CRITICAL_SECTION(object);
+    object->spill.threshold = numElem;
+    LEAVE_CRITICAL_SECTION(object);
+    return 0;
+}
+
+int queue_resize(queue_t queue, size_t numElem) {
+    object_t *object = (object_t*)queue;
+    uint8_t **chunks = NULL;
+    uint8_t **previous = NULL;
+    size_t size = 0U;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!numElem) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* create a new (empty) table of chunks */
+    if ((chunks = (uint8_t**)calloc(NUM_CHUNKS(numElem), sizeof(uint8_t*))) == NULL) {
+        /* errno set */
+        return -1;
+    }
+    /* exchange the chunks and remove all elements from queue */
+    ENTER_CRITICAL_SECTION(object);
+    previous = object->chunks;
+    size = object->size;
+    object->chunks = chunks;
+    object->size = numElem;
+    object->used = 0;
+    object->head = 0;
+    object->tail = 0;
+    object->high = 0;
+    object->spill.used = 0;
+    object->spill.head = 0;
+    object->spill.tail = 0;
+    object->ovfl.flag = false;
+    object->ovfl.counter = 0U;
+    object->ovfl.newest = 0U;
+    object->ovfl.oldest = 0U;
+    object->ovfl.expired = 0U;
+    SIGNAL_SPACE_CONDITION(object);
+    LEAVE_CRITICAL_SECTION(object);
+    /* release the previous chunks */
+    free_chunks(previous, size);
+    return 0;
+}
+
+int queue_status(queue_t queue, size_t *size, size_t *used, size_t *high) {
+    object_t *object = (object_t*)queue;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* get fill level and high-water mark from queue */
+    ENTER_CRITICAL_SECTION(object);
+    if (size)
+        *size = object->size + object->spill.size;
+    if (used)
+        *used = object->used + object->spill.used;
+    if (high)
+        *high = object->high;
+    LEAVE_CRITICAL_SECTION(object);
+    return 0;
+}
+
 int queue_enqueue(queue_t queue, const void *element, size_t nbytes) {
     object_t *object = (object_t*)queue;
     int res = -1;
+    uint8_t *ahead = NULL;
+    size_t length = 0U;
+    struct timespec absTime;
 
     /* sanity check */
     errno = 0;
@@ -269,6 +530,18 @@ int queue_enqueue(queue_t queue, const void *element, size_t nbytes) {
     }
     /* enqueue element (with truncation), if queue not full */
     ENTER_CRITICAL_SECTION(object);
+    if ((object->policy.mode == QUEUE_BOUNDED_BLOCK) && IS_FULL(object)) {
+        /* bounded-block: wait until there is space or the time has expired */
+        GET_TIME(absTime);
+        ADD_TIME(absTime, (uint64_t)object->policy.timeout * 1000U);
+        object->policy.waiting += 1U;
+        /* note: the calling thread might be cancelled while waiting */
+        pthread_cleanup_push(wait_cleanup, (void*)object);
+        while (IS_FULL(object) && (WAIT_SPACE_TIMEOUT(object, absTime) == 0))
+            ;
+        pthread_cleanup_pop(0);
+        object->policy.waiting -= 1U;
+    }
     if (enqueue_element(object, element, nbytes)) {
         res = (int)MIN(object->elemSize, nbytes);
         SIGNAL_WAIT_CONDITION(object, true);
@@ -276,20 +549,34 @@ int queue_enqueue(queue_t queue, const void *element, size_t nbytes) {
         errno = ENOSPC;
         res = -20;
     }
+    /* note: the pages of the spill file ahead of the tail are touched outside
+     *       of the lock, so that a waiting consumer is not blocked by page faults */
+    length = touch_ahead(object, &ahead);
     LEAVE_CRITICAL_SECTION(object);
+    if (length) {
+        touch_pages(ahead, length);
+        LEAVE_TOUCHING(object);
+    }
     /* return number of bytes enqueued, or negative value on error */
     return res;
 }
 
 int queue_dequeue(queue_t queue, void *element, size_t maxbytes, uint16_t timeout) {
+    /* note: 65535 [ms] means blocking read */
+    return queue_dequeue_us(queue, element, maxbytes, TO_USEC(timeout));
+}
+
+int queue_dequeue_us(queue_t queue, void *element, size_t maxbytes, uint64_t timeout) {
     object_t *object = (object_t*)queue;
     int res = -1;
     int waitCond = 0;
     struct timespec absTime;
 
-    GET_TIME(absTime);
-    ADD_TIME(absTime, timeout);
-
+    /* note: no deadline for an infinite blocking read */
+    if (timeout != QUEUE_INFINITE_US) {
+        GET_TIME(absTime);
+        ADD_TIME(absTime, timeout);
+    }
     /* sanity check */
     errno = 0;
     if (!object) {
@@ -305,8 +592,9 @@ int queue_dequeue(queue_t queue, void *element, size_t maxbytes, uint16_t timeou
 again:
     if (dequeue_element(object, element, maxbytes)) {
         res = (int)MIN(object->elemSize, maxbytes);
+        SIGNAL_SPACE_CONDITION(object);
     } else {
-        if (timeout == 65535U) {  /* infinite blocking read */
+        if (timeout == QUEUE_INFINITE_US) {  /* infinite blocking read */
             WAIT_CONDITION_INFINITE(object, waitCond);
             if ((waitCond == 0) && object->wait.flag)
                 goto again;
@@ -334,30 +622,56 @@ again:
  *  head :  read position of the queue
  *  tail :  write position of the queue
  *  used :  number of queued elements
+ *  high :  high-water mark (maximum of used, including spilled elements)
  *
  *  (§1) empty :  used == 0
  *  (§2) full  :  used == size  &&  size > 0
+ *
+ *  spill :  optional ring of elements in a memory-mapped file, used when
+ *           the queue is full; the spilled elements are always younger
+ *           than the elements in memory and move into memory in order
+ *           when an element is dequeued
  */
 static bool enqueue_element(object_t *queue, const void *element, size_t nbytes) {
     assert(queue);
     assert(element);
     assert(queue->size);
     assert(queue->elemSize);
-    assert(queue->queueElem);
+    assert(queue->chunks);
 
-    if (queue->used < queue->size) {
-        if (queue->used != 0U)
-            queue->tail = (queue->tail + 1U) % queue->size;
-        else
-            queue->head = queue->tail;  /* to make sure */
-        (void)memcpy(&queue->queueElem[(queue->tail * queue->elemSize)], element, MIN(queue->elemSize, nbytes));
-        queue->used += 1U;
-        return true;
+    if (IS_FULL(queue) && (queue->policy.mode == QUEUE_DROP_OLDEST)) {
+        /* drop the oldest element to make room for the new one */
+        drop_element(queue);
+        queue->ovfl.counter += 1U;
+        queue->ovfl.oldest += 1U;
+        queue->ovfl.flag = true;
+    }
+    if ((queue->spill.used == 0U) && (queue->used < SPILL_LEVEL(queue))) {
+        /* note: a chunk is allocated when it is entered for the first time */
+        if (!put_element(queue, element, nbytes)) {
+            queue->ovfl.counter += 1U;
+            queue->ovfl.newest += 1U;
+            queue->ovfl.flag = true;
+            return false;
+        }
+    } else if (queue->spill.used < queue->spill.size) {
+        /* note: once spilling, all elements go to the spill file until it is empty */
+        (void)memcpy(SPILLED(queue, queue->spill.tail), element, MIN(queue->elemSize, nbytes));
+        queue->spill.tail = (queue->spill.tail + 1U) % queue->spill.size;
+        queue->spill.used += 1U;
     } else {
+        /* note: with bounded-block policy the wait time has expired */
+        if (queue->policy.mode == QUEUE_BOUNDED_BLOCK)
+            queue->ovfl.expired += 1U;
+        else
+            queue->ovfl.newest += 1U;
         queue->ovfl.counter += 1U;
         queue->ovfl.flag = true;
         return false;
     }
+    if ((queue->used + queue->spill.used) > queue->high)
+        queue->high = queue->used + queue->spill.used;
+    return true;
 }
 
 static bool dequeue_element(object_t *queue, void *element, size_t maxbytes) {
@@ -365,17 +679,215 @@ static bool dequeue_element(object_t *queue, void *element, size_t maxbytes) {
     assert(element);
     assert(queue->size);
     assert(queue->elemSize);
-    assert(queue->queueElem);
+    assert(queue->chunks);
 
     if (queue->used > 0U) {
-        (void)memcpy(element, &queue->queueElem[(queue->head * queue->elemSize)], MIN(queue->elemSize, maxbytes));
+        (void)memcpy(element, ELEMENT(queue, queue->head), MIN(queue->elemSize, maxbytes));
         queue->head = (queue->head + 1U) % queue->size;
         queue->used -= 1U;
+        /* note: the oldest spilled element moves into memory to keep the order */
+        if ((queue->spill.used > 0U) &&
+            put_element(queue, SPILLED(queue, queue->spill.head), queue->elemSize)) {
+            queue->spill.head = (queue->spill.head + 1U) % queue->spill.size;
+            queue->spill.used -= 1U;
+        }
+        return true;
+    } else if (queue->spill.used > 0U) {
+        /* note: spilled elements are younger than the elements in memory */
+        (void)memcpy(element, SPILLED(queue, queue->spill.head), MIN(queue->elemSize, maxbytes));
+        queue->spill.head = (queue->spill.head + 1U) % queue->spill.size;
+        queue->spill.used -= 1U;
         return true;
     } else
         return false;
 }
 
+static bool put_element(object_t *queue, const void *element, size_t nbytes) {
+    size_t index = (queue->used != 0U) ? ((queue->tail + 1U) % queue->size) : queue->tail;
+
+    assert(queue->used < queue->size);
+
+    if (!queue->chunks[index / CHUNK_ELEMS] && !alloc_chunk(queue, index))
+        return false;
+    if (queue->used != 0U)
+        queue->tail = index;
+    else
+        queue->head = queue->tail;  /* to make sure */
+    (void)memcpy(ELEMENT(queue, queue->tail), element, MIN(queue->elemSize, nbytes));
+    queue->used += 1U;
+    return true;
+}
+
+static void drop_element(object_t *queue) {
+    assert(IS_FULL(queue));
+
+    if (queue->used > 0U) {
+        queue->head = (queue->head + 1U) % queue->size;
+        queue->used -= 1U;
+        /* note: the oldest spilled element moves into memory to keep the order */
+        if ((queue->spill.used > 0U) &&
+            put_element(queue, SPILLED(queue, queue->spill.head), queue->elemSize)) {
+            queue->spill.head = (queue->spill.head + 1U) % queue->spill.size;
+            queue->spill.used -= 1U;
+        }
+    } else {
+        queue->spill.head = (queue->spill.head + 1U) % queue->spill.size;
+        queue->spill.used -= 1U;
+    }
+}
+
+static void move_spilled(object_t *queue, struct spill_t *spill) {
+    const uint8_t *element;
+    bool moved;
+
+    assert(queue);
+    assert(spill);
+
+    /* note: the spilled elements are younger than the elements in memory,
+     *       they are moved in order into memory and then into the new spill
+     *       file; the remaining (youngest) ones are counted as dropped */
+    while (spill->used > 0U) {
+        element = &spill->map[spill->head * queue->elemSize];
+        moved = (queue->spill.used == 0U) && (queue->used < SPILL_LEVEL(queue)) &&
+                put_element(queue, element, queue->elemSize);
+        if (!moved && (queue->spill.used < queue->spill.size)) {
+            (void)memcpy(SPILLED(queue, queue->spill.tail), element, queue->elemSize);
+            queue->spill.tail = (queue->spill.tail + 1U) % queue->spill.size;
+            queue->spill.used += 1U;
+        } else if (!moved) {
+            queue->ovfl.counter += 1U;
+            queue->ovfl.newest += 1U;
+            queue->ovfl.flag = true;
+        }
+        spill->head = (spill->head + 1U) % spill->size;
+        spill->used -= 1U;
+    }
+}
+
+static void wait_cleanup(void *arg) {
+    object_t *object = (object_t*)arg;
+
+    assert(object);
+
+    object->policy.waiting -= 1U;
+    LEAVE_CRITICAL_SECTION(object);
+}
+
+static int timed_wait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *absTime) {
+#if !defined(__APPLE__)
+    /* note: the condition variable is on the queue clock */
+    return pthread_cond_timedwait(cond, mutex, absTime);
+#else
+    struct timespec now, relTime;
+
+    /* note: the deadline is on the queue clock, wait for the remaining time */
+    GET_TIME(now);
+    relTime.tv_sec = absTime->tv_sec - now.tv_sec;
+    relTime.tv_nsec = absTime->tv_nsec - now.tv_nsec;
+    if (relTime.tv_nsec < 0L) {
+        relTime.tv_nsec += (long)1000000000;
+        relTime.tv_sec -= (time_t)1;
+    }
+    if (relTime.tv_sec < (time_t)0)
+        return ETIMEDOUT;
+    return pthread_cond_timedwait_relative_np(cond, mutex, &relTime);
+#endif
+}
+
+static bool alloc_chunk(object_t *queue, size_t index) {
+    size_t first = (index / CHUNK_ELEMS) * CHUNK_ELEMS;
+    size_t count = MIN(CHUNK_ELEMS, queue->size - first);
+
+    assert(queue);
+    assert(queue->chunks);
+    assert(index < queue->size);
+
+    /* note: the last chunk holds only the remaining elements */
+    queue->chunks[index / CHUNK_ELEMS] = (uint8_t*)malloc(count * queue->elemSize);
+    return (queue->chunks[index / CHUNK_ELEMS] != NULL) ? true : false;
+}
+
+static void free_chunks(uint8_t **chunks, size_t numElem) {
+    size_t i;
+
+    assert(chunks);
+
+    for (i = 0U; i < NUM_CHUNKS(numElem); i++) {
+        if (chunks[i])
+            free(chunks[i]);
+    }
+    free(chunks);
+}
+
+static size_t touch_ahead(object_t *queue, uint8_t **addr) {
+    size_t length;
+    size_t limit;
+    size_t start;
+
+    assert(queue);
+    assert(addr);
+
+    /* note: the pages are touched once spilling is about to start or has started,
+     *       up to a fixed distance ahead of the tail (once per page of the file) */
+    if (!queue->spill.map)
+        return 0U;
+    length = queue->spill.size * queue->elemSize;
+    if ((queue->spill.touched >= length) ||
+        ((queue->spill.used == 0U) && ((queue->used + (SPILL_AHEAD / queue->elemSize)) < SPILL_LEVEL(queue))))
+        return 0U;
+    limit = (queue->spill.tail * queue->elemSize) + SPILL_AHEAD;
+    limit = MIN(((limit + SPILL_PAGE - 1U) / SPILL_PAGE) * SPILL_PAGE, length);
+    if (limit <= queue->spill.touched)
+        return 0U;
+    start = queue->spill.touched;
+    queue->spill.touched = limit;
+    ENTER_TOUCHING(queue);
+    *addr = &queue->spill.map[start];
+    return limit - start;
+}
+
+static void touch_pages(uint8_t *addr, size_t length) {
+    size_t offset;
+
+    assert(addr);
+
+    /* note: an atomic addition of zero faults the page in for writing,
+     *       without changing an element written by another thread */
+    for (offset = 0U; offset < length; offset += SPILL_PAGE)
+        TOUCH_PAGE(&addr[offset]);
+}
+
+static uint8_t *map_spill_file(const char *folder, size_t length) {
+    char path[PATH_MAX];
+    void *map;
+    int fd;
+
+    assert(length);
+
+    /* create a unique (anonymous) file in the given folder */
+    if (snprintf(path, PATH_MAX, "%s/" SPILL_PREFIX, (folder && folder[0]) ? folder : SPILL_FOLDER) >= PATH_MAX) {
+        errno = ENAMETOOLONG;
+        return NULL;
+    }
+    if ((fd = mkstemp(path)) < 0)
+        return NULL;
+    (void)unlink(path);
+    /* note: the file is sparse, storage is allocated when its pages are touched */
+    if (ftruncate(fd, (off_t)length) < 0) {
+        (void)close(fd);
+        return NULL;
+    }
+    map = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    (void)close(fd);
+    return (map != MAP_FAILED) ? (uint8_t*)map : NULL;
+}
+
+static void unmap_spill_file(uint8_t *map, size_t length) {
+    assert(map);
+
+    (void)munmap((void*)map, length);
+}
+
 /*  ----------------------------------------------------------------------
  *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
  *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
@@ -0,0 +1,509 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'recorder'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        recorder.c
+ *
+ *  @brief       Flight recorder for CAN messages (trigger-based dump).
+ *
+ *  @remarks     The dump thread is realized by the 'poller' module and the
+ *               trace files are written by the 'tracer' module, so only the
+ *               lock of the ring depends on the platform.
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @addtogroup  recorder
+ *  @{
+ */
+#include "recorder.h"
+#include "poller.h"
+#include "timer.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <assert.h>
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define DUMP_INTERVAL  10U              /* dump thread: every 10ms */
+#define DUMP_RETRY  1000U               /* tracer ring full: retry after 1ms */
+#define NAME_SUFFIX  16U                /* '_<number>' and extension */
+#define MSEC_TO_NSEC(ms)  ((uint64_t)(ms) * 1000000U)
+
+#define ARMED      0U                   /* waiting for a trigger */
+#define TRIGGERED  1U                   /* recording the post-trigger window */
+
+#if defined(_WIN32) || defined(_WIN64)
+#define INIT_LOCK(obj)  InitializeSRWLock(&(obj)->lock)
+#define FREE_LOCK(obj)  while (0)
+#define LOCK(obj)  AcquireSRWLockExclusive(&(obj)->lock)
+#define UNLOCK(obj)  ReleaseSRWLockExclusive(&(obj)->lock)
+#else
+#define INIT_LOCK(obj)  (void)pthread_mutex_init(&(obj)->lock, NULL)
+#define FREE_LOCK(obj)  (void)pthread_mutex_destroy(&(obj)->lock)
+#define LOCK(obj)  (void)pthread_mutex_lock(&(obj)->lock)
+#define UNLOCK(obj)  (void)pthread_mutex_unlock(&(obj)->lock)
+#endif
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef struct dump_t_ {                /* ring to be dumped: */
+    tracer_record_t *records;           /* - the records (spare ring) */
+    uint64_t count;                     /* - number of records put */
+    uint64_t trigger;                   /* - position of the trigger */
+    uint64_t time;                      /* - time of the trigger (in [ns]) */
+    bool pending;                       /* - dump in progress */
+} dump_t;
+
+typedef struct object_t_ {
+#if defined(_WIN32) || defined(_WIN64)
+    SRWLOCK lock;                       /* - ring lock (producers and dump thread) */
+#else
+    pthread_mutex_t lock;               /* - ring lock (producers and dump thread) */
+#endif
+    recorder_attr_t attr;               /* - recorder settings */
+    uint32_t capacity;                  /* - ring size (pre- and post-trigger window) */
+    uint32_t limit;                     /* - post-trigger window (in [frames]) */
+    tracer_record_t *records;           /* - active ring */
+    uint64_t count;                     /* - number of records put */
+    uint8_t state;                      /* - ARMED or TRIGGERED */
+    uint64_t trigger;                   /* - position of the trigger */
+    uint64_t time;                      /* - time of the trigger (in [ns]) */
+    uint64_t deadline;                  /* - end of the post-trigger window (monotonic) */
+    uint32_t post;                      /* - records since the trigger */
+    dump_t dump;                        /* - ring to be dumped */
+    poller_t dumper;                    /* - dump thread */
+    char *basename;                     /* - path and name (w/o number and extension) */
+    char *filename;                     /* - name of the last trace file */
+    uint32_t dumps;                     /* - number of dumps */
+    uint32_t ignored;                   /* - number of ignored triggers */
+    int error;                          /* - first write error (errno) */
+} object_t;
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static void dumper(void *arg);
+static int fire(object_t *object, uint64_t time);
+static void complete(object_t *object);
+static void write_dump(object_t *object);
+static bool match_pattern(const recorder_pattern_t *pattern, const tracer_record_t *record);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+recorder_t recorder_create(const char *basename, const recorder_attr_t *attr) {
+    object_t *object = (object_t*)NULL;
+    int res;
+
+    /* reset errno variable */
+    errno = 0;
+    /* sanity check */
+    if (!basename || !basename[0] || !attr) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!attr->frames || (attr->frames > RECORDER_MAX_FRAMES) || (attr->post_frames > RECORDER_MAX_FRAMES)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if ((attr->format != TRACER_BINARY) && (attr->format != TRACER_CSV) &&
+        (attr->format != TRACER_CANDUMP) && (attr->format != TRACER_ASC) && (attr->format != TRACER_VENDOR)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    /* C language constructor */
+    if ((object = (object_t*)calloc(1, sizeof(object_t))) == NULL) {
+        /* errno set */
+        return NULL;
+    }
+    object->attr = *attr;
+    object->limit = attr->post_frames ? attr->post_frames : (attr->post_time ? attr->frames : 0U);
+    object->capacity = attr->frames + object->limit;
+    if (((object->basename = (char*)malloc(strlen(basename) + 1U)) == NULL) ||
+        ((object->filename = (char*)calloc(1, strlen(basename) + NAME_SUFFIX)) == NULL) ||
+        ((object->records = (tracer_record_t*)malloc((size_t)object->capacity * sizeof(tracer_record_t))) == NULL) ||
+        ((object->dump.records = (tracer_record_t*)malloc((size_t)object->capacity * sizeof(tracer_record_t))) == NULL)) {
+        /* errno set */
+        free(object->records);
+        free(object->filename);
+        free(object->basename);
+        free(object);
+        return NULL;
+    }
+    strcpy(object->basename, basename);
+    object->state = ARMED;
+    INIT_LOCK(object);
+    /* start the dump thread */
+    if ((object->dumper = poller_create(dumper, (void*)object, DUMP_INTERVAL)) == NULL) {
+        res = errno;
+        FREE_LOCK(object);
+        free(object->dump.records);
+        free(object->records);
+        free(object->filename);
+        free(object->basename);
+        free(object);
+        errno = res;
+        return NULL;
+    }
+    return (recorder_t)object;
+}
+
+int recorder_destroy(recorder_t recorder) {
+    object_t *object = (object_t*)recorder;
+    int res = 0;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* stop the dump thread and dump a pending or a triggered ring */
+    (void)poller_destroy(object->dumper);
+    if (object->dump.pending) {
+        write_dump(object);
+        object->dump.pending = false;
+    }
+    if (object->state == TRIGGERED) {
+        complete(object);
+        write_dump(object);
+        object->dump.pending = false;
+    }
+    if (object->error) {
+        errno = object->error;
+        res = -1;
+    }
+    /* C language destructor */
+    FREE_LOCK(object);
+    free(object->dump.records);
+    free(object->records);
+    free(object->filename);
+    free(object->basename);
+    free(object);
+    return res;
+}
+
+int recorder_put(recorder_t recorder, const tracer_record_t *record) {
+    object_t *object = (object_t*)recorder;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!record) {
+        errno = EINVAL;
+        return -1;
+    }
+    LOCK(object);
+    /* note: the oldest record is overwritten when the ring is full */
+    object->records[object->count % object->capacity] = *record;
+    object->count++;
+    if (object->state == TRIGGERED) {
+        /* post-trigger window: complete after the given number of frames */
+        if (++object->post >= object->limit)
+            complete(object);
+    }
+    else if (((object->attr.events & RECORDER_ON_PATTERN) && match_pattern(&object->attr.pattern, record)) ||
+             ((object->attr.events & RECORDER_ON_ERROR) && (record->can_id & TRACER_ERR_FRAME))) {
+        /* note: the triggering message is the last one of the pre-trigger window */
+        (void)fire(object, record->time);
+    }
+    UNLOCK(object);
+    return 0;
+}
+
+int recorder_trigger(recorder_t recorder, uint8_t event) {
+    object_t *object = (object_t*)recorder;
+    struct timespec now = timer_get_time();
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if ((event != RECORDER_ON_REQUEST) && !(object->attr.events & event)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    LOCK(object);
+    res = fire(object, ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec);
+    UNLOCK(object);
+    if (res < 0)
+        errno = EBUSY;
+    return res;
+}
+
+int recorder_filename(recorder_t recorder, char *buffer, size_t length) {
+    object_t *object = (object_t*)recorder;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!buffer || !length) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* note: the file name is changed by the dump thread */
+    LOCK(object);
+    strncpy(buffer, object->filename, length);
+    buffer[length - 1U] = '\0';
+    UNLOCK(object);
+    return 0;
+}
+
+int recorder_status(recorder_t recorder, uint32_t *dumps, uint32_t *ignored) {
+    object_t *object = (object_t*)recorder;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    LOCK(object);
+    if (dumps)
+        *dumps = object->dumps;
+    if (ignored)
+        *ignored = object->ignored;
+    UNLOCK(object);
+    return 0;
+}
+
+int recorder_flush(recorder_t recorder) {
+    object_t *object = (object_t*)recorder;
+    bool pending;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* end the post-trigger window and wait for the dump thread */
+    LOCK(object);
+    if (object->state == TRIGGERED)
+        complete(object);
+    pending = object->dump.pending;
+    UNLOCK(object);
+    while (pending) {
+        (void)timer_delay(DUMP_RETRY);
+        LOCK(object);
+        pending = object->dump.pending;
+        UNLOCK(object);
+    }
+    return 0;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static void dumper(void *arg) {
+    object_t *object = (object_t*)arg;
+    bool pending;
+
+    assert(object);
+    /* post-trigger window: complete after the given time */
+    LOCK(object);
+    if ((object->state == TRIGGERED) && object->attr.post_time &&
+        (timer_get_clock() >= object->deadline))
+        complete(object);
+    pending = object->dump.pending;
+    UNLOCK(object);
+    /* note: the spare ring belongs to the dump thread while a dump is pending */
+    if (pending) {
+        write_dump(object);
+        LOCK(object);
+        object->dump.pending = false;
+        UNLOCK(object);
+    }
+}
+
+static int fire(object_t *object, uint64_t time) {
+    assert(object);
+
+    /* note: the ring is locked by the caller */
+    if (object->state == TRIGGERED)
+        return -1;
+    if (object->dump.pending) {
+        object->ignored++;
+        return -1;
+    }
+    object->state = TRIGGERED;
+    object->trigger = object->count;
+    object->time = time;
+    object->deadline = timer_get_clock() + MSEC_TO_NSEC(object->attr.post_time);
+    object->post = 0U;
+    if (!object->limit)                 /* no post-trigger window */
+        complete(object);
+    return 0;
+}
+
+static void complete(object_t *object) {
+    tracer_record_t *records;
+
+    assert(object);
+
+    /* note: the ring is locked by the caller, and the spare ring is free */
+    assert(!object->dump.pending);
+    records = object->dump.records;
+    object->dump.records = object->records;
+    object->dump.count = object->count;
+    object->dump.trigger = object->trigger;
+    object->dump.time = object->time;
+    object->dump.pending = true;
+    /* continue recording with the spare ring */
+    object->records = records;
+    object->count = 0U;
+    object->state = ARMED;
+}
+
+static void write_dump(object_t *object) {
+    const dump_t *dump = &object->dump;
+    char *basename;
+    tracer_t tracer;
+    uint64_t first, last, limit;
+    uint64_t index;
+    const tracer_record_t *record;
+    size_t length;
+
+    assert(object);
+    assert(dump->pending);
+
+    /* pre-trigger window: the last frames before the trigger, in the given time */
+    first = (dump->count > object->capacity) ? (dump->count - object->capacity) : 0U;
+    if (dump->trigger > ((uint64_t)object->attr.frames + first))
+        first = dump->trigger - object->attr.frames;
+    last = dump->count;
+    limit = (object->attr.time && (dump->time > MSEC_TO_NSEC(object->attr.time))) ?
+            (dump->time - MSEC_TO_NSEC(object->attr.time)) : 0U;
+    /* file name: <basename>_<number> */
+    length = strlen(object->basename) + NAME_SUFFIX;
+    if ((basename = (char*)malloc(length)) == NULL) {
+        if (!object->error)
+            object->error = errno;
+        return;
+    }
+    (void)snprintf(basename, length, "%s_%03u", object->basename, object->dumps % 1000U);
+    if ((tracer = tracer_create(basename, object->attr.format, TRACER_OVERWRITE, 0U)) == NULL) {
+        if (!object->error)
+            object->error = errno;
+        free(basename);
+        return;
+    }
+    for (index = first; index < last; index++) {
+        record = &dump->records[index % object->capacity];
+        if ((index < dump->trigger) && (record->time < limit))
+            continue;
+        /* note: the dump thread is the only producer of the tracer */
+        while ((tracer_put(tracer, record) < 0) && (errno == ENOSPC))
+            (void)timer_delay(DUMP_RETRY);
+    }
+    LOCK(object);
+    (void)tracer_filename(tracer, object->filename, length);
+    object->dumps++;
+    UNLOCK(object);
+    if ((tracer_destroy(tracer) < 0) && !object->error)
+        object->error = errno;
+    free(basename);
+}
+
+static bool match_pattern(const recorder_pattern_t *pattern, const tracer_record_t *record) {
+    int i;
+
+    assert(pattern);
+    assert(record);
+
+    if ((record->can_id ^ pattern->can_id) & pattern->id_mask)
+        return false;
+    for (i = 0; i < 8; i++) {
+        if (pattern->data_mask[i]) {
+            if (i >= (int)record->can_dlc)
+                return false;
+            if ((record->data[i] ^ pattern->data[i]) & pattern->data_mask[i])
+                return false;
+        }
+    }
+    return true;
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,287 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'recorder'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        recorder.h
+ *
+ *  @brief       Flight recorder for CAN messages (trigger-based dump).
+ *
+ *  @remarks     The producers (e.g. the reception thread and the transmitting
+ *               thread) put all messages into a pre-trigger ring, where the
+ *               oldest messages are overwritten. When a trigger occurs (by
+ *               request, by a message matching a pattern, by an error frame or
+ *               by a bus status change) the recorder keeps recording for a
+ *               post-trigger window and then dumps the ring to a trace file.
+ *
+ *  @remarks     The filled ring is exchanged for a spare one at the end of the
+ *               post-trigger window, so the recording continues while the dump
+ *               thread writes the trace file. A trigger during a dump in progress
+ *               is ignored and counted.
+ *
+ *  @note        Each dump is written to a new trace file. The dump number is
+ *               added to the file name (e.g. 'flight_000.bin', 'flight_001.bin').
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @defgroup    recorder Flight Recorder
+ *  @{
+ */
+#ifndef RECORDER_H_INCLUDED
+#define RECORDER_H_INCLUDED
+
+#include "tracer.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+/** @name  Trigger Events
+ *  @brief Events that trigger a dump (can be combined)
+ *  @{ */
+#define RECORDER_ON_REQUEST  0x00U      /**< by request (always enabled) */
+#define RECORDER_ON_PATTERN  0x01U      /**< message matching the pattern */
+#define RECORDER_ON_ERROR    0x02U      /**< error frame */
+#define RECORDER_ON_STATUS   0x04U      /**< bus status change (by the caller) */
+/** @} */
+
+#define RECORDER_MAX_FRAMES  16777216U  /**< max. number of frames per window */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef void *recorder_t;               /**< recorder (opaque data type) */
+
+/** @brief       trigger pattern (identifier and payload)
+ *
+ *  @remarks     A message matches when all bits selected by the masks are
+ *               equal. Payload bytes with a non-zero mask must be within the
+ *               data length of the message.
+ */
+typedef struct recorder_pattern_t_ {
+    uint32_t can_id;                    /**< identifier with frame flags */
+    uint32_t id_mask;                   /**< mask for the identifier and flags */
+    uint8_t data[8];                    /**< payload */
+    uint8_t data_mask[8];               /**< mask for the payload */
+} recorder_pattern_t;
+
+/** @brief       recorder settings
+ *
+ *  @remarks     The pre-trigger window holds the last 'frames' messages, and
+ *               only those of the last 'time' milliseconds (if not zero).
+ *               The post-trigger window ends after 'post_frames' messages or
+ *               after 'post_time' milliseconds, whichever comes first (zero is
+ *               not used; both zero dumps immediately). With 'post_time' only,
+ *               the post-trigger window holds at most 'frames' messages.
+ */
+typedef struct recorder_attr_t_ {
+    uint32_t frames;                    /**< pre-trigger window (in [frames]) */
+    uint32_t time;                      /**< pre-trigger window (in [ms], 0 = off) */
+    uint32_t post_frames;               /**< post-trigger window (in [frames], 0 = off) */
+    uint32_t post_time;                 /**< post-trigger window (in [ms], 0 = off) */
+    uint8_t events;                     /**< trigger events (RECORDER_ON_xyz) */
+    uint8_t format;                     /**< trace file format (TRACER_xyz) */
+    recorder_pattern_t pattern;         /**< trigger pattern (RECORDER_ON_PATTERN) */
+} recorder_attr_t;
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief       creates a recorder, allocates the rings and starts the dump
+ *               thread (constructor).
+ *
+ *  @param[in]   basename  - path and name of the trace files (w/o dump number
+ *                           and extension)
+ *  @param[in]   attr      - recorder settings
+ *
+ *  @returns     pointer to a recorder instance if successful, or NULL on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EINVAL   - invalid argument (basename or settings)
+ *  @retval      ENOMEM   - out of memory (insufficient storage space)
+ *  @retval      'errno'  - error code from called system functions:
+ *                          'pthread_mutex_init', 'pthread_create', etc.
+ */
+extern recorder_t recorder_create(const char *basename, const recorder_attr_t *attr);
+
+
+/** @brief       stops the dump thread and destroys the recorder (destructor).
+ *
+ *  @remarks     A trigger in progress is completed, i.e. the recorded messages
+ *               are dumped without waiting for the end of the post-trigger
+ *               window. The producers must not call 'recorder_put' during or
+ *               after the call of this function.
+ *
+ *  @param[in]   recorder  - pointer to a recorder instance
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid recorder instance)
+ *  @retval      'errno'  - error code from called system functions:
+ *                          'fwrite', 'fclose', etc.
+ */
+extern int recorder_destroy(recorder_t recorder);
+
+
+/** @brief       puts a record into the ring and checks it for a trigger
+ *               (message pattern or error frame).
+ *
+ *  @remarks     The function can be called by several producers (e.g. the
+ *               reception thread and the transmitting threads). It does not
+ *               wait for the dump thread; the ring is locked only briefly.
+ *
+ *  @param[in]   recorder  - pointer to a recorder instance
+ *  @param[in]   record    - the record to be recorded
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid recorder instance)
+ *  @retval      EINVAL   - invalid argument (record)
+ */
+extern int recorder_put(recorder_t recorder, const tracer_record_t *record);
+
+
+/** @brief       triggers a dump by request or by an external event (e.g. a
+ *               bus status change).
+ *
+ *  @param[in]   recorder  - pointer to a recorder instance
+ *  @param[in]   event     - trigger event (RECORDER_ON_REQUEST or _STATUS)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid recorder instance)
+ *  @retval      ENOTSUP  - trigger event not enabled
+ *  @retval      EBUSY    - already triggered or dump in progress (ignored)
+ */
+extern int recorder_trigger(recorder_t recorder, uint8_t event);
+
+
+/** @brief       returns the file name of the last dump (or an empty string).
+ *
+ *  @param[in]   recorder  - pointer to a recorder instance
+ *  @param[out]  buffer    - buffer for the file name (zero-terminated)
+ *  @param[in]   length    - size of the buffer (in [byte])
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid recorder instance)
+ *  @retval      EINVAL   - invalid argument (buffer or length)
+ */
+extern int recorder_filename(recorder_t recorder, char *buffer, size_t length);
+
+
+/** @brief       returns the number of dumps and of ignored triggers.
+ *
+ *  @param[in]   recorder  - pointer to a recorder instance
+ *  @param[out]  dumps     - number of dumps written (optional)
+ *  @param[out]  ignored   - number of triggers ignored (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid recorder instance)
+ */
+extern int recorder_status(recorder_t recorder, uint32_t *dumps, uint32_t *ignored);
+
+
+/** @brief       completes a trigger in progress and waits until all dumps
+ *               are written.
+ *
+ *  @remarks     The post-trigger window of a trigger in progress ends with the
+ *               call of this function. It should be called when the producers
+ *               no longer call 'recorder_put' (e.g. before reading the status
+ *               and the file name of the last dump).
+ *
+ *  @param[in]   recorder  - pointer to a recorder instance
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid recorder instance)
+ */
+extern int recorder_flush(recorder_t recorder);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* RECORDER_H_INCLUDED */
+
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,302 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'ring'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        ring.h
+ *
+ *  @brief       Broadcast ring for intertask communication.
+ *
+ *  @remarks     One producer thread writes data elements of configurable size
+ *               into the ring; it is never blocked and overwrites the oldest
+ *               element when the ring is full.
+ *               Up to RING_MAX_READERS consumer threads read all elements from
+ *               the ring independently, each with its own read position, its
+ *               own filter and its own overflow counter. An element is stored
+ *               once, regardless of the number of readers.
+ *
+ *  @note        A reader that is overtaken by the producer loses the oldest
+ *               elements; they are counted and skipped with the next read.
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @defgroup    ring Broadcast Ring
+ *  @{
+ */
+#ifndef RING_H_INCLUDED
+#define RING_H_INCLUDED
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define RING_MAX_READERS  16            /**< maximum number of readers */
+#define RING_INFINITE_US  UINT64_MAX    /**< blocking read (time-out in [us]) */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef void *ring_t;                   /**< ring (opaque data type) */
+
+/** @brief       filter function of a reader (returns true to accept an element)
+ */
+typedef bool (*ring_filter_t)(const void *element, const void *param);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief       creates an instance of a broadcast ring (constructor).
+ *
+ *  @param[in]   numElem   - number of elements in the ring
+ *  @param[in]   elemSize  - size of a ring element (number of bytes)
+ *
+ *  @returns     pointer to a ring instance if successful, or NULL on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EINVAL   - invalid argument (numElem or elemSize)
+ *  @retval      ENOMEM   - out of memory (insufficient storage space)
+ *  @retval      'errno'  - error code from called system functions:
+ *                          'pthread_mutex_init', 'pthread_cond_init'
+ */
+extern ring_t ring_create(size_t numElem, size_t elemSize);
+
+
+/** @brief       destroys the ring instance (destructor).
+ *
+ *  @param[in]   ring  - pointer to a ring instance
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid ring instance)
+ *  @retval      'errno'  - error code from called system functions:
+ *                          'pthread_mutex_destroy', 'pthread_cond_destroy'
+ */
+extern int ring_destroy(ring_t ring);
+
+
+/** @brief       signals all waiting readers (e.g. to terminate a blocking read).
+ *
+ *  @param[in]   ring  - pointer to a ring instance
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid ring instance)
+ */
+extern int ring_signal(ring_t ring);
+
+
+/** @brief       writes one element of n data bytes into the ring (producer).
+ *
+ *  @remarks     When the ring is full the oldest element is overwritten.
+ *               If the element is smaller than the element size, the rest
+ *               is filled with zeros; if it is bigger, it is truncated.
+ *
+ *  @param[in]   ring     - pointer to a ring instance
+ *  @param[in]   element  - pointer to the data element
+ *  @param[in]   nbytes   - number of data bytes
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid ring instance)
+ *  @retval      EINVAL   - invalid argument (element or nbytes)
+ */
+extern int ring_put(ring_t ring, const void *element, size_t nbytes);
+
+
+/** @brief       attaches a reader to the ring.
+ *
+ *  @remarks     The reader starts with the next element written into the ring.
+ *               The filter function (optional) is called by the reader for each
+ *               element; rejected elements are skipped. It is called outside of
+ *               the ring's critical section with a copy of the element, so it
+ *               does not block the producer or the other readers. A reader is
+ *               read by one thread at a time.
+ *
+ *  @param[in]   ring    - pointer to a ring instance
+ *  @param[in]   filter  - filter function of the reader (or NULL)
+ *  @param[in]   param   - parameter of the filter function (optional)
+ *
+ *  @returns     reader number (0..RING_MAX_READERS-1) if successful,
+ *               or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid ring instance)
+ *  @retval      EBUSY    - too many readers attached
+ */
+extern int ring_attach(ring_t ring, ring_filter_t filter, const void *param);
+
+
+/** @brief       detaches a reader from the ring.
+ *
+ *  @remarks     When the filter function of the reader is running, the function
+ *               waits until it has returned (the filter parameter is no longer
+ *               used after this function has returned).
+ *
+ *  @param[in]   ring    - pointer to a ring instance
+ *  @param[in]   reader  - reader number (from ring_attach)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid ring instance)
+ *  @retval      EINVAL   - invalid argument (reader not attached)
+ */
+extern int ring_detach(ring_t ring, int reader);
+
+
+/** @brief       reads the next (accepted) element of a reader from the ring.
+ *
+ *  @param[in]   ring      - pointer to a ring instance
+ *  @param[in]   reader    - reader number (from ring_attach)
+ *  @param[out]  element   - pointer to a buffer for the data element
+ *  @param[in]   maxbytes  - size of the buffer (number of bytes)
+ *  @param[in]   timeout   - time to wait for an element (in [ms]):
+ *                            0 means the function returns immediately,
+ *                            65535 means blocking read, and any other
+ *                            value means the time to wait im milliseconds
+ *
+ *  @returns     number of data bytes read (with truncation), or a negative
+ *               value on error.
+ *
+ *  @retval      -30  - when no element was read from the ring
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT     - bad address (invalid ring instance)
+ *  @retval      EINVAL     - invalid argument (reader, element or maxbytes)
+ *  @retval      ENOMSG     - no element available (polling or signalled)
+ *  @retval      ETIMEDOUT  - time-out occurred (blocking read)
+ */
+extern int ring_get(ring_t ring, int reader, void *element, size_t maxbytes, uint16_t timeout);
+
+
+/** @brief       reads the next (accepted) element of a reader from the ring
+ *               (with a time-out in microseconds).
+ *
+ *  @param[in]   ring      - pointer to a ring instance
+ *  @param[in]   reader    - reader number (from ring_attach)
+ *  @param[out]  element   - pointer to a buffer for the data element
+ *  @param[in]   maxbytes  - size of the buffer (number of bytes)
+ *  @param[in]   timeout   - time to wait for an element (in [us]):
+ *                            0 means the function returns immediately,
+ *                            RING_INFINITE_US means blocking read, and any
+ *                            other value means the time to wait in [us]
+ *
+ *  @returns     number of data bytes read (with truncation), or a negative
+ *               value on error.
+ *
+ *  @retval      -30  - when no element was read from the ring
+ *
+ *  @note        The time-out is measured on a monotonic clock (if available),
+ *               it is not affected by adjustments of the system time. On
+ *               Windows it is rounded up to full milliseconds.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT     - bad address (invalid ring instance)
+ *  @retval      EINVAL     - invalid argument (reader, element or maxbytes)
+ *  @retval      ENOMSG     - no element available (polling or signalled)
+ *  @retval      ETIMEDOUT  - time-out occurred (blocking read)
+ */
+extern int ring_get_us(ring_t ring, int reader, void *element, size_t maxbytes, uint64_t timeout);
+
+
+/** @brief       retrieves the capacity of the ring, the high-water mark and
+ *               the overflow counter of a reader.
+ *
+ *  @param[in]   ring    - pointer to a ring instance
+ *  @param[in]   reader  - reader number (from ring_attach)
+ *  @param[out]  size    - number of elements in the ring (optional)
+ *  @param[out]  high    - maximum number of pending elements of the reader (optional)
+ *  @param[out]  lost    - number of elements lost by the reader (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid ring instance)
+ *  @retval      EINVAL   - invalid argument (reader not attached)
+ */
+extern int ring_status(ring_t ring, int reader, size_t *size, size_t *high, uint64_t *lost);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* RING_H_INCLUDED */
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
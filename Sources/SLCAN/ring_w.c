@@ -0,0 +1,485 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'ring'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        ring.c
+ *
+ *  @brief       Broadcast ring for intertask communication.
+ *
+ *  @remarks     Windows compatible variant (_WIN32 and _WIN64)
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @addtogroup  ring
+ *  @{
+ */
+#include "ring.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <Windows.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define MIN(x,y)  ((x) < (y) ? (x) : (y))
+
+#define ELEMENT(rng,pos)  (&(rng)->elements[((pos) % (rng)->size) * (rng)->elemSize])
+#define IS_READER(rng,rdr)  ((0 <= (rdr)) && ((rdr) < RING_MAX_READERS) && (rng)->readers[rdr].used)
+#define BUFFER(rng,rdr)  (&(rng)->buffers[(size_t)(rdr) * (rng)->elemSize])
+
+#define TO_USEC(ms)  (((ms) != 65535U) ? ((uint64_t)(ms) * 1000U) : UINT64_MAX)
+#define TO_MSEC(us)  (((us) != UINT64_MAX) ? (DWORD)MIN(((us) + 999U) / 1000U, (uint64_t)(INFINITE - 1U)) : INFINITE)
+
+#define ENTER_CRITICAL_SECTION(rng)  do { (void)WaitForSingleObject(rng->hMutex, INFINITE); } while(0)
+#define LEAVE_CRITICAL_SECTION(rng)  do { (void)ReleaseMutex(rng->hMutex); } while(0)
+
+#define SIGNAL_ALL_READERS(rng)  do { int i_; for (i_ = 0; i_ < RING_MAX_READERS; i_++) \
+                                          if (rng->readers[i_].used) (void)SetEvent(rng->hEvent[i_]); } while(0)
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef struct reader_t_ {
+    bool used;
+    bool busy;
+    bool detach;
+    uint64_t next;
+    uint64_t lost;
+    size_t high;
+    ring_filter_t filter;
+    const void *param;
+} reader_t;
+
+typedef struct object_t_ {
+    size_t size;
+    size_t elemSize;
+    uint8_t *elements;
+    uint8_t *buffers;
+    uint64_t head;
+    reader_t readers[RING_MAX_READERS];
+    uint64_t signals;
+    HANDLE hMutex;
+    HANDLE hEvent[RING_MAX_READERS];
+} object_t;
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static bool get_element(object_t *ring, int index, void *element, size_t maxbytes);
+static void close_handles(object_t *ring);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+ring_t ring_create(size_t numElem, size_t elemSize) {
+    object_t *object = (object_t*)NULL;
+    int i;
+
+    /* reset errno variable */
+    errno = 0;
+    /* sanity check */
+    if (!numElem || !elemSize) {
+        errno = EINVAL;
+        return NULL;
+    }
+    /* C language constructor */
+    if ((object = (object_t*)malloc(sizeof(object_t))) != NULL) {
+        (void)memset(object, 0x00, sizeof(object_t));
+        /* create a fixed size ring for data exchange */
+        if ((object->elements = (uint8_t*)calloc(numElem, elemSize)) == NULL) {
+            /* errno set */
+            free(object);
+            return NULL;
+        }
+        /* and one element per reader for its filter */
+        if ((object->buffers = (uint8_t*)calloc(RING_MAX_READERS, elemSize)) == NULL) {
+            /* errno set */
+            free(object->elements);
+            free(object);
+            return NULL;
+        }
+        object->elemSize = elemSize;
+        object->size = numElem;
+        object->head = 0U;
+        object->signals = 0U;
+        /* create a mutex and an event handle for each reader */
+        if ((object->hMutex = CreateMutex(
+            NULL,             // default security attributes
+            FALSE,            // initially not owned
+            NULL)) == NULL) {
+            errno = ENODEV;
+            free(object->buffers);
+            free(object->elements);
+            free(object);
+            return NULL;
+        }
+        for (i = 0; i < RING_MAX_READERS; i++) {
+            if ((object->hEvent[i] = CreateEvent(
+                NULL,             // default security attributes
+                FALSE,            // auto-reset event
+                FALSE,            // initial state is nonsignaled
+                NULL)) == NULL) {
+                errno = ENODEV;
+                close_handles(object);
+                free(object->buffers);
+                free(object->elements);
+                free(object);
+                return NULL;
+            }
+        }
+    }
+    return (ring_t)object;
+}
+
+int ring_destroy(ring_t ring) {
+    object_t *object = (object_t*)ring;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* destroy mutex and event handles */
+    close_handles(object);
+    /* C language destructor */
+    free(object->buffers);
+    free(object->elements);
+    free(object);
+    return 0;
+}
+
+int ring_signal(ring_t ring) {
+    object_t *object = (object_t*)ring;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* signal the event objects of all readers */
+    ENTER_CRITICAL_SECTION(object);
+    object->signals += 1U;
+    SIGNAL_ALL_READERS(object);
+    LEAVE_CRITICAL_SECTION(object);
+    return 0;
+}
+
+int ring_put(ring_t ring, const void *element, size_t nbytes) {
+    object_t *object = (object_t*)ring;
+    uint8_t *slot;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!element || !nbytes) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* write the element (the oldest one is overwritten) */
+    ENTER_CRITICAL_SECTION(object);
+    slot = ELEMENT(object, object->head);
+    memcpy(slot, element, MIN(object->elemSize, nbytes));
+    if (nbytes < object->elemSize)
+        memset(&slot[nbytes], 0x00, object->elemSize - nbytes);
+    object->head += 1U;
+    SIGNAL_ALL_READERS(object);
+    LEAVE_CRITICAL_SECTION(object);
+    return 0;
+}
+
+int ring_attach(ring_t ring, ring_filter_t filter, const void *param) {
+    object_t *object = (object_t*)ring;
+    int res = -1;
+    int i;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* take an unused reader (starting with the next element) */
+    ENTER_CRITICAL_SECTION(object);
+    for (i = 0; (i < RING_MAX_READERS) && (res < 0); i++) {
+        if (!object->readers[i].used) {
+            object->readers[i].used = true;
+            object->readers[i].next = object->head;
+            object->readers[i].lost = 0U;
+            object->readers[i].high = 0U;
+            object->readers[i].filter = filter;
+            object->readers[i].param = param;
+            (void)ResetEvent(object->hEvent[i]);
+            res = i;
+        }
+    }
+    LEAVE_CRITICAL_SECTION(object);
+    if (res < 0)
+        errno = EBUSY;
+    return res;
+}
+
+int ring_detach(ring_t ring, int reader) {
+    object_t *object = (object_t*)ring;
+    int res = -1;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* release the reader, if attached (and wake it up) */
+    ENTER_CRITICAL_SECTION(object);
+    if (IS_READER(object, reader)) {
+        /* note: wait until the filter of the reader has returned (if running) */
+        object->readers[reader].detach = true;
+        while (object->readers[reader].busy) {
+            LEAVE_CRITICAL_SECTION(object);
+            (void)SwitchToThread();
+            ENTER_CRITICAL_SECTION(object);
+        }
+        (void)memset(&object->readers[reader], 0x00, sizeof(reader_t));
+        (void)SetEvent(object->hEvent[reader]);
+        res = 0;
+    } else
+        errno = EINVAL;
+    LEAVE_CRITICAL_SECTION(object);
+    return res;
+}
+
+int ring_get(ring_t ring, int reader, void *element, size_t maxbytes, uint16_t timeout) {
+    /* note: 65535 [ms] means blocking read */
+    return ring_get_us(ring, reader, element, maxbytes, TO_USEC(timeout));
+}
+
+int ring_get_us(ring_t ring, int reader, void *element, size_t maxbytes, uint64_t timeout) {
+    object_t *object = (object_t*)ring;
+    DWORD msec = TO_MSEC(timeout);  /* note: rounded up to full milliseconds */
+    ULONGLONG deadline = GetTickCount64() + (ULONGLONG)msec;
+    ULONGLONG now;
+    uint64_t signals;
+    int res = -1;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!element || !maxbytes) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* read the next accepted element of the reader, if any */
+    ENTER_CRITICAL_SECTION(object);
+    if (!IS_READER(object, reader)) {
+        LEAVE_CRITICAL_SECTION(object);
+        errno = EINVAL;
+        return -1;
+    }
+    signals = object->signals;
+    while (res < 0) {
+        if (get_element(object, reader, element, maxbytes)) {
+            res = (int)MIN(object->elemSize, maxbytes);
+            break;
+        }
+        if (timeout == 0U) {  /* polling (timeout == 0) */
+            errno = ENOMSG;
+            res = -30;
+            break;
+        }
+        now = GetTickCount64();
+        if ((msec != INFINITE) && (now >= deadline)) {
+            errno = ETIMEDOUT;
+            res = -30;
+            break;
+        }
+        /* - wait for the next element (outside the critical section) */
+        LEAVE_CRITICAL_SECTION(object);
+        switch (WaitForSingleObject(object->hEvent[reader], (msec != INFINITE) ? (DWORD)(deadline - now) : INFINITE)) {
+        case WAIT_OBJECT_0:     /* event signalled */
+        case WAIT_TIMEOUT:      /* event timed out (checked above) */
+            break;
+        default:                /* error: no data! */
+            ENTER_CRITICAL_SECTION(object);
+            errno = ENOMSG;
+            res = -30;
+            continue;
+        }
+        ENTER_CRITICAL_SECTION(object);
+        /* - when signalled externally (e.g. by SIGINT) or detached */
+        if ((signals != object->signals) || !IS_READER(object, reader)) {
+            errno = ENOMSG;
+            res = -30;
+        }
+    }
+    LEAVE_CRITICAL_SECTION(object);
+    /* return number of bytes read, or negative value on error */
+    return res;
+}
+
+int ring_status(ring_t ring, int reader, size_t *size, size_t *high, uint64_t *lost) {
+    object_t *object = (object_t*)ring;
+    int res = -1;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* get the status of the reader, if attached */
+    ENTER_CRITICAL_SECTION(object);
+    if (IS_READER(object, reader)) {
+        if (size)
+            *size = object->size;
+        if (high)
+            *high = object->readers[reader].high;
+        if (lost)
+            *lost = object->readers[reader].lost;
+        res = 0;
+    } else
+        errno = EINVAL;
+    LEAVE_CRITICAL_SECTION(object);
+    return res;
+}
+
+/*  ---  RING  ---
+ *
+ *  size :  total number of elements
+ *  head :  number of elements written (the next element is written to
+ *          position head % size)
+ *  next :  number of the next element to be read by a reader
+ *
+ *  (§1) pending :  head - next
+ *  (§2) lost    :  head - next > size  (the oldest elements are overwritten)
+ */
+static bool get_element(object_t *ring, int index, void *element, size_t maxbytes) {
+    reader_t *reader = &ring->readers[index];
+    uint8_t *buffer = BUFFER(ring, index);
+    const uint8_t *slot;
+    uint64_t pending;
+    ring_filter_t filter;
+    const void *param;
+    bool accepted;
+
+    assert(ring);
+    assert(element);
+
+    while (!reader->detach && (reader->next < ring->head)) {
+        pending = ring->head - reader->next;
+        if (pending > (uint64_t)ring->size) {
+            /* the reader has been overtaken by the producer */
+            reader->lost += pending - (uint64_t)ring->size;
+            reader->next = ring->head - (uint64_t)ring->size;
+            pending = (uint64_t)ring->size;
+        }
+        if ((size_t)pending > reader->high)
+            reader->high = (size_t)pending;
+        slot = ELEMENT(ring, reader->next);
+        reader->next += 1U;
+        if (!reader->filter) {
+            memcpy(element, slot, MIN(ring->elemSize, maxbytes));
+            return true;
+        }
+        /* note: the filter is called outside of the critical section with a copy
+         *       of the element, so a slow filter does not block the producer */
+        memcpy(buffer, slot, ring->elemSize);
+        filter = reader->filter;
+        param = reader->param;
+        reader->busy = true;
+        LEAVE_CRITICAL_SECTION(ring);
+        accepted = filter((const void*)buffer, param);
+        ENTER_CRITICAL_SECTION(ring);
+        reader->busy = false;
+        if (accepted) {
+            memcpy(element, buffer, MIN(ring->elemSize, maxbytes));
+            return true;
+        }
+    }
+    return false;
+}
+
+static void close_handles(object_t *ring) {
+    int i;
+
+    assert(ring);
+
+    for (i = 0; i < RING_MAX_READERS; i++) {
+        if (ring->hEvent[i] != NULL)
+            (void)CloseHandle(ring->hEvent[i]);
+    }
+    if (ring->hMutex != NULL)
+        (void)CloseHandle(ring->hMutex);
+}
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -60,6 +60,7 @@
  */
 #include "serial.h"
 #include "logger.h"
+#include "eventlog.h"
 
 #include <string.h>
 #include <stdlib.h>
@@ -81,13 +82,13 @@
 #endif
 
 #if (OPTION_SERIAL_DEBUG_LEVEL > 0)
-#define SERIAL_DEBUG_ERROR(...)  log_printf(__VA_ARGS__)
+#define SERIAL_DEBUG_ERROR(...)  evlog_write(__VA_ARGS__)
 #else
 #define SERIAL_DEBUG_ERROR(...)  while (0)
 #endif
 
 #if (OPTION_SERIAL_DEBUG_LEVEL > 1)
-#define SERIAL_DEBUG_INFO(...)  log_printf(__VA_ARGS__)
+#define SERIAL_DEBUG_INFO(...)  evlog_write(__VA_ARGS__)
 #else
 #define SERIAL_DEBUG_INFO(...)  while (0)
 #endif
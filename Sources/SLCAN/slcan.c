@@ -89,28 +89,37 @@ static const char version[] = "SLCAN Protocol (Serial-Line CAN), Version %i.%i.%
 #include "slcan.h"
 #include "serial.h"
 #include "queue.h"
+#include "ring.h"
 #include "buffer.h"
+#include "poller.h"
 #include "timer.h"
 #include "logger.h"
+#include "eventlog.h"
+#include "atomics.h"
 
 #include <stdbool.h>
 #include <string.h>
 #include <stdlib.h>
 #include <errno.h>
 #include <assert.h>
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
 
 
 /*  -----------  options  ------------------------------------------------
  */
 
 #if (OPTION_SLCAN_DEBUG_LEVEL > 0)
-#define SLCAN_DEBUG_ERROR(...)  log_printf(__VA_ARGS__)
+#define SLCAN_DEBUG_ERROR(...)  evlog_write(__VA_ARGS__)
 #else
 #define SLCAN_DEBUG_ERROR(...)  while (0)
 #endif
 
 #if (OPTION_SLCAN_DEBUG_LEVEL > 1)
-#define SLCAN_DEBUG_INFO(...)  log_printf(__VA_ARGS__)
+#define SLCAN_DEBUG_INFO(...)  evlog_write(__VA_ARGS__)
 #else
 #define SLCAN_DEBUG_INFO(...)  while (0)
 #endif
@@ -155,16 +164,110 @@ static void _finalizer() {
 #define MAX_DLC(l)  (((l) < CAN_LEN_MAX) ? (l) : (CAN_DLC_MAX))
 
 #define BUFFER_SIZE 128U
+#define BATCH_SIZE  4U                  /* max. number of pipelined commands */
 #define RESPONSE_TIMEOUT  100U
 #define TRANSMIT_TIMEOUT  1000U
 
 #define PROTOCOL_LAWICEL  "Lawicel"
 #define PROTOCOL_CANABLE  "CANable"
 
+#define BUSLOAD_SLOTS  10U              /* sliding window: 10 slots */
+#define BUSLOAD_SLOT_TIME  100000U      /* of 100ms each (in [usec]) */
+#define CAN_CRC15_POLY  0x4599U         /* CRC-15/CAN polynomial */
+#define CAN_FRAME_TAIL  13U             /* CRC del. + ACK + EOF + IFS */
+
+#define XTD_ID_HASH(id)  (size_t)(((uint32_t)(id) * 2654435761U) >> 20)
+
+#define MAILBOX_STD_SLOTS  (CAN_STD_MASK + 1U)  /* one slot per 11-bit identifier */
+#define MAILBOX_XTD_SLOTS  4096U        /* hash table for 29-bit identifiers */
+
+#define REDUCTION_STD_SLOTS  (CAN_STD_MASK + 1U)  /* one slot per 11-bit identifier */
+#define REDUCTION_XTD_SLOTS  4096U      /* hash table for 29-bit identifiers */
+
+#define SUBSCRIBER_RING_SIZE  65536U    /* broadcast ring for subscribers */
+
+/* note: see 'atomics.h' for the mapping to GCC built-ins and MSVC intrinsics */
+#define SEQ_LOAD(ptr)  LOAD_ACQUIRE(ptr)
+#define SEQ_STORE(ptr,val)  STORE_RELEASE(ptr,val)
+#define SEQ_FENCE()  MEMORY_FENCE()
+#define SEQ_INC(ptr)  INCREMENT(ptr)
+#define SEQ_DEC(ptr)  DECREMENT(ptr)
+#define LOAD_HANDLER(ptr)  (slcan_trace_handler_t)LOAD_POINTER(ptr)
+#define STORE_HANDLER(ptr,val)  STORE_POINTER(ptr,val)
+#define LOAD_CAPTURE(ptr)  (slcan_capture_handler_t)LOAD_POINTER(ptr)
+#define STORE_CAPTURE(ptr,val)  STORE_POINTER(ptr,val)
+
+#if defined(_WIN32) || defined(_WIN64)
+#define INIT_COMMAND_LOCK(slcan)  InitializeSRWLock(&(slcan)->lock)
+#define FREE_COMMAND_LOCK(slcan)  while (0)
+#define LOCK_COMMAND(slcan)  AcquireSRWLockExclusive(&(slcan)->lock)
+#define UNLOCK_COMMAND(slcan)  ReleaseSRWLockExclusive(&(slcan)->lock)
+#define INIT_HANDLER_LOCK(slcan)  InitializeSRWLock(&(slcan)->handler_lock)
+#define FREE_HANDLER_LOCK(slcan)  while (0)
+#define LOCK_HANDLER(slcan)  AcquireSRWLockExclusive(&(slcan)->handler_lock)
+#define UNLOCK_HANDLER(slcan)  ReleaseSRWLockExclusive(&(slcan)->handler_lock)
+#define INIT_TABLES_ONCE()  (void)InitOnceExecuteOnce(&tables_once, init_tables_once, NULL, NULL)
+#else
+#define INIT_COMMAND_LOCK(slcan)  (void)pthread_mutex_init(&(slcan)->lock, NULL)
+#define FREE_COMMAND_LOCK(slcan)  (void)pthread_mutex_destroy(&(slcan)->lock)
+#define LOCK_COMMAND(slcan)  (void)pthread_mutex_lock(&(slcan)->lock)
+#define UNLOCK_COMMAND(slcan)  (void)pthread_mutex_unlock(&(slcan)->lock)
+#define INIT_HANDLER_LOCK(slcan)  (void)pthread_mutex_init(&(slcan)->handler_lock, NULL)
+#define FREE_HANDLER_LOCK(slcan)  (void)pthread_mutex_destroy(&(slcan)->handler_lock)
+#define LOCK_HANDLER(slcan)  (void)pthread_mutex_lock(&(slcan)->handler_lock)
+#define UNLOCK_HANDLER(slcan)  (void)pthread_mutex_unlock(&(slcan)->handler_lock)
+#define INIT_TABLES_ONCE()  (void)pthread_once(&tables_once, init_tables)
+#endif
+
+#define POLLED_VALID  0x100U            /* status flags of the last poll are valid */
+
+#define TO_USEC(ms)  (((ms) != CAN_INFINITE) ? ((uint64_t)(ms) * 1000U) : CAN_INFINITE_US)
+
 
 /*  -----------  types  --------------------------------------------------
  */
 
+typedef struct busload_t_ {             /* bus load (sliding window): */
+    uint32_t sequence;                  /* - sequence counter (odd while written) */
+    uint64_t slot[BUSLOAD_SLOTS];       /* - slot number (time / slot time) */
+    uint32_t bits[BUSLOAD_SLOTS];       /* - number of bits in the slot */
+} busload_t;
+
+typedef struct mailbox_slot_t_ {        /* mailbox slot (latest message): */
+    uint32_t sequence;                  /* - sequence counter (odd while written) */
+    uint32_t can_id;                    /* - identifier with XTD flag (0 = unused) */
+    slcan_message_t message;            /* - latest message */
+    struct timespec timestamp;          /* - time of reception */
+} mailbox_slot_t;
+
+typedef struct mailbox_t_ {             /* latest-value mailbox: */
+    mailbox_slot_t std[MAILBOX_STD_SLOTS];  /* - slots for 11-bit identifiers */
+    mailbox_slot_t xtd[MAILBOX_XTD_SLOTS];  /* - slots for 29-bit identifiers */
+} mailbox_t;
+
+typedef struct reduction_slot_t_ {      /* reduction slot (last forwarded message): */
+    bool used;                          /* - slot in use */
+    uint32_t can_id;                    /* - identifier with flags */
+    uint8_t can_dlc;                    /* - data length code */
+    uint8_t data[CAN_LEN_MAX];          /* - payload */
+    uint64_t next;                      /* - earliest time for the next message (in [usec]) */
+} reduction_slot_t;
+
+typedef struct reduction_t_ {           /* data reduction of received messages: */
+    uint8_t mode;                       /* - reduction mode (SLCAN_REDUCE_xyz) */
+    uint64_t period;                    /* - decimation period (in [usec]) */
+    uint64_t suppressed;                /* - number of suppressed messages */
+    reduction_slot_t std[REDUCTION_STD_SLOTS];  /* - slots for 11-bit identifiers */
+    reduction_slot_t xtd[REDUCTION_XTD_SLOTS];  /* - slots for 29-bit identifiers */
+} reduction_t;
+
+typedef struct batch_t_ {               /* pipelined commands: */
+    uint32_t pending;                   /* - number of expected responses (0 = off) */
+    uint32_t count;                     /* - number of collected responses */
+    size_t nbytes;                      /* - length of the collected responses */
+    uint8_t data[BUFFER_SIZE];          /* - collected responses (in order) */
+} batch_t;
+
 typedef struct slcan_t_ {               /* SLCAN communication instance: */
     sio_port_t port;                    /* - serial communication port */
     buffer_t response;                  /* - buffer for command response */
@@ -172,24 +275,79 @@ typedef struct slcan_t_ {               /* SLCAN communication instance: */
     uint8_t buffer[BUFFER_SIZE];        /* - receive buffer (reception loop) */
     size_t index;                       /* - write index of the receive buffer */
     bool ack;                           /* - ACK/NACK feedback enabled/disabled */
+    busload_t rx_load;                  /* - bus load of received messages */
+    busload_t tx_load;                  /* - bus load of sent messages */
+    mailbox_t *mailbox;                 /* - latest-value mailbox (optional) */
+    reduction_t *reduction;             /* - data reduction (optional) */
+    slcan_rx_handler_t rx_handler;      /* - reception handler (optional) */
+    void *rx_context;                   /* - context of the reception handler */
+    ring_t subscribers;                 /* - broadcast ring for subscribers (optional) */
+    slcan_filter_t *filters[RING_MAX_READERS];  /* - filters of the subscribers */
+    batch_t batch;                      /* - responses of pipelined commands */
+#if defined(_WIN32) || defined(_WIN64)
+    SRWLOCK lock;                       /* - one command at a time (request/response) */
+    SRWLOCK handler_lock;               /* - one change of the trace/capture handler at a time */
+#else
+    pthread_mutex_t lock;               /* - one command at a time (request/response) */
+    pthread_mutex_t handler_lock;       /* - one change of the trace/capture handler at a time */
+#endif
+    poller_t poller;                    /* - status polling thread (optional) */
+    uint32_t polled;                    /* - status flags of the last poll (or 0) */
+    uint8_t reported;                   /* - status flags passed to the status handler */
+    slcan_status_handler_t status_handler;  /* - status handler (optional) */
+    void *status_context;               /* - context of the status handler */
+    slcan_trace_handler_t trace_handler;  /* - trace handler (optional) */
+    void *trace_context;                /* - context of the trace handler */
+    uint32_t tracing;                   /* - reception thread in progress (trace) */
+    slcan_capture_handler_t capture_handler;  /* - capture handler (optional) */
+    void *capture_context;              /* - context of the capture handler */
+    uint32_t capturing;                 /* - sending threads in progress (capture) */
 } slcan_t;
 
 
 /*  -----------  prototypes  ---------------------------------------------
  */
 
+static int transmit(slcan_t *slcan, const uint8_t *buffer, size_t nbytes);
 static int send_command(slcan_t *slcan, const uint8_t *request, size_t nbytes,
                         uint8_t *response, size_t maxbytes, uint16_t timeout);
+static int send_batch(slcan_t *slcan, const uint8_t *request, size_t nbytes, uint32_t count,
+                      uint8_t *response, size_t maxbytes, uint16_t timeout);
+static void put_response(slcan_t *slcan);
+static void reset_reception(slcan_t *slcan);
+static int read_flags(slcan_t *slcan, slcan_flags_t *flags);
+static void poll_status(void *arg);
 static bool encode_message(const slcan_message_t *message, uint8_t *buffer, size_t *nbytes);
 static bool decode_message(slcan_message_t *message, const uint8_t *buffer, size_t nbytes);
 static void reception_loop(const void *port, const uint8_t *buffer, size_t nbytes);
 
 static int wait_for_bytes_sent(slcan_t *slcan, int nbytes);  // for CANable devices only
 
+static void init_tables(void);
+#if defined(_WIN32) || defined(_WIN64)
+static BOOL CALLBACK init_tables_once(PINIT_ONCE once, PVOID param, PVOID *context);
+#endif
+static uint32_t frame_bits(const slcan_message_t *message);
+static void update_load(busload_t *load, const slcan_message_t *message);
+static uint64_t sum_load(const busload_t *load, uint64_t slot);
+
+static mailbox_slot_t *find_slot(mailbox_t *mailbox, uint32_t can_id, bool claim);
+static void update_mailbox(mailbox_t *mailbox, const slcan_message_t *message);
+static bool forward_message(reduction_t *reduction, const slcan_message_t *message);
+static bool accept_message(const void *element, const void *param);
+
 
 /*  -----------  variables  ----------------------------------------------
  */
 
+static uint8_t stuff_table[10][256];    /* stuff bits: (state, byte) => (count << 4 | state) */
+static uint16_t crc15_table[256];       /* CRC-15/CAN: byte-wise lookup table */
+#if defined(_WIN32) || defined(_WIN64)
+static INIT_ONCE tables_once = INIT_ONCE_STATIC_INIT;  /* lookup tables initialized */
+#else
+static pthread_once_t tables_once = PTHREAD_ONCE_INIT;  /* lookup tables initialized */
+#endif
+
 
 /*  -----------  functions  ----------------------------------------------
  */
@@ -218,6 +376,8 @@ slcan_port_t slcan_create(size_t queueSize) {
 
     /* reset errno variable */
     errno = 0;
+    /* lookup tables for bus load calculation (once per process) */
+    INIT_TABLES_ONCE();
     /* C language constructor */
     if ((slcan = (slcan_t*)malloc(sizeof(slcan_t))) != NULL) {
         (void)memset(slcan, 0x00, sizeof(slcan_t));
@@ -249,6 +409,9 @@ slcan_port_t slcan_create(size_t queueSize) {
         slcan->index = 0U;
         /* enable ACK/NACK feedback */
         slcan->ack = true;
+        /* one command at a time */
+        INIT_COMMAND_LOCK(slcan);
+        INIT_HANDLER_LOCK(slcan);
     }
     /* return a pointer to the instance */
     return (slcan_port_t)slcan;
@@ -267,6 +430,9 @@ int slcan_destroy(slcan_port_t port) {
     }
     /* close opened port (if any) and */
     (void)slcan_disconnect(port);
+    /* stop the status polling (if any) */
+    if (slcan->poller)
+        (void)poller_destroy(slcan->poller);
     /* destroy serial port instance */
     if (slcan->port)
         (void)sio_destroy(slcan->port);
@@ -274,6 +440,18 @@ int slcan_destroy(slcan_port_t port) {
         (void)buffer_destroy(slcan->response);
     if (slcan->messages)
         (void)queue_destroy(slcan->messages);
+    if (slcan->mailbox)
+        free(slcan->mailbox);
+    if (slcan->reduction)
+        free(slcan->reduction);
+    if (slcan->subscribers)
+        (void)ring_destroy(slcan->subscribers);
+    for (int i = 0; i < RING_MAX_READERS; i++) {
+        if (slcan->filters[i])
+            free(slcan->filters[i]);
+    }
+    FREE_HANDLER_LOCK(slcan);
+    FREE_COMMAND_LOCK(slcan);
     /* C language destructor */
     free(slcan);
     return 0;
@@ -296,6 +474,8 @@ int slcan_signal(slcan_port_t port) {
         (void)buffer_signal(slcan->response);
     if (slcan->messages)
         (void)queue_signal(slcan->messages);
+    if (slcan->subscribers)
+        (void)ring_signal(slcan->subscribers);
     SLCAN_DEBUG_INFO("slcan_signal\n");
     return 0;
 }
@@ -340,6 +520,13 @@ int slcan_disconnect(slcan_port_t port) {
         errno = ENODEV;
         return -1;
     }
+    /* stop the status polling (if any) */
+    if (slcan->poller) {
+        if (poller_destroy(slcan->poller) < 0)
+            return -1;
+        slcan->poller = NULL;
+        SEQ_STORE(&slcan->polled, 0U);
+    }
     /* disconnect from serial port */
     (void)slcan_close_channel(port);
     return sio_disconnect(slcan->port);
@@ -425,7 +612,7 @@ int slcan_setup_bitrate(slcan_port_t port, uint8_t index) {
         }
     } else {
         /* CANable SLCAN protocol (w/o ACK/NACK feaadback) */
-        res = sio_transmit(slcan->port, request, 3);
+        res = transmit(slcan, request, 3);
         /* note: Variable 'errno' is set by the called functions according to
          *       their result. On error they return a negative value.
          *       When a wrong number of bytes has been transmitted this will
@@ -500,8 +687,8 @@ int slcan_open_channel(slcan_port_t port) {
         errno = ENODEV;
         return -1;
     }
-    /* clear the message queue */
-    (void)queue_clear(slcan->messages);  // FIXME: (?)
+    /* clear the message queue, etc. */
+    reset_reception(slcan);
     /* send command 'Open the CAN channel' */
     if (slcan->ack) {
         /* Lawicel SLCAN protocol (with ACK/NACK feaadback) */
@@ -520,7 +707,7 @@ int slcan_open_channel(slcan_port_t port) {
         }
     } else {
         /* CANable SLCAN protocol (w/o ACK/NACK feaadback) */
-        res = sio_transmit(slcan->port, request, 2);
+        res = transmit(slcan, request, 2);
         /* note: Variable 'errno' is set by the called functions according to
          *       their result. On error they return a negative value.
          *       When a wrong number of bytes has been transmitted this will
@@ -567,7 +754,7 @@ int slcan_close_channel(slcan_port_t port) {
         }
     } else {
         /* CANable SLCAN protocol (w/o ACK/NACK feaadback) */
-        res = sio_transmit(slcan->port, request, 2);
+        res = transmit(slcan, request, 2);
         /* note: Variable 'errno' is set by the called functions according to
          *       their result. On error they return a negative value.
          *       When a wrong number of bytes has been transmitted this will
@@ -582,6 +769,106 @@ int slcan_close_channel(slcan_port_t port) {
     return res;
 }
 
+EXPORT
+int slcan_start_channel(slcan_port_t port, const slcan_setup_t *setup) {
+    slcan_t *slcan = (slcan_t*)port;
+    uint8_t request[6 + 10 + 10 + 2];
+    uint8_t response[BATCH_SIZE];
+    size_t length = 0U;
+    uint32_t count = 0U;
+    int nbytes;
+    int res = -1;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->port) {
+        errno = ENODEV;
+        return -1;
+    }
+    if (!setup || (!setup->use_btr && (setup->index > 8))) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!slcan->ack && (setup->use_btr || setup->filter)) {
+        /* note: These commands are not supported by the CANable SLCAN protocol.
+         *       A protocol error (EBADMSG) will be returned in this case.
+         */
+        errno = EBADMSG;
+        return -1;
+    }
+    /* command 'Setup with standard CAN bit-rates' or 'Setup with BTR0/BTR1' */
+    if (!setup->use_btr) {
+        request[length++] = 'S';
+        request[length++] = '0' + setup->index;
+    } else {
+        request[length++] = 's';
+        request[length++] = BCD2CHR(setup->btr >> 12);
+        request[length++] = BCD2CHR(setup->btr >> 8);
+        request[length++] = BCD2CHR(setup->btr >> 4);
+        request[length++] = BCD2CHR(setup->btr >> 0);
+    }
+    request[length++] = '\r';
+    count++;
+    /* commands 'Sets Acceptance Code Register' and 'Sets Acceptance Mask Register' */
+    if (setup->filter) {
+        request[length++] = 'M';
+        for (int shift = 28; shift >= 0; shift -= 4)
+            request[length++] = BCD2CHR(setup->code >> shift);
+        request[length++] = '\r';
+        request[length++] = 'm';
+        for (int shift = 28; shift >= 0; shift -= 4)
+            request[length++] = BCD2CHR(setup->mask >> shift);
+        request[length++] = '\r';
+        count += 2U;
+    }
+    /* command 'Open the CAN channel' */
+    request[length++] = 'O';
+    request[length++] = '\r';
+    count++;
+    /* clear the message queue, etc. */
+    reset_reception(slcan);
+    /* send all commands at once */
+    if (slcan->ack) {
+        /* Lawicel SLCAN protocol (with ACK/NACK feaadback) */
+        nbytes = send_batch(slcan, request, length, count, response, BATCH_SIZE, RESPONSE_TIMEOUT * count);
+        if ((nbytes == (int)count) && !memcmp(response, "\r\r\r\r", (size_t)nbytes)) {
+            res = 0;
+        }
+        else if (nbytes >= 0) {
+            /* note: Each command must be acknowledged by [CR]. A negative
+             *       acknowledge [BEL] of any command or a wrong number of bytes
+             *       will be interpreted as protocol error (EBADMSG).
+             */
+            errno = EBADMSG;
+            res = -1;
+        }
+        if (res < 0) {
+            /* note: The 'Open' command has been sent anyway; make sure that
+             *       the CAN channel is closed (errno is preserved).
+             */
+            int error = errno;
+            (void)slcan_close_channel(port);
+            errno = error;
+        }
+    } else {
+        /* CANable SLCAN protocol (w/o ACK/NACK feaadback) */
+        res = transmit(slcan, request, length);
+        /* note: Variable 'errno' is set by the called functions according to
+         *       their result. On error they return a negative value.
+         *       When a wrong number of bytes has been transmitted this will
+         *       be interpreted as the sender or the receiver is busy (EBUSY).
+         */
+        if (res != (int)length) {
+            errno = EBUSY;
+            res = -1;
+        } else {
+            res = 0;
+        }
+    }
+    SLCAN_DEBUG_INFO("slcan_start_channel (%i)\n", res);
+    return res;
+}
+
 EXPORT
 int slcan_write_message(slcan_port_t port, const slcan_message_t *message, uint16_t timeout) {
     slcan_t *slcan = (slcan_t*)port;
@@ -589,7 +876,6 @@ int slcan_write_message(slcan_port_t port, const slcan_message_t *message, uint1
     size_t length;
     int nbytes;
     int res = -1;
-    (void)timeout;
 
     /* sanity check */
     errno = 0;
@@ -601,21 +887,28 @@ int slcan_write_message(slcan_port_t port, const slcan_message_t *message, uint1
         errno = EINVAL;
         return -1;
     }
+    /* note: the device has to acknowledge the message, so there is no
+     *       "return immediately" (0 means the default time-out instead)
+     */
+    if (timeout == 0U)
+        timeout = TRANSMIT_TIMEOUT;
     /* encode the CAN message */
     if (!encode_message(message, buffer, &length)) {
         errno = EFAULT;
         return -99;
     }
+    /* note: the response buffer is shared by all commands */
+    LOCK_COMMAND(slcan);
     /* clear pending response, if any */
     (void)buffer_clear(slcan->response);
     /* send CAN message to the device via serial port */
-    nbytes = sio_transmit(slcan->port, buffer, length);
+    nbytes = transmit(slcan, buffer, length);
     if (nbytes == (int)length) {
         if (slcan->ack) {
             /* Lawicel SLCAN protocol (with ACK/NACK feaadback) */
             uint8_t response[2];
             /* wait for response in the reception buffer */
-            nbytes = buffer_get(slcan->response, (void*)response, 2, TRANSMIT_TIMEOUT);
+            nbytes = buffer_get(slcan->response, (void*)response, 2, timeout);
             if ((nbytes == 2) && (response[1] == '\r') &&
                 ((((response[0] == 'z') && ((buffer[0] == 't') || (buffer[0] == 'r')))) ||
                     (((response[0] == 'Z') && ((buffer[0] == 'T') || (buffer[0] == 'R')))))) {
@@ -638,6 +931,14 @@ int slcan_write_message(slcan_port_t port, const slcan_message_t *message, uint1
              */
             res = wait_for_bytes_sent(slcan, nbytes);
         }
+        /* count the bits of the sent message (bus load) */
+        if (res == 0)
+            update_load(&slcan->tx_load, message);
+        /* trace the sent message (note: the command lock is held) */
+        if ((res == 0) && LOAD_HANDLER(&slcan->trace_handler)) {
+            struct timespec timestamp = timer_get_time();
+            slcan->trace_handler(message, &timestamp, true, slcan->trace_context);
+        }
     } else if (nbytes >= 0) {
         /* note: Variable 'errno' is set by the called functions according to
          *       their result. On error they return a negative value.
@@ -647,12 +948,18 @@ int slcan_write_message(slcan_port_t port, const slcan_message_t *message, uint1
         errno = EBUSY;
         res = -1;
     }
+    UNLOCK_COMMAND(slcan);
     SLCAN_DEBUG_INFO("slcan_write_message (%i)\n", res);
     return res;
 }
 
 EXPORT
 int slcan_read_message(slcan_port_t port, slcan_message_t *message, uint16_t timeout) {
+    return slcan_read_message_us(port, message, TO_USEC(timeout));
+}
+
+EXPORT
+int slcan_read_message_us(slcan_port_t port, slcan_message_t *message, uint64_t timeout) {
     slcan_t *slcan = (slcan_t*)port;
     int res;
 
@@ -667,7 +974,7 @@ int slcan_read_message(slcan_port_t port, slcan_message_t *message, uint16_t tim
         return -1;
     }
     /* get one message from the message queue, if any */
-    res = queue_dequeue(slcan->messages, (void*)message, sizeof(slcan_message_t), timeout);
+    res = queue_dequeue_us(slcan->messages, (void*)message, sizeof(slcan_message_t), timeout);
     if (res == (int)sizeof(slcan_message_t)) {
         /* note: On success value 0 will be returned (CAN API compatible).
          *       In case of a queue overflow variable 'errno' will be set.
@@ -693,9 +1000,7 @@ int slcan_read_message(slcan_port_t port, slcan_message_t *message, uint16_t tim
 EXPORT
 int slcan_status_flags(slcan_port_t port, slcan_flags_t *flags) {
     slcan_t *slcan = (slcan_t*)port;
-    uint8_t request[2] = {'F','\r'};
-    uint8_t response[4];
-    int nbytes;
+    uint32_t polled;
     int res = -1;
 
     /* sanity check */
@@ -704,43 +1009,54 @@ int slcan_status_flags(slcan_port_t port, slcan_flags_t *flags) {
         errno = ENODEV;
         return -1;
     }
-    /* send command 'Read Status Flags' */
-    if (slcan->ack) {
-        /* Lawicel SLCAN protocol (with ACK/NACK feaadback) */
-        nbytes = send_command(slcan, request, 2, response, 4, RESPONSE_TIMEOUT);
-        if ((nbytes == 4) && (response[0] == 'F') && (response[3] == '\r')) {
-            if (flags) {
-                flags->byte = (uint8_t)(CHR2BCD(response[1]) << 4);
-                flags->byte |= (uint8_t)CHR2BCD(response[2]);
-            }
-            res = 0;
-        }
-        else if (nbytes >= 0) {
-            /* note: Variable 'errno' is set by the called functions according
-             *       to their result. On error they return a negative value.
-             *       Receiving a wrong number of bytes will be interpreted as
-             *       protocol error (EBADMSG).
-             */
-            errno = EBADMSG;
-            res = -1;
-        }
-    } else {
-        /* note: This command is not supported by the CANable SLCAN protocol.
-         *       A protocol error (EBADMSG) will be returned in this case.
-         */
-#if (OPTION_SLCAN_FAKE_COMMANDS != 0)
+    /* status flags of the last poll (if any) */
+    polled = SEQ_LOAD(&slcan->polled);
+    if (polled & POLLED_VALID) {
         if (flags)
-            flags->byte = 0x00U;
+            flags->byte = (uint8_t)polled;
         res = 0;
-#else
-        errno = EBADMSG;
-        res = -1;
-#endif
+    } else {
+        /* read the status flags from the device */
+        res = read_flags(slcan, flags);
     }
     SLCAN_DEBUG_INFO("slcan_status_flags (%i)\n", res);
     return res;
 }
 
+EXPORT
+int slcan_status_polling(slcan_port_t port, uint16_t interval, slcan_status_handler_t handler, void *context) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->port) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* note: The CANable SLCAN protocol has no command 'Read Status Flags'. */
+    if (!slcan->ack && interval) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    /* stop the running poller (if any) */
+    if (slcan->poller) {
+        if (poller_destroy(slcan->poller) < 0)
+            return -1;
+        slcan->poller = NULL;
+        SEQ_STORE(&slcan->polled, 0U);
+    }
+    /* start a new poller with the given interval */
+    if (interval) {
+        slcan->status_handler = handler;
+        slcan->status_context = context;
+        slcan->reported = 0x00U;
+        if ((slcan->poller = poller_create(poll_status, (void*)slcan, (uint32_t)interval)) == NULL)
+            return -1;
+    }
+    SLCAN_DEBUG_INFO("slcan_status_polling (%u)\n", interval);
+    return 0;
+}
+
 EXPORT
 int slcan_acceptance_code(slcan_port_t port, uint32_t code) {
     slcan_t *slcan = (slcan_t*)port;
@@ -900,6 +1216,70 @@ int slcan_version_number(slcan_port_t port, uint8_t *hardware, uint8_t *software
 
 }
 
+EXPORT
+int slcan_probe_device(slcan_port_t port, slcan_identity_t *identity) {
+    slcan_t *slcan = (slcan_t*)port;
+    uint8_t request[6] = {'V','\r','N','\r','C','\r'};
+    uint8_t response[16];
+    int nbytes;
+    int res = -1;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->port) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* send commands 'Get Version number', 'Get Serial number' and 'Close the CAN channel' at once */
+    if (slcan->ack) {
+        /* Lawicel SLCAN protocol (with ACK/NACK feaadback) */
+        nbytes = send_batch(slcan, request, 6, 3U, response, 16, RESPONSE_TIMEOUT * 3U);
+        /* note: the 'Get Serial number' command is answered with [BEL] when
+         *       not supported; the 'Close' command is answered with [CR] or
+         *       with [BEL] when the CAN channel is already closed (all fine)
+         */
+        if (((nbytes == 13) && (response[6] == 'N') && (response[11] == '\r')) ||
+            ((nbytes == 8) && (response[6] == '\a'))) {
+            if ((response[0] == 'V') && (response[5] == '\r') &&
+                ((response[nbytes - 1] == '\r') || (response[nbytes - 1] == '\a'))) {
+                if (identity) {
+                    identity->hardware = (uint8_t)(CHR2BCD(response[1]) << 4);
+                    identity->hardware |= (uint8_t)CHR2BCD(response[2]);
+                    identity->software = (uint8_t)(CHR2BCD(response[3]) << 4);
+                    identity->software |= (uint8_t)CHR2BCD(response[4]);
+                    identity->has_serial = (nbytes == 13) ? true : false;
+                    identity->serial = 0U;
+                    if (identity->has_serial) {
+                        /* note: same encoding as 'slcan_serial_number' */
+                        identity->serial = (uint32_t)(response[6] << 24);
+                        identity->serial |= (uint32_t)(response[7] << 16);
+                        identity->serial |= (uint32_t)(response[8] << 8);
+                        identity->serial |= (uint32_t)response[9];
+                    }
+                }
+                res = 0;
+            }
+        }
+        if ((res < 0) && (nbytes >= 0)) {
+            /* note: Variable 'errno' is set by the called functions according
+             *       to their result. On error they return a negative value.
+             *       Receiving a wrong number of bytes will be interpreted as
+             *       protocol error (EBADMSG).
+             */
+            errno = EBADMSG;
+            res = -1;
+        }
+    } else {
+        /* note: The version number is not supported by the CANable SLCAN
+         *       protocol. A protocol error (EBADMSG) will be returned.
+         */
+        errno = EBADMSG;
+        res = -1;
+    }
+    SLCAN_DEBUG_INFO("slcan_probe_device (%i)\n", res);
+    return res;
+}
+
 EXPORT
 int slcan_serial_number(slcan_port_t port, uint32_t *number) {
     slcan_t *slcan = (slcan_t*)port;
@@ -948,87 +1328,739 @@ int slcan_serial_number(slcan_port_t port, uint32_t *number) {
 }
 
 EXPORT
-char *slcan_api_version(uint16_t *version_no, uint8_t *patch_no, uint32_t *build_no) {
-    static char str[100 + 1] = "Try to relaxe and enjoy the crisis.";
-    const char svn[17 + 1] = "$Rev: 823 $";
-    unsigned rev = 0u;
-
-    /* determine pseudo build no. from SVN revision */
-    if (sscanf(svn, "$Rev: %u", &rev) != 1)
-        rev = 99u;
-
-    /* numerical version information are optional */
-    if (version_no)
-        *version_no = ((uint16_t)VERSION_MAJOR << 8) | (uint16_t)VERSION_MINOR;
-    if (patch_no)
-        *patch_no = (uint8_t)VERSION_PATCH;
-    if (build_no)
-        *build_no = (uint32_t)rev;
-
-    /* return the version as zero-terminated string */
-#if (VERSION_PATCH != 0)
-    snprintf(str, 100, version, VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH, rev);
-#else
-    snprintf(str, 100, version, VERSION_MAJOR, VERSION_MINOR, rev);
-#endif
-    str[100] = '\0';
-    SLCAN_DEBUG_INFO("slcan_api_version (%s)\n", str);
-    return (char*)str;
-}
-
-static int send_command(slcan_t *slcan, const uint8_t *request, size_t nbytes,
-                        uint8_t *response, size_t maxbytes, uint16_t timeout) {
-    int res;
-
-    assert(slcan);
-    assert(request);
-    assert(response);
+int slcan_bus_load(slcan_port_t port, uint32_t bitrate, uint16_t *load) {
+    slcan_t *slcan = (slcan_t*)port;
+    struct timespec now;
+    uint64_t slot;
+    uint64_t bits;
+    uint64_t value;
 
-    /* clear pending response, if any */
-    (void)buffer_clear(slcan->response);
-    /* send request to the device via serial port */
-    res = sio_transmit(slcan->port, request, nbytes);
-    if (res == (int)nbytes) {
-        /* wait for response in the reception buffer */
-        res = buffer_get(slcan->response, (void*)response, maxbytes, timeout);
-        /* note: Interpretation of the received data shall be done by the
-         *       caller (e.g. EBADMSG).
-         */
-    } else if (res >= 0) {
-        /* note: Variable 'errno' is set by the called functions according to
-         *       their result. On error they return a negative value.
-         *       When a wrong number of bytes has been transmitted this will
-         *       be interpreted as the sender or the receiver is busy (EBUSY).
-         */
-        errno = EBUSY;
-        res = -1;
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
     }
-    /* return number of received bytes, or a negative value on error */
-    return res;
+    if (!bitrate || !load) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* note: The slot currently filled is not complete. Only the bits of the
+     *       preceding slots of the sliding window are taken into account.
+     */
+    now = timer_get_time();
+    slot = (((uint64_t)now.tv_sec * 1000000U) + ((uint64_t)now.tv_nsec / 1000U)) / BUSLOAD_SLOT_TIME;
+    bits = sum_load(&slcan->rx_load, slot) + sum_load(&slcan->tx_load, slot);
+    /* bus load in [1/100 percent]: bits * 100.00% / (bit-rate * window) */
+    value = (bits * 10000U * 1000000U) / ((uint64_t)bitrate * (uint64_t)((BUSLOAD_SLOTS - 1U) * BUSLOAD_SLOT_TIME));
+    *load = (uint16_t)((value < 10000U) ? value : 10000U);
+    return 0;
 }
 
-static int wait_for_bytes_sent(slcan_t *slcan, int nbytes) {
-    int baud = 57600; /* baud rate (in [bps]) */
-    sio_attr_t attr;
-
-    assert(slcan);
-    assert(nbytes >= 0);
-
-    /* get the baud rate from serial device */
-    if ((sio_get_attr(slcan->port, &attr) >= 0) && (attr.baudrate != 0U))
-        baud = (int)attr.baudrate;
+EXPORT
+int slcan_mailbox(slcan_port_t port, bool enable) {
+    slcan_t *slcan = (slcan_t*)port;
 
-    /* wait until all data bytes has been certainly sent */
-    /* note: transmission time for one byte is:
-     *
-     *       tByte = (1sec / baud rate) * (1 + bits per byte + 1)
-     */
+    /* sanity check */
     errno = 0;
-    return timer_delay((timer_val_t)((10000000 / baud) * nbytes));
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* note: The mailbox must not be changed while the reception thread
+     *       receives messages (i.e. while the CAN channel is open).
+     */
+    if (enable && !slcan->mailbox) {
+        if ((slcan->mailbox = (mailbox_t*)calloc(1U, sizeof(mailbox_t))) == NULL) {
+            /* errno set */
+            return -1;
+        }
+    } else if (!enable && slcan->mailbox) {
+        free(slcan->mailbox);
+        slcan->mailbox = NULL;
+    }
+    SLCAN_DEBUG_INFO("slcan_mailbox (%i)\n", enable);
+    return 0;
 }
 
-static bool encode_message(const slcan_message_t *message, uint8_t *buffer, size_t *nbytes) {
-    size_t index = 0;
+EXPORT
+int slcan_read_latest(slcan_port_t port, uint32_t can_id, slcan_message_t *message, struct timespec *timestamp, uint32_t *counter) {
+    slcan_t *slcan = (slcan_t*)port;
+    mailbox_slot_t *slot;
+    mailbox_slot_t copy;
+    uint32_t sequence;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    if (!message || ((can_id & ~(CAN_XTD_FRAME | CAN_XTD_MASK)) != 0U) ||
+        (!(can_id & CAN_XTD_FRAME) && (can_id > CAN_STD_MASK))) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!slcan->mailbox) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    /* look up the slot of the identifier (O(1)) */
+    if ((slot = find_slot(slcan->mailbox, can_id, false)) == NULL) {
+        errno = ENOMSG;
+        return -30;
+    }
+    /* read the slot consistently (seqlock): retry while it is written */
+    for (;;) {
+        sequence = SEQ_LOAD(&slot->sequence);
+        if (sequence & 1U)
+            continue;
+        SEQ_FENCE();
+        copy.message = slot->message;
+        copy.timestamp = slot->timestamp;
+        SEQ_FENCE();
+        if (SEQ_LOAD(&slot->sequence) == sequence)
+            break;
+    }
+    if (sequence == 0U) {
+        errno = ENOMSG;
+        return -30;
+    }
+    *message = copy.message;
+    if (timestamp)
+        *timestamp = copy.timestamp;
+    if (counter)
+        *counter = sequence / 2U;
+    return 0;
+}
+
+EXPORT
+int slcan_set_rx_handler(slcan_port_t port, slcan_rx_handler_t handler, void *context) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* note: The handler must not be changed while the reception thread
+     *       receives messages (i.e. while the CAN channel is open).
+     */
+    slcan->rx_handler = handler;
+    slcan->rx_context = handler ? context : NULL;
+    SLCAN_DEBUG_INFO("slcan_set_rx_handler (%s)\n", handler ? "on" : "off");
+    return 0;
+}
+
+EXPORT
+int slcan_set_trace_handler(slcan_port_t port, slcan_trace_handler_t handler, void *context) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* note: The handler is called by the reception thread and by the sending
+     *       threads. The former is waited for (its flag is set before it loads
+     *       the handler) without holding the command lock, because a reception
+     *       handler may send a message and would then wait for the command lock.
+     *       The latter call the handler with the command lock held, so they are
+     *       excluded by the command lock. The handler lock excludes a second setter.
+     */
+    LOCK_HANDLER(slcan);
+    STORE_HANDLER(&slcan->trace_handler, (slcan_trace_handler_t)NULL);
+    SEQ_FENCE();
+    while (SEQ_LOAD(&slcan->tracing))
+        (void)timer_delay(100U);
+    LOCK_COMMAND(slcan);
+    slcan->trace_context = context;
+    STORE_HANDLER(&slcan->trace_handler, handler);
+    UNLOCK_COMMAND(slcan);
+    UNLOCK_HANDLER(slcan);
+    SLCAN_DEBUG_INFO("slcan_set_trace_handler (%s)\n", handler ? "on" : "off");
+    return 0;
+}
+
+EXPORT
+int slcan_set_capture_handler(slcan_port_t port, slcan_capture_handler_t handler, void *context) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* note: The handler is called by the reception thread and by the sending
+     *       threads. Both are waited for (their flag or counter is set before
+     *       they load the handler) without holding the command lock, because
+     *       a reception handler may send a message and would then wait for it.
+     *       The handler lock excludes a second setter.
+     */
+    LOCK_HANDLER(slcan);
+    STORE_CAPTURE(&slcan->capture_handler, (slcan_capture_handler_t)NULL);
+    SEQ_FENCE();
+    while (SEQ_LOAD(&slcan->tracing) || SEQ_LOAD(&slcan->capturing))
+        (void)timer_delay(100U);
+    slcan->capture_context = context;
+    STORE_CAPTURE(&slcan->capture_handler, handler);
+    UNLOCK_HANDLER(slcan);
+    SLCAN_DEBUG_INFO("slcan_set_capture_handler (%s)\n", handler ? "on" : "off");
+    return 0;
+}
+
+EXPORT
+int slcan_reduction(slcan_port_t port, uint8_t mode, uint16_t rate) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    if ((mode & ~(SLCAN_REDUCE_CHANGE_ONLY | SLCAN_REDUCE_DECIMATE)) ||
+        ((mode & SLCAN_REDUCE_DECIMATE) && (rate == 0U))) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* note: The data reduction must not be changed while the reception
+     *       thread receives messages (i.e. while the CAN channel is open).
+     */
+    if ((mode != SLCAN_REDUCE_OFF) && !slcan->reduction) {
+        if ((slcan->reduction = (reduction_t*)calloc(1U, sizeof(reduction_t))) == NULL) {
+            /* errno set */
+            return -1;
+        }
+    } else if ((mode == SLCAN_REDUCE_OFF) && slcan->reduction) {
+        free(slcan->reduction);
+        slcan->reduction = NULL;
+    }
+    if (slcan->reduction) {
+        slcan->reduction->mode = mode;
+        slcan->reduction->period = (mode & SLCAN_REDUCE_DECIMATE) ? (1000000U / (uint64_t)rate) : 0U;
+    }
+    SLCAN_DEBUG_INFO("slcan_reduction (%u, %u)\n", mode, rate);
+    return 0;
+}
+
+EXPORT
+int slcan_reduced(slcan_port_t port, uint64_t *suppressed) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    if (!suppressed) {
+        errno = EINVAL;
+        return -1;
+    }
+    *suppressed = slcan->reduction ? slcan->reduction->suppressed : 0U;
+    return 0;
+}
+
+EXPORT
+int slcan_subscribe(slcan_port_t port, const slcan_filter_t *filter) {
+    slcan_t *slcan = (slcan_t*)port;
+    slcan_filter_t *copy = NULL;
+    ring_t ring;
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* create the broadcast ring on first subscription
+     * note: The ring is published to the reception thread after it has been
+     *       initialized, and it is not destroyed before the SLCAN instance.
+     */
+    if (!slcan->subscribers) {
+        if ((ring = ring_create(SUBSCRIBER_RING_SIZE, sizeof(slcan_message_t))) == NULL) {
+            /* errno set */
+            return -1;
+        }
+        SEQ_FENCE();
+        slcan->subscribers = ring;
+    }
+    /* the filter is copied (it must be valid as long as the subscriber) */
+    if (filter) {
+        if ((copy = (slcan_filter_t*)malloc(sizeof(slcan_filter_t))) == NULL) {
+            /* errno set */
+            return -1;
+        }
+        *copy = *filter;
+    }
+    if ((res = ring_attach(slcan->subscribers, accept_message, copy)) < 0) {
+        /* errno set */
+        if (copy)
+            free(copy);
+        return -1;
+    }
+    slcan->filters[res] = copy;
+    SLCAN_DEBUG_INFO("slcan_subscribe (%i)\n", res);
+    return res;
+}
+
+EXPORT
+int slcan_unsubscribe(slcan_port_t port, int subscriber) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    if (!slcan->subscribers || (ring_detach(slcan->subscribers, subscriber) < 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* note: the reader has been detached, its filter is no longer used */
+    if (slcan->filters[subscriber]) {
+        free(slcan->filters[subscriber]);
+        slcan->filters[subscriber] = NULL;
+    }
+    SLCAN_DEBUG_INFO("slcan_unsubscribe (%i)\n", subscriber);
+    return 0;
+}
+
+EXPORT
+int slcan_read_subscriber(slcan_port_t port, int subscriber, slcan_message_t *message, uint16_t timeout) {
+    return slcan_read_subscriber_us(port, subscriber, message, TO_USEC(timeout));
+}
+
+EXPORT
+int slcan_read_subscriber_us(slcan_port_t port, int subscriber, slcan_message_t *message, uint64_t timeout) {
+    slcan_t *slcan = (slcan_t*)port;
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    if (!slcan->subscribers || !message) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* get the next accepted message from the broadcast ring, if any */
+    res = ring_get_us(slcan->subscribers, subscriber, (void*)message, sizeof(slcan_message_t), timeout);
+    if (res == (int)sizeof(slcan_message_t)) {
+        res = 0;
+    } else if (res >= 0) {
+        errno = ENOMSG;
+        res = -30;
+    }
+    return res;
+}
+
+EXPORT
+int slcan_subscriber_status(slcan_port_t port, int subscriber, uint32_t *size, uint32_t *high, uint64_t *overflow) {
+    slcan_t *slcan = (slcan_t*)port;
+    size_t capacity = 0U;
+    size_t maximum = 0U;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    if (!slcan->subscribers || (ring_status(slcan->subscribers, subscriber, &capacity, &maximum, overflow) < 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (size)
+        *size = (uint32_t)capacity;
+    if (high)
+        *high = (uint32_t)maximum;
+    return 0;
+}
+
+EXPORT
+int slcan_queue_status(slcan_port_t port, uint32_t *size, uint32_t *high, uint64_t *overflow) {
+    slcan_t *slcan = (slcan_t*)port;
+    size_t capacity = 0U;
+    size_t maximum = 0U;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* get fill level statistics from the message queue */
+    if (queue_status(slcan->messages, &capacity, NULL, &maximum) < 0)
+        return -1;
+    if (overflow)
+        (void)queue_overflow(slcan->messages, overflow);
+    if (size)
+        *size = (uint32_t)capacity;
+    if (high)
+        *high = (uint32_t)maximum;
+    return 0;
+}
+
+EXPORT
+int slcan_queue_resize(slcan_port_t port, uint32_t size) {
+    slcan_t *slcan = (slcan_t*)port;
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    if (!size) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* resize the message queue (messages are discarded) */
+    res = queue_resize(slcan->messages, (size_t)size);
+    SLCAN_DEBUG_INFO("slcan_queue_resize (%i)\n", res);
+    return res;
+}
+
+EXPORT
+int slcan_queue_spill(slcan_port_t port, const char *folder, uint32_t size) {
+    slcan_t *slcan = (slcan_t*)port;
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* attach or detach a spill file (spilled messages are taken over) */
+    res = queue_spill(slcan->messages, folder, (size_t)size);
+    SLCAN_DEBUG_INFO("slcan_queue_spill (%i)\n", res);
+    return res;
+}
+
+EXPORT
+int slcan_queue_threshold(slcan_port_t port, uint32_t threshold) {
+    slcan_t *slcan = (slcan_t*)port;
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* set the spill threshold (effective with the next message) */
+    res = queue_threshold(slcan->messages, (size_t)threshold);
+    SLCAN_DEBUG_INFO("slcan_queue_threshold (%i)\n", res);
+    return res;
+}
+
+EXPORT
+int slcan_queue_policy(slcan_port_t port, uint8_t policy, uint16_t timeout) {
+    slcan_t *slcan = (slcan_t*)port;
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* set the overflow policy of the message queue */
+    switch (policy) {
+    case SLCAN_DROP_NEWEST: res = queue_policy(slcan->messages, QUEUE_DROP_NEWEST, 0U); break;
+    case SLCAN_DROP_OLDEST: res = queue_policy(slcan->messages, QUEUE_DROP_OLDEST, 0U); break;
+    case SLCAN_BOUNDED_BLOCK: res = queue_policy(slcan->messages, QUEUE_BOUNDED_BLOCK, timeout); break;
+    default: errno = EINVAL; res = -1; break;
+    }
+    SLCAN_DEBUG_INFO("slcan_queue_policy (%i)\n", res);
+    return res;
+}
+
+EXPORT
+int slcan_queue_drops(slcan_port_t port, uint64_t *newest, uint64_t *oldest, uint64_t *expired) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* get drop counters from the message queue */
+    return queue_drops(slcan->messages, newest, oldest, expired);
+}
+
+EXPORT
+char *slcan_api_version(uint16_t *version_no, uint8_t *patch_no, uint32_t *build_no) {
+    static char str[100 + 1] = "Try to relaxe and enjoy the crisis.";
+    const char svn[17 + 1] = "$Rev: 823 $";
+    unsigned rev = 0u;
+
+    /* determine pseudo build no. from SVN revision */
+    if (sscanf(svn, "$Rev: %u", &rev) != 1)
+        rev = 99u;
+
+    /* numerical version information are optional */
+    if (version_no)
+        *version_no = ((uint16_t)VERSION_MAJOR << 8) | (uint16_t)VERSION_MINOR;
+    if (patch_no)
+        *patch_no = (uint8_t)VERSION_PATCH;
+    if (build_no)
+        *build_no = (uint32_t)rev;
+
+    /* return the version as zero-terminated string */
+#if (VERSION_PATCH != 0)
+    snprintf(str, 100, version, VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH, rev);
+#else
+    snprintf(str, 100, version, VERSION_MAJOR, VERSION_MINOR, rev);
+#endif
+    str[100] = '\0';
+    SLCAN_DEBUG_INFO("slcan_api_version (%s)\n", str);
+    return (char*)str;
+}
+
+static int transmit(slcan_t *slcan, const uint8_t *buffer, size_t nbytes) {
+    slcan_capture_handler_t capture_handler;
+    struct timespec timestamp;
+    int res;
+
+    assert(slcan);
+    assert(buffer);
+
+    /* send the data to the device via serial port */
+    res = sio_transmit(slcan->port, buffer, nbytes);
+    /* capture the sent data (note: the capture handler must not be removed while it is called) */
+    if ((res > 0) && LOAD_CAPTURE(&slcan->capture_handler)) {
+        SEQ_INC(&slcan->capturing);
+        if ((capture_handler = LOAD_CAPTURE(&slcan->capture_handler)) != NULL) {
+            timestamp = timer_get_time();
+            capture_handler(buffer, (size_t)res, &timestamp, true, slcan->capture_context);
+        }
+        SEQ_DEC(&slcan->capturing);
+    }
+    return res;
+}
+
+static int send_command(slcan_t *slcan, const uint8_t *request, size_t nbytes,
+                        uint8_t *response, size_t maxbytes, uint16_t timeout) {
+    int res;
+
+    assert(slcan);
+    assert(request);
+    assert(response);
+
+    /* note: the response buffer is shared by all commands */
+    LOCK_COMMAND(slcan);
+    /* clear pending response, if any */
+    (void)buffer_clear(slcan->response);
+    /* send request to the device via serial port */
+    res = transmit(slcan, request, nbytes);
+    if (res == (int)nbytes) {
+        /* wait for response in the reception buffer */
+        res = buffer_get(slcan->response, (void*)response, maxbytes, timeout);
+        /* note: Interpretation of the received data shall be done by the
+         *       caller (e.g. EBADMSG).
+         */
+    } else if (res >= 0) {
+        /* note: Variable 'errno' is set by the called functions according to
+         *       their result. On error they return a negative value.
+         *       When a wrong number of bytes has been transmitted this will
+         *       be interpreted as the sender or the receiver is busy (EBUSY).
+         */
+        errno = EBUSY;
+        res = -1;
+    }
+    UNLOCK_COMMAND(slcan);
+    /* return number of received bytes, or a negative value on error */
+    return res;
+}
+
+static int send_batch(slcan_t *slcan, const uint8_t *request, size_t nbytes, uint32_t count,
+                      uint8_t *response, size_t maxbytes, uint16_t timeout) {
+    int res;
+
+    assert(slcan);
+    assert(request);
+    assert(response);
+    assert((0U < count) && (count <= BATCH_SIZE));
+
+    /* note: the response buffer is shared by all commands */
+    LOCK_COMMAND(slcan);
+    /* clear pending response, if any */
+    (void)buffer_clear(slcan->response);
+    /* the reception loop collects the next 'count' responses */
+    slcan->batch.count = 0U;
+    slcan->batch.nbytes = 0U;
+    SEQ_FENCE();
+    SEQ_STORE(&slcan->batch.pending, count);
+    SEQ_FENCE();
+    /* send all requests to the device at once */
+    res = transmit(slcan, request, nbytes);
+    if (res == (int)nbytes) {
+        /* wait for all responses in the reception buffer */
+        res = buffer_get(slcan->response, (void*)response, maxbytes, timeout);
+        /* note: Interpretation of the received data shall be done by the
+         *       caller (e.g. EBADMSG).
+         */
+    } else if (res >= 0) {
+        /* note: Variable 'errno' is set by the called functions according to
+         *       their result. On error they return a negative value.
+         *       When a wrong number of bytes has been transmitted this will
+         *       be interpreted as the sender or the receiver is busy (EBUSY).
+         */
+        errno = EBUSY;
+        res = -1;
+    }
+    /* back to single responses (e.g. on time-out) */
+    SEQ_STORE(&slcan->batch.pending, 0U);
+    SEQ_FENCE();
+    UNLOCK_COMMAND(slcan);
+    /* return number of received bytes, or a negative value on error */
+    return res;
+}
+
+static void put_response(slcan_t *slcan) {
+    batch_t *batch = &slcan->batch;
+    uint32_t pending = SEQ_LOAD(&batch->pending);
+
+    /* single command: pass the response to the waiting caller */
+    if (pending == 0U) {
+        (void)buffer_put(slcan->response, slcan->buffer, slcan->index);
+        return;
+    }
+    /* pipelined commands: collect the responses in order of arrival */
+    SEQ_FENCE();
+    if ((batch->nbytes + slcan->index) <= BUFFER_SIZE) {
+        (void)memcpy(&batch->data[batch->nbytes], slcan->buffer, slcan->index);
+        batch->nbytes += slcan->index;
+    }
+    if (++batch->count == pending) {
+        /* note: the batch is finished before the caller is woken up,
+         *       otherwise this could overwrite the caller's next batch
+         */
+        SEQ_STORE(&batch->pending, 0U);
+        SEQ_FENCE();
+        (void)buffer_put(slcan->response, batch->data, batch->nbytes);
+    }
+}
+
+static void reset_reception(slcan_t *slcan) {
+    assert(slcan);
+
+    /* clear the message queue */
+    (void)queue_clear(slcan->messages);  // FIXME: (?)
+    /* reset the bus load windows */
+    (void)memset(&slcan->rx_load, 0x00, sizeof(busload_t));
+    (void)memset(&slcan->tx_load, 0x00, sizeof(busload_t));
+    /* clear the mailbox (if any) */
+    if (slcan->mailbox)
+        (void)memset(slcan->mailbox, 0x00, sizeof(mailbox_t));
+    /* reset the data reduction (if any) */
+    if (slcan->reduction) {
+        slcan->reduction->suppressed = 0U;
+        (void)memset(slcan->reduction->std, 0x00, sizeof(slcan->reduction->std));
+        (void)memset(slcan->reduction->xtd, 0x00, sizeof(slcan->reduction->xtd));
+    }
+}
+
+static int read_flags(slcan_t *slcan, slcan_flags_t *flags) {
+    uint8_t request[2] = {'F','\r'};
+    uint8_t response[4];
+    int nbytes;
+    int res = -1;
+
+    assert(slcan);
+
+    /* send command 'Read Status Flags' */
+    if (slcan->ack) {
+        /* Lawicel SLCAN protocol (with ACK/NACK feaadback) */
+        nbytes = send_command(slcan, request, 2, response, 4, RESPONSE_TIMEOUT);
+        if ((nbytes == 4) && (response[0] == 'F') && (response[3] == '\r')) {
+            if (flags) {
+                flags->byte = (uint8_t)(CHR2BCD(response[1]) << 4);
+                flags->byte |= (uint8_t)CHR2BCD(response[2]);
+            }
+            res = 0;
+        }
+        else if (nbytes >= 0) {
+            /* note: Variable 'errno' is set by the called functions according
+             *       to their result. On error they return a negative value.
+             *       Receiving a wrong number of bytes will be interpreted as
+             *       protocol error (EBADMSG).
+             */
+            errno = EBADMSG;
+            res = -1;
+        }
+    } else {
+        /* note: This command is not supported by the CANable SLCAN protocol.
+         *       A protocol error (EBADMSG) will be returned in this case.
+         */
+#if (OPTION_SLCAN_FAKE_COMMANDS != 0)
+        if (flags)
+            flags->byte = 0x00U;
+        res = 0;
+#else
+        errno = EBADMSG;
+        res = -1;
+#endif
+    }
+    return res;
+}
+
+static void poll_status(void *arg) {
+    slcan_t *slcan = (slcan_t*)arg;
+    slcan_flags_t flags;
+
+    assert(slcan);
+
+    /* read the status flags from the device */
+    if (read_flags(slcan, &flags) < 0) {
+        /* note: the next call of 'slcan_status_flags' reports the error */
+        SEQ_STORE(&slcan->polled, 0U);
+        return;
+    }
+    SEQ_STORE(&slcan->polled, POLLED_VALID | (uint32_t)flags.byte);
+    /* notify a change of the status flags (if requested) */
+    if (flags.byte != slcan->reported) {
+        slcan->reported = flags.byte;
+        if (slcan->status_handler)
+            slcan->status_handler(flags, slcan->status_context);
+    }
+}
+
+static int wait_for_bytes_sent(slcan_t *slcan, int nbytes) {
+    int baud = 57600; /* baud rate (in [bps]) */
+    sio_attr_t attr;
+
+    assert(slcan);
+    assert(nbytes >= 0);
+
+    /* get the baud rate from serial device */
+    if ((sio_get_attr(slcan->port, &attr) >= 0) && (attr.baudrate != 0U))
+        baud = (int)attr.baudrate;
+
+    /* wait until all data bytes has been certainly sent */
+    /* note: transmission time for one byte is:
+     *
+     *       tByte = (1sec / baud rate) * (1 + bits per byte + 1)
+     */
+    errno = 0;
+    return timer_delay((timer_val_t)((10000000 / baud) * nbytes));
+}
+
+static bool encode_message(const slcan_message_t *message, uint8_t *buffer, size_t *nbytes) {
+    size_t index = 0;
 
     assert(message);
     assert(buffer);
@@ -1140,10 +2172,22 @@ static bool decode_message(slcan_message_t *message, const uint8_t *buffer, size
 static void reception_loop(const void *port, const uint8_t *buffer, size_t nbytes) {
     slcan_t *slcan = (slcan_t*)port;
     slcan_message_t message;
+    struct timespec timestamp;
+    slcan_trace_handler_t trace_handler;
+    slcan_capture_handler_t capture_handler;
 
     if (slcan && buffer) {
         assert(slcan->response);
         assert(slcan->messages);
+        /* note: the trace and the capture handler must not be removed while they are called */
+        SEQ_STORE(&slcan->tracing, 1U);
+        SEQ_FENCE();
+        trace_handler = LOAD_HANDLER(&slcan->trace_handler);
+        capture_handler = LOAD_CAPTURE(&slcan->capture_handler);
+        if (capture_handler) {
+            timestamp = timer_get_time();
+            capture_handler(buffer, nbytes, &timestamp, false, slcan->capture_context);
+        }
         for (size_t index = 0; index < nbytes; index++) {
             /* get next byte (asynchronous reception) */
             if ((slcan->index + 1) < BUFFER_SIZE)
@@ -1155,26 +2199,372 @@ static void reception_loop(const void *port, const uint8_t *buffer, size_t nbyte
                     /* message indication or confirmation? */
                     if (slcan->index > 2) {
                         /* new message received (indication) */
-                        if (decode_message(&message, slcan->buffer, slcan->index))
-                            (void)queue_enqueue(slcan->messages, &message, sizeof(slcan_message_t));
+                        if (decode_message(&message, slcan->buffer, slcan->index)) {
+                            if (trace_handler) {
+                                timestamp = timer_get_time();
+                                trace_handler(&message, &timestamp, false, slcan->trace_context);
+                            }
+                            if (!slcan->reduction || forward_message(slcan->reduction, &message)) {
+                                if (slcan->rx_handler) {
+                                    /* note: the handler replaces the message queue */
+                                    if (!trace_handler)
+                                        timestamp = timer_get_time();
+                                    slcan->rx_handler(&message, &timestamp, slcan->rx_context);
+                                } else
+                                    (void)queue_enqueue(slcan->messages, &message, sizeof(slcan_message_t));
+                                if (slcan->subscribers)
+                                    (void)ring_put(slcan->subscribers, &message, sizeof(slcan_message_t));
+                            }
+                            update_load(&slcan->rx_load, &message);
+                            if (slcan->mailbox)
+                                update_mailbox(slcan->mailbox, &message);
+                        }
                     } else {
                         /* confirmation of a sent message received */
                         (void)buffer_put(slcan->response, slcan->buffer, slcan->index);
                     }
                 } else {
                     /* response of a sent request received */
-                    (void)buffer_put(slcan->response, slcan->buffer, slcan->index);
+                    put_response(slcan);
                 }
                 /* done: reset reception buffer */
                 slcan->index = 0U;
             } else if (buffer[index] == '\a') {
                 /* Negative ACKnowledge [BEL] received */
-                (void)buffer_put(slcan->response, slcan->buffer, slcan->index);
+                put_response(slcan);
                 /* done: reset reception buffer */
                 slcan->index = 0U;
             }
         }
+        /* note: the handlers are no longer used (release) */
+        STORE_RELEASE(&slcan->tracing, 0U);
+    }
+}
+
+/*  ---  bus load  ---
+ *
+ *  The number of bits of a CAN 2.0 frame on the bus is calculated from the
+ *  frame fields SOF up to the CRC sequence (which are subject to bit stuffing)
+ *  plus 13 fixed bits (CRC delimiter, ACK slot and delimiter, EOF and IFS).
+ *
+ *  The stuff bits are counted byte-wise by a lookup table. The counting state
+ *  is the level of the last bit and its run length (1..5) before the byte,
+ *  i.e. state = level * 5 + (run - 1). A stuff bit of opposite level will be
+ *  inserted after five consecutive bits of equal level (the stuff bit counts
+ *  as the first bit of the next run).
+ */
+static void init_tables(void) {
+    uint16_t crc;
+    uint8_t entry;
+    int level, run, count;
+    int state, byte, i;
+
+    for (state = 0; state < 10; state++) {
+        for (byte = 0; byte < 256; byte++) {
+            level = state / 5;
+            run = (state % 5) + 1;
+            count = 0;
+            for (i = 7; i >= 0; i--) {
+                if (((byte >> i) & 1) == level) {
+                    run++;
+                } else {
+                    level = (byte >> i) & 1;
+                    run = 1;
+                }
+                if (run == 5) {
+                    level ^= 1;
+                    run = 1;
+                    count++;
+                }
+            }
+            entry = (uint8_t)((count << 4) | ((level * 5) + (run - 1)));
+            stuff_table[state][byte] = entry;
+        }
     }
+    for (byte = 0; byte < 256; byte++) {
+        crc = (uint16_t)(byte << 7);
+        for (i = 0; i < 8; i++) {
+            if (crc & 0x4000U)
+                crc = (uint16_t)((crc << 1) ^ CAN_CRC15_POLY);
+            else
+                crc = (uint16_t)(crc << 1);
+        }
+        crc15_table[byte] = (uint16_t)(crc & 0x7FFFU);
+    }
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+static BOOL CALLBACK init_tables_once(PINIT_ONCE once, PVOID param, PVOID *context) {
+    (void)once;
+    (void)param;
+    (void)context;
+
+    init_tables();
+    return TRUE;
+}
+#endif
+
+static uint32_t frame_bits(const slcan_message_t *message) {
+    uint8_t stream[16];                 /* frame bits from SOF to CRC (max. 118) */
+    size_t length = 0U;                 /* number of complete bytes */
+    uint64_t accu = 0U;                 /* bit accumulator (MSB first) */
+    unsigned int nbits = 0U;            /* number of bits in the accumulator */
+    unsigned int total;                 /* number of bits in the stream */
+    uint16_t crc = 0U;
+    uint8_t state = 5U;                 /* recessive level (bus idle) before SOF */
+    uint32_t stuff = 0U;
+    uint8_t dlc, bit;
+    size_t i;
+
+    assert(message);
+
+#define PUT_BITS(val,n)  do{ accu = (accu << (n)) | (uint64_t)(val); nbits += (n); \
+                             while (nbits >= 8U) { nbits -= 8U; stream[length++] = (uint8_t)(accu >> nbits); } } while(0)
+    dlc = MAX_DLC(message->can_dlc);
+    /* (1) arbitration and control field (SOF, identifier, flags, DLC) */
+    PUT_BITS(0U, 1U);
+    if (!(message->can_id & CAN_XTD_FRAME)) {
+        PUT_BITS(message->can_id & CAN_STD_MASK, 11U);
+        PUT_BITS((message->can_id & CAN_RTR_FRAME) ? 1U : 0U, 1U);
+        PUT_BITS(0U, 2U);  /* IDE, r0 */
+    } else {
+        PUT_BITS((message->can_id & CAN_XTD_MASK) >> 18, 11U);
+        PUT_BITS(3U, 2U);  /* SRR, IDE */
+        PUT_BITS(message->can_id & 0x3FFFFU, 18U);
+        PUT_BITS((message->can_id & CAN_RTR_FRAME) ? 1U : 0U, 1U);
+        PUT_BITS(0U, 2U);  /* r1, r0 */
+    }
+    PUT_BITS(dlc, 4U);
+    /* (2) data field (none in RTR frames) */
+    if (!(message->can_id & CAN_RTR_FRAME)) {
+        for (i = 0U; i < (size_t)dlc; i++)
+            PUT_BITS(message->data[i], 8U);
+    }
+    /* (3) CRC sequence: byte-wise for complete bytes, bit-wise for the rest */
+    for (i = 0U; i < length; i++)
+        crc = (uint16_t)(((crc << 8) ^ crc15_table[((crc >> 7) ^ stream[i]) & 0xFFU]) & 0x7FFFU);
+    for (i = nbits; i > 0U; i--) {
+        bit = (uint8_t)((accu >> (i - 1U)) & 1U);
+        crc = (uint16_t)(crc << 1);
+        if (((crc >> 15) ^ bit) & 1U)
+            crc ^= CAN_CRC15_POLY;
+        crc &= 0x7FFFU;
+    }
+    PUT_BITS(crc, 15U);
+#undef PUT_BITS
+    total = (unsigned int)(length * 8U) + nbits;
+    /* (4) stuff bits: byte-wise by lookup table, bit-wise for the rest */
+    for (i = 0U; i < length; i++) {
+        stuff += (uint32_t)(stuff_table[state][stream[i]] >> 4);
+        state = stuff_table[state][stream[i]] & 0x0FU;
+    }
+    for (i = nbits; i > 0U; i--) {
+        bit = (uint8_t)((accu >> (i - 1U)) & 1U);
+        if (bit == (state / 5U)) {
+            if ((state % 5U) == 3U) {  /* fifth bit of equal level */
+                state = (uint8_t)((bit ^ 1U) * 5U);
+                stuff++;
+            } else
+                state++;
+        } else
+            state = (uint8_t)(bit * 5U);
+    }
+    return (uint32_t)total + stuff + CAN_FRAME_TAIL;
+}
+
+static void update_load(busload_t *load, const slcan_message_t *message) {
+    struct timespec now;
+    uint64_t slot;
+    uint32_t bits;
+    uint32_t sequence;
+    size_t index;
+
+    assert(load);
+    assert(message);
+
+    /* note: Each window is updated by one thread only (reception thread or
+     *       transmitter), therefore no locking is required here. The window
+     *       is read by the application (seqlock, see 'sum_load').
+     */
+    bits = frame_bits(message);
+    now = timer_get_time();
+    slot = (((uint64_t)now.tv_sec * 1000000U) + ((uint64_t)now.tv_nsec / 1000U)) / BUSLOAD_SLOT_TIME;
+    index = (size_t)(slot % BUSLOAD_SLOTS);
+    sequence = load->sequence;
+    SEQ_STORE(&load->sequence, sequence + 1U);
+    SEQ_FENCE();
+    if (load->slot[index] != slot) {
+        load->bits[index] = 0U;
+        load->slot[index] = slot;
+    }
+    load->bits[index] += bits;
+    SEQ_FENCE();
+    SEQ_STORE(&load->sequence, sequence + 2U);
+}
+
+static uint64_t sum_load(const busload_t *load, uint64_t slot) {
+    busload_t copy;
+    uint64_t bits = 0U;
+    uint64_t prev;
+    uint32_t sequence;
+
+    assert(load);
+
+    /* read the window consistently (seqlock): retry while it is written */
+    for (;;) {
+        sequence = SEQ_LOAD(&load->sequence);
+        if (sequence & 1U)
+            continue;
+        SEQ_FENCE();
+        (void)memcpy(copy.slot, load->slot, sizeof(copy.slot));
+        (void)memcpy(copy.bits, load->bits, sizeof(copy.bits));
+        SEQ_FENCE();
+        if (SEQ_LOAD(&load->sequence) == sequence)
+            break;
+    }
+    for (prev = slot - (BUSLOAD_SLOTS - 1U); prev < slot; prev++) {
+        if (copy.slot[prev % BUSLOAD_SLOTS] == prev)
+            bits += (uint64_t)copy.bits[prev % BUSLOAD_SLOTS];
+    }
+    return bits;
+}
+
+/*  ---  latest-value mailbox  ---
+ *
+ *  The reception thread is the only writer of the mailbox. Each slot is
+ *  protected by a sequence counter (seqlock), which is odd while the slot
+ *  is written. A reader retries when the counter was odd or has changed
+ *  while it copied the slot, so the writer never waits for a reader.
+ *
+ *  11-bit identifiers are mapped directly to a slot. 29-bit identifiers are
+ *  stored in a hash table (open addressing, linear probing); a slot is
+ *  claimed by the writer with the first message of an identifier and kept
+ *  until the mailbox is cleared. When the table is full, further 29-bit
+ *  identifiers are not stored in the mailbox (but in the message queue).
+ */
+static mailbox_slot_t *find_slot(mailbox_t *mailbox, uint32_t can_id, bool claim) {
+    uint32_t key = can_id & (CAN_XTD_FRAME | CAN_XTD_MASK);
+    uint32_t used;
+    size_t index;
+    size_t i;
+
+    assert(mailbox);
+
+    if (!(key & CAN_XTD_FRAME))
+        return &mailbox->std[key & CAN_STD_MASK];
+
+    index = XTD_ID_HASH(key & CAN_XTD_MASK) % MAILBOX_XTD_SLOTS;
+    for (i = 0U; i < MAILBOX_XTD_SLOTS; i++) {
+        used = SEQ_LOAD(&mailbox->xtd[index].can_id);
+        if (used == key)
+            return &mailbox->xtd[index];
+        if (used == 0U)
+            return claim ? &mailbox->xtd[index] : NULL;
+        index = (index + 1U) % MAILBOX_XTD_SLOTS;
+    }
+    return NULL;
+}
+
+static void update_mailbox(mailbox_t *mailbox, const slcan_message_t *message) {
+    mailbox_slot_t *slot;
+    uint32_t sequence;
+
+    assert(mailbox);
+    assert(message);
+
+    if ((slot = find_slot(mailbox, message->can_id, true)) == NULL)
+        return;
+    sequence = slot->sequence;
+    SEQ_STORE(&slot->sequence, sequence + 1U);
+    SEQ_FENCE();
+    slot->message = *message;
+    slot->timestamp = timer_get_time();
+    SEQ_FENCE();
+    SEQ_STORE(&slot->sequence, sequence + 2U);
+    /* note: a new slot is published after its content has been written */
+    if ((message->can_id & CAN_XTD_FRAME) && (slot->can_id == 0U)) {
+        SEQ_FENCE();
+        SEQ_STORE(&slot->can_id, message->can_id & (CAN_XTD_FRAME | CAN_XTD_MASK));
+    }
+}
+
+/*  ---  data reduction  ---
+ *
+ *  A received message is compared with the last forwarded message of its
+ *  identifier (change-only) and/or with the time when the last message of
+ *  its identifier was forwarded (decimation). The table is only accessed by
+ *  the reception thread. When the 29-bit table is full, messages of further
+ *  29-bit identifiers are forwarded without reduction.
+ */
+static bool forward_message(reduction_t *reduction, const slcan_message_t *message) {
+    reduction_slot_t *slot = NULL;
+    uint32_t key = message->can_id & (CAN_XTD_FRAME | CAN_XTD_MASK);
+    struct timespec now;
+    uint64_t usec = 0U;
+    size_t index;
+    size_t i;
+
+    assert(reduction);
+    assert(message);
+
+    /* look up the slot of the identifier */
+    if (!(key & CAN_XTD_FRAME))
+        slot = &reduction->std[key & CAN_STD_MASK];
+    else {
+        index = XTD_ID_HASH(key & CAN_XTD_MASK) % REDUCTION_XTD_SLOTS;
+        for (i = 0U; (i < REDUCTION_XTD_SLOTS) && !slot; i++) {
+            if (!reduction->xtd[index].used ||
+                ((reduction->xtd[index].can_id & (CAN_XTD_FRAME | CAN_XTD_MASK)) == key))
+                slot = &reduction->xtd[index];
+            index = (index + 1U) % REDUCTION_XTD_SLOTS;
+        }
+        if (!slot)
+            return true;
+    }
+    if (reduction->mode & SLCAN_REDUCE_DECIMATE) {
+        now = timer_get_time();
+        usec = ((uint64_t)now.tv_sec * 1000000U) + ((uint64_t)now.tv_nsec / 1000U);
+    }
+    /* the first message of an identifier is always forwarded */
+    if (slot->used) {
+        if ((reduction->mode & SLCAN_REDUCE_CHANGE_ONLY) &&
+            (slot->can_id == message->can_id) && (slot->can_dlc == message->can_dlc) &&
+            ((message->can_id & CAN_RTR_FRAME) ||
+             !memcmp(slot->data, message->data, MAX_DLC(message->can_dlc)))) {
+            reduction->suppressed++;
+            return false;
+        }
+        if ((reduction->mode & SLCAN_REDUCE_DECIMATE) && (usec < slot->next)) {
+            reduction->suppressed++;
+            return false;
+        }
+    }
+    /* remember the forwarded message */
+    slot->used = true;
+    slot->can_id = message->can_id;
+    slot->can_dlc = message->can_dlc;
+    (void)memcpy(slot->data, message->data, MAX_DLC(message->can_dlc));
+    /* note: the decimation period is kept in step, unless a message is late */
+    if ((usec - slot->next) < reduction->period)
+        slot->next += reduction->period;
+    else
+        slot->next = usec + reduction->period;
+    return true;
+}
+
+static bool accept_message(const void *element, const void *param) {
+    const slcan_message_t *message = (const slcan_message_t*)element;
+    const slcan_filter_t *filter = (const slcan_filter_t*)param;
+
+    assert(message);
+
+    if (!filter)
+        return true;
+    /* note: a mask bit of 1 means the identifier bit is relevant */
+    if (message->can_id & CAN_XTD_FRAME)
+        return (((message->can_id & CAN_XTD_MASK) ^ filter->xtd_code) & filter->xtd_mask) == 0U;
+    else
+        return (((message->can_id & CAN_STD_MASK) ^ filter->std_code) & filter->std_mask) == 0U;
 }
 
 /*  ----------------------------------------------------------------------
@@ -64,6 +64,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 
 
 /*  -----------  options  ------------------------------------------------
@@ -97,6 +98,22 @@
 #define CAN_RTR_FRAME   0x20000000U     /**< remote frame */
 /** @} */
 
+/** @name  Queue Overflow Policy
+ *  @brief What happens when a message is received and the queue is full
+ *  @{ */
+#define SLCAN_DROP_NEWEST    0x00U      /**< drop the received message (default) */
+#define SLCAN_DROP_OLDEST    0x01U      /**< drop the oldest message in the queue */
+#define SLCAN_BOUNDED_BLOCK  0x02U      /**< block the reception for a bounded time */
+/** @} */
+
+/** @name  Data Reduction
+ *  @brief Which received messages are put into the queue (can be combined)
+ *  @{ */
+#define SLCAN_REDUCE_OFF          0x00U /**< all received messages (default) */
+#define SLCAN_REDUCE_CHANGE_ONLY  0x01U /**< only when the payload or DLC has changed */
+#define SLCAN_REDUCE_DECIMATE     0x02U /**< at most N messages per second and identifier */
+/** @} */
+
 /** @name  CAN Identifier
  *  @brief CAN identifier masks
  *  @{ */
@@ -127,6 +144,7 @@
 /** @} */
 
 #define CAN_INFINITE    65535U          /**< infinite time-out (blocking read) */
+#define CAN_INFINITE_US UINT64_MAX      /**< infinite time-out (in [usec]) */
 
 
 /*  -----------  types  --------------------------------------------------
@@ -163,6 +181,51 @@ typedef union slcan_flags_t_ {          /* SLACAN status flags */
     };
 } slcan_flags_t;
 
+/** @brief  SLCAN reception handler (called by the reception thread)
+ */
+typedef void (*slcan_rx_handler_t)(const slcan_message_t *message, const struct timespec *timestamp, void *context);
+
+/** @brief  SLCAN status handler (called by the polling thread on changes)
+ */
+typedef void (*slcan_status_handler_t)(slcan_flags_t flags, void *context);
+
+/** @brief  SLCAN trace handler (called for each received and each sent message)
+ */
+typedef void (*slcan_trace_handler_t)(const slcan_message_t *message, const struct timespec *timestamp, bool tx, void *context);
+
+/** @brief  SLCAN capture handler (called for each chunk of received and sent serial data)
+ */
+typedef void (*slcan_capture_handler_t)(const uint8_t *buffer, size_t nbytes, const struct timespec *timestamp, bool tx, void *context);
+
+/** @brief  SLCAN subscriber filter (a mask bit of 1 means the identifier bit is relevant)
+ */
+typedef struct slcan_filter_t_ {        /* subscriber filter: */
+    uint32_t std_code;                  /**< acceptance code for 11-bit identifiers */
+    uint32_t std_mask;                  /**< acceptance mask for 11-bit identifiers */
+    uint32_t xtd_code;                  /**< acceptance code for 29-bit identifiers */
+    uint32_t xtd_mask;                  /**< acceptance mask for 29-bit identifiers */
+} slcan_filter_t;
+
+/** @brief  SLCAN channel setup (sent as one batch of pipelined commands)
+ */
+typedef struct slcan_setup_t_ {         /* channel setup: */
+    bool use_btr;                       /**< BTR0/BTR1 register instead of bit-rate index */
+    uint8_t index;                      /**< bit-rate index (0 = 10kbps .. 8 = 1000kbps) */
+    uint16_t btr;                       /**< SJA1000 bit-timing register (BTR0/BTR1) */
+    bool filter;                        /**< set acceptance code and mask register */
+    uint32_t code;                      /**< acceptance code register (ACn of SJA1000) */
+    uint32_t mask;                      /**< acceptance mask register (AMn of SJA1000) */
+} slcan_setup_t;
+
+/** @brief  SLCAN device identity (read by one batch of pipelined commands)
+ */
+typedef struct slcan_identity_t_ {      /* device identity: */
+    uint8_t hardware;                   /**< hardware version (8-bit: <major>.<minor>) */
+    uint8_t software;                   /**< software version (8-bit: <major>.<minor>) */
+    bool has_serial;                    /**< serial number supported by the device */
+    uint32_t serial;                    /**< serial number (if supported) */
+} slcan_identity_t;
+
 
 /*  -----------  variables  ----------------------------------------------
  */
@@ -375,13 +438,44 @@ SLCANAPI int slcan_open_channel(slcan_port_t port);
 SLCANAPI int slcan_close_channel(slcan_port_t port);
 
 
+/** @brief       sets up and opens the CAN channel with one batch of pipelined
+ *               commands: 'Setup Bitrate' or 'Setup BTR', optionally 'Sets
+ *               Acceptance Code' and 'Sets Acceptance Mask', and 'Open'.
+ *
+ *  @remarks     The commands are sent at once and the responses are collected
+ *               in order afterwards (one round trip instead of up to four).
+ *               If one of the commands is not acknowledged, the CAN channel
+ *               will be closed again.
+ *
+ *  @param[in]   port  - pointer to a SLCAN instance
+ *  @param[in]   setup - bit-rate and acceptance filter settings
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (bit-rate index)
+ *  @retval      EBADF     - bad file descriptor (device not connected)
+ *  @retval      EBUSY     - device / resource busy (disturbance)
+ *  @retval      EBADMSG   - bad message (format or disturbance)
+ *  @retval      ETIMEDOUT - timed out (command not acknowledged)
+ *  @retval      'errno'   - error code from called system functions:
+ *                           'write', 'read', etc.
+ */
+SLCANAPI int slcan_start_channel(slcan_port_t port, const slcan_setup_t *setup);
+
+
 /** @brief       transmits a CAN message.
  *
  *  @remarks     This command is only active if the CAN channel is open.
  *
  *  @param[in]   port     - pointer to a SLCAN instance
  *  @param[in]   message  - pointer to the message to be sent
- *  @param[in]   timeout  - (not implemented yet)
+ *  @param[in]   timeout  - time to wait for the acknowledge of the device:
+ *                               0 means the default time-out (1000ms),
+ *                               65535 means blocking write, and any other
+ *                               value means the time to wait im milliseconds
  *
  *  @returns     0 if successful, or a negative value on error.
  *
@@ -427,6 +521,34 @@ SLCANAPI int slcan_write_message(slcan_port_t port, const slcan_message_t *messa
 SLCANAPI int slcan_read_message(slcan_port_t port, slcan_message_t *message, uint16_t timeout);
 
 
+/** @brief       read one message from the message queue, if any (with a time-out
+ *               in microseconds).
+ *
+ *  @param[in]   port     - pointer to a SLCAN instance
+ *  @param[out]  message  - pointer to a message buffer
+ *  @param[in]   timeout  - time to wait for the reception of a message:
+ *                               0 means the function returns immediately,
+ *                               CAN_INFINITE_US means blocking read, and any
+ *                               other value means the time to wait in [usec]
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      -30  - when the message queue is empty (CAN API compatible)
+ *
+ *  @note        The time-out is measured on a monotonic clock, it is not
+ *               affected by adjustments of the system time (e.g. by NTP).
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (message)
+ *  @retval      ENOMSG    - no data available (message queue empty)
+ *  @retval      ETIMEDOUT - timed out (no message received)
+ *  @retval      ENOSPC    - no space left (message queue overflow)
+ */
+SLCANAPI int slcan_read_message_us(slcan_port_t port, slcan_message_t *message, uint64_t timeout);
+
+
 /** @brief       read status flags.
  *
  *  @remarks     This command is only active if the CAN channel is open.
@@ -449,6 +571,40 @@ SLCANAPI int slcan_read_message(slcan_port_t port, slcan_message_t *message, uin
 SLCANAPI int slcan_status_flags(slcan_port_t port, slcan_flags_t *flags);
 
 
+/** @brief       start or stop the background polling of the status flags.
+ *
+ *  @remarks     A polling thread reads the status flags from the device every
+ *               'interval' milliseconds. While the polling is active, function
+ *               'slcan_status_flags' returns the result of the last poll without
+ *               any serial I/O. When a poll fails, the next call of function
+ *               'slcan_status_flags' reads the status flags from the device
+ *               (and reports the error, if any).
+ *
+ *  @remarks     The handler (optional) is called by the polling thread whenever
+ *               the status flags differ from the previous poll (e.g. bus error,
+ *               error passive, data overrun). It must not call this function.
+ *
+ *  @note        The polling shall only be active when the CAN channel is open.
+ *               It is stopped when the SLCAN instance is disconnected.
+ *
+ *  @param[in]   port      - pointer to a SLCAN instance
+ *  @param[in]   interval  - polling interval (in [ms], 0 = stop polling)
+ *  @param[in]   handler   - status handler (or NULL)
+ *  @param[in]   context   - pointer passed to the handler (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      ENOTSUP   - operation not supported (CANable protocol)
+ *  @retval      EDEADLK   - called by the status handler
+ *  @retval      'errno'   - error code from called system functions:
+ *                           'pthread_create', etc.
+ */
+SLCANAPI int slcan_status_polling(slcan_port_t port, uint16_t interval, slcan_status_handler_t handler, void *context);
+
+
 /** @brief       sets Acceptance Code Register (ACn Register of SJA1000).
  *
  *  @remarks     This command is only active if the CAN channel is initiated
@@ -518,6 +674,31 @@ SLCANAPI int slcan_acceptance_mask(slcan_port_t port, uint32_t mask);
 SLCANAPI int slcan_version_number(slcan_port_t port, uint8_t *hardware, uint8_t *software);
 
 
+/** @brief       probes the SLCAN device (version number and serial number)
+ *               and closes the CAN channel with one batch of pipelined commands.
+ *
+ *  @remarks     The result of the 'Close' command is ignored, because the
+ *               CAN channel is possibly already closed. A device that does
+ *               not support the serial number is accepted.
+ *
+ *  @param[in]   port      - pointer to a SLCAN instance
+ *  @param[out]  identity  - version numbers and serial number (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EBADF     - bad file descriptor (device not connected)
+ *  @retval      EBUSY     - device / resource busy (disturbance)
+ *  @retval      EBADMSG   - bad message (format or disturbance)
+ *  @retval      ETIMEDOUT - timed out (command not acknowledged)
+ *  @retval      'errno'   - error code from called system functions:
+ *                           'write', 'read', etc.
+ */
+SLCANAPI int slcan_probe_device(slcan_port_t port, slcan_identity_t *identity);
+
+
 /** @brief       get serial number of the SLCAN device.
  *
  *  @remarks     This command is active always.
@@ -540,6 +721,437 @@ SLCANAPI int slcan_version_number(slcan_port_t port, uint8_t *hardware, uint8_t
 SLCANAPI int slcan_serial_number(slcan_port_t port, uint32_t *number);
 
 
+/** @brief       get the bus load of the CAN channel (sliding window).
+ *
+ *  @remarks     The bus load is calculated from the received and the sent CAN
+ *               messages during the last 900ms (9 slots of 100ms each). The
+ *               length of each frame includes the stuff bits (exact counting).
+ *
+ *  @param[in]   port     - pointer to a SLCAN instance
+ *  @param[in]   bitrate  - active bit-rate of the CAN channel (in [bps])
+ *  @param[out]  load     - bus load (in [1/100 percent], 0..10000)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (bitrate or load)
+ */
+SLCANAPI int slcan_bus_load(slcan_port_t port, uint32_t bitrate, uint16_t *load);
+
+
+/** @brief       enable or disable the latest-value mailbox.
+ *
+ *  @remarks     When the mailbox is enabled, the reception thread stores the
+ *               latest message of each identifier (with its time of reception)
+ *               in addition to the message queue.
+ *
+ *  @note        The mailbox shall only be changed when the CAN channel is
+ *               closed. It is cleared when the CAN channel is opened.
+ *
+ *  @param[in]   port    - pointer to a SLCAN instance
+ *  @param[in]   enable  - true to enable, or false to disable the mailbox
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      ENOMEM    - out of memory (insufficient storage space)
+ */
+SLCANAPI int slcan_mailbox(slcan_port_t port, bool enable);
+
+
+/** @brief       read the latest message of an identifier from the mailbox.
+ *
+ *  @remarks     The function does not wait and does not remove the message
+ *               from the mailbox. The message queue is not affected.
+ *
+ *  @param[in]   port       - pointer to a SLCAN instance
+ *  @param[in]   can_id     - CAN identifier (with flag CAN_XTD_FRAME for 29-bit)
+ *  @param[out]  message    - pointer to a message buffer
+ *  @param[out]  timestamp  - time of reception (optional)
+ *  @param[out]  counter    - number of messages received with this identifier
+ *                            since the CAN channel was opened (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      -30  - when no message has been received with this identifier
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (can_id or message)
+ *  @retval      ENOTSUP   - mailbox not enabled
+ *  @retval      ENOMSG    - no message received with this identifier
+ */
+SLCANAPI int slcan_read_latest(slcan_port_t port, uint32_t can_id, slcan_message_t *message, struct timespec *timestamp, uint32_t *counter);
+
+
+/** @brief       set a handler that is called by the reception thread for each
+ *               received message instead of putting it into the message queue.
+ *
+ *  @remarks     The handler is called directly after the message has been
+ *               decoded (and has passed the data reduction, if any). It runs
+ *               in the context of the reception thread, so it must not block
+ *               and should return as fast as possible: no further data is read
+ *               from the serial port until it returns. It must not call any
+ *               function of this SLCAN instance.
+ *
+ *  @note        The handler shall only be changed when the CAN channel is
+ *               closed. A null-pointer removes the handler; then received
+ *               messages are put into the message queue again.
+ *
+ *  @param[in]   port     - pointer to a SLCAN instance
+ *  @param[in]   handler  - reception handler (or NULL)
+ *  @param[in]   context  - pointer passed to the handler (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ */
+SLCANAPI int slcan_set_rx_handler(slcan_port_t port, slcan_rx_handler_t handler, void *context);
+
+
+/** @brief       set a handler that is called for each received message (by the
+ *               reception thread) and for each sent message (by the thread that
+ *               sent it), e.g. to record a trace file.
+ *
+ *  @remarks     Received messages are passed before the data reduction, so the
+ *               handler sees all messages on the bus. Sent messages are passed
+ *               when their transmission has been acknowledged. The handler must
+ *               not block and must not call any function of this SLCAN instance.
+ *
+ *  @note        The handler can be changed at any time. When the function returns,
+ *               a previous handler is no longer called and no call of it is in
+ *               progress. A null-pointer removes the handler.
+ *
+ *  @param[in]   port     - pointer to a SLCAN instance
+ *  @param[in]   handler  - trace handler (or NULL)
+ *  @param[in]   context  - pointer passed to the handler (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ */
+SLCANAPI int slcan_set_trace_handler(slcan_port_t port, slcan_trace_handler_t handler, void *context);
+
+
+/** @brief       set a handler that is called for each chunk of data received
+ *               from the serial port (by the reception thread) and for each
+ *               chunk sent to it (by the thread that sent it), e.g. to capture
+ *               the raw SLCAN traffic.
+ *
+ *  @remarks     The chunks are passed as they are read from or written to the
+ *               serial port, i.e. a chunk can contain several SLCAN frames or
+ *               a part of one. The handler must not block and must not call
+ *               any function of this SLCAN instance.
+ *
+ *  @note        The handler can be changed at any time. When the function returns,
+ *               a previous handler is no longer called and no call of it is in
+ *               progress. A null-pointer removes the handler.
+ *
+ *  @param[in]   port     - pointer to a SLCAN instance
+ *  @param[in]   handler  - capture handler (or NULL)
+ *  @param[in]   context  - pointer passed to the handler (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ */
+SLCANAPI int slcan_set_capture_handler(slcan_port_t port, slcan_capture_handler_t handler, void *context);
+
+
+/** @brief       set the data reduction of received messages.
+ *
+ *  @remarks     With SLCAN_REDUCE_CHANGE_ONLY a received message is only put
+ *               into the message queue when its payload or DLC differs from
+ *               the last message of its identifier put into the queue.
+ *               With SLCAN_REDUCE_DECIMATE at most 'rate' messages per second
+ *               are put into the queue for each identifier.
+ *
+ *  @note        The data reduction shall only be changed when the CAN channel
+ *               is closed. It is reset when the CAN channel is opened.
+ *
+ *  @note        The bus load and the mailbox include all received messages.
+ *
+ *  @param[in]   port  - pointer to a SLCAN instance
+ *  @param[in]   mode  - reduction mode (SLCAN_REDUCE_xyz, can be combined)
+ *  @param[in]   rate  - messages per second and identifier (1..65535),
+ *                       only used with mode SLCAN_REDUCE_DECIMATE
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (mode or rate)
+ *  @retval      ENOMEM    - out of memory (insufficient storage space)
+ */
+SLCANAPI int slcan_reduction(slcan_port_t port, uint8_t mode, uint16_t rate);
+
+
+/** @brief       get the number of received messages suppressed by the data
+ *               reduction since the CAN channel was opened.
+ *
+ *  @param[in]   port        - pointer to a SLCAN instance
+ *  @param[out]  suppressed  - number of suppressed messages
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (null-pointer)
+ */
+SLCANAPI int slcan_reduced(slcan_port_t port, uint64_t *suppressed);
+
+
+/** @brief       attaches a subscriber to the received messages.
+ *
+ *  @remarks     Each received message (after data reduction, if any) is written
+ *               once into a broadcast ring that is shared by all subscribers of
+ *               the SLCAN instance. Every subscriber has its own read position,
+ *               its own overflow counter and its own acceptance filter; it will
+ *               receive all accepted messages from the time of subscription on.
+ *               A slow subscriber loses the oldest messages, but never blocks the
+ *               reception thread or other subscribers.
+ *
+ *  @remarks     The message queue (and the reception handler) is not affected by
+ *               subscribers. Up to 16 subscribers can be attached at a time.
+ *
+ *  @param[in]   port     - pointer to a SLCAN instance
+ *  @param[in]   filter   - acceptance filter (or NULL to accept all messages)
+ *
+ *  @returns     subscriber number (0..15) if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EBUSY     - device / resource busy (no free subscriber)
+ *  @retval      ENOMEM    - out of memory (insufficient storage space)
+ */
+SLCANAPI int slcan_subscribe(slcan_port_t port, const slcan_filter_t *filter);
+
+
+/** @brief       detaches a subscriber from the received messages.
+ *
+ *  @remarks     A subscriber blocked in 'slcan_read_subscriber' will return.
+ *
+ *  @param[in]   port       - pointer to a SLCAN instance
+ *  @param[in]   subscriber - subscriber number (from 'slcan_subscribe')
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (subscriber)
+ */
+SLCANAPI int slcan_unsubscribe(slcan_port_t port, int subscriber);
+
+
+/** @brief       read one message of a subscriber from the broadcast ring.
+ *
+ *  @param[in]   port       - pointer to a SLCAN instance
+ *  @param[in]   subscriber - subscriber number (from 'slcan_subscribe')
+ *  @param[out]  message    - the message read from the broadcast ring
+ *  @param[in]   timeout    - time to wait for the reception of a message:
+ *                                 0 means the function returns immediately,
+ *                                 65535 means blocking read, and any other
+ *                                 value means the time to wait im milliseconds
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (subscriber or message)
+ *  @retval      ENOMSG    - no data available (message ring empty)
+ *  @retval      ETIMEDOUT - timed out (no message received)
+ */
+SLCANAPI int slcan_read_subscriber(slcan_port_t port, int subscriber, slcan_message_t *message, uint16_t timeout);
+
+
+/** @brief       read one message of a subscriber from the broadcast ring (with
+ *               a time-out in microseconds).
+ *
+ *  @param[in]   port       - pointer to a SLCAN instance
+ *  @param[in]   subscriber - subscriber number (from 'slcan_subscribe')
+ *  @param[out]  message    - the message read from the broadcast ring
+ *  @param[in]   timeout    - time to wait for the reception of a message:
+ *                                 0 means the function returns immediately,
+ *                                 CAN_INFINITE_US means blocking read, and any
+ *                                 other value means the time to wait in [usec]
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (subscriber or message)
+ *  @retval      ENOMSG    - no data available (message ring empty)
+ *  @retval      ETIMEDOUT - timed out (no message received)
+ */
+SLCANAPI int slcan_read_subscriber_us(slcan_port_t port, int subscriber, slcan_message_t *message, uint64_t timeout);
+
+
+/** @brief       get the capacity, the high-water mark and the overflow counter
+ *               of a subscriber.
+ *
+ *  @param[in]   port       - pointer to a SLCAN instance
+ *  @param[in]   subscriber - subscriber number (from 'slcan_subscribe')
+ *  @param[out]  size       - number of messages the broadcast ring can hold (optional)
+ *  @param[out]  high       - maximum number of messages pending for the subscriber (optional)
+ *  @param[out]  overflow   - number of messages lost by the subscriber (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (subscriber)
+ */
+SLCANAPI int slcan_subscriber_status(slcan_port_t port, int subscriber, uint32_t *size, uint32_t *high, uint64_t *overflow);
+
+
+/** @brief       get the capacity, the high-water mark and the overflow counter
+ *               of the message queue (reception queue).
+ *
+ *  @remarks     The high-water mark and the overflow counter are reset when the
+ *               CAN channel is opened.
+ *
+ *  @param[in]   port     - pointer to a SLCAN instance
+ *  @param[out]  size     - maximum number of messages the queue can hold (optional)
+ *  @param[out]  high     - maximum number of messages the queue has hold (optional)
+ *  @param[out]  overflow - number of messages lost due to a queue overflow (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ */
+SLCANAPI int slcan_queue_status(slcan_port_t port, uint32_t *size, uint32_t *high, uint64_t *overflow);
+
+
+/** @brief       set the maximum number of messages the message queue (reception
+ *               queue) can hold.
+ *
+ *  @remarks     All messages in the queue are discarded, and the high-water mark
+ *               and the overflow counter are reset. The memory for the messages
+ *               is allocated on demand, so a large queue does not occupy memory
+ *               until it is filled up.
+ *
+ *  @param[in]   port  - pointer to a SLCAN instance
+ *  @param[in]   size  - maximum number of messages in the queue (at least 1)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (size)
+ *  @retval      ENOMEM    - out of memory (insufficient storage space)
+ */
+SLCANAPI int slcan_queue_resize(slcan_port_t port, uint32_t size);
+
+
+/** @brief       attach a spill file to the message queue (reception queue),
+ *               or detach it.
+ *
+ *  @remarks     When the message queue is full, or has reached the spill
+ *               threshold (see 'slcan_queue_threshold'), received messages are
+ *               written into a memory-mapped file and read from it in order, before
+ *               newer messages. Messages in a previous spill file are kept as
+ *               far as they fit, the others are counted as dropped.
+ *
+ *  @param[in]   port    - pointer to a SLCAN instance
+ *  @param[in]   folder  - folder for the spill file (NULL for '/var/tmp' on
+ *                         POSIX systems or the temp. folder on Windows)
+ *  @param[in]   size    - maximum number of messages in the spill file, or
+ *                         0 to detach the spill file
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (spill file too large)
+ *  @retval      'errno'   - error code from called system functions
+ */
+SLCANAPI int slcan_queue_spill(slcan_port_t port, const char *folder, uint32_t size);
+
+
+/** @brief       set the number of messages in the message queue (reception
+ *               queue) at which spilling into the spill file starts.
+ *
+ *  @remarks     The threshold is only effective with a spill file. Messages
+ *               are then written into the spill file once the given number of
+ *               messages is in memory, before the message queue is full.
+ *
+ *  @param[in]   port       - pointer to a SLCAN instance
+ *  @param[in]   threshold  - number of messages in memory at which spilling
+ *                            starts, or 0 to spill when the queue is full
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ */
+SLCANAPI int slcan_queue_threshold(slcan_port_t port, uint32_t threshold);
+
+
+/** @brief       set the overflow policy of the message queue (reception queue).
+ *
+ *  @remarks     With policy SLCAN_BOUNDED_BLOCK the reception thread waits at
+ *               most 'timeout' milliseconds for a free element in the queue.
+ *               Meanwhile no further data is read from the serial port.
+ *
+ *  @param[in]   port     - pointer to a SLCAN instance
+ *  @param[in]   policy   - overflow policy (SLCAN_DROP_NEWEST, SLCAN_DROP_OLDEST
+ *                          or SLCAN_BOUNDED_BLOCK)
+ *  @param[in]   timeout  - maximum blocking time in milliseconds (1..65534),
+ *                          only used with policy SLCAN_BOUNDED_BLOCK
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (policy or timeout)
+ */
+SLCANAPI int slcan_queue_policy(slcan_port_t port, uint8_t policy, uint16_t timeout);
+
+
+/** @brief       get the number of messages dropped by the overflow policies.
+ *
+ *  @remarks     The sum of the three counters is equal to the overflow counter
+ *               of the message queue (see 'slcan_queue_status').
+ *
+ *  @param[in]   port     - pointer to a SLCAN instance
+ *  @param[out]  newest   - number of received messages dropped (optional)
+ *  @param[out]  oldest   - number of oldest messages dropped (optional)
+ *  @param[out]  expired  - number of received messages dropped after the
+ *                          blocking time has expired (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ */
+SLCANAPI int slcan_queue_drops(slcan_port_t port, uint64_t *newest, uint64_t *oldest, uint64_t *expired);
+
+
 /** @brief       signal all waiting objects, if any.
  *
  *  @param[in]   port  - pointer to a SLCAN instance
@@ -83,6 +83,8 @@
 #define TIMER_SEC(x)        (uint64_t)((uint64_t)(x) * (uint64_t)1000000)
 #define TIMER_MIN(x)        (uint64_t)((uint64_t)(x) * (uint64_t)60000000)
 
+#define TIMER_NSEC_PER_USEC (uint64_t)1000  /**< nanoseconds per microsecond */
+
 
 /*  -----------  types  -------------------------------------------------
  */
@@ -152,6 +154,28 @@ struct timespec timer_get_time(void);
  */
 double timer_diff_time(struct timespec *start, struct timespec *stop);
 
+/** @brief       returns the time of a monotonic clock in [nsec].
+ *
+ *  @remarks     The clock is not affected by adjustments of the system time
+ *               (e.g. by NTP); it is the time base for 'timer_wait_until'.
+ *
+ *  @returns     the monotonic time in [nsec]
+ */
+uint64_t timer_get_clock(void);
+
+/** @brief       suspends the calling thread until the monotonic clock has
+ *               reached the given point in time (absolute deadline).
+ *
+ *  @remarks     The thread sleeps until shortly before the deadline and spins
+ *               on the clock for the rest of the time, so that the wake-up is
+ *               accurate and the errors of successive waits do not add up.
+ *
+ *  @param[in]   deadline  in [nsec] of the monotonic clock (timer_get_clock)
+ *
+ *  @returns     none-zero value on success, or zero otherwise
+ */
+int timer_wait_until(uint64_t deadline);
+
 
 #ifdef __cplusplus
 }
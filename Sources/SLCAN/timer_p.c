@@ -86,6 +86,8 @@
 /*  -----------  defines  -----------------------------------------------
  */
 
+#define SPIN_TAIL  (uint64_t)200000  /* timer_wait_until: spin for the last 200us */
+
 
 /*  -----------  types  -------------------------------------------------
  */
@@ -190,6 +192,42 @@ double timer_diff_time(struct timespec *start, struct timespec *stop) {
             ((double)start->tv_sec + ((double)start->tv_nsec / 1000000000.f)));
 }
 
+uint64_t timer_get_clock(void) {
+    struct timespec now = { 0, 0 };
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * (uint64_t)1000000000) + (uint64_t)now.tv_nsec;
+}
+
+int timer_wait_until(uint64_t deadline) {
+    struct timespec wakeup;
+    uint64_t now = timer_get_clock();
+    int rc = 0;
+
+    // sleep until shortly before the deadline
+    if ((now + SPIN_TAIL) < deadline) {
+#if defined(__APPLE__)
+        // note: macOS has no 'clock_nanosleep', the remaining time is slept
+        //       relative (the spin tail makes up for the inaccuracy)
+        uint64_t delay = deadline - SPIN_TAIL - now;
+        wakeup.tv_sec = (time_t)(delay / (uint64_t)1000000000);
+        wakeup.tv_nsec = (long)(delay % (uint64_t)1000000000);
+        errno = 0;
+        while ((nanosleep(&wakeup, &wakeup) != 0) && (errno == EINTR))
+            ;
+#else
+        uint64_t until = deadline - SPIN_TAIL;
+        wakeup.tv_sec = (time_t)(until / (uint64_t)1000000000);
+        wakeup.tv_nsec = (long)(until % (uint64_t)1000000000);
+        while ((rc = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, NULL)) == EINTR)
+            ;
+#endif
+    }
+    // spin for the rest of the time
+    while (timer_get_clock() < deadline)
+        ;
+    return (rc != 0) ? 0 : 1;
+}
+
 /*  -----------  local functions  ---------------------------------------
  */
 
@@ -86,6 +86,8 @@
 /*  -----------  defines  -----------------------------------------------
  */
 
+#define SPIN_TAIL  (uint64_t)2000000  /* timer_wait_until: spin for the last 2ms */
+
 
 /*  -----------  types  -------------------------------------------------
  */
@@ -241,6 +243,38 @@ double timer_diff_time(struct timespec *start, struct timespec *stop) {
             ((double)start->tv_sec + ((double)start->tv_nsec / 1000000000.f)));
 }
 
+uint64_t timer_get_clock(void) {
+    static LARGE_INTEGER largeFrequency = { 0 };  // frequency in counts per second
+    LARGE_INTEGER largeCounter;
+
+    if (!largeFrequency.QuadPart) {
+        // retrieve the frequency of the high-resolution performance counter
+        if (!QueryPerformanceFrequency(&largeFrequency))
+            return 0;
+    }
+    // retrieve the current value of the high-resolution performance counter
+    if (!QueryPerformanceCounter(&largeCounter))
+        return 0;
+    // convert the counter value into nanoseconds (w/o overflow)
+    uint64_t sec = (uint64_t)(largeCounter.QuadPart / largeFrequency.QuadPart);
+    uint64_t rem = (uint64_t)(largeCounter.QuadPart % largeFrequency.QuadPart);
+    return (sec * (uint64_t)1000000000) + ((rem * (uint64_t)1000000000) / (uint64_t)largeFrequency.QuadPart);
+}
+
+int timer_wait_until(uint64_t deadline) {
+    uint64_t now = timer_get_clock();
+
+    // sleep until shortly before the deadline
+    // note: Windows has no absolute high-resolution sleep, the remaining
+    //       time is slept relative (the spin tail makes up for the inaccuracy)
+    if ((now + SPIN_TAIL) < deadline)
+        (void)timer_delay((deadline - SPIN_TAIL - now) / (uint64_t)1000);
+    // spin for the rest of the time
+    while (timer_get_clock() < deadline)
+        ;
+    return 1;
+}
+
 /*  -----------  local functions  ---------------------------------------
  */
 
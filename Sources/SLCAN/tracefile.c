@@ -0,0 +1,596 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'tracefile'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        tracefile.c
+ *
+ *  @brief       Binary trace file format and indexed reader.
+ *
+ *  @remarks     The trace file is mapped into memory (POSIX 'mmap' resp.
+ *               Windows 'MapViewOfFile'); all other code is the same for
+ *               all platforms.
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @addtogroup  tracefile
+ *  @{
+ */
+#include "tracefile.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <assert.h>
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define DIRECTORY_SIZE  1024U           /* initial size of the block directory */
+#define INDEX_SIZE  16384U              /* initial size of the identifier directory */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef struct block_t_ {               /* block directory entry: */
+    const tracefile_block_t *header;    /* - block header (in the mapping) */
+    uint64_t number;                    /* - number of the first record */
+} block_t;
+
+typedef struct index_t_ {               /* identifier directory entry: */
+    uint32_t can_id;                    /* - identifier with XTD flag (key) */
+    uint32_t block;                     /* - a block with this identifier */
+} index_t;
+
+typedef struct object_t_ {
+    const uint8_t *address;             /* - mapped trace file */
+    size_t length;                      /* - length of the mapping */
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE hFile;                       /* - file handle */
+    HANDLE hMapping;                    /* - file mapping handle */
+#endif
+    block_t *blocks;                    /* - block directory */
+    uint32_t count;                     /* - number of blocks */
+    index_t *index;                     /* - identifier directory (sorted) */
+    size_t entries;                     /* - number of directory entries */
+    uint64_t records;                   /* - number of records */
+    uint32_t block;                     /* - read position: block */
+    uint32_t record;                    /* - read position: record in the block */
+    uint64_t time;                      /* - time of the record at the read position */
+} object_t;
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static int map_file(object_t *object, const char *filename);
+static void unmap_file(object_t *object);
+static int scan_blocks(object_t *object);
+static bool check_block(const tracefile_block_t *header);
+static int add_index(object_t *object, const tracefile_block_t *header, size_t *size);
+static int compare_index(const void *entry1, const void *entry2);
+static void set_position(object_t *object, uint32_t block, uint32_t record);
+static uint32_t find_time(const tracefile_block_t *header, uint64_t time);
+static const tracefile_id_t *find_id(const tracefile_block_t *header, uint32_t can_id);
+static uint32_t find_position(const tracefile_block_t *header, const tracefile_id_t *entry, uint32_t record);
+
+#define RECORDS(hdr)  ((const tracefile_record_t*)((const uint8_t*)(hdr) + sizeof(tracefile_block_t)))
+#define TIMES(hdr)  ((const uint64_t*)((const uint8_t*)(hdr) + TRACEFILE_TIMES_OFFSET((hdr)->records)))
+#define IDS(hdr)  ((const tracefile_id_t*)((const uint8_t*)(hdr) + TRACEFILE_IDS_OFFSET((hdr)->records, (hdr)->step)))
+#define POSITIONS(hdr)  ((const uint16_t*)((const uint8_t*)(hdr) + TRACEFILE_POSITIONS_OFFSET((hdr)->records, (hdr)->ids, (hdr)->step)))
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+tracefile_t tracefile_open(const char *filename) {
+    object_t *object = (object_t*)NULL;
+    int res;
+
+    /* reset errno variable */
+    errno = 0;
+    /* sanity check */
+    if (!filename || !filename[0]) {
+        errno = EINVAL;
+        return NULL;
+    }
+    /* C language constructor */
+    if ((object = (object_t*)calloc(1, sizeof(object_t))) == NULL) {
+        /* errno set */
+        return NULL;
+    }
+    /* map the trace file into memory and build the block directory */
+    if (map_file(object, filename) < 0) {
+        res = errno;
+        free(object);
+        errno = res;
+        return NULL;
+    }
+    if (scan_blocks(object) < 0) {
+        res = errno;
+        unmap_file(object);
+        free(object->blocks);
+        free(object->index);
+        free(object);
+        errno = res;
+        return NULL;
+    }
+    set_position(object, 0U, 0U);
+    return (tracefile_t)object;
+}
+
+int tracefile_close(tracefile_t reader) {
+    object_t *object = (object_t*)reader;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* C language destructor */
+    unmap_file(object);
+    free(object->blocks);
+    free(object->index);
+    free(object);
+    return 0;
+}
+
+int tracefile_info(tracefile_t reader, uint64_t *records, uint64_t *first, uint64_t *last) {
+    object_t *object = (object_t*)reader;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (records)
+        *records = object->records;
+    if (first)
+        *first = object->count ? object->blocks[0].header->first : 0U;
+    if (last)
+        *last = object->count ? object->blocks[object->count - 1U].header->last : 0U;
+    return 0;
+}
+
+int tracefile_seek_time(tracefile_t reader, uint64_t time) {
+    object_t *object = (object_t*)reader;
+    uint32_t lower, upper, middle;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* binary search for the first block that ends at or after the given time */
+    lower = 0U;
+    upper = object->count;
+    while (lower < upper) {
+        middle = lower + (upper - lower) / 2U;
+        if (object->blocks[middle].header->last < time)
+            lower = middle + 1U;
+        else
+            upper = middle;
+    }
+    if (lower >= object->count) {
+        set_position(object, object->count, 0U);
+        errno = ENOMSG;
+        return -1;
+    }
+    set_position(object, lower, find_time(object->blocks[lower].header, time));
+    return 0;
+}
+
+int tracefile_seek_id(tracefile_t reader, uint32_t can_id) {
+    object_t *object = (object_t*)reader;
+    const tracefile_block_t *header;
+    const tracefile_id_t *entry;
+    size_t lower, upper, middle;
+    uint32_t block, record;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    can_id &= TRACEFILE_ID_MASK;
+    /* binary search for the first block with the identifier at or after the read position */
+    lower = 0U;
+    upper = object->entries;
+    while (lower < upper) {
+        middle = lower + (upper - lower) / 2U;
+        if ((object->index[middle].can_id < can_id) ||
+            ((object->index[middle].can_id == can_id) && (object->index[middle].block < object->block)))
+            lower = middle + 1U;
+        else
+            upper = middle;
+    }
+    /* then binary search in the position index of the block (resp. the next one) */
+    for (; (lower < object->entries) && (object->index[lower].can_id == can_id); lower++) {
+        block = object->index[lower].block;
+        record = (block == object->block) ? object->record : 0U;
+        header = object->blocks[block].header;
+        if ((entry = find_id(header, can_id)) == NULL)
+            continue;
+        if ((record = find_position(header, entry, record)) < header->records) {
+            set_position(object, block, record);
+            return 0;
+        }
+    }
+    set_position(object, object->count, 0U);
+    errno = ENOMSG;
+    return -1;
+}
+
+int tracefile_read(tracefile_t reader, tracer_record_t *record) {
+    object_t *object = (object_t*)reader;
+    const tracefile_block_t *header;
+    const tracefile_record_t *entry;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!record) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (object->block >= object->count) {
+        errno = ENOMSG;
+        return -1;
+    }
+    /* the record at the read position */
+    header = object->blocks[object->block].header;
+    entry = &RECORDS(header)[object->record];
+    record->time = object->time;
+    record->can_id = entry->can_id;
+    record->can_dlc = entry->can_dlc;
+    record->dir = entry->dir;
+    record->__res[0] = record->__res[1] = 0U;
+    memcpy(record->data, entry->data, 8U);
+    /* advance the read position (the time-stamps are delta-encoded) */
+    if (++object->record < header->records) {
+        object->time += (uint64_t)entry[1].delta;
+    } else {
+        object->block += 1U;
+        object->record = 0U;
+        object->time = (object->block < object->count) ? object->blocks[object->block].header->first : 0U;
+    }
+    return 0;
+}
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static int scan_blocks(object_t *object) {
+    const tracefile_header_t *file = (const tracefile_header_t*)object->address;
+    const tracefile_block_t *header;
+    block_t *blocks;
+    uint32_t size = 0U;
+    size_t entries = 0U;
+    size_t offset;
+
+    /* the file header */
+    if ((object->length < sizeof(tracefile_header_t)) ||
+        (memcmp(file->magic, TRACEFILE_MAGIC, sizeof(file->magic)) != 0) ||
+        (file->version != TRACEFILE_VERSION) ||
+        (file->record_size != (uint16_t)sizeof(tracefile_record_t))) {
+        errno = EBADMSG;
+        return -1;
+    }
+    /* note: the blocks are visited once to get their position in the file,
+     *       an incomplete or a damaged block terminates the trace file.
+     */
+    for (offset = sizeof(tracefile_header_t); (object->length - offset) >= sizeof(tracefile_block_t);
+         offset += (size_t)header->size) {
+        header = (const tracefile_block_t*)&object->address[offset];
+        if ((header->magic != TRACEFILE_BLOCK) || !header->records || !header->step ||
+            (header->records > TRACEFILE_RECORDS) || (header->ids > header->records) ||
+            (header->size != TRACEFILE_BLOCK_SIZE(header->records, header->ids, header->step)) ||
+            (header->size > (object->length - offset)) || !check_block(header))
+            break;
+        if (object->count >= size) {
+            size = size ? (size * 2U) : DIRECTORY_SIZE;
+            if ((blocks = (block_t*)realloc(object->blocks, (size_t)size * sizeof(block_t))) == NULL) {
+                /* errno set */
+                return -1;
+            }
+            object->blocks = blocks;
+        }
+        object->blocks[object->count].header = header;
+        object->blocks[object->count].number = object->records;
+        if (add_index(object, header, &entries) < 0) {
+            /* errno set */
+            return -1;
+        }
+        object->records += (uint64_t)header->records;
+        object->count += 1U;
+    }
+    /* the identifier directory is sorted by identifier and block */
+    if (object->entries > 1U)
+        qsort(object->index, object->entries, sizeof(index_t), compare_index);
+    return 0;
+}
+
+static bool check_block(const tracefile_block_t *header) {
+    const tracefile_id_t *ids = IDS(header);
+    uint32_t i, total = 0U;
+
+    /* note: the identifier index must cover the position index exactly */
+    for (i = 0U; i < header->ids; i++) {
+        if (!ids[i].count || (ids[i].index != total) || (ids[i].first >= header->records) ||
+            (ids[i].count > (header->records - total)))
+            return false;
+        total += ids[i].count;
+    }
+    return (total == header->records) ? true : false;
+}
+
+static int add_index(object_t *object, const tracefile_block_t *header, size_t *size) {
+    const tracefile_id_t *ids = IDS(header);
+    index_t *index;
+    uint32_t i;
+
+    /* note: a block is entered once for each of its identifiers */
+    while ((object->entries + (size_t)header->ids) > *size) {
+        *size = *size ? (*size * 2U) : INDEX_SIZE;
+        if ((index = (index_t*)realloc(object->index, *size * sizeof(index_t))) == NULL) {
+            /* errno set */
+            return -1;
+        }
+        object->index = index;
+    }
+    for (i = 0U; i < header->ids; i++) {
+        object->index[object->entries].can_id = ids[i].can_id;
+        object->index[object->entries].block = object->count;
+        object->entries += 1U;
+    }
+    return 0;
+}
+
+static int compare_index(const void *entry1, const void *entry2) {
+    const index_t *index1 = (const index_t*)entry1;
+    const index_t *index2 = (const index_t*)entry2;
+
+    if (index1->can_id != index2->can_id)
+        return (index1->can_id < index2->can_id) ? -1 : 1;
+    return (index1->block < index2->block) ? -1 : (index1->block > index2->block) ? 1 : 0;
+}
+
+static void set_position(object_t *object, uint32_t block, uint32_t record) {
+    const tracefile_block_t *header;
+    const tracefile_record_t *records;
+    uint32_t i;
+
+    if (block >= object->count) {
+        object->block = object->count;
+        object->record = 0U;
+        object->time = 0U;
+        return;
+    }
+    header = object->blocks[block].header;
+    assert(record < header->records);
+    /* absolute time from the time index plus the deltas up to the record */
+    records = RECORDS(header);
+    object->time = TIMES(header)[record / header->step];
+    for (i = (record / header->step) * header->step + 1U; i <= record; i++)
+        object->time += (uint64_t)records[i].delta;
+    object->block = block;
+    object->record = record;
+}
+
+static uint32_t find_time(const tracefile_block_t *header, uint64_t time) {
+    const tracefile_record_t *records = RECORDS(header);
+    const uint64_t *times = TIMES(header);
+    uint32_t lower = 0U, upper = (header->records + header->step - 1U) / header->step;
+    uint32_t middle, record;
+    uint64_t current;
+
+    /* binary search for the last index entry before the given time */
+    while (lower < upper) {
+        middle = lower + (upper - lower) / 2U;
+        if (times[middle] < time)
+            lower = middle + 1U;
+        else
+            upper = middle;
+    }
+    if (lower == 0U)
+        return 0U;
+    /* then at most 'step' records from there on */
+    record = (lower - 1U) * header->step;
+    current = times[lower - 1U];
+    while (((record + 1U) < header->records) && (current < time))
+        current += (uint64_t)records[++record].delta;
+    return record;
+}
+
+static const tracefile_id_t *find_id(const tracefile_block_t *header, uint32_t can_id) {
+    const tracefile_id_t *ids = IDS(header);
+    uint32_t lower = 0U, upper = header->ids;
+    uint32_t middle;
+
+    /* binary search in the sorted identifier index */
+    while (lower < upper) {
+        middle = lower + (upper - lower) / 2U;
+        if (ids[middle].can_id < can_id)
+            lower = middle + 1U;
+        else if (ids[middle].can_id > can_id)
+            upper = middle;
+        else
+            return &ids[middle];
+    }
+    return NULL;
+}
+
+static uint32_t find_position(const tracefile_block_t *header, const tracefile_id_t *entry, uint32_t record) {
+    const uint16_t *positions = &POSITIONS(header)[entry->index];
+    uint32_t lower = 0U, upper = entry->count;
+    uint32_t middle;
+
+    /* binary search for the first record with the identifier at or after the given one */
+    while (lower < upper) {
+        middle = lower + (upper - lower) / 2U;
+        if ((uint32_t)positions[middle] < record)
+            lower = middle + 1U;
+        else
+            upper = middle;
+    }
+    return (lower < entry->count) ? (uint32_t)positions[lower] : header->records;
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+static int map_file(object_t *object, const char *filename) {
+    LARGE_INTEGER size;
+
+    object->hFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (object->hFile == INVALID_HANDLE_VALUE) {
+        errno = (GetLastError() == ERROR_FILE_NOT_FOUND) ? ENOENT : EACCES;
+        return -1;
+    }
+    if (!GetFileSizeEx(object->hFile, &size) || ((uint64_t)size.QuadPart > (uint64_t)SIZE_MAX)) {
+        (void)CloseHandle(object->hFile);
+        errno = EFBIG;
+        return -1;
+    }
+    if ((object->length = (size_t)size.QuadPart) < sizeof(tracefile_header_t)) {
+        (void)CloseHandle(object->hFile);
+        errno = EBADMSG;
+        return -1;
+    }
+    if ((object->hMapping = CreateFileMapping(object->hFile, NULL, PAGE_READONLY, 0, 0, NULL)) == NULL) {
+        (void)CloseHandle(object->hFile);
+        errno = ENOMEM;
+        return -1;
+    }
+    if ((object->address = (const uint8_t*)MapViewOfFile(object->hMapping, FILE_MAP_READ, 0, 0, 0)) == NULL) {
+        (void)CloseHandle(object->hMapping);
+        (void)CloseHandle(object->hFile);
+        errno = ENOMEM;
+        return -1;
+    }
+    return 0;
+}
+
+static void unmap_file(object_t *object) {
+    (void)UnmapViewOfFile((LPCVOID)object->address);
+    (void)CloseHandle(object->hMapping);
+    (void)CloseHandle(object->hFile);
+}
+#else
+static int map_file(object_t *object, const char *filename) {
+    struct stat st;
+    void *address;
+    int fd, res;
+
+    if ((fd = open(filename, O_RDONLY)) < 0)
+        return -1;
+    if (fstat(fd, &st) < 0) {
+        res = errno;
+        (void)close(fd);
+        errno = res;
+        return -1;
+    }
+    if ((uint64_t)st.st_size > (uint64_t)SIZE_MAX) {
+        (void)close(fd);
+        errno = EFBIG;
+        return -1;
+    }
+    if ((object->length = (size_t)st.st_size) < sizeof(tracefile_header_t)) {
+        (void)close(fd);
+        errno = EBADMSG;
+        return -1;
+    }
+    if ((address = mmap(NULL, object->length, PROT_READ, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        res = errno;
+        (void)close(fd);
+        errno = res;
+        return -1;
+    }
+    /* note: the mapping is still valid when the file is closed */
+    (void)close(fd);
+    object->address = (const uint8_t*)address;
+    return 0;
+}
+
+static void unmap_file(object_t *object) {
+    (void)munmap((void*)object->address, object->length);
+}
+#endif
+
+/** @}
+ */
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,305 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'tracefile'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        tracefile.h
+ *
+ *  @brief       Binary trace file format and indexed reader.
+ *
+ *  @remarks     A binary trace file consists of a file header followed by a
+ *               sequence of self-contained blocks. Each block has a header
+ *               (number of records, time of the first and the last record),
+ *               the fixed-size records with delta-encoded time-stamps, and
+ *               a sparse index: the absolute time of every n-th record, a
+ *               table of the identifiers in the block, sorted by their value,
+ *               and the positions of the records grouped by identifier. A
+ *               block is written when it is complete; an incomplete block at
+ *               the end of a file (e.g. after a crash) is ignored.
+ *
+ *  @remarks     The reader maps a trace file into memory and builds a block
+ *               directory and an identifier directory (the blocks with each
+ *               identifier), so that seeking by time or by identifier is done
+ *               in O(log n) without reading the file. In segmented mode each
+ *               segment is a trace file of its own and has to be opened
+ *               separately.
+ *
+ *  @note        All fields are stored in host byte order.
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @defgroup    tracefile Binary Trace File
+ *  @{
+ */
+#ifndef TRACEFILE_H_INCLUDED
+#define TRACEFILE_H_INCLUDED
+
+#include "tracer.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define TRACEFILE_MAGIC    "SLCTRACE"   /**< file header: magic word */
+#define TRACEFILE_VERSION  3U           /**< file header: format version */
+#define TRACEFILE_BLOCK    0x4B4C4254U  /**< block header: magic number ('TBLK') */
+#define TRACEFILE_STEP     64U          /**< time index: one entry every 64 records */
+#define TRACEFILE_RECORDS  65536U       /**< max. number of records per block */
+
+#define TRACEFILE_ID_MASK  (TRACER_XTD_FRAME | 0x1FFFFFFFU)  /**< identifier index: XTD flag and identifier */
+
+/** @brief       aligns a size or an offset to 8 bytes
+ */
+#define TRACEFILE_ALIGN(x)  (((x) + 7U) & ~(size_t)7U)
+
+/** @brief       offset of the time index in a block with n records
+ */
+#define TRACEFILE_TIMES_OFFSET(n)  \
+        TRACEFILE_ALIGN(sizeof(tracefile_block_t) + ((size_t)(n) * sizeof(tracefile_record_t)))
+
+/** @brief       offset of the identifier index in a block with n records
+ */
+#define TRACEFILE_IDS_OFFSET(n,step)  \
+        (TRACEFILE_TIMES_OFFSET(n) + ((((size_t)(n) + (step) - 1U) / (step)) * sizeof(uint64_t)))
+
+/** @brief       offset of the position index in a block with n records and
+ *               m different identifiers
+ */
+#define TRACEFILE_POSITIONS_OFFSET(n,m,step)  \
+        (TRACEFILE_IDS_OFFSET(n,step) + ((size_t)(m) * sizeof(tracefile_id_t)))
+
+/** @brief       size of a block with n records and m different identifiers
+ */
+#define TRACEFILE_BLOCK_SIZE(n,m,step)  \
+        TRACEFILE_ALIGN(TRACEFILE_POSITIONS_OFFSET(n,m,step) + ((size_t)(n) * sizeof(uint16_t)))
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef void *tracefile_t;              /**< trace file reader (opaque data type) */
+
+/** @brief       file header (16 bytes)
+ */
+typedef struct tracefile_header_t_ {
+    char magic[8];                      /**< magic word 'SLCTRACE' */
+    uint16_t version;                   /**< format version */
+    uint16_t record_size;               /**< size of a record (in [byte]) */
+    uint32_t __res;                     /**< (reserved) */
+} tracefile_header_t;
+
+/** @brief       block header (40 bytes)
+ */
+typedef struct tracefile_block_t_ {
+    uint32_t magic;                     /**< magic number 'TBLK' */
+    uint32_t size;                      /**< size of the block incl. header (in [byte]) */
+    uint32_t records;                   /**< number of records (at least one) */
+    uint32_t ids;                       /**< number of different identifiers */
+    uint16_t step;                      /**< time index: records per entry */
+    uint16_t __res1;                    /**< (reserved) */
+    uint32_t __res2;                    /**< (reserved) */
+    uint64_t first;                     /**< time of the first record (in [ns]) */
+    uint64_t last;                      /**< time of the last record (in [ns]) */
+} tracefile_block_t;
+
+/** @brief       binary trace record (20 bytes)
+ */
+typedef struct tracefile_record_t_ {
+    uint32_t delta;                     /**< time since the previous record (in [ns]) */
+    uint32_t can_id;                    /**< identifier with frame flags */
+    uint8_t can_dlc;                    /**< data length code (0..8) */
+    uint8_t dir;                        /**< direction (TRACER_RX or TRACER_TX) */
+    uint8_t __res[2];                   /**< (reserved) */
+    uint8_t data[8];                    /**< payload */
+} tracefile_record_t;
+
+/** @brief       identifier index entry (16 bytes)
+ *
+ *  @remarks     The records with the identifier are listed in ascending order
+ *               in the position index, from entry 'index' on ('count' entries).
+ */
+typedef struct tracefile_id_t_ {
+    uint32_t can_id;                    /**< identifier with XTD flag (key) */
+    uint32_t first;                     /**< first record with this identifier */
+    uint32_t count;                     /**< number of records with this identifier */
+    uint32_t index;                     /**< its first entry in the position index */
+} tracefile_id_t;
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief       opens a binary trace file, maps it into memory and builds
+ *               the block directory and the identifier directory (constructor).
+ *
+ *  @remarks     The read position is set to the first record of the file.
+ *
+ *  @param[in]   filename  - name of the trace file
+ *
+ *  @returns     pointer to a reader instance if successful, or NULL on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EINVAL   - invalid argument (filename)
+ *  @retval      EBADMSG  - not a binary trace file (or other version)
+ *  @retval      ENOMEM   - out of memory (insufficient storage space)
+ *  @retval      'errno'  - error code from called system functions:
+ *                          'open', 'fstat', 'mmap', etc.
+ */
+extern tracefile_t tracefile_open(const char *filename);
+
+
+/** @brief       unmaps and closes the trace file (destructor).
+ *
+ *  @param[in]   reader  - pointer to a reader instance
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid reader instance)
+ */
+extern int tracefile_close(tracefile_t reader);
+
+
+/** @brief       returns the number of records and the time range of the
+ *               trace file.
+ *
+ *  @param[in]   reader   - pointer to a reader instance
+ *  @param[out]  records  - number of records (optional)
+ *  @param[out]  first    - time of the first record (in [ns], optional)
+ *  @param[out]  last     - time of the last record (in [ns], optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid reader instance)
+ */
+extern int tracefile_info(tracefile_t reader, uint64_t *records, uint64_t *first, uint64_t *last);
+
+
+/** @brief       sets the read position to the first record with a time-stamp
+ *               equal to or later than the given time.
+ *
+ *  @param[in]   reader  - pointer to a reader instance
+ *  @param[in]   time    - time (in [ns] since the epoch)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid reader instance)
+ *  @retval      ENOMSG   - no such record (read position at the end)
+ */
+extern int tracefile_seek_time(tracefile_t reader, uint64_t time);
+
+
+/** @brief       sets the read position to the next record with the given
+ *               identifier, starting at the current read position.
+ *
+ *  @remarks     Data frames and remote frames are found alike; the flag
+ *               TRACER_XTD_FRAME selects an extended identifier.
+ *
+ *  @remarks     The record is found in O(log n): by binary search in the
+ *               identifier directory for the next block with the identifier,
+ *               then in the position index of that block.
+ *
+ *  @param[in]   reader  - pointer to a reader instance
+ *  @param[in]   can_id  - identifier (with TRACER_XTD_FRAME flag)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid reader instance)
+ *  @retval      ENOMSG   - no such record (read position at the end)
+ */
+extern int tracefile_seek_id(tracefile_t reader, uint32_t can_id);
+
+
+/** @brief       reads the record at the read position and advances the
+ *               read position to the next record.
+ *
+ *  @param[in]   reader  - pointer to a reader instance
+ *  @param[out]  record  - the record with its absolute time-stamp
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid reader instance)
+ *  @retval      EINVAL   - invalid argument (record)
+ *  @retval      ENOMSG   - no more records (end of the trace file)
+ */
+extern int tracefile_read(tracefile_t reader, tracer_record_t *record);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* TRACEFILE_H_INCLUDED */
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
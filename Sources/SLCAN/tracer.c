@@ -0,0 +1,744 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'tracer'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        tracer.c
+ *
+ *  @brief       Trace file recording of CAN messages.
+ *
+ *  @remarks     The writer thread is realized by the 'poller' module, so
+ *               this module is the same for all platforms.
+ *
+ *  @remarks     The text formats (CSV, candump, ASC) are rendered by the
+ *               reentrant message formatter of the 'can_msg' module.
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @addtogroup  tracer
+ *  @{
+ */
+#include "tracer.h"
+#include "tracefile.h"
+#include "poller.h"
+#include "can_msg.h"
+#include "atomics.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <assert.h>
+#include <inttypes.h>
+#include <time.h>
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#endif
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define FIFO_SIZE  16384U               /* records per direction (power of two) */
+#define FIFO_MASK  (FIFO_SIZE - 1U)
+#define BUFFER_SIZE  262144U            /* output buffer (written in one chunk) */
+#define LINE_SIZE  128U                 /* max. length of a formatted record */
+#define HEADER_SIZE  256U               /* max. length of the file header */
+#define WRITE_INTERVAL  10U             /* writer thread: every 10ms */
+#define WRITE_CHUNK  (BUFFER_SIZE / 4U) /* write when a quarter is filled */
+#define WRITE_LATENCY  50U              /* or at the latest after 50 polls */
+#define MIN_SEGMENT  1024U              /* min. segment size (in [byte]) */
+#define CACHE_LINE  64U
+
+#define BLOCK_RECORDS  4096U            /* binary format: max. records per block */
+#define BLOCK_LATENCY  100U             /* or at the latest after 100 polls */
+#define ID_BITS  13U                    /* identifier table: 2^13 slots */
+#define ID_SLOTS  (1U << ID_BITS)       /*   (at least twice the block size) */
+#define ID_HASH(id)  (((uint32_t)(id) * 2654435761U) >> (32U - ID_BITS))
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef struct fifo_t_ {                /* single-producer ring: */
+    uint64_t dropped;                   /* - number of dropped records (producer) */
+    uint32_t tail;                      /* - write position (producer) */
+    uint8_t __pad1[CACHE_LINE - 12U];
+    uint32_t head;                      /* - read position (writer thread) */
+    uint8_t __pad2[CACHE_LINE - 4U];
+    tracer_record_t records[FIFO_SIZE]; /* - the records */
+} fifo_t;
+
+typedef struct block_t_ {               /* binary format: block under construction */
+    tracefile_record_t *records;        /* - the records */
+    uint64_t *times;                    /* - time index */
+    tracefile_id_t *ids;                /* - identifier table (open addressing) */
+    uint32_t capacity;                  /* - max. number of records */
+    uint32_t count;                     /* - number of records */
+    uint32_t distinct;                  /* - number of different identifiers */
+    uint64_t first;                     /* - time of the first record */
+    uint64_t last;                      /* - time of the last record */
+} block_t;
+
+typedef struct object_t_ {
+    fifo_t fifo[2];                     /* - one ring per direction */
+    poller_t writer;                    /* - writer thread */
+    FILE *file;                         /* - current trace file */
+    char *basename;                     /* - path and name (w/o extension) */
+    uint8_t format;                     /* - trace file format */
+    uint8_t mode;                       /* - trace file mode */
+    uint64_t segment;                   /* - segment size (in [byte]) */
+    uint32_t number;                    /* - segment number */
+    uint64_t size;                      /* - size of the current file */
+    uint64_t header;                    /* - size of the file header */
+    msg_fmt_options_t options;          /* - formatter options (text formats) */
+    uint8_t *buffer;                    /* - output buffer */
+    size_t used;                        /* - bytes in the output buffer */
+    uint64_t pending;                   /* - records in the output buffer */
+    block_t block;                      /* - current block (binary format) */
+    uint32_t polls;                     /* - polls since the last write */
+    uint64_t written;                   /* - number of written records */
+    uint64_t lost;                      /* - number of lost records (write error) */
+    int error;                          /* - first write error (errno) */
+} object_t;
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static void writer(void *arg);
+static void write_records(object_t *object, bool final);
+static void write_buffer(object_t *object);
+static void next_file(object_t *object);
+static void add_record(object_t *object, const tracer_record_t *record);
+static void write_block(object_t *object);
+static int compare_ids(const void *id1, const void *id2);
+static int create_block(object_t *object);
+static void delete_block(object_t *object);
+static int open_file(object_t *object);
+static int close_file(object_t *object);
+static void make_name(const object_t *object, uint32_t number, char *buffer, size_t length);
+static size_t format_record(object_t *object, const tracer_record_t *record, char *line);
+static size_t format_vendor(const tracer_record_t *record, char *line);
+static size_t format_header(const object_t *object, char *line);
+static size_t format_footer(const object_t *object, char *line);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+static const char hex[] = "0123456789ABCDEF";
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+tracer_t tracer_create(const char *basename, uint8_t format, uint8_t mode, uint64_t segment) {
+    object_t *object = (object_t*)NULL;
+    int res;
+
+    /* reset errno variable */
+    errno = 0;
+    /* sanity check */
+    if (!basename || !basename[0]) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if ((format != TRACER_BINARY) && (format != TRACER_CSV) &&
+        (format != TRACER_CANDUMP) && (format != TRACER_ASC) && (format != TRACER_VENDOR)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if ((mode & TRACER_SEGMENTED) && (segment < MIN_SEGMENT)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    /* C language constructor */
+    if ((object = (object_t*)calloc(1, sizeof(object_t))) == NULL) {
+        /* errno set */
+        return NULL;
+    }
+    if (((object->basename = (char*)malloc(strlen(basename) + 1U)) == NULL) ||
+        ((object->buffer = (uint8_t*)malloc(BUFFER_SIZE)) == NULL)) {
+        /* errno set */
+        free(object->basename);
+        free(object);
+        return NULL;
+    }
+    strcpy(object->basename, basename);
+    object->format = format;
+    object->mode = mode;
+    object->segment = (mode & TRACER_SEGMENTED) ? segment : UINT64_MAX;
+    object->number = 0U;
+    /* formatter options for the text formats (see 'can_msg.h') */
+    object->options.format = (format == TRACER_CSV) ? MSG_FORMAT_CSV :
+                             (format == TRACER_CANDUMP) ? MSG_FORMAT_CANDUMP :
+                             (format == TRACER_ASC) ? MSG_FORMAT_ASC : MSG_FORMAT_DEFAULT;
+    object->options.time_stamp = (format == TRACER_ASC) ? MSG_FMT_TIMESTAMP_ZERO : MSG_FMT_TIMESTAMP_ABSOLUTE;
+    object->options.end_of_line = MSG_FMT_OPTION_ON;
+    if ((format == TRACER_BINARY) && (create_block(object) < 0)) {
+        /* errno set */
+        free(object->buffer);
+        free(object->basename);
+        free(object);
+        return NULL;
+    }
+    /* open the (first) trace file */
+    if (open_file(object) < 0) {
+        res = errno;
+        delete_block(object);
+        free(object->buffer);
+        free(object->basename);
+        free(object);
+        errno = res;
+        return NULL;
+    }
+    /* start the writer thread */
+    if ((object->writer = poller_create(writer, (void*)object, WRITE_INTERVAL)) == NULL) {
+        res = errno;
+        (void)fclose(object->file);
+        delete_block(object);
+        free(object->buffer);
+        free(object->basename);
+        free(object);
+        errno = res;
+        return NULL;
+    }
+    return (tracer_t)object;
+}
+
+int tracer_destroy(tracer_t tracer) {
+    object_t *object = (object_t*)tracer;
+    int res = 0;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* stop the writer thread and write all pending records */
+    (void)poller_destroy(object->writer);
+    write_records(object, true);
+    if (object->file && (close_file(object) != 0) && !object->error)
+        object->error = errno;
+    if (object->error) {
+        errno = object->error;
+        res = -1;
+    }
+    /* C language destructor */
+    delete_block(object);
+    free(object->buffer);
+    free(object->basename);
+    free(object);
+    return res;
+}
+
+int tracer_put(tracer_t tracer, const tracer_record_t *record) {
+    object_t *object = (object_t*)tracer;
+    fifo_t *fifo;
+    uint32_t tail;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!record) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* note: the producer owns the write position of its ring */
+    fifo = &object->fifo[record->dir & TRACER_TX];
+    tail = fifo->tail;
+    if ((uint32_t)(tail - LOAD_ACQUIRE(&fifo->head)) >= FIFO_SIZE) {
+        STORE_64(&fifo->dropped, fifo->dropped + 1U);
+        errno = ENOSPC;
+        return -1;
+    }
+    fifo->records[tail & FIFO_MASK] = *record;
+    STORE_RELEASE(&fifo->tail, tail + 1U);
+    return 0;
+}
+
+int tracer_filename(tracer_t tracer, char *buffer, size_t length) {
+    object_t *object = (object_t*)tracer;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!buffer || !length) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* note: the segment number is changed by the writer thread */
+    make_name(object, LOAD_ACQUIRE(&object->number), buffer, length);
+    return 0;
+}
+
+int tracer_status(tracer_t tracer, uint64_t *written, uint64_t *dropped) {
+    object_t *object = (object_t*)tracer;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (written)
+        *written = LOAD_64(&object->written);
+    if (dropped)
+        *dropped = LOAD_64(&object->fifo[TRACER_RX].dropped) +
+                   LOAD_64(&object->fifo[TRACER_TX].dropped) + LOAD_64(&object->lost);
+    return 0;
+}
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static void writer(void *arg) {
+    object_t *object = (object_t*)arg;
+
+    assert(object);
+    write_records(object, false);
+}
+
+/*  ---  writer thread  ---
+ *
+ *  The records of both rings are merged by their time-stamp (each ring is
+ *  in chronological order) and formatted into the output buffer. A slot is
+ *  released as soon as its record has been formatted. The output buffer is
+ *  written in one chunk when a quarter of it is filled, at the latest after
+ *  WRITE_LATENCY polls, and when the tracer is destroyed.
+ *
+ *  In binary format the records are collected in a block, which is written
+ *  when it is full, at the latest after BLOCK_LATENCY polls, and when the
+ *  tracer is destroyed.
+ */
+static void write_records(object_t *object, bool final) {
+    fifo_t *rx = &object->fifo[TRACER_RX];
+    fifo_t *tx = &object->fifo[TRACER_TX];
+    uint32_t rx_tail = LOAD_ACQUIRE(&rx->tail);
+    uint32_t tx_tail = LOAD_ACQUIRE(&tx->tail);
+    const tracer_record_t *record;
+    fifo_t *fifo;
+    char line[LINE_SIZE];
+    size_t length;
+
+    while ((rx->head != rx_tail) || (tx->head != tx_tail)) {
+        /* take the older one of both rings */
+        if ((rx->head != rx_tail) &&
+            ((tx->head == tx_tail) ||
+             (rx->records[rx->head & FIFO_MASK].time <= tx->records[tx->head & FIFO_MASK].time)))
+            fifo = rx;
+        else
+            fifo = tx;
+        record = &fifo->records[fifo->head & FIFO_MASK];
+        if (object->format == TRACER_BINARY) {
+            add_record(object, record);
+            STORE_RELEASE(&fifo->head, fifo->head + 1U);
+        } else {
+            length = format_record(object, record, line);
+            STORE_RELEASE(&fifo->head, fifo->head + 1U);
+            /* start a new segment when the record does not fit into the current one */
+            if ((object->size + object->used + length) > object->segment)
+                next_file(object);
+            if ((object->used + length) > BUFFER_SIZE)
+                write_buffer(object);
+            memcpy(&object->buffer[object->used], line, length);
+            object->used += length;
+            object->pending += 1U;
+        }
+    }
+    if (object->format == TRACER_BINARY) {
+        if (final || (++object->polls >= BLOCK_LATENCY))
+            write_block(object);
+    } else if (final || (object->used >= WRITE_CHUNK) || (++object->polls >= WRITE_LATENCY))
+        write_buffer(object);
+}
+
+static void write_buffer(object_t *object) {
+    if (object->used) {
+        if (object->file && (fwrite(object->buffer, 1U, object->used, object->file) == object->used)) {
+            object->size += (uint64_t)object->used;
+            STORE_64(&object->written, object->written + object->pending);
+        } else {
+            if (!object->error)
+                object->error = object->file ? errno : EBADF;
+            STORE_64(&object->lost, object->lost + object->pending);
+        }
+    }
+    object->used = 0U;
+    object->pending = 0U;
+    object->polls = 0U;
+}
+
+static void next_file(object_t *object) {
+    write_buffer(object);
+    /* note: an empty trace file is not replaced by a new one */
+    if (object->size > object->header) {
+        if (object->file)
+            (void)close_file(object);
+        STORE_RELEASE(&object->number, object->number + 1U);
+        if ((open_file(object) < 0) && !object->error)
+            object->error = errno;
+    }
+}
+
+/*  ---  binary trace file format  ---
+ *
+ *  The records are collected in a block with a time index (every STEP-th
+ *  record) and a hash table of the identifiers. When the block is written
+ *  the identifier table is compacted and sorted, so that the reader can
+ *  find an identifier by binary search, and the positions of the records
+ *  are listed per identifier behind it. A time-stamp is stored as delta to
+ *  the previous record; when the delta does not fit into 32 bits (4.29s) a
+ *  new block is started.
+ */
+static void add_record(object_t *object, const tracer_record_t *record) {
+    block_t *block = &object->block;
+    tracefile_record_t *entry;
+    tracefile_id_t *id;
+    uint32_t can_id = record->can_id & TRACEFILE_ID_MASK;
+    uint32_t slot = ID_HASH(can_id);
+    /* note: the time-stamps must not go backwards (both rings are merged) */
+    uint64_t time = (record->time > block->last) ? record->time : block->last;
+
+    if ((block->count >= block->capacity) || (block->count && ((time - block->last) > UINT32_MAX)))
+        write_block(object);
+    if (block->count == 0U)
+        block->first = time;
+    entry = &block->records[block->count];
+    entry->delta = block->count ? (uint32_t)(time - block->last) : 0U;
+    entry->can_id = record->can_id;
+    entry->can_dlc = (record->can_dlc < 8U) ? record->can_dlc : 8U;
+    entry->dir = record->dir;
+    entry->__res[0] = entry->__res[1] = 0U;
+    memcpy(entry->data, record->data, 8U);
+    if ((block->count % TRACEFILE_STEP) == 0U)
+        block->times[block->count / TRACEFILE_STEP] = time;
+    for (id = &block->ids[slot]; id->count && (id->can_id != can_id); id = &block->ids[slot])
+        slot = (slot + 1U) & (ID_SLOTS - 1U);
+    if (!id->count) {
+        id->can_id = can_id;
+        id->first = block->count;
+        block->distinct += 1U;
+    }
+    id->count += 1U;
+    block->last = time;
+    block->count += 1U;
+}
+
+static void write_block(object_t *object) {
+    block_t *block = &object->block;
+    tracefile_block_t *header;
+    tracefile_id_t *ids;
+    uint16_t *positions;
+    size_t size;
+    uint32_t i, n, lower, upper, middle, can_id;
+
+    object->polls = 0U;
+    if (block->count == 0U)
+        return;
+    size = TRACEFILE_BLOCK_SIZE(block->count, block->distinct, TRACEFILE_STEP);
+    assert(size <= BUFFER_SIZE);
+    /* start a new segment when the block does not fit into the current one */
+    if ((object->size + object->used + size) > object->segment)
+        next_file(object);
+    if ((object->used + size) > BUFFER_SIZE)
+        write_buffer(object);
+    /* block header, records, time index, identifier index and position index */
+    header = (tracefile_block_t*)&object->buffer[object->used];
+    memset(header, 0, size);
+    header->magic = TRACEFILE_BLOCK;
+    header->size = (uint32_t)size;
+    header->records = block->count;
+    header->ids = block->distinct;
+    header->step = (uint16_t)TRACEFILE_STEP;
+    header->first = block->first;
+    header->last = block->last;
+    memcpy((uint8_t*)header + sizeof(tracefile_block_t), block->records,
+           (size_t)block->count * sizeof(tracefile_record_t));
+    memcpy((uint8_t*)header + TRACEFILE_TIMES_OFFSET(block->count), block->times,
+           (size_t)((block->count + TRACEFILE_STEP - 1U) / TRACEFILE_STEP) * sizeof(uint64_t));
+    ids = (tracefile_id_t*)((uint8_t*)header + TRACEFILE_IDS_OFFSET(block->count, TRACEFILE_STEP));
+    for (i = 0U, n = 0U; (i < ID_SLOTS) && (n < block->distinct); i++) {
+        if (block->ids[i].count) {
+            ids[n++] = block->ids[i];
+            block->ids[i].count = 0U;
+        }
+    }
+    qsort(ids, (size_t)n, sizeof(tracefile_id_t), compare_ids);
+    for (i = 0U, upper = 0U; i < n; i++) {
+        ids[i].index = upper;
+        upper += ids[i].count;
+        ids[i].count = 0U;
+    }
+    positions = (uint16_t*)((uint8_t*)header + TRACEFILE_POSITIONS_OFFSET(block->count, n, TRACEFILE_STEP));
+    for (i = 0U; i < block->count; i++) {
+        /* note: the counters are restored while the positions are listed */
+        can_id = block->records[i].can_id & TRACEFILE_ID_MASK;
+        for (lower = 0U, upper = n, middle = 0U; lower < upper; ) {
+            middle = lower + (upper - lower) / 2U;
+            if (ids[middle].can_id < can_id)
+                lower = middle + 1U;
+            else if (ids[middle].can_id > can_id)
+                upper = middle;
+            else
+                break;
+        }
+        assert(ids[middle].can_id == can_id);
+        positions[ids[middle].index + ids[middle].count++] = (uint16_t)i;
+    }
+    object->used += size;
+    object->pending += (uint64_t)block->count;
+    block->count = 0U;
+    block->distinct = 0U;
+    /* note: a block is written as soon as it is complete */
+    write_buffer(object);
+}
+
+static int compare_ids(const void *id1, const void *id2) {
+    uint32_t can_id1 = ((const tracefile_id_t*)id1)->can_id;
+    uint32_t can_id2 = ((const tracefile_id_t*)id2)->can_id;
+
+    return (can_id1 < can_id2) ? -1 : (can_id1 > can_id2) ? 1 : 0;
+}
+
+static int create_block(object_t *object) {
+    block_t *block = &object->block;
+    uint64_t capacity;
+
+    /* note: a block must fit into a segment (approx. 39 bytes per record) */
+    capacity = (object->segment - sizeof(tracefile_header_t) - 80U) / 39U;
+    block->capacity = (capacity < (uint64_t)BLOCK_RECORDS) ? (uint32_t)capacity : BLOCK_RECORDS;
+    block->records = (tracefile_record_t*)malloc((size_t)block->capacity * sizeof(tracefile_record_t));
+    block->times = (uint64_t*)malloc((size_t)((block->capacity + TRACEFILE_STEP - 1U) / TRACEFILE_STEP) * sizeof(uint64_t));
+    block->ids = (tracefile_id_t*)calloc(ID_SLOTS, sizeof(tracefile_id_t));
+    if (!block->records || !block->times || !block->ids) {
+        /* errno set */
+        delete_block(object);
+        return -1;
+    }
+    block->count = 0U;
+    block->distinct = 0U;
+    block->first = block->last = 0U;
+    return 0;
+}
+
+static void delete_block(object_t *object) {
+    free(object->block.records);
+    free(object->block.times);
+    free(object->block.ids);
+    object->block.records = NULL;
+    object->block.times = NULL;
+    object->block.ids = NULL;
+}
+
+static int open_file(object_t *object) {
+    char name[FILENAME_MAX];
+    char line[HEADER_SIZE];
+    size_t length;
+    long offset;
+
+    object->size = 0U;
+    make_name(object, object->number, name, FILENAME_MAX);
+    if ((object->file = fopen(name, (object->mode & TRACER_OVERWRITE) ? "wb" : "ab")) == NULL)
+        return -1;
+    /* note: the output buffer is written in one chunk (no stdio buffering) */
+    (void)setvbuf(object->file, NULL, _IONBF, 0U);
+    if ((fseek(object->file, 0L, SEEK_END) != 0) || ((offset = ftell(object->file)) < 0L)) {
+        (void)fclose(object->file);
+        object->file = NULL;
+        return -1;
+    }
+    object->size = (uint64_t)offset;
+    /* note: the time of the first record in the file is the reference (ASC) */
+    memset(&object->options.reference, 0, sizeof(object->options.reference));
+    /* write the file header into a new (or empty) trace file */
+    length = format_header(object, line);
+    if ((object->size == 0U) && (length > 0U)) {
+        if (fwrite(line, 1U, length, object->file) != length) {
+            (void)fclose(object->file);
+            object->file = NULL;
+            return -1;
+        }
+        object->size = (uint64_t)length;
+    }
+    object->header = (uint64_t)length;
+    return 0;
+}
+
+static int close_file(object_t *object) {
+    char line[LINE_SIZE];
+    size_t length;
+    int res;
+
+    /* write the file footer (if any) and close the trace file */
+    length = format_footer(object, line);
+    if ((length > 0U) && (fwrite(line, 1U, length, object->file) != length)) {
+        res = errno;
+        (void)fclose(object->file);
+        object->file = NULL;
+        errno = res;
+        return -1;
+    }
+    object->size += (uint64_t)length;
+    res = fclose(object->file);
+    object->file = NULL;
+    return res;
+}
+
+static void make_name(const object_t *object, uint32_t number, char *buffer, size_t length) {
+    const char *extension = (object->format == TRACER_BINARY) ? ".bin" :
+                            (object->format == TRACER_CSV) ? ".csv" :
+                            (object->format == TRACER_CANDUMP) ? ".log" :
+                            (object->format == TRACER_ASC) ? ".asc" : ".trc";
+
+    if (object->mode & TRACER_SEGMENTED)
+        (void)snprintf(buffer, length, "%s_%03" PRIu32 "%s", object->basename, number, extension);
+    else
+        (void)snprintf(buffer, length, "%s%s", object->basename, extension);
+}
+
+/*  ---  trace file formats  ---
+ *
+ *  TRACER_BINARY :  16-byte header ('SLCTRACE', version, record size, 0)
+ *                   followed by blocks of records (see 'tracefile.h')
+ *  TRACER_CSV    :  comma-separated values (see 'can_msg.c')
+ *  TRACER_CANDUMP:  candump log format (see 'can_msg.c')
+ *  TRACER_ASC    :  Vector ASCII log format with the time relative to the
+ *                   first message in the file (see 'can_msg.c')
+ *  TRACER_VENDOR :  (time) dir SLCAN-frame
+ *                   (1697123456.123456) Rx t12321122
+ */
+static size_t format_record(object_t *object, const tracer_record_t *record, char *line) {
+    msg_message_t message;
+    int n;
+
+    if (object->format == TRACER_VENDOR)
+        return format_vendor(record, line);
+    /* map the record onto a CAN API message */
+    memset(&message, 0, sizeof(msg_message_t));
+    message.xtd = (record->can_id & TRACER_XTD_FRAME) ? 1 : 0;
+    message.rtr = (record->can_id & TRACER_RTR_FRAME) ? 1 : 0;
+    message.sts = (record->can_id & TRACER_ERR_FRAME) ? 1 : 0;
+    message.id = record->can_id & (message.xtd ? 0x1FFFFFFFU : 0x7FFU);
+    message.dlc = (record->can_dlc < 8U) ? record->can_dlc : 8U;
+    memcpy(message.data, record->data, message.dlc);
+    message.timestamp.tv_sec = (time_t)(record->time / 1000000000U);
+    message.timestamp.tv_nsec = (long)(record->time % 1000000000U);
+    n = msg_format_message_r(line, LINE_SIZE, &object->options, &message,
+                             (record->dir == TRACER_TX) ? MSG_TX_MESSAGE : MSG_RX_MESSAGE, 0U, 0);
+    /* note: a classical CAN message always fits into a line */
+    return ((n > 0) && (n < (int)LINE_SIZE)) ? (size_t)n : 0U;
+}
+
+static size_t format_vendor(const tracer_record_t *record, char *line) {
+    uint32_t id = record->can_id & ((record->can_id & TRACER_XTD_FRAME) ? 0x1FFFFFFFU : 0x7FFU);
+    uint8_t dlc = (record->can_dlc < 8U) ? record->can_dlc : 8U;
+    bool xtd = (record->can_id & TRACER_XTD_FRAME) ? true : false;
+    bool rtr = (record->can_id & TRACER_RTR_FRAME) ? true : false;
+    size_t n;
+    int i;
+
+    n = (size_t)snprintf(line, LINE_SIZE, "(%" PRIu64 ".%06" PRIu64 ") %s %c",
+                         record->time / 1000000000U, (record->time % 1000000000U) / 1000U,
+                         (record->dir == TRACER_TX) ? "Tx" : "Rx", rtr ? (xtd ? 'R' : 'r') : (xtd ? 'T' : 't'));
+    for (i = xtd ? 8 : 3; i > 0; i--)
+        line[n++] = hex[(id >> ((i - 1) * 4)) & 0xFU];
+    line[n++] = hex[dlc];
+    if (!rtr) {
+        for (i = 0; i < (int)dlc; i++) {
+            line[n++] = hex[record->data[i] >> 4];
+            line[n++] = hex[record->data[i] & 0xFU];
+        }
+    }
+    line[n++] = '\n';
+    return n;
+}
+
+static size_t format_header(const object_t *object, char *line) {
+    tracefile_header_t header;
+    int n;
+
+    if (object->format == TRACER_BINARY) {
+        header.version = (uint16_t)TRACEFILE_VERSION;
+        header.record_size = (uint16_t)sizeof(tracefile_record_t);
+        header.__res = 0U;
+        memcpy(header.magic, TRACEFILE_MAGIC, sizeof(header.magic));
+        memcpy(line, &header, sizeof(tracefile_header_t));
+        return sizeof(tracefile_header_t);
+    }
+    n = msg_format_header_r(line, HEADER_SIZE, &object->options);
+    return ((n > 0) && (n < (int)HEADER_SIZE)) ? (size_t)n : 0U;
+}
+
+static size_t format_footer(const object_t *object, char *line) {
+    int n;
+
+    if (object->format == TRACER_BINARY)
+        return 0U;
+    n = msg_format_footer_r(line, LINE_SIZE, &object->options);
+    return ((n > 0) && (n < (int)LINE_SIZE)) ? (size_t)n : 0U;
+}
+
+/** @}
+ */
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
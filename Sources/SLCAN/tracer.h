@@ -0,0 +1,245 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'tracer'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        tracer.h
+ *
+ *  @brief       Trace file recording of CAN messages.
+ *
+ *  @remarks     The producers (e.g. the reception thread and the transmitting
+ *               thread) put the traced messages into lock-free single-producer
+ *               rings, one for each direction. A writer thread drains both rings
+ *               periodically, merges the records by their time-stamp, formats
+ *               them into a large buffer and writes it to the trace file in one
+ *               chunk. The producers are never blocked; when a ring is full the
+ *               record is dropped and counted.
+ *
+ *  @note        In segmented mode a new trace file is started when the current
+ *               one would exceed the segment size. The segment number is added
+ *               to the file name (e.g. 'trace_000.csv', 'trace_001.csv', ...).
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 811 $
+ *
+ *  @defgroup    tracer Trace File Recording
+ *  @{
+ */
+#ifndef TRACER_H_INCLUDED
+#define TRACER_H_INCLUDED
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+/** @name  Trace File Format
+ *  @brief Format of the trace file (file extension)
+ *  @{ */
+#define TRACER_BINARY      0x00U        /**< fixed-size binary records (.bin) */
+#define TRACER_CSV         0x01U        /**< comma-separated values (.csv) */
+#define TRACER_CANDUMP     0x02U        /**< candump log format (.log) */
+#define TRACER_ASC         0x03U        /**< Vector ASCII log format (.asc) */
+#define TRACER_VENDOR      0x80U        /**< SLCAN frames in ASCII (.trc) */
+/** @} */
+
+/** @name  Trace File Mode
+ *  @brief How the trace file is opened (can be combined)
+ *  @{ */
+#define TRACER_APPEND      0x00U        /**< append to an existing file (default) */
+#define TRACER_OVERWRITE   0x01U        /**< overwrite an existing file */
+#define TRACER_SEGMENTED   0x02U        /**< start a new file at the segment size */
+/** @} */
+
+/** @name  Trace Direction
+ *  @brief Direction of a traced message
+ *  @{ */
+#define TRACER_RX          0x00U        /**< received message */
+#define TRACER_TX          0x01U        /**< transmitted message */
+/** @} */
+
+#define TRACER_ERR_FRAME   0x40000000U  /**< error frame (flag of 'can_id') */
+#define TRACER_RTR_FRAME   0x20000000U  /**< remote frame (flag of 'can_id') */
+#define TRACER_XTD_FRAME   0x80000000U  /**< extended frame (flag of 'can_id') */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef void *tracer_t;                 /**< tracer (opaque data type) */
+
+/** @brief       trace record (one CAN message)
+ */
+typedef struct tracer_record_t_ {
+    uint64_t time;                      /**< time-stamp (in [ns] since the epoch) */
+    uint32_t can_id;                    /**< identifier with frame flags */
+    uint8_t can_dlc;                    /**< data length code (0..8) */
+    uint8_t dir;                        /**< direction (TRACER_RX or TRACER_TX) */
+    uint8_t __res[2];                   /**< (reserved) */
+    uint8_t data[8];                    /**< payload */
+} tracer_record_t;
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief       creates a tracer, opens the (first) trace file and starts
+ *               the writer thread (constructor).
+ *
+ *  @param[in]   basename  - path and name of the trace file (w/o extension)
+ *  @param[in]   format    - trace file format (TRACER_BINARY, _CSV, _CANDUMP,
+ *                           _ASC or _VENDOR)
+ *  @param[in]   mode      - trace file mode (TRACER_APPEND, _OVERWRITE and/or
+ *                           _SEGMENTED)
+ *  @param[in]   segment   - segment size (in [byte], only in segmented mode)
+ *
+ *  @returns     pointer to a tracer instance if successful, or NULL on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EINVAL   - invalid argument (basename, format or segment)
+ *  @retval      ENOMEM   - out of memory (insufficient storage space)
+ *  @retval      'errno'  - error code from called system functions:
+ *                          'fopen', 'fwrite', etc.
+ */
+extern tracer_t tracer_create(const char *basename, uint8_t format, uint8_t mode, uint64_t segment);
+
+
+/** @brief       stops the writer thread, writes all pending records and
+ *               closes the trace file (destructor).
+ *
+ *  @remarks     The producers must not call 'tracer_put' during or after
+ *               the call of this function.
+ *
+ *  @param[in]   tracer  - pointer to a tracer instance
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid tracer instance)
+ *  @retval      'errno'  - error code from called system functions:
+ *                          'fwrite', 'fclose', etc.
+ */
+extern int tracer_destroy(tracer_t tracer);
+
+
+/** @brief       puts a record into the ring of its direction (lock-free).
+ *
+ *  @remarks     There must be at most one producer per direction at a time
+ *               (e.g. the reception thread for TRACER_RX). The function does
+ *               not wait and does not call any system function.
+ *
+ *  @param[in]   tracer  - pointer to a tracer instance
+ *  @param[in]   record  - the record to be traced
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid tracer instance)
+ *  @retval      EINVAL   - invalid argument (record)
+ *  @retval      ENOSPC   - no space left (record dropped)
+ */
+extern int tracer_put(tracer_t tracer, const tracer_record_t *record);
+
+
+/** @brief       returns the file name of the current trace file.
+ *
+ *  @param[in]   tracer  - pointer to a tracer instance
+ *  @param[out]  buffer  - buffer for the file name (zero-terminated)
+ *  @param[in]   length  - size of the buffer (in [byte])
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid tracer instance)
+ *  @retval      EINVAL   - invalid argument (buffer or length)
+ */
+extern int tracer_filename(tracer_t tracer, char *buffer, size_t length);
+
+
+/** @brief       returns the number of written and dropped records.
+ *
+ *  @param[in]   tracer   - pointer to a tracer instance
+ *  @param[out]  written  - number of records written to the trace file (optional)
+ *  @param[out]  dropped  - number of records dropped (ring full or write error)
+ *                          (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid tracer instance)
+ */
+extern int tracer_status(tracer_t tracer, uint64_t *written, uint64_t *dropped);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* TRACER_H_INCLUDED */
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
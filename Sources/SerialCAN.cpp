@@ -295,6 +295,42 @@ CANAPI_Return_t CSerialCAN::ReadMessage(CANAPI_Message_t &message, uint16_t time
     return can_read(m_Handle, &message, timeout);
 }
 
+EXPORT
+CANAPI_Return_t CSerialCAN::WriteMessageUs(CANAPI_Message_t message, uint64_t timeout) {
+    // transmit a message over the CAN bus (with a time-out in [us])
+    return can_write_us(m_Handle, &message, timeout);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::ReadMessageUs(CANAPI_Message_t &message, uint64_t timeout) {
+    // read one message from the message queue of the CAN interface, if any (with a time-out in [us])
+    return can_read_us(m_Handle, &message, timeout);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::ReadLatest(uint32_t id, bool xtd, CANAPI_Message_t &message) {
+    // read the latest message of an identifier from the mailbox of the CAN interface, if any
+    return can_read_latest(m_Handle, xtd ? (id | CANSIO_XTD_ID) : id, &message);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::SetRxHandler(can_rx_handler_t handler, void *context) {
+    // install a handler called by the reception thread for each received message
+    return can_callback(m_Handle, handler, context);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::SetStatusHandler(can_status_handler_t handler, void *context) {
+    // install a handler called by the status polling when the bus status changes
+    return can_status_callback(m_Handle, handler, context);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::ReplayTrace(const char *filename, uint16_t speed, can_replay_stats_t &stats) {
+    // transmit the messages of a trace file with the original timing (scaled by the speed factor)
+    return can_replay(m_Handle, filename, speed, &stats);
+}
+
 EXPORT
 CANAPI_Return_t CSerialCAN::GetStatus(CANAPI_Status_t &status) {
     // retrieve the status register of the CAN interface
@@ -387,6 +423,12 @@ CANAPI_Return_t CSerialCAN::ResetFilters() {
     return can_property(m_Handle, CANPROP_SET_FILTER_RESET, NULL, 0U);
 }
 
+EXPORT
+CANAPI_Return_t CSerialCAN::RefreshIdentity() {
+    // re-read serial number and version numbers of the CAN interface
+    return can_property(m_Handle, SERIALCAN_PROPERTY_DEVICE_REFRESH, NULL, 0U);
+}
+
 EXPORT
 char *CSerialCAN::GetHardwareVersion() {
     // retrieve the hardware version of the CAN controller
@@ -110,6 +110,12 @@ public:
 
     CANAPI_Return_t WriteMessage(CANAPI_Message_t message, uint16_t timeout = 0U);
     CANAPI_Return_t ReadMessage(CANAPI_Message_t &message, uint16_t timeout = CANWAIT_INFINITE);
+    CANAPI_Return_t WriteMessageUs(CANAPI_Message_t message, uint64_t timeout = 0U);  // time-out in [us]
+    CANAPI_Return_t ReadMessageUs(CANAPI_Message_t &message, uint64_t timeout = CANSIO_INFINITE_US);  // time-out in [us]
+    CANAPI_Return_t ReadLatest(uint32_t id, bool xtd, CANAPI_Message_t &message);
+    CANAPI_Return_t SetRxHandler(can_rx_handler_t handler, void *context = NULL);
+    CANAPI_Return_t SetStatusHandler(can_status_handler_t handler, void *context = NULL);
+    CANAPI_Return_t ReplayTrace(const char *filename, uint16_t speed, can_replay_stats_t &stats);  // speed in [%]
 
     CANAPI_Return_t GetStatus(CANAPI_Status_t &status);
     CANAPI_Return_t GetBusLoad(uint8_t &load);
@@ -126,6 +132,8 @@ public:
     CANAPI_Return_t GetFilter29Bit(uint32_t &code, uint32_t &mask);
     CANAPI_Return_t ResetFilters();
 
+    CANAPI_Return_t RefreshIdentity();
+
     char *GetHardwareVersion();  // (for compatibility reasons)
     char *GetFirmwareVersion();  // (for compatibility reasons)
     static char *GetVersion();  // (for compatibility reasons)
@@ -170,12 +178,60 @@ public:
 #define SERIALCAN_PROPERTY_TX_COUNTER           (CANPROP_GET_TX_COUNTER)
 #define SERIALCAN_PROPERTY_RX_COUNTER           (CANPROP_GET_RX_COUNTER)
 #define SERIALCAN_PROPERTY_ERR_COUNTER          (CANPROP_GET_ERR_COUNTER)
-//#define SERIALCAN_PROPERTY_RCV_QUEUE_SIZE       (CANPROP_GET_RCV_QUEUE_SIZE)
-//#define SERIALCAN_PROPERTY_RCV_QUEUE_HIGH       (CANPROP_GET_RCV_QUEUE_HIGH)
-//#define SERIALCAN_PROPERTY_RCV_QUEUE_OVFL       (CANPROP_GET_RCV_QUEUE_OVFL)
+#define SERIALCAN_PROPERTY_RCV_QUEUE_SIZE       (CANPROP_GET_RCV_QUEUE_SIZE)
+#define SERIALCAN_PROPERTY_RCV_QUEUE_HIGH       (CANPROP_GET_RCV_QUEUE_HIGH)
+#define SERIALCAN_PROPERTY_RCV_QUEUE_OVFL       (CANPROP_GET_RCV_QUEUE_OVFL)
 #define SERIALCAN_PROPERTY_SERIAL_NUMBER        (CANPROP_GET_VENDOR_PROP + SLCAN_SERIAL_NUMBER)
 #define SERIALCAN_PROPERTY_HARDWARE_VERSION     (CANPROP_GET_VENDOR_PROP + SLCAN_HARDWARE_VERSION)
 #define SERIALCAN_PROPERTY_FIRMWARE_VERSION     (CANPROP_GET_VENDOR_PROP + SLCAN_FIRMWARE_VERSION)
+#define SERIALCAN_PROPERTY_DEVICE_REFRESH       (CANPROP_SET_VENDOR_PROP + SLCAN_DEVICE_REFRESH)
 #define SERIALCAN_PROPERTY_CLOCK_DOMAIN         (CANPROP_GET_CAN_CLOCK)
+#define SERIALCAN_PROPERTY_SET_RCV_QUEUE_SIZE   (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE)
+#define SERIALCAN_PROPERTY_RCV_QUEUE_POLICY     (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_POLICY)
+#define SERIALCAN_PROPERTY_SET_RCV_QUEUE_POLICY (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_POLICY)
+#define SERIALCAN_PROPERTY_RCV_QUEUE_TIMEOUT    (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_TIMEOUT)
+#define SERIALCAN_PROPERTY_SET_RCV_QUEUE_TIMEOUT (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_TIMEOUT)
+#define SERIALCAN_PROPERTY_RCV_DROPPED_NEWEST   (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_DROPPED_NEWEST)
+#define SERIALCAN_PROPERTY_RCV_DROPPED_OLDEST   (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_DROPPED_OLDEST)
+#define SERIALCAN_PROPERTY_RCV_DROPPED_EXPIRED  (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_DROPPED_EXPIRED)
+#define SERIALCAN_PROPERTY_RCV_SPILL_FOLDER     (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_SPILL_FOLDER)
+#define SERIALCAN_PROPERTY_SET_RCV_SPILL_FOLDER (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_SPILL_FOLDER)
+#define SERIALCAN_PROPERTY_RCV_SPILL_SIZE       (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_SPILL_SIZE)
+#define SERIALCAN_PROPERTY_SET_RCV_SPILL_SIZE   (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_SPILL_SIZE)
+#define SERIALCAN_PROPERTY_RCV_SPILL_THRESHOLD  (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_SPILL_THRESHOLD)
+#define SERIALCAN_PROPERTY_SET_RCV_SPILL_THRESHOLD (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_SPILL_THRESHOLD)
+#define SERIALCAN_PROPERTY_RCV_MAILBOX          (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_MAILBOX)
+#define SERIALCAN_PROPERTY_SET_RCV_MAILBOX      (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_MAILBOX)
+#define SERIALCAN_PROPERTY_RCV_REDUCTION        (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_REDUCTION)
+#define SERIALCAN_PROPERTY_SET_RCV_REDUCTION    (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_REDUCTION)
+#define SERIALCAN_PROPERTY_RCV_DECIMATION       (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_DECIMATION)
+#define SERIALCAN_PROPERTY_SET_RCV_DECIMATION   (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_DECIMATION)
+#define SERIALCAN_PROPERTY_RCV_SUPPRESSED       (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_SUPPRESSED)
+#define SERIALCAN_PROPERTY_STATUS_POLLING       (CANPROP_GET_VENDOR_PROP + SLCAN_STATUS_POLLING)
+#define SERIALCAN_PROPERTY_SET_STATUS_POLLING   (CANPROP_SET_VENDOR_PROP + SLCAN_STATUS_POLLING)
+#define SERIALCAN_PROPERTY_RECORDER_ACTIVE      (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_ACTIVE)
+#define SERIALCAN_PROPERTY_SET_RECORDER_ACTIVE  (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_ACTIVE)
+#define SERIALCAN_PROPERTY_RECORDER_FRAMES      (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_FRAMES)
+#define SERIALCAN_PROPERTY_SET_RECORDER_FRAMES  (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_FRAMES)
+#define SERIALCAN_PROPERTY_RECORDER_TIME        (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_TIME)
+#define SERIALCAN_PROPERTY_SET_RECORDER_TIME    (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_TIME)
+#define SERIALCAN_PROPERTY_RECORDER_POST_FRAMES (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_POST_FRAMES)
+#define SERIALCAN_PROPERTY_SET_RECORDER_POST_FRAMES (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_POST_FRAMES)
+#define SERIALCAN_PROPERTY_RECORDER_POST_TIME   (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_POST_TIME)
+#define SERIALCAN_PROPERTY_SET_RECORDER_POST_TIME (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_POST_TIME)
+#define SERIALCAN_PROPERTY_RECORDER_EVENTS      (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_EVENTS)
+#define SERIALCAN_PROPERTY_SET_RECORDER_EVENTS  (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_EVENTS)
+#define SERIALCAN_PROPERTY_RECORDER_PATTERN     (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_PATTERN)
+#define SERIALCAN_PROPERTY_SET_RECORDER_PATTERN (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_PATTERN)
+#define SERIALCAN_PROPERTY_RECORDER_TRIGGER     (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_TRIGGER)
+#define SERIALCAN_PROPERTY_RECORDER_DUMPS       (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_DUMPS)
+#define SERIALCAN_PROPERTY_RECORDER_IGNORED     (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_IGNORED)
+#define SERIALCAN_PROPERTY_RECORDER_FILE        (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_FILE)
+#define SERIALCAN_PROPERTY_CAPTURE_ACTIVE       (CANPROP_GET_VENDOR_PROP + SLCAN_CAPTURE_ACTIVE)
+#define SERIALCAN_PROPERTY_SET_CAPTURE_ACTIVE   (CANPROP_SET_VENDOR_PROP + SLCAN_CAPTURE_ACTIVE)
+#define SERIALCAN_PROPERTY_CAPTURE_TYPE         (CANPROP_GET_VENDOR_PROP + SLCAN_CAPTURE_TYPE)
+#define SERIALCAN_PROPERTY_SET_CAPTURE_TYPE     (CANPROP_SET_VENDOR_PROP + SLCAN_CAPTURE_TYPE)
+#define SERIALCAN_PROPERTY_CAPTURE_FILE         (CANPROP_GET_VENDOR_PROP + SLCAN_CAPTURE_FILE)
+#define SERIALCAN_PROPERTY_CAPTURE_DROPPED      (CANPROP_GET_VENDOR_PROP + SLCAN_CAPTURE_DROPPED)
 /// \}
 #endif // SERIALCAN_H_INCLUDED
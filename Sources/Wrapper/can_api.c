@@ -80,12 +80,20 @@
 #include "slcan.h"
 #else
 #include <unistd.h>
+#include <pthread.h>
 #include "slcan.h"
 #endif
+#include "tracer.h"
+#include "tracefile.h"
+#include "recorder.h"
+#include "capture.h"
+#include "timer.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
+#include <time.h>
 
 /*  -----------  options  ------------------------------------------------
  */
@@ -113,11 +121,70 @@ static void _finalizer() {
 /*  -----------  defines  ------------------------------------------------
  */
 #ifndef CAN_MAX_HANDLES
-#define CAN_MAX_HANDLES         (16)    // maximum number of open handles
+#define CAN_MAX_HANDLES         (1024)  // maximum number of open handles
 #endif
+#define CAN_HANDLE_BLOCK        (16)    // handles per block of the table
+#define CAN_HANDLE_BLOCKS       ((CAN_MAX_HANDLES + CAN_HANDLE_BLOCK - 1) / CAN_HANDLE_BLOCK)
+#define CAN_NAME_BUCKETS        (64)    // buckets of the name index
+#define CAN_CLOSE_INTERVAL      (10)    // wake-up interval in [ms] (closing)
 #define INVALID_HANDLE          (-1)
-#define IS_HANDLE_VALID(hnd)    ((0 <= (hnd)) && ((hnd) < CAN_MAX_HANDLES))
-#define IS_HANDLE_OPENED(hnd)   (can[hnd].port != NULL)
+#define IS_HANDLE_VALID(hnd)    ((0 <= (hnd)) && ((hnd) < ATOMIC_GET(&handles)))
+#define CHANNEL(hnd)            (table[(hnd) / CAN_HANDLE_BLOCK][(hnd) % CAN_HANDLE_BLOCK])
+#define IS_HANDLE_OPENED(hnd)   (ATOMIC_GET(&CHANNEL(hnd).state) == HANDLE_OPENED)
+#define IS_STOPPED(hnd)         ((ATOMIC_GET8(&CHANNEL(hnd).status.byte) & CANSTAT_RESET) != 0U)
+#define STATUS(hnd)             ATOMIC_GET8(&CHANNEL(hnd).status.byte)
+#define IS_SUBSCRIBER(hnd)      (CHANNEL(hnd).owner != INVALID_HANDLE)
+#define DEVICE(hnd)             (IS_SUBSCRIBER(hnd) ? CHANNEL(hnd).owner : (hnd))
+#define BUS_STATUS              (CANSTAT_BOFF | CANSTAT_EWRN | CANSTAT_BERR | CANSTAT_MSG_LST)
+#define TO_USEC(ms)             (((ms) != CANWAIT_INFINITE) ? ((uint64_t)(ms) * 1000U) : CANSIO_INFINITE_US)
+#define TO_MSEC(us)             (((us) != CANSIO_INFINITE_US) ? (uint16_t)(((us) < 65534000U) ? (((us) + 999U) / 1000U) : 65534U) : CANWAIT_INFINITE)
+
+#define HANDLE_FREE             0       // handle can be used
+#define HANDLE_BUSY             1       // handle is being opened or closed
+#define HANDLE_OPENED           2       // handle is in use
+
+#if defined(_MSC_VER)
+#define ATOMIC_GET(ptr)         (int32_t)InterlockedCompareExchange((volatile LONG*)(ptr), 0, 0)
+#define ATOMIC_SET(ptr,val)     (void)InterlockedExchange((volatile LONG*)(ptr), (LONG)(val))
+#define ATOMIC_INC(ptr)         (void)InterlockedIncrement((volatile LONG*)(ptr))
+#define ATOMIC_DEC(ptr)         (void)InterlockedDecrement((volatile LONG*)(ptr))
+#define ATOMIC_GET8(ptr)        (uint8_t)_InterlockedOr8((volatile char*)(ptr), 0)
+#define ATOMIC_CAS8(ptr,old,val) ((uint8_t)_InterlockedCompareExchange8((volatile char*)(ptr), (char)(val), (char)(old)) == (uint8_t)(old))
+#define ATOMIC_GET64(ptr)       (uint64_t)InterlockedCompareExchange64((volatile LONG64*)(ptr), 0, 0)
+#define ATOMIC_SET64(ptr,val)   (void)InterlockedExchange64((volatile LONG64*)(ptr), (LONG64)(val))
+#define ATOMIC_ADD64(ptr,val)   (void)InterlockedExchangeAdd64((volatile LONG64*)(ptr), (LONG64)(val))
+#else
+#define ATOMIC_GET(ptr)         __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+#define ATOMIC_SET(ptr,val)     __atomic_store_n((ptr), (val), __ATOMIC_SEQ_CST)
+#define ATOMIC_INC(ptr)         (void)__atomic_add_fetch((ptr), 1, __ATOMIC_SEQ_CST)
+#define ATOMIC_DEC(ptr)         (void)__atomic_sub_fetch((ptr), 1, __ATOMIC_SEQ_CST)
+#define ATOMIC_GET8(ptr)        __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+#define ATOMIC_CAS8(ptr,old,val) __atomic_compare_exchange_n((ptr), &(old), (val), false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+#define ATOMIC_GET64(ptr)       __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+#define ATOMIC_SET64(ptr,val)   __atomic_store_n((ptr), (uint64_t)(val), __ATOMIC_SEQ_CST)
+#define ATOMIC_ADD64(ptr,val)   (void)__atomic_add_fetch((ptr), (uint64_t)(val), __ATOMIC_SEQ_CST)
+#endif
+#if defined(_WIN32) || defined(_WIN64)
+#define LOCK_TABLE()            AcquireSRWLockExclusive(&table_lock)
+#define UNLOCK_TABLE()          ReleaseSRWLockExclusive(&table_lock)
+#define LOCK_CLOSE()            AcquireSRWLockExclusive(&close_lock)
+#define UNLOCK_CLOSE()          ReleaseSRWLockExclusive(&close_lock)
+#define WAIT_CLOSE()            (void)SleepConditionVariableSRW(&close_cond, &close_lock, CAN_CLOSE_INTERVAL, 0)
+#define SIGNAL_CLOSE()          WakeAllConditionVariable(&close_cond)
+#else
+#define LOCK_TABLE()            (void)pthread_mutex_lock(&table_lock)
+#define UNLOCK_TABLE()          (void)pthread_mutex_unlock(&table_lock)
+#define LOCK_CLOSE()            (void)pthread_mutex_lock(&close_lock)
+#define UNLOCK_CLOSE()          (void)pthread_mutex_unlock(&close_lock)
+#define WAIT_CLOSE()            do{ struct timespec ts; (void)clock_gettime(CLOCK_REALTIME, &ts); \
+                                    ts.tv_nsec += (long)CAN_CLOSE_INTERVAL * 1000000L; \
+                                    if (ts.tv_nsec >= 1000000000L) { \
+                                        ts.tv_nsec -= 1000000000L; \
+                                        ts.tv_sec += (time_t)1; \
+                                    } \
+                                    (void)pthread_cond_timedwait(&close_cond, &close_lock, &ts); } while(0)
+#define SIGNAL_CLOSE()          (void)pthread_cond_broadcast(&close_cond)
+#endif
 
 #define SERIAL_BAUDRATE         57600U
 #define SERIAL_BYTESIZE         CANSIO_8DATABITS
@@ -125,10 +192,25 @@ static void _finalizer() {
 #define SERIAL_STOPBITS         CANSIO_1STOPBIT
 #define SERIAL_PROTOCOL         CANSIO_LAWICEL
 
-#define SUPPORTED_OP_MODE       (CANMODE_DEFAULT)
+#define SUPPORTED_OP_MODE       (CANMODE_SHRD)
 #define CAN_CLOCK_FREQUENCY     CANBTR_FREQ_SJA1000
 #define CAN_BTR_DEFAULT         0x011CU
-#define SLCAN_QUEUE_SIZE        65536U
+#define SLCAN_QUEUE_SIZE        65536U  // default (allocated on demand)
+#define SLCAN_QUEUE_LIMIT       16777216U
+#define SLCAN_QUEUE_POLICY      CANSIO_DROP_NEWEST
+#define SLCAN_QUEUE_TIMEOUT     100U    // in [ms] (bounded-block)
+#define SLCAN_SPILL_LIMIT       268435456U
+#define SLCAN_REDUCTION         CANSIO_REDUCE_OFF
+#define SLCAN_DECIMATION        10U     // in [msg/s] per identifier
+#define SLCAN_POLLING           0U      // in [ms] (0 = off)
+#define TRACE_SEGMENT_SIZE      104857600U  // in [byte] (trace size 0)
+#define RECORDER_FRAMES         10000U  // pre-trigger window in [frames]
+#define RECORDER_POST_TIME      1000U   // post-trigger window in [ms]
+#define REPLAY_HISTOGRAM        10000U  // timing errors in [us] (1us per bin)
+#define REPLAY_SLICE            10000000U  // max. waiting time in [ns] (abort check)
+#define TRACE_MODE_SUPPORTED    (CANPARA_TRACE_MODE_OVERWRITE | CANPARA_TRACE_MODE_SEGMENTED | \
+                                 CANPARA_TRACE_MODE_PREFIX_DATE | CANPARA_TRACE_MODE_PREFIX_TIME | \
+                                 CANPARA_TRACE_MODE_OUTPUT_LEN)
 #define FILTER_STD_CODE         (uint32_t)(0x000)
 #define FILTER_STD_MASK         (uint32_t)(0x000)
 #define FILTER_XTD_CODE         (uint32_t)(0x00000000)
@@ -165,6 +247,53 @@ typedef struct {                        // frame counters:
     uint64_t err;                       //   number of receiced error frames
 }   can_counter_t;
 
+typedef struct {                        // receive queue:
+    uint8_t policy;                     //   overflow policy
+    uint16_t timeout;                   //   blocking time (bounded-block)
+    uint32_t spill;                     //   spill file size (0 = off)
+    uint32_t threshold;                 //   spill threshold (0 = queue full)
+    char folder[CANPROP_MAX_BUFFER_SIZE]; // spill file folder
+    bool mailbox;                       //   latest-value mailbox (on/off)
+    uint8_t reduction;                  //   data reduction mode
+    uint16_t rate;                      //   decimation rate (msg/s per ID)
+}   can_queue_t;
+
+typedef struct {                        // reception callback:
+    can_rx_handler_t handler;           //   handler function (or NULL)
+    void *context;                      //   context of the handler
+}   can_callback_t;
+
+typedef struct {                        // status polling:
+    uint16_t interval;                  //   polling interval in [ms] (0 = off)
+    can_status_handler_t handler;       //   status handler (or NULL)
+    void *context;                      //   context of the handler
+}   can_polling_t;
+
+typedef struct {                        // trace file:
+    uint8_t type;                       //   trace file type
+    uint16_t mode;                      //   trace file mode
+    uint16_t size;                      //   segment size (in [10KB], 0 = 100MB)
+    char folder[CANPROP_MAX_BUFFER_SIZE]; // trace file folder
+    char file[CANPROP_MAX_BUFFER_SIZE]; //   name of the last trace file
+    tracer_t tracer;                    //   trace file writer (or NULL)
+}   can_trace_t;
+
+typedef struct {                        // flight recorder:
+    recorder_attr_t attr;               //   recorder settings
+    uint32_t dumps;                     //   number of dumps (last recording)
+    uint32_t ignored;                   //   number of ignored triggers (ditto)
+    char file[CANPROP_MAX_BUFFER_SIZE]; //   name of the last dump file
+    recorder_t recorder;                //   flight recorder (or NULL)
+}   can_flight_t;
+
+typedef struct {                        // packet capture:
+    uint8_t type;                       //   content of the pcapng file
+    bool decoded;                       //   SocketCAN frames (current capture)
+    uint64_t dropped;                   //   number of dropped packets (last capture)
+    char file[CANPROP_MAX_BUFFER_SIZE]; //   name of the last pcapng file
+    capture_t capture;                  //   pcapng file writer (or NULL)
+}   can_capture_t;
+
 typedef struct {                        // SLCAN interface:
     slcan_port_t port;                  //   serial communication port
     can_sio_attr_t attr;                //   serial communication attributes
@@ -172,6 +301,20 @@ typedef struct {                        // SLCAN interface:
     can_filter_t filter;                //   message filter settings
     can_status_t status;                //   8-bit status register
     can_counter_t counters;             //   statistical counters
+    can_queue_t queue;                  //   receive queue settings
+    can_callback_t callback;            //   reception callback
+    can_polling_t polling;              //   status polling
+    can_trace_t trace;                  //   trace file recording
+    can_flight_t flight;                //   flight recorder
+    can_capture_t capture;              //   packet capture
+    int owner;                          //   owner handle (shared access)
+    int reader;                         //   subscriber no. (shared access)
+    int32_t state;                      //   handle state (atomic)
+    int32_t users;                      //   reference counter (atomic)
+    int32_t replaying;                  //   replay in progress (atomic)
+    int link;                           //   next handle (free list or name index)
+    slcan_identity_t identity;          //   device identity (cached)
+    bool identified;                    //   device identity is cached
     uint16_t btr0btr1;                  //   bit-rate settings
     char name[CANPROP_MAX_BUFFER_SIZE]; //   TTY device name
 }   can_interface_t;
@@ -180,18 +323,62 @@ typedef struct {                        // SLCAN interface:
  */
 static void var_init(void);             // initialize all variables
 static int all_closed(void);            // check if all handles closed
+static void init_handle(int handle);    // initialize a single handle
+static int grow_table(void);            // add a block of handles
+static int new_handle(const char *name);// reserve an unused handle
+static void free_handle(int handle);    // release a handle
+static int find_handle(const char *name);  // lookup a handle by name
+static unsigned name_hash(const char *name);
+static int acquire_handle(int handle);  // use an open handle
+static void release_handle(int handle); // handle no longer used
+static void set_status(int handle, uint8_t mask, uint8_t bits);
 
 static int exit_channel(int handle);    // teardown a single channel
 static int kill_channel(int handle);    // signal a single channel
-
-static slcan_attr_t* slcan_attr(const can_sio_attr_t* attr);
+static int start_channel(int handle, const can_bitrate_t *bitrate);
+static int reset_channel(int handle);
+static int write_channel(int handle, const can_message_t *msg, uint64_t timeout);
+static int read_channel(int handle, can_message_t *msg, uint64_t timeout);
+static int peek_channel(int handle, uint32_t id, can_message_t *msg);
+static int callback_channel(int handle, can_rx_handler_t handler, void *context);
+static int notify_channel(int handle, can_status_handler_t handler, void *context);
+static int replay_channel(int handle, const char *filename, uint16_t speed, can_replay_stats_t *stats);
+static int status_channel(int handle, uint8_t *status);
+static int busload_channel(int handle, uint8_t *load, uint8_t *status);
+static int bitrate_channel(int handle, can_bitrate_t *bitrate, can_speed_t *speed);
+
+static slcan_attr_t* slcan_attr(const can_sio_attr_t* attr, slcan_attr_t *slcan);
+static void map_message(can_message_t *msg, const slcan_message_t *slcan);
+static void rx_handler(const slcan_message_t *message, const struct timespec *timestamp, void *context);
+static uint8_t map_flags(slcan_flags_t flags);
+static void status_handler(slcan_flags_t flags, void *context);
+static void trace_handler(const slcan_message_t *message, const struct timespec *timestamp, bool tx, void *context);
+static void capture_handler(const uint8_t *buffer, size_t nbytes, const struct timespec *timestamp, bool tx, void *context);
 static int slcan_error(int code);       // SLCAN specific errors
 static int get_sio_attr(slcan_port_t port, can_sio_attr_t *attr);
 static int set_filter(int handle, uint64_t filter, bool xtd);
 static int reset_filter(int handle);
+static int get_busload(int handle, uint16_t *load);
+static int set_policy(int handle, uint8_t policy, uint16_t timeout);
+static int set_spill(int handle, const char *folder, uint32_t size);
+static int set_reduction(int handle, uint8_t mode, uint16_t rate);
+static int set_tracing(int handle);
+static int trace_format(int handle, uint8_t *format);
+static void trace_basename(int handle, const char *suffix, char *basename, size_t size);
+static int start_trace(int handle);
+static int stop_trace(int handle);
+static int start_recorder(int handle);
+static int stop_recorder(int handle);
+static int start_capture(int handle);
+static int stop_capture(int handle);
+static uint32_t percentile(const uint64_t *histogram, uint64_t count, uint32_t max, uint32_t permille);
+static int init_subscriber(int owner, uint8_t mode);
+static int refresh_identity(int handle);
+static int start_subscriber(int handle);
 
 static int lib_parameter(uint16_t param, void *value, size_t nbyte);
 static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte);
+static int sub_parameter(int handle, uint16_t param, void *value, size_t nbyte);
 
 /*  -----------  variables  ----------------------------------------------
  */
@@ -205,8 +392,20 @@ can_board_t can_boards[NUM_CHANNELS+1] = {  // list of supported CAN channels
 //static const uint8_t dlc_table[16] = {  // DLC to length
 //    0,1,2,3,4,5,6,7,8,12,16,20,24,32,48,64
 //};
-static can_interface_t can[CAN_MAX_HANDLES];  // interface handles
-static int init = 0;                    // initialization flag
+static can_interface_t *table[CAN_HANDLE_BLOCKS];  // interface handles
+static int32_t handles = 0;             // number of allocated handles
+static int free_list = INVALID_HANDLE;  // unused handles (linked list)
+static int names[CAN_NAME_BUCKETS];     // handles by TTY name (hash index)
+static int32_t init = 0;                // initialization flag
+#if defined(_WIN32) || defined(_WIN64)
+static SRWLOCK table_lock = SRWLOCK_INIT;  // for opening and closing
+static SRWLOCK close_lock = SRWLOCK_INIT;  // for waiting on the last user
+static CONDITION_VARIABLE close_cond = CONDITION_VARIABLE_INIT;
+#else
+static pthread_mutex_t table_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t close_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t close_cond = PTHREAD_COND_INITIALIZER;
+#endif
 
 /*  -----------  functions  ----------------------------------------------
  */
@@ -214,7 +413,6 @@ EXPORT
 int can_test(int32_t channel, uint8_t mode, const void *param, int *result)
 {
     int rc = CANERR_NOERROR;            // return value
-    int i;                              // loop variable
 
     if (result)                         // serial device not testtable
         *result = CANBRD_NOT_TESTABLE;
@@ -240,9 +438,10 @@ int can_test(int32_t channel, uint8_t mode, const void *param, int *result)
     if (name == NULL)                   // must have at least a TTY name
         return CANERR_NULLPTR;
 
+    LOCK_TABLE();                       // note: opening and closing
     if (!init) {                        // if not initialized:
         var_init();                     //   initialize all variables
-        init = 1;                       //   set initialization flag
+        ATOMIC_SET(&init, 1);           //   set initialization flag
     }
     // check requested SLCAN protocol option
     switch (((can_sio_param_t*)param)->attr.protocol) {
@@ -258,20 +457,18 @@ int can_test(int32_t channel, uint8_t mode, const void *param, int *result)
         //goto end_test;
     }
     /* check if the SLCAN device is occupied by own process */
-    for (i = 0; i < CAN_MAX_HANDLES; i++) {
-        if (can[i].port && !strcmp(can[i].name, name)) {
-            if (result)
-                *result = CANBRD_OCCUPIED;
-            break;
-        }
+    if (find_handle(name) != INVALID_HANDLE) {
+        if (result)
+            *result = CANBRD_OCCUPIED;
     }
 end_test:
     // when the music is over, turn out the lights
 #if (1)
     if (all_closed()) {                 // if no open handle then
-        init = 0;                       //   clear initialization flag
+        ATOMIC_SET(&init, 0);           //   clear initialization flag
     }
 #endif
+    UNLOCK_TABLE();
     return rc;
 }
 
@@ -281,6 +478,7 @@ int can_init(int32_t channel, uint8_t mode, const void *param)
     int rc = CANERR_FATAL;              // return value
     int handle = (-1);                  // handle index
     int fd = (-1);                      // file descriptor
+    slcan_attr_t sio_attr;              // serial attributes
 
 #if (OPTION_SERIAL_CHANNEL != 0)
     if (channel != CANDEV_SERIAL)       // must be serial port device!
@@ -303,52 +501,61 @@ int can_init(int32_t channel, uint8_t mode, const void *param)
     if (name == NULL)                   // must have at least a TTY name
         return CANERR_NULLPTR;
 
-    if (!init) {                        // if not initialized:
-        var_init();                     //   initialize all variables
-        init = 1;                       //   set initialization flag
-    }
-    for (handle = 0; handle < CAN_MAX_HANDLES; handle++) {
-        if ((can[handle].port != NULL) &&  // channel already in use
-            !strcmp(can[handle].name, name))
-            return CANERR_YETINIT;
-    }
-    for (handle = 0; handle < CAN_MAX_HANDLES; handle++) {
-        if (can[handle].port == NULL)   // get an unused handle, if any
-            break;
-    }
-    if (!IS_HANDLE_VALID(handle)) {     // no free handle found
-        return CANERR_NOTINIT;
-    }
     // check requested SLCAN protocol option
     switch (((can_sio_param_t*)param)->attr.protocol) {
     case CANSIO_LAWICEL: break;         //   Lawicel SLCAN protocol
     case CANSIO_CANABLE: break;         //   CANable SLCAN protocol
     default:                            //   sorry, not supported
-        rc = CANERR_ILLPARA;
-        goto err_init;
+        return CANERR_ILLPARA;
     }
     // check if requested operation mode is supported
     if ((mode & (uint8_t)(~SUPPORTED_OP_MODE)) != 0) {
-        rc = CANERR_ILLPARA;
-        goto err_init;
+        return CANERR_ILLPARA;
+    }
+    // note: the handle table is only locked to reserve a handle and
+    //       to create the SLCAN port, the device is connected outside
+    //       of the lock (several devices can be opened in parallel)
+    LOCK_TABLE();
+    if (!init) {                        // if not initialized:
+        var_init();                     //   initialize all variables
+        ATOMIC_SET(&init, 1);           //   set initialization flag
+    }
+    if ((handle = find_handle(name)) != INVALID_HANDLE) {  // channel already in use
+        // note: with shared access a subscriber handle is returned
+        if ((mode & CANMODE_SHRD) && IS_HANDLE_OPENED(handle))
+            rc = init_subscriber(handle, mode);
+        else
+            rc = CANERR_YETINIT;
+        UNLOCK_TABLE();
+        return rc;
+    }
+    // reserve a handle for the tty name (state is busy)
+    if ((handle = new_handle(name)) == INVALID_HANDLE) {
+        UNLOCK_TABLE();                 // no free handle found
+        return CANERR_NOTINIT;
     }
+
     // create an SLCAN port (w/ message queue)
-    can[handle].port = slcan_create(SLCAN_QUEUE_SIZE);
-    if (can[handle].port == NULL) {
+    CHANNEL(handle).port = slcan_create(SLCAN_QUEUE_SIZE);
+    UNLOCK_TABLE();
+    if (CHANNEL(handle).port == NULL) {
         rc = slcan_error(-1);
         goto err_init;
     }
     // connect serial interface (returns a file descriptor)
-    fd = slcan_connect(can[handle].port, name, slcan_attr(&((can_sio_param_t*)param)->attr));
+    fd = slcan_connect(CHANNEL(handle).port, name, slcan_attr(&((can_sio_param_t*)param)->attr, &sio_attr));
     rc = slcan_error(fd);
     if (fd < 0) {                       // errno is set in this case
-        (void)slcan_destroy(can[handle].port);
+        (void)slcan_destroy(CHANNEL(handle).port);
         goto err_init;
     }
     // check for SLCAN protocol (Lawicel or CANable protocol)
     if (((can_sio_param_t*)param)->attr.protocol != CANSIO_CANABLE) {
         // dummy read to check the protocol (w/ ACK/NACK feedback)
-        rc = slcan_version_number(can[handle].port, NULL, NULL);
+        // note: the CAN controller is reset in the same round trip and
+        //       the device identity is cached (no round trips later on)
+        rc = slcan_probe_device(CHANNEL(handle).port, &CHANNEL(handle).identity);
+        CHANNEL(handle).identified = (rc == 0) ? true : false;
         if ((rc < 0) && (errno == EBADMSG)) {   // wrong protocol (errno is set)
             rc = CANERR_VENDOR;
             errno = 0;                  //   clear errno to return CAN API error
@@ -356,51 +563,115 @@ int can_init(int32_t channel, uint8_t mode, const void *param)
     }
     else {
         // disable ACK/NAK feedback for serial commands
-        rc = slcan_set_ack(can[handle].port, false);
+        rc = slcan_set_ack(CHANNEL(handle).port, false);
+        CHANNEL(handle).identified = false;
     }
     rc = slcan_error(rc);
     if (rc != CANERR_NOERROR) {         // errno is set in this case
-        (void)slcan_disconnect(can[handle].port);
-        (void)slcan_destroy(can[handle].port);
+        (void)slcan_disconnect(CHANNEL(handle).port);
+        (void)slcan_destroy(CHANNEL(handle).port);
         goto err_init;
     }
     // reset CAN controller (it's possibly running)
-    (void)slcan_close_channel(can[handle].port);
-
-    // store the tty name and the operation mode
-    strncpy(can[handle].name, &name[0], CANPROP_MAX_BUFFER_SIZE);
-    can[handle].name[CANPROP_MAX_BUFFER_SIZE - 1] = '\0';
-    can[handle].attr.protocol = ((can_sio_param_t*)param)->attr.protocol;
-    (void)get_sio_attr(can[handle].port, &can[handle].attr);
-    can[handle].mode.byte = mode;       // store selected operation mode
-    can[handle].status.byte = CANSTAT_RESET; // CAN controller not started yet
+    if (((can_sio_param_t*)param)->attr.protocol == CANSIO_CANABLE)
+        (void)slcan_close_channel(CHANNEL(handle).port);
+
+    // store the operation mode (the tty name is already stored)
+    CHANNEL(handle).attr.protocol = ((can_sio_param_t*)param)->attr.protocol;
+    (void)get_sio_attr(CHANNEL(handle).port, &CHANNEL(handle).attr);
+    CHANNEL(handle).mode.byte = mode;       // store selected operation mode
+    CHANNEL(handle).queue.policy = SLCAN_QUEUE_POLICY;  // default queue settings
+    CHANNEL(handle).queue.timeout = SLCAN_QUEUE_TIMEOUT;
+    CHANNEL(handle).queue.spill = 0U;       // no spill file
+    CHANNEL(handle).queue.threshold = 0U;
+    CHANNEL(handle).queue.folder[0] = '\0';
+    CHANNEL(handle).queue.mailbox = false;  // no latest-value mailbox
+    CHANNEL(handle).queue.reduction = SLCAN_REDUCTION;  // no data reduction
+    CHANNEL(handle).queue.rate = SLCAN_DECIMATION;
+    CHANNEL(handle).callback.handler = NULL;  // no reception callback
+    CHANNEL(handle).callback.context = NULL;
+    CHANNEL(handle).polling.interval = SLCAN_POLLING;  // no status polling
+    CHANNEL(handle).polling.handler = NULL;
+    CHANNEL(handle).polling.context = NULL;
+    CHANNEL(handle).trace.type = CANPARA_TRACE_TYPE_BINARY;  // trace file settings
+    CHANNEL(handle).trace.mode = CANPARA_TRACE_MODE_DEFAULT;
+    CHANNEL(handle).trace.size = CANPARA_TRACE_SIZE_DEFAULT;
+    CHANNEL(handle).trace.folder[0] = '\0';
+    CHANNEL(handle).trace.file[0] = '\0';
+    CHANNEL(handle).trace.tracer = NULL;    // no trace file recording
+    memset(&CHANNEL(handle).flight.attr, 0, sizeof(recorder_attr_t));
+    CHANNEL(handle).flight.attr.frames = RECORDER_FRAMES;  // flight recorder settings
+    CHANNEL(handle).flight.attr.post_time = RECORDER_POST_TIME;
+    CHANNEL(handle).flight.dumps = 0U;
+    CHANNEL(handle).flight.ignored = 0U;
+    CHANNEL(handle).flight.file[0] = '\0';
+    CHANNEL(handle).flight.recorder = NULL; // no flight recorder
+    CHANNEL(handle).capture.type = CANSIO_CAPTURE_SERIAL;  // packet capture settings
+    CHANNEL(handle).capture.decoded = false;
+    CHANNEL(handle).capture.dropped = 0U;
+    CHANNEL(handle).capture.file[0] = '\0';
+    CHANNEL(handle).capture.capture = NULL; // no packet capture
+    CHANNEL(handle).owner = INVALID_HANDLE; // owner of the SLCAN port
+    CHANNEL(handle).reader = INVALID_HANDLE;
+    set_status(handle, 0xFFU, CANSTAT_RESET); // CAN controller not started yet
+    ATOMIC_SET(&CHANNEL(handle).state, HANDLE_OPENED);
     return handle;                      // return the handle
 
 err_init:                               // otherwise:
-    can[handle].port = NULL;
+    LOCK_TABLE();
+    free_handle(handle);                // release the handle
+    UNLOCK_TABLE();
     return rc;                          // return error code
 }
 
 static int exit_channel(int handle)
 {
     int rc;                             // return value
+    int i;                              // loop variable
 
     if (!IS_HANDLE_VALID(handle))       // must be a valid handle
         return CANERR_HANDLE;
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return CANERR_HANDLE;
-    if (!can[handle].status.can_stopped) { // if running then go bus off
-        (void)can_reset(handle);
+    // note: the handle is closed for new calls, and calls in progress
+    //       (e.g. a blocking read) are woken up and waited for without
+    //       holding the table lock (the last user signals the condition)
+    ATOMIC_SET(&CHANNEL(handle).state, HANDLE_BUSY);
+    if (ATOMIC_GET(&CHANNEL(handle).users) > 0) {
+        UNLOCK_TABLE();
+        LOCK_CLOSE();
+        while (ATOMIC_GET(&CHANNEL(handle).users) > 0) {
+            (void)slcan_signal(CHANNEL(handle).port);
+            WAIT_CLOSE();
+        }
+        UNLOCK_CLOSE();
+        LOCK_TABLE();
+    }
+    if (!IS_STOPPED(handle)) {          // if running then go bus off
+        (void)reset_channel(handle);
+    }
+    if (IS_SUBSCRIBER(handle)) {        // subscriber: release the handle
+        set_status(handle, CANSTAT_RESET, CANSTAT_RESET);
+        free_handle(handle);            //   (the port belongs to the owner)
+        return CANERR_NOERROR;
+    }
+    for (i = 0; i < ATOMIC_GET(&handles); i++) {
+        if (IS_HANDLE_OPENED(i) && (CHANNEL(i).owner == handle))
+            (void)exit_channel(i);      // close all subscribers first
     }
-    rc = slcan_disconnect(can[handle].port);  // disconnect serial interface
+    (void)stop_trace(handle);           // stop trace file recording (if any)
+    (void)stop_recorder(handle);        // stop the flight recorder (if any)
+    (void)stop_capture(handle);         // stop packet capture (if any)
+    rc = slcan_disconnect(CHANNEL(handle).port);  // disconnect serial interface
     rc = slcan_error(rc);
     if (rc != CANERR_NOERROR) {         // errno is set in this case
+        ATOMIC_SET(&CHANNEL(handle).state, HANDLE_OPENED);
         return rc;
     }
-    (void)slcan_destroy(can[handle].port);  // destroy SLCAN port
+    (void)slcan_destroy(CHANNEL(handle).port);  // destroy SLCAN port
 
-    can[handle].status.byte |= CANSTAT_RESET;  // CAN controller in INIT state
-    can[handle].port = NULL;            // handle can be used again
+    set_status(handle, CANSTAT_RESET, CANSTAT_RESET);  // CAN controller in INIT state
+    free_handle(handle);                // handle can be used again
     return CANERR_NOERROR;
 }
 
@@ -410,21 +681,25 @@ int can_exit(int handle)
     int rc;                             // return value
     int i;                              // loop variable
 
-    if (!init)                          // must be initialized
+    if (!ATOMIC_GET(&init))             // must be initialized
         return CANERR_NOTINIT;
+    LOCK_TABLE();                       // note: opening and closing
     if (handle != CANEXIT_ALL) {        // close a single handle
-        if ((rc = exit_channel(handle)) != CANERR_NOERROR)
+        if ((rc = exit_channel(handle)) != CANERR_NOERROR) {
+            UNLOCK_TABLE();
             return rc;
+        }
     }
     else {                              // close all open handles
-        for (i = 0; i < CAN_MAX_HANDLES; i++) {
+        for (i = 0; i < ATOMIC_GET(&handles); i++) {
             (void)exit_channel(i);      //   don't care about the result
         }
     }
     // when the music is over, turn out the lights
     if (all_closed()) {                 // if no open handle then
-        init = 0;                       //   clear initialization flag
+        ATOMIC_SET(&init, 0);           //   clear initialization flag
     }
+    UNLOCK_TABLE();
     return CANERR_NOERROR;
 }
 
@@ -434,10 +709,12 @@ static int kill_channel(int handle)
 
     if (!IS_HANDLE_VALID(handle))       // must be a valid handle
         return CANERR_HANDLE;
-    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+    if (!acquire_handle(handle))        // must be an open handle
         return CANERR_HANDLE;
-    rc = slcan_signal(can[handle].port);// wake up the SLCAN thread
+    ATOMIC_SET(&CHANNEL(handle).replaying, 0);// abort a replay
+    rc = slcan_signal(CHANNEL(handle).port);// wake up the SLCAN thread
     rc = slcan_error(rc);
+    release_handle(handle);
     if (rc != CANERR_NOERROR) {         // errno is set in this case
         return rc;
     }
@@ -450,42 +727,38 @@ int can_kill(int handle)
     int rc;                             // return value
     int i;                              // loop variable
 
-    if (!init)                          // must be initialized
+    if (!ATOMIC_GET(&init))             // must be initialized
         return CANERR_NOTINIT;
     if (handle != CANKILL_ALL) {        // signal a single handle
         if ((rc = kill_channel(handle)) != CANERR_NOERROR)
             return rc;
     }
     else {                              // signal all open handles
-        for (i = 0; i < CAN_MAX_HANDLES; i++) {
+        for (i = 0; i < ATOMIC_GET(&handles); i++) {
             (void)kill_channel(i);      //   don't care about the result
         }
     }
     return CANERR_NOERROR;
 }
 
-EXPORT
-int can_start(int handle, const can_bitrate_t *bitrate)
+static int start_channel(int handle, const can_bitrate_t *bitrate)
 {
     int rc = CANERR_FATAL;              // return value
 
     uint16_t btr0btr1 = CAN_BTR_DEFAULT;// btr0btr1 value
     can_bitrate_t temporary;            // bit-rate settings
+    slcan_setup_t setup;                // setup commands
 
-    if (!init)                          // must be initialized
-        return CANERR_NOTINIT;
-    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
-        return CANERR_HANDLE;
-    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
-        return CANERR_HANDLE;
     if (bitrate == NULL)                // check for null-pointer
         return CANERR_NULLPTR;
-    if (!can[handle].status.can_stopped) // must be stopped
+    if (!IS_STOPPED(handle))            // must be stopped
         return CANERR_ONLINE;
+    if (IS_SUBSCRIBER(handle))          // subscriber: bit-rate of the owner
+        return start_subscriber(handle);
 
     // note: CANable devices do not support SJA1000 bit-rate settings
     //
-    if ((bitrate->index > 0) && (can[handle].attr.protocol == CANSIO_CANABLE)) {
+    if ((bitrate->index > 0) && (CHANNEL(handle).attr.protocol == CANSIO_CANABLE)) {
         // convert bit-rate settings to index (SJA1000)
         if(btr_bitrate2index(bitrate, &temporary.index) != CANERR_NOERROR)
             return CANERR_BAUDRATE;
@@ -503,54 +776,70 @@ int can_start(int handle, const can_bitrate_t *bitrate)
         if (btr_index2sja1000(temporary.index, &btr0btr1) != CANERR_NOERROR)
             return CANERR_BAUDRATE;
         // set the bit-rate (with reverse index numbering)
-        rc = slcan_setup_bitrate(can[handle].port, (uint8_t)(CANBDR_10 + temporary.index));
+        setup.use_btr = false;
+        setup.index = (uint8_t)(CANBDR_10 + temporary.index);
     }
     else {
         // convert bit-rate to SJA1000 BTR0/BTR1 register
         if (btr_bitrate2sja1000(&temporary, &btr0btr1) != CANERR_NOERROR)
             return CANERR_BAUDRATE;
         // set the bit-timing register
-        rc = slcan_setup_btr(can[handle].port, btr0btr1);
+        setup.use_btr = true;
+        setup.index = 0U;
     }
-    if (rc < 0)
-        return slcan_error(rc);
+    setup.btr = btr0btr1;
     // set acceptance filter (code and mask)
-    if (can[handle].attr.protocol != CANSIO_CANABLE) {
-        rc = slcan_acceptance_code(can[handle].port, can[handle].filter.sja1000.code);
-        if (rc < 0)
-            return slcan_error(rc);
-        rc = slcan_acceptance_mask(can[handle].port, can[handle].filter.sja1000.mask);
-        if (rc < 0)
-            return slcan_error(rc);
-    }
+    setup.filter = (CHANNEL(handle).attr.protocol != CANSIO_CANABLE) ? true : false;
+    setup.code = CHANNEL(handle).filter.sja1000.code;
+    setup.mask = CHANNEL(handle).filter.sja1000.mask;
     // start the CAN controller
-    rc = slcan_open_channel(can[handle].port);
+    // note: the setup commands are sent at once (pipelined)
+    rc = slcan_start_channel(CHANNEL(handle).port, &setup);
     if (rc < 0)
         return slcan_error(rc);
     // store the bit-rate settings
-    can[handle].btr0btr1 = btr0btr1;
-    // clear old status and counters
-    can[handle].status.byte = 0x00u;
-    can[handle].counters.tx = 0ull;
-    can[handle].counters.rx = 0ull;
-    can[handle].counters.err = 0ull;
+    CHANNEL(handle).btr0btr1 = btr0btr1;
+    // clear old counters and status
+    ATOMIC_SET64(&CHANNEL(handle).counters.tx, 0U);
+    ATOMIC_SET64(&CHANNEL(handle).counters.rx, 0U);
+    ATOMIC_SET64(&CHANNEL(handle).counters.err, 0U);
     // CAN controller started!
-    can[handle].status.can_stopped = 0;
+    set_status(handle, 0xFFU, 0x00U);
+    // start the status polling (if enabled)
+    if (CHANNEL(handle).polling.interval > 0U) {
+        rc = slcan_status_polling(CHANNEL(handle).port, CHANNEL(handle).polling.interval,
+                                  status_handler, (void*)(intptr_t)handle);
+        if (rc < 0) {
+            rc = slcan_error(rc);
+            (void)slcan_close_channel(CHANNEL(handle).port);
+            set_status(handle, CANSTAT_RESET, CANSTAT_RESET);
+            return rc;
+        }
+    }
     return CANERR_NOERROR;
 }
 
 EXPORT
-int can_reset(int handle)
+int can_start(int handle, const can_bitrate_t *bitrate)
 {
-    int rc = CANERR_FATAL;              // return value
+    int rc;                             // return value
 
-    if (!init)                          // must be initialized
+    if (!ATOMIC_GET(&init))             // must be initialized
         return CANERR_NOTINIT;
     if (!IS_HANDLE_VALID(handle))       // must be a valid handle
         return CANERR_HANDLE;
-    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+    if (!acquire_handle(handle))        // must be an open handle
         return CANERR_HANDLE;
-    if (can[handle].status.can_stopped) // must be running
+    rc = start_channel(handle, bitrate);
+    release_handle(handle);             // handle can be closed now
+    return rc;
+}
+
+static int reset_channel(int handle)
+{
+    int rc = CANERR_FATAL;              // return value
+
+    if (IS_STOPPED(handle))             // must be running
 #if (OPTION_CANAPI_RETVALS == OPTION_DISABLED)
         return CANERR_OFFLINE;
 #else
@@ -558,37 +847,57 @@ int can_reset(int handle)
         //       the CAN controller has not been started
         return CANERR_NOERROR;
 #endif
+    if (IS_SUBSCRIBER(handle)) {        // subscriber: detach from the port
+        rc = slcan_unsubscribe(CHANNEL(handle).port, CHANNEL(handle).reader);
+        CHANNEL(handle).reader = INVALID_HANDLE;
+        set_status(handle, CANSTAT_RESET, CANSTAT_RESET);
+        return slcan_error(rc);
+    }
+    // stop the status polling (if enabled)
+    if (CHANNEL(handle).polling.interval > 0U)
+        (void)slcan_status_polling(CHANNEL(handle).port, 0U, NULL, NULL);
     // stop the CAN controller (INIT state)
-    rc = slcan_close_channel(can[handle].port);
+    rc = slcan_close_channel(CHANNEL(handle).port);
     rc = slcan_error(rc);
-    can[handle].status.can_stopped = (rc == CANERR_NOERROR) ? 1 : 0;
+    set_status(handle, CANSTAT_RESET, (rc == CANERR_NOERROR) ? CANSTAT_RESET : 0x00U);
     return rc;
 }
 
 EXPORT
-int can_write(int handle, const can_message_t *msg, uint16_t timeout)
+int can_reset(int handle)
 {
-    slcan_message_t slcan;              // SLCAN message
-    int rc = CANERR_FATAL;              // return value
+    int rc;                             // return value
 
-    if (!init)                          // must be initialized
+    if (!ATOMIC_GET(&init))             // must be initialized
         return CANERR_NOTINIT;
     if (!IS_HANDLE_VALID(handle))       // must be a valid handle
         return CANERR_HANDLE;
-    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+    if (!acquire_handle(handle))        // must be an open handle
         return CANERR_HANDLE;
+    rc = reset_channel(handle);
+    release_handle(handle);             // handle can be closed now
+    return rc;
+}
+
+static int write_channel(int handle, const can_message_t *msg, uint64_t timeout)
+{
+    slcan_message_t slcan;              // SLCAN message
+    int rc = CANERR_FATAL;              // return value
+
     if (msg == NULL)                    // check for null-pointer
         return CANERR_NULLPTR;
-    if (can[handle].status.can_stopped) // must be running
+    if (IS_SUBSCRIBER(handle))          // subscribers are read-only
+        return CANERR_NOTSUPP;
+    if (IS_STOPPED(handle))             // must be running
         return CANERR_OFFLINE;
 
     if (msg->id > (uint32_t)(msg->xtd ? CAN_MAX_XTD_ID : CAN_MAX_STD_ID))
         return CANERR_ILLPARA;          // invalid identifier
     if (msg->dlc > CAN_MAX_DLC)
         return CANERR_ILLPARA;          // invalid data length code
-    if (msg->xtd && can[handle].mode.nxtd)
+    if (msg->xtd && CHANNEL(handle).mode.nxtd)
         return CANERR_ILLPARA;          // suppress extended frames
-    if (msg->rtr && can[handle].mode.nrtr)
+    if (msg->rtr && CHANNEL(handle).mode.nrtr)
         return CANERR_ILLPARA;          // suppress remote frames
     if (msg->sts)
         return CANERR_ILLPARA;          // error frames cannot be sent
@@ -601,49 +910,68 @@ int can_write(int handle, const can_message_t *msg, uint16_t timeout)
     slcan.can_dlc = msg->dlc;
     memcpy(slcan.data, msg->data, slcan.can_dlc);
     // transmit the CAN message
-    rc = slcan_write_message(can[handle].port, &slcan, timeout);
+    // note: the SLCAN protocol is synchronous (no transmit queue), the
+    //       time-out bounds the wait for the acknowledge of the device;
+    //       it is passed in [ms] and rounded up to full milliseconds
+    rc = slcan_write_message(CHANNEL(handle).port, &slcan, TO_MSEC(timeout));
     rc = slcan_error(rc);
     // update status and tx counter
-    can[handle].status.transmitter_busy = (rc != CANERR_NOERROR) ? 1 : 0;
-    can[handle].counters.tx += (rc == CANERR_NOERROR) ? 1U : 0U;
+    set_status(handle, CANSTAT_TX_BUSY, (rc != CANERR_NOERROR) ? CANSTAT_TX_BUSY : 0x00U);
+    if (rc == CANERR_NOERROR)
+        ATOMIC_ADD64(&CHANNEL(handle).counters.tx, 1U);
 
     return rc;
 }
 
 EXPORT
-int can_read(int handle, can_message_t *msg, uint16_t timeout)
+int can_write(int handle, const can_message_t *msg, uint16_t timeout)
 {
-    slcan_message_t slcan;              // SLCAN message
-    int rc = CANERR_FATAL;              // return value
+    return can_write_us(handle, msg, TO_USEC(timeout));
+}
+
+EXPORT
+int can_write_us(int handle, const can_message_t *msg, uint64_t timeout)
+{
+    int rc;                             // return value
 
-    if (!init)                          // must be initialized
+    if (!ATOMIC_GET(&init))             // must be initialized
         return CANERR_NOTINIT;
     if (!IS_HANDLE_VALID(handle))       // must be a valid handle
         return CANERR_HANDLE;
-    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+    if (!acquire_handle(handle))        // must be an open handle
         return CANERR_HANDLE;
+    rc = write_channel(handle, msg, timeout);
+    release_handle(handle);             // handle can be closed now
+    return rc;
+}
+
+static int read_channel(int handle, can_message_t *msg, uint64_t timeout)
+{
+    slcan_message_t slcan;              // SLCAN message
+    int rc = CANERR_FATAL;              // return value
+
     if (msg == NULL)                    // check for null-pointer
         return CANERR_NULLPTR;
-    if (can[handle].status.can_stopped) // must be running
+    if (IS_STOPPED(handle))             // must be running
         return CANERR_OFFLINE;
 
     memset(msg, 0x00, sizeof(can_message_t));
     msg->id = 0xFFFFFFFFu;
     msg->sts = 1;
 
-    // read one CAN message from message queue, if any
-    rc = slcan_read_message(can[handle].port, &slcan, timeout);
+    // read one CAN message from message queue (or broadcast ring), if any
+    if (!IS_SUBSCRIBER(handle))
+        rc = slcan_read_message_us(CHANNEL(handle).port, &slcan, timeout);
+    else
+        rc = slcan_read_subscriber_us(CHANNEL(handle).port, CHANNEL(handle).reader, &slcan, timeout);
     if (rc == CANERR_NOERROR) {
         // map message layout
-        msg->xtd = (slcan.can_id & CAN_XTD_FRAME) ? 1 : 0;
-        msg->sts = (slcan.can_id & CAN_ERR_FRAME) ? 1 : 0;
-        msg->rtr = (slcan.can_id & CAN_RTR_FRAME) ? 1 : 0;
-        msg->id = slcan.can_id & (msg->xtd ? CAN_XTD_MASK : CAN_STD_MASK);
-        msg->dlc = (slcan.can_dlc < CAN_DLC_MAX) ? slcan.can_dlc : CAN_LEN_MAX;
-        memcpy(msg->data, slcan.data, msg->dlc);
+        map_message(msg, &slcan);
         // update receive counter
-        can[handle].counters.rx += !msg->sts ? 1U : 0U;
-        can[handle].counters.err += msg->sts ? 1U : 0U;
+        if (!msg->sts)
+            ATOMIC_ADD64(&CHANNEL(handle).counters.rx, 1U);
+        else
+            ATOMIC_ADD64(&CHANNEL(handle).counters.err, 1U);
     }
     else if (rc != CANERR_RX_EMPTY) {
         rc = slcan_error(rc);
@@ -652,64 +980,328 @@ int can_read(int handle, can_message_t *msg, uint16_t timeout)
         rc = CANERR_RX_EMPTY;
     }
     // update status register
-    can[handle].status.receiver_empty = (rc != CANERR_NOERROR) ? 1 : 0;
-    can[handle].status.queue_overrun |= (errno == ENOSPC) ? 1 : 0;
+    set_status(handle, CANSTAT_RX_EMPTY, (rc != CANERR_NOERROR) ? CANSTAT_RX_EMPTY : 0x00U);
+    if (errno == ENOSPC)
+        set_status(handle, CANSTAT_QUE_OVR, CANSTAT_QUE_OVR);
 
     return rc;
 }
 
 EXPORT
-int can_status(int handle, uint8_t *status)
+int can_read(int handle, can_message_t *msg, uint16_t timeout)
+{
+    return can_read_us(handle, msg, TO_USEC(timeout));
+}
+
+EXPORT
+int can_read_us(int handle, can_message_t *msg, uint64_t timeout)
+{
+    int rc;                             // return value
+
+    if (!ATOMIC_GET(&init))             // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!acquire_handle(handle))        // must be an open handle
+        return CANERR_HANDLE;
+    rc = read_channel(handle, msg, timeout);
+    release_handle(handle);             // handle can be closed now
+    return rc;
+}
+
+static int peek_channel(int handle, uint32_t id, can_message_t *msg)
 {
+    slcan_message_t slcan;              // SLCAN message
+    uint32_t can_id;                    // SLCAN identifier
     int rc = CANERR_FATAL;              // return value
 
-    slcan_flags_t flags;                // SLCAN flags
+    if (msg == NULL)                    // check for null-pointer
+        return CANERR_NULLPTR;
+    if (id & CANSIO_XTD_ID) {           // check identifier range
+        if ((id & ~CANSIO_XTD_ID) > CAN_MAX_XTD_ID)
+            return CANERR_ILLPARA;
+        can_id = (id & ~CANSIO_XTD_ID) | CAN_XTD_FRAME;
+    }
+    else {
+        if (id > CAN_MAX_STD_ID)
+            return CANERR_ILLPARA;
+        can_id = id;
+    }
+    if (IS_STOPPED(handle))             // must be running
+        return CANERR_OFFLINE;
+
+    memset(msg, 0x00, sizeof(can_message_t));
+    msg->id = 0xFFFFFFFFu;
+    msg->sts = 1;
+
+    // read the latest CAN message of the identifier from the mailbox
+    // note: the receive queue and the receive counters are not affected
+    rc = slcan_read_latest(CHANNEL(handle).port, can_id, &slcan, &msg->timestamp, NULL);
+    if (rc == CANERR_NOERROR) {
+        // map message layout
+        map_message(msg, &slcan);
+    }
+    else if (rc != CANERR_RX_EMPTY) {
+        rc = slcan_error(rc);
+    }
+    return rc;
+}
+
+EXPORT
+int can_read_latest(int handle, uint32_t id, can_message_t *msg)
+{
+    int rc;                             // return value
 
-    if (!init)                          // must be initialized
+    if (!ATOMIC_GET(&init))             // must be initialized
         return CANERR_NOTINIT;
     if (!IS_HANDLE_VALID(handle))       // must be a valid handle
         return CANERR_HANDLE;
-    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+    if (!acquire_handle(handle))        // must be an open handle
+        return CANERR_HANDLE;
+    rc = peek_channel(handle, id, msg);
+    release_handle(handle);             // handle can be closed now
+    return rc;
+}
+
+static int callback_channel(int handle, can_rx_handler_t handler, void *context)
+{
+    int rc = CANERR_FATAL;              // return value
+
+    if (IS_SUBSCRIBER(handle))          // subscribers read from the ring
+        return CANERR_NOTSUPP;
+    if (!IS_STOPPED(handle))            // must be stopped
+        return CANERR_ONLINE;
+
+    // note: the handler is called by the reception thread instead of
+    //       putting the received messages into the message queue
+    CHANNEL(handle).callback.handler = handler;
+    CHANNEL(handle).callback.context = context;
+    rc = slcan_set_rx_handler(CHANNEL(handle).port, handler ? rx_handler : NULL, handler ? (void*)&CHANNEL(handle) : NULL);
+    if ((rc = slcan_error(rc)) != CANERR_NOERROR) {
+        CHANNEL(handle).callback.handler = NULL;
+        CHANNEL(handle).callback.context = NULL;
+    }
+    return rc;
+}
+
+EXPORT
+int can_callback(int handle, can_rx_handler_t handler, void *context)
+{
+    int rc;                             // return value
+
+    if (!ATOMIC_GET(&init))             // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!acquire_handle(handle))        // must be an open handle
+        return CANERR_HANDLE;
+    rc = callback_channel(handle, handler, context);
+    release_handle(handle);             // handle can be closed now
+    return rc;
+}
+
+static int notify_channel(int handle, can_status_handler_t handler, void *context)
+{
+    if (IS_SUBSCRIBER(handle))          // subscribers don't poll the device
+        return CANERR_NOTSUPP;
+    if (!IS_STOPPED(handle))            // must be stopped
+        return CANERR_ONLINE;
+
+    // note: the handler is called by the polling thread (see 'start_channel')
+    CHANNEL(handle).polling.handler = handler;
+    CHANNEL(handle).polling.context = context;
+    return CANERR_NOERROR;
+}
+
+EXPORT
+int can_status_callback(int handle, can_status_handler_t handler, void *context)
+{
+    int rc;                             // return value
+
+    if (!ATOMIC_GET(&init))             // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!acquire_handle(handle))        // must be an open handle
+        return CANERR_HANDLE;
+    rc = notify_channel(handle, handler, context);
+    release_handle(handle);             // handle can be closed now
+    return rc;
+}
+
+static int replay_channel(int handle, const char *filename, uint16_t speed, can_replay_stats_t *stats)
+{
+    can_replay_stats_t result;          // replay statistics
+    tracefile_t reader = NULL;          // trace file reader
+    tracer_record_t record;             // trace record
+    can_message_t msg;                  // CAN message
+    uint64_t *histogram = NULL;         // timing errors (1us per bin)
+    uint64_t origin = 0U;               // time-stamp of the first record
+    uint64_t start, deadline = 0U, now = 0U;  // monotonic clock in [ns]
+    uint64_t error, sum = 0U;           // timing error in [ns]
+    uint64_t count = 0U;                // number of timing errors
+    int rc = CANERR_NOERROR;            // return value
+
+    if (filename == NULL)               // check for null-pointer
+        return CANERR_NULLPTR;
+    if (IS_SUBSCRIBER(handle))          // subscribers are read-only
+        return CANERR_NOTSUPP;
+    if (IS_STOPPED(handle))             // must be running
+        return CANERR_OFFLINE;
+
+    // open the trace file (binary format)
+    if ((reader = tracefile_open(filename)) == NULL) {
+        if (errno == EBADMSG)           //   not a binary trace file
+            return CANERR_ILLPARA;
+        return slcan_error(-1);
+    }
+    memset(&result, 0x00, sizeof(can_replay_stats_t));
+    (void)tracefile_info(reader, &result.records, &origin, NULL);
+    if ((speed != CANSIO_REPLAY_ASAP) &&
+        ((histogram = (uint64_t*)calloc(REPLAY_HISTOGRAM + 1U, sizeof(uint64_t))) == NULL)) {
+        (void)tracefile_close(reader);
+        return CANERR_RESOURCE;
+    }
+    ATOMIC_SET(&CHANNEL(handle).replaying, 1);
+    start = timer_get_clock();
+    // transmit the messages of the trace file
+    // note: each message has an absolute deadline relative to the start of
+    //       the replay, scaled by the speed factor (errors do not add up)
+    while (tracefile_read(reader, &record) == 0) {
+        if (record.can_id & CAN_ERR_FRAME) {
+            result.skipped++;           //   error frames cannot be sent
+            continue;
+        }
+        if (speed != CANSIO_REPLAY_ASAP) {
+            deadline = start + (((record.time - origin) * CANSIO_REPLAY_ORIGINAL) / speed);
+            // wait in slices, so that the replay can be aborted
+            while ((now = timer_get_clock()) < deadline) {
+                if (!ATOMIC_GET(&CHANNEL(handle).replaying) || !IS_HANDLE_OPENED(handle) || IS_STOPPED(handle))
+                    break;
+                (void)timer_wait_until(((deadline - now) > REPLAY_SLICE) ? (now + REPLAY_SLICE) : deadline);
+            }
+        }
+        if (!ATOMIC_GET(&CHANNEL(handle).replaying) || !IS_HANDLE_OPENED(handle) || IS_STOPPED(handle)) {
+            errno = ECANCELED;          //   aborted by can_kill, can_reset or can_exit
+            rc = slcan_error(-1);
+            break;
+        }
+        if (speed != CANSIO_REPLAY_ASAP) {
+            // timing error at the start of transmission
+            error = (now > deadline) ? (now - deadline) : 0U;
+            histogram[(error < ((uint64_t)REPLAY_HISTOGRAM * 1000U)) ? (error / 1000U) : REPLAY_HISTOGRAM]++;
+            if ((error / 1000U) > result.max)
+                result.max = (uint32_t)(((error / 1000U) < UINT32_MAX) ? (error / 1000U) : UINT32_MAX);
+            sum += error;
+            count++;
+        }
+        // map record to CAN message
+        memset(&msg, 0x00, sizeof(can_message_t));
+        msg.xtd = (record.can_id & CAN_XTD_FRAME) ? 1 : 0;
+        msg.rtr = (record.can_id & CAN_RTR_FRAME) ? 1 : 0;
+        msg.id = record.can_id & (msg.xtd ? CAN_XTD_MASK : CAN_STD_MASK);
+        msg.dlc = (record.can_dlc <= CAN_MAX_DLC) ? record.can_dlc : CAN_MAX_DLC;
+        memcpy(msg.data, record.data, (record.can_dlc <= 8U) ? record.can_dlc : 8U);
+        // transmit the CAN message
+        if (write_channel(handle, &msg, 0U) == CANERR_NOERROR)
+            result.sent++;
+        else
+            result.failed++;
+    }
+    ATOMIC_SET(&CHANNEL(handle).replaying, 0);
+    result.duration = (timer_get_clock() - start) / 1000U;
+    // timing error statistics (in [us])
+    if (count) {
+        result.mean = (uint32_t)((sum / count) / 1000U);
+        result.p50 = percentile(histogram, count, result.max, 500U);
+        result.p90 = percentile(histogram, count, result.max, 900U);
+        result.p99 = percentile(histogram, count, result.max, 990U);
+        result.p999 = percentile(histogram, count, result.max, 999U);
+    }
+    if (stats)
+        memcpy(stats, &result, sizeof(can_replay_stats_t));
+    if (histogram)
+        free(histogram);
+    (void)tracefile_close(reader);
+    return rc;
+}
+
+EXPORT
+int can_replay(int handle, const char *filename, uint16_t speed, can_replay_stats_t *stats)
+{
+    int rc;                             // return value
+
+    if (!ATOMIC_GET(&init))             // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!acquire_handle(handle))        // must be an open handle
         return CANERR_HANDLE;
+    rc = replay_channel(handle, filename, speed, stats);
+    release_handle(handle);             // handle can be closed now
+    return rc;
+}
+
+static int status_channel(int handle, uint8_t *status)
+{
+    int rc = CANERR_FATAL;              // return value
 
-    if (!can[handle].status.can_stopped) { // if running get bus status
+    slcan_flags_t flags;                // SLCAN flags
+    uint64_t lost = 0U;                 // lost messages (subscriber)
+    int owner;                          // owner handle (subscriber)
+
+    if (IS_SUBSCRIBER(handle)) {        // subscriber: bus status of the owner
+        // note: the device is not queried by a subscriber
+        owner = CHANNEL(handle).owner;
+        set_status(handle, BUS_STATUS, STATUS(owner));
+        if (!IS_STOPPED(handle) &&
+            (slcan_subscriber_status(CHANNEL(handle).port, CHANNEL(handle).reader, NULL, NULL, &lost) == 0))
+            set_status(handle, CANSTAT_QUE_OVR, (lost > 0U) ? CANSTAT_QUE_OVR : 0x00U);
+    }
+    else if (!IS_STOPPED(handle)) {     // if running get bus status
         // get status-register from device (CAN API V1 compatible)
-        if ((rc = slcan_status_flags(can[handle].port, &flags)) < 0)
+        // note: with status polling from the last poll (no serial I/O)
+        if ((rc = slcan_status_flags(CHANNEL(handle).port, &flags)) < 0)
             return slcan_error(rc);
-        // TODO: SJA1000 datasheet, rtfm!
-        can[handle].status.message_lost = (flags.DOI | flags.RxFIFO | flags.TxFIFO) ? 1 : 0;
-        can[handle].status.bus_error = flags.BEI ? 1 : 0;
-        can[handle].status.warning_level = (flags.EI | flags.EPI);
-        can[handle].status.bus_off = flags.ALI;
+        set_status(handle, BUS_STATUS, map_flags(flags));
     }
     if (status)                         // status-register
-        *status = can[handle].status.byte;
+        *status = STATUS(handle);
     return CANERR_NOERROR;
 }
 
 EXPORT
-int can_busload(int handle, uint8_t *load, uint8_t *status)
+int can_status(int handle, uint8_t *status)
 {
-    int rc = CANERR_FATAL;              // return value
-    float busLoad = 0.0;                // bus-load (in [percent])
+    int rc;                             // return value
 
-    if (!init)                          // must be initialized
+    if (!ATOMIC_GET(&init))             // must be initialized
         return CANERR_NOTINIT;
     if (!IS_HANDLE_VALID(handle))       // must be a valid handle
         return CANERR_HANDLE;
-    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+    if (!acquire_handle(handle))        // must be an open handle
         return CANERR_HANDLE;
+    rc = status_channel(handle, status);
+    release_handle(handle);             // handle can be closed now
+    return rc;
+}
+
+static int busload_channel(int handle, uint8_t *load, uint8_t *status)
+{
+    int rc = CANERR_FATAL;              // return value
+    uint16_t busLoad = 0U;              // bus-load (in [1/100 percent])
 
-    if (!can[handle].status.can_stopped) { // if running get bus load
-        (void)busLoad; //  TODO: measure bus load
+    if (!IS_STOPPED(handle)) {          // if running get bus load
+        if ((rc = get_busload(handle, &busLoad)) != CANERR_NOERROR)
+            return rc;
     }
     if (load)                           // bus-load (in [percent])
-        *load = (uint8_t)busLoad;
+        *load = (uint8_t)((busLoad + 50U) / 100U);
     // get status-register from device
-    rc = can_status(handle, status);
+    rc = status_channel(handle, status);
 #if (OPTION_CANAPI_RETVALS == OPTION_DISABLED)
     if (rc == CANERR_NOERROR)
-        rc = !can[handle].status.can_stopped ? CANERR_NOERROR : CANERR_OFFLINE;
+        rc = !IS_STOPPED(handle) ? CANERR_NOERROR : CANERR_OFFLINE;
 #else
     // note: can_busload shall return CANERR_NOERROR if
     //       the CAN controller has not been started
@@ -718,7 +1310,22 @@ int can_busload(int handle, uint8_t *load, uint8_t *status)
 }
 
 EXPORT
-int can_bitrate(int handle, can_bitrate_t *bitrate, can_speed_t *speed)
+int can_busload(int handle, uint8_t *load, uint8_t *status)
+{
+    int rc;                             // return value
+
+    if (!ATOMIC_GET(&init))             // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!acquire_handle(handle))        // must be an open handle
+        return CANERR_HANDLE;
+    rc = busload_channel(handle, load, status);
+    release_handle(handle);             // handle can be closed now
+    return rc;
+}
+
+static int bitrate_channel(int handle, can_bitrate_t *bitrate, can_speed_t *speed)
 {
     int rc = CANERR_FATAL;              // return value
     can_bitrate_t tmpBitrate;           // bit-rate settings
@@ -727,15 +1334,8 @@ int can_bitrate(int handle, can_bitrate_t *bitrate, can_speed_t *speed)
     memset(&tmpBitrate, 0, sizeof(can_bitrate_t));
     memset(&tmpSpeed, 0, sizeof(can_speed_t));
 
-    if (!init)                          // must be initialized
-        return CANERR_NOTINIT;
-    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
-        return CANERR_HANDLE;
-    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
-        return CANERR_HANDLE;
-
     // get bit-rate settings from SJA1000 registers
-    if ((rc = btr_sja10002bitrate(can[handle].btr0btr1, &tmpBitrate)) == CANERR_NOERROR)
+    if ((rc = btr_sja10002bitrate(CHANNEL(DEVICE(handle)).btr0btr1, &tmpBitrate)) == CANERR_NOERROR)
         rc = btr_bitrate2speed(&tmpBitrate, &tmpSpeed);
     /* note: 'bitrate' as well as 'speed' are optional */
     if (bitrate)
@@ -744,7 +1344,7 @@ int can_bitrate(int handle, can_bitrate_t *bitrate, can_speed_t *speed)
         memcpy(speed, &tmpSpeed, sizeof(can_speed_t));
 #if (OPTION_CANAPI_RETVALS == OPTION_DISABLED)
     if (rc == CANERR_NOERROR)
-        rc = !can[handle].status.can_stopped ? CANERR_NOERROR : CANERR_OFFLINE;
+        rc = !IS_STOPPED(handle) ? CANERR_NOERROR : CANERR_OFFLINE;
 #else
     // note: can_bitrate shall return CANERR_NOERROR if
     //       the CAN controller has not been started
@@ -753,18 +1353,41 @@ int can_bitrate(int handle, can_bitrate_t *bitrate, can_speed_t *speed)
 }
 
 EXPORT
-int can_property(int handle, uint16_t param, void *value, uint32_t nbyte)
+int can_bitrate(int handle, can_bitrate_t *bitrate, can_speed_t *speed)
 {
-    if (!init || !IS_HANDLE_VALID(handle)) {
-        // note: library properties can be queried w/o a handle
-        return lib_parameter(param, value, (size_t)nbyte);
-    }
-    // note: library is initialized and handle is valid
+    int rc;                             // return value
 
-    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+    if (!ATOMIC_GET(&init))             // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!acquire_handle(handle))        // must be an open handle
+        return CANERR_HANDLE;
+    rc = bitrate_channel(handle, bitrate, speed);
+    release_handle(handle);             // handle can be closed now
+    return rc;
+}
+
+EXPORT
+int can_property(int handle, uint16_t param, void *value, uint32_t nbyte)
+{
+    int rc;                             // return value
+
+    if (!ATOMIC_GET(&init) || !IS_HANDLE_VALID(handle)) {
+        // note: library properties can be queried w/o a handle
+        return lib_parameter(param, value, (size_t)nbyte);
+    }
+    // note: library is initialized and handle is valid
+
+    if (!acquire_handle(handle))        // must be an open handle
         return CANERR_HANDLE;
     // note: device properties must be queried with a valid handle
-    return drv_parameter(handle, param, value, (size_t)nbyte);
+    if (IS_SUBSCRIBER(handle))
+        rc = sub_parameter(handle, param, value, (size_t)nbyte);
+    else
+        rc = drv_parameter(handle, param, value, (size_t)nbyte);
+    release_handle(handle);             // handle can be closed now
+    return rc;
 }
 
 EXPORT
@@ -773,23 +1396,28 @@ char *can_hardware(int handle)
     static char hardware[(2 * CANPROP_MAX_BUFFER_SIZE) + 1] = "";
     uint8_t hw_version = 0x00U;
 
-    if (!init)                          // must be initialized
+    if (!ATOMIC_GET(&init))             // must be initialized
         return NULL;
     if (!IS_HANDLE_VALID(handle))       // must be a valid handle
         return NULL;
-    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+    if (!acquire_handle(handle))        // must be an open handle
         return NULL;
 
-    // get version number: HW and SW
-    if (slcan_version_number(can[handle].port, &hw_version, NULL) < 0)
+    // get version number: HW and SW (from the cache, if any)
+    if (CHANNEL(DEVICE(handle)).identified)
+        hw_version = CHANNEL(DEVICE(handle)).identity.hardware;
+    else if (slcan_version_number(CHANNEL(handle).port, &hw_version, NULL) < 0) {
+        release_handle(handle);
         return NULL;
+    }
 
     // note: TTY name has at worst 255 characters plus terminating zero
     snprintf(hardware, (2 * CANPROP_MAX_BUFFER_SIZE), "Hardware %u.%u (%s:%u,%u-%c-%u)",
         (uint8_t)(hw_version >> 4), (uint8_t)(hw_version & 0xFU),
-        can[handle].name, can[handle].attr.baudrate, can[handle].attr.bytesize,
-        can[handle].attr.parity == CANSIO_EVENPARITY ? 'E' : (can[handle].attr.parity == CANSIO_ODDPARITY ? 'O' : 'N'),
-        can[handle].attr.stopbits);
+        CHANNEL(handle).name, CHANNEL(handle).attr.baudrate, CHANNEL(handle).attr.bytesize,
+        CHANNEL(handle).attr.parity == CANSIO_EVENPARITY ? 'E' : (CHANNEL(handle).attr.parity == CANSIO_ODDPARITY ? 'O' : 'N'),
+        CHANNEL(handle).attr.stopbits);
+    release_handle(handle);             // handle can be closed now
     hardware[(2 * CANPROP_MAX_BUFFER_SIZE)] = '\0';
     return (char*)hardware;
 }
@@ -800,21 +1428,26 @@ char *can_firmware(int handle)
     static char firmware[CANPROP_MAX_BUFFER_SIZE+1] = "";
     uint8_t sw_version = 0x00U;
 
-    if (!init)                          // must be initialized
+    if (!ATOMIC_GET(&init))             // must be initialized
         return NULL;
     if (!IS_HANDLE_VALID(handle))       // must be a valid handle
         return NULL;
-    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+    if (!acquire_handle(handle))        // must be an open handle
         return NULL;
 
-    // get version number: HW and SW
-    if (slcan_version_number(can[handle].port, NULL, &sw_version) < 0)
+    // get version number: HW and SW (from the cache, if any)
+    if (CHANNEL(DEVICE(handle)).identified)
+        sw_version = CHANNEL(DEVICE(handle)).identity.software;
+    else if (slcan_version_number(CHANNEL(handle).port, NULL, &sw_version) < 0) {
+        release_handle(handle);
         return NULL;
+    }
 
     snprintf(firmware, CANPROP_MAX_BUFFER_SIZE, "Firmware %u.%u (%s SLCAN protocol)",
         (uint8_t)(sw_version >> 4), (uint8_t)(sw_version & 0xFU),
-        can[handle].attr.protocol == CANSIO_LAWICEL ? "Lawicel" :
-        can[handle].attr.protocol == CANSIO_CANABLE ? "CANable" : "?");
+        CHANNEL(handle).attr.protocol == CANSIO_LAWICEL ? "Lawicel" :
+        CHANNEL(handle).attr.protocol == CANSIO_CANABLE ? "CANable" : "?");
+    release_handle(handle);             // handle can be closed now
     firmware[CANPROP_MAX_BUFFER_SIZE] = '\0';
     return (char*)firmware;
 }
@@ -825,28 +1458,174 @@ static void var_init(void)
 {
     int i;
 
-    for (i = 0; i < CAN_MAX_HANDLES; i++) {
-        memset(&can[i], 0, sizeof(can_interface_t));
-        can[i].port = NULL;
-        can[i].name[0] = '\0';
-        can[i].attr.baudrate = SERIAL_BAUDRATE;
-        can[i].attr.bytesize = SERIAL_BYTESIZE;
-        can[i].attr.parity = SERIAL_PARITY;
-        can[i].attr.stopbits = SERIAL_STOPBITS;
-        can[i].attr.protocol = SERIAL_PROTOCOL;
-        can[i].btr0btr1 = CAN_BTR_DEFAULT;
-        can[i].mode.byte = CANMODE_DEFAULT;
-        can[i].status.byte = CANSTAT_RESET;
-        can[i].filter.sja1000.code = FILTER_SJA1000_CODE;
-        can[i].filter.sja1000.mask = FILTER_SJA1000_MASK;
-        can[i].filter.std.code = FILTER_STD_CODE;
-        can[i].filter.std.mask = FILTER_STD_MASK;
-        can[i].filter.xtd.code = FILTER_XTD_CODE;
-        can[i].filter.xtd.mask = FILTER_XTD_MASK;
-        can[i].counters.tx = 0ull;
-        can[i].counters.rx = 0ull;
-        can[i].counters.err = 0ull;
+    // note: the blocks of the handle table are kept once allocated,
+    //       because a handle could still be used by another thread
+    for (i = 0; i < CAN_NAME_BUCKETS; i++)
+        names[i] = INVALID_HANDLE;
+    free_list = INVALID_HANDLE;
+    for (i = ATOMIC_GET(&handles) - 1; i >= 0; i--) {
+        init_handle(i);
+        CHANNEL(i).link = free_list;
+        free_list = i;
+    }
+}
+
+static void init_handle(int handle)
+{
+    // note: the reference counter is not touched, because another thread
+    //       could increment it at any time (see 'acquire_handle')
+    ATOMIC_SET(&CHANNEL(handle).state, HANDLE_FREE);
+    ATOMIC_SET(&CHANNEL(handle).replaying, 0);
+    CHANNEL(handle).port = NULL;
+    CHANNEL(handle).name[0] = '\0';
+    memset(&CHANNEL(handle).identity, 0, sizeof(slcan_identity_t));
+    CHANNEL(handle).identified = false;
+    memset(&CHANNEL(handle).attr, 0, sizeof(can_sio_attr_t));
+    CHANNEL(handle).attr.baudrate = SERIAL_BAUDRATE;
+    CHANNEL(handle).attr.bytesize = SERIAL_BYTESIZE;
+    CHANNEL(handle).attr.parity = SERIAL_PARITY;
+    CHANNEL(handle).attr.stopbits = SERIAL_STOPBITS;
+    CHANNEL(handle).attr.protocol = SERIAL_PROTOCOL;
+    CHANNEL(handle).btr0btr1 = CAN_BTR_DEFAULT;
+    CHANNEL(handle).mode.byte = CANMODE_DEFAULT;
+    CHANNEL(handle).status.byte = CANSTAT_RESET;
+    CHANNEL(handle).filter.sja1000.code = FILTER_SJA1000_CODE;
+    CHANNEL(handle).filter.sja1000.mask = FILTER_SJA1000_MASK;
+    CHANNEL(handle).filter.std.code = FILTER_STD_CODE;
+    CHANNEL(handle).filter.std.mask = FILTER_STD_MASK;
+    CHANNEL(handle).filter.xtd.code = FILTER_XTD_CODE;
+    CHANNEL(handle).filter.xtd.mask = FILTER_XTD_MASK;
+    CHANNEL(handle).counters.tx = 0ull;
+    CHANNEL(handle).counters.rx = 0ull;
+    CHANNEL(handle).counters.err = 0ull;
+    CHANNEL(handle).queue.policy = SLCAN_QUEUE_POLICY;
+    CHANNEL(handle).queue.timeout = SLCAN_QUEUE_TIMEOUT;
+    CHANNEL(handle).queue.spill = 0U;
+    CHANNEL(handle).queue.threshold = 0U;
+    CHANNEL(handle).queue.folder[0] = '\0';
+    CHANNEL(handle).queue.mailbox = false;
+    CHANNEL(handle).queue.reduction = SLCAN_REDUCTION;
+    CHANNEL(handle).queue.rate = SLCAN_DECIMATION;
+    CHANNEL(handle).callback.handler = NULL;
+    CHANNEL(handle).callback.context = NULL;
+    CHANNEL(handle).polling.interval = SLCAN_POLLING;
+    CHANNEL(handle).polling.handler = NULL;
+    CHANNEL(handle).polling.context = NULL;
+    CHANNEL(handle).trace.type = CANPARA_TRACE_TYPE_BINARY;
+    CHANNEL(handle).trace.mode = CANPARA_TRACE_MODE_DEFAULT;
+    CHANNEL(handle).trace.size = CANPARA_TRACE_SIZE_DEFAULT;
+    CHANNEL(handle).trace.folder[0] = '\0';
+    CHANNEL(handle).trace.file[0] = '\0';
+    CHANNEL(handle).trace.tracer = NULL;
+    memset(&CHANNEL(handle).flight.attr, 0, sizeof(recorder_attr_t));
+    CHANNEL(handle).flight.attr.frames = RECORDER_FRAMES;
+    CHANNEL(handle).flight.attr.post_time = RECORDER_POST_TIME;
+    CHANNEL(handle).flight.dumps = 0U;
+    CHANNEL(handle).flight.ignored = 0U;
+    CHANNEL(handle).flight.file[0] = '\0';
+    CHANNEL(handle).flight.recorder = NULL;
+    CHANNEL(handle).capture.type = CANSIO_CAPTURE_SERIAL;
+    CHANNEL(handle).capture.decoded = false;
+    CHANNEL(handle).capture.dropped = 0U;
+    CHANNEL(handle).capture.file[0] = '\0';
+    CHANNEL(handle).capture.capture = NULL;
+    CHANNEL(handle).owner = INVALID_HANDLE;
+    CHANNEL(handle).reader = INVALID_HANDLE;
+    CHANNEL(handle).link = INVALID_HANDLE;
+}
+
+static int grow_table(void)
+{
+    can_interface_t *block;
+    int first = ATOMIC_GET(&handles);
+    int i;
+
+    // note: the table grows by blocks of handles, a block is never moved
+    //       (the hot paths access the table without holding the lock)
+    if ((first / CAN_HANDLE_BLOCK) >= CAN_HANDLE_BLOCKS)
+        return 0;
+    if ((block = (can_interface_t*)calloc(CAN_HANDLE_BLOCK, sizeof(can_interface_t))) == NULL)
+        return 0;
+    table[first / CAN_HANDLE_BLOCK] = block;
+    for (i = first + CAN_HANDLE_BLOCK - 1; i >= first; i--) {
+        init_handle(i);
+        CHANNEL(i).link = free_list;
+        free_list = i;
+    }
+    ATOMIC_SET(&handles, first + CAN_HANDLE_BLOCK);  // publish the block
+    return 1;
+}
+
+static int new_handle(const char *name)
+{
+    int handle;
+    unsigned bucket;
+
+    // note: the handle table must be locked by the caller
+    if ((free_list == INVALID_HANDLE) && !grow_table())
+        return INVALID_HANDLE;
+    handle = free_list;
+    free_list = CHANNEL(handle).link;
+    CHANNEL(handle).link = INVALID_HANDLE;
+    CHANNEL(handle).owner = INVALID_HANDLE;
+    CHANNEL(handle).name[0] = '\0';
+    if (name) {                         // owner: add it to the name index
+        strncpy(CHANNEL(handle).name, name, CANPROP_MAX_BUFFER_SIZE);
+        CHANNEL(handle).name[CANPROP_MAX_BUFFER_SIZE - 1] = '\0';
+        bucket = name_hash(CHANNEL(handle).name);
+        CHANNEL(handle).link = names[bucket];
+        names[bucket] = handle;
+    }
+    ATOMIC_SET(&CHANNEL(handle).state, HANDLE_BUSY);
+    return handle;
+}
+
+static void free_handle(int handle)
+{
+    int *link;
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    // note: the handle table must be locked by the caller
+    link = &names[name_hash(CHANNEL(handle).name)];
+    while (*link != INVALID_HANDLE) {   // remove it from the name index
+        if (*link == handle) {
+            *link = CHANNEL(handle).link;
+            break;
+        }
+        link = &CHANNEL(*link).link;
+    }
+    CHANNEL(handle).port = NULL;
+    CHANNEL(handle).name[0] = '\0';
+    CHANNEL(handle).owner = INVALID_HANDLE;
+    CHANNEL(handle).link = free_list;   // add it to the free list
+    free_list = handle;
+    ATOMIC_SET(&CHANNEL(handle).state, HANDLE_FREE);
+}
+
+static int find_handle(const char *name)
+{
+    int handle;
+
+    // note: the handle table must be locked by the caller
+    if (!init)
+        return INVALID_HANDLE;
+    handle = names[name_hash(name)];
+    while (handle != INVALID_HANDLE) {
+        if (!strcmp(CHANNEL(handle).name, name))
+            break;
+        handle = CHANNEL(handle).link;
     }
+    return handle;
+}
+
+static unsigned name_hash(const char *name)
+{
+    uint32_t hash = 2166136261U;        // FNV-1a
+
+    while (*name)
+        hash = (hash ^ (uint8_t)*name++) * 16777619U;
+    return (unsigned)(hash % CAN_NAME_BUCKETS);
 }
 
 static int all_closed(void)
@@ -855,13 +1634,58 @@ static int all_closed(void)
 
     if (!init)
         return 1;
-    for (handle = 0; handle < CAN_MAX_HANDLES; handle++) {
-        if (IS_HANDLE_OPENED(handle))
+    for (handle = 0; handle < ATOMIC_GET(&handles); handle++) {
+        if (ATOMIC_GET(&CHANNEL(handle).state) != HANDLE_FREE)
             return 0;
     }
     return 1;
 }
 
+static int acquire_handle(int handle)
+{
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    // note: the reference counter is incremented before the state is
+    //       checked, so that 'exit_channel' either sees the user or the
+    //       user sees the closing handle (no lock on the hot paths)
+    ATOMIC_INC(&CHANNEL(handle).users);
+    if (ATOMIC_GET(&CHANNEL(handle).state) != HANDLE_OPENED) {
+        ATOMIC_DEC(&CHANNEL(handle).users);
+        return 0;
+    }
+    return 1;
+}
+
+static void release_handle(int handle)
+{
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    // note: when the handle is being closed, the counter is decremented
+    //       with the close lock held, so that the waiting thread cannot
+    //       miss the signal (the table lock must not be taken here)
+    if (ATOMIC_GET(&CHANNEL(handle).state) == HANDLE_BUSY) {
+        LOCK_CLOSE();
+        ATOMIC_DEC(&CHANNEL(handle).users);
+        SIGNAL_CLOSE();
+        UNLOCK_CLOSE();
+    }
+    else
+        ATOMIC_DEC(&CHANNEL(handle).users);
+}
+
+static void set_status(int handle, uint8_t mask, uint8_t bits)
+{
+    uint8_t old, val;
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    // note: status bits are changed by several threads (lock-free)
+    do {
+        old = STATUS(handle);
+        val = (uint8_t)((old & ~mask) | (bits & mask));
+    } while (!ATOMIC_CAS8(&CHANNEL(handle).status.byte, old, val));
+}
+
 static int slcan_error(int code)
 {
     int rc = CANERR_NOERROR;
@@ -874,35 +1698,97 @@ static int slcan_error(int code)
         case ENODEV:   rc = CANERR_HANDLE; break;
         case EBADF:    rc = CANERR_NOTINIT; break;
         case EALREADY: rc = CANERR_YETINIT; break;
+        case ENOMEM:   rc = CANERR_RESOURCE; break;
+        case ENOTSUP:  rc = CANERR_NOTSUPP; break;
         default:       rc = CANERR_VENDOR - errno; break;
         }
     }
     return rc;
 }
 
-static slcan_attr_t* slcan_attr(const can_sio_attr_t *attr)
+static void map_message(can_message_t *msg, const slcan_message_t *slcan)
+{
+    assert(msg);                        // just to make sure
+    assert(slcan);
+
+    msg->xtd = (slcan->can_id & CAN_XTD_FRAME) ? 1 : 0;
+    msg->sts = (slcan->can_id & CAN_ERR_FRAME) ? 1 : 0;
+    msg->rtr = (slcan->can_id & CAN_RTR_FRAME) ? 1 : 0;
+    msg->id = slcan->can_id & (msg->xtd ? CAN_XTD_MASK : CAN_STD_MASK);
+    msg->dlc = (slcan->can_dlc < CAN_DLC_MAX) ? slcan->can_dlc : CAN_LEN_MAX;
+    memcpy(msg->data, slcan->data, msg->dlc);
+}
+
+static void rx_handler(const slcan_message_t *message, const struct timespec *timestamp, void *context)
 {
-    static slcan_attr_t slcan;
+    can_interface_t *channel = (can_interface_t*)context;
+    can_message_t msg;                  // CAN API message
+
+    // note: this function is called by the reception thread
+    if (!channel || !channel->callback.handler || !message)
+        return;
+    memset(&msg, 0x00, sizeof(can_message_t));
+    map_message(&msg, message);
+    if (timestamp)
+        msg.timestamp = *timestamp;
+    // update receive counter
+    if (!msg.sts)
+        ATOMIC_ADD64(&channel->counters.rx, 1U);
+    else
+        ATOMIC_ADD64(&channel->counters.err, 1U);
+    // deliver the message to the application
+    channel->callback.handler(&msg, channel->callback.context);
+}
+
+static uint8_t map_flags(slcan_flags_t flags)
+{
+    // TODO: SJA1000 datasheet, rtfm!
+    return (uint8_t)(((flags.DOI | flags.RxFIFO | flags.TxFIFO) ? CANSTAT_MSG_LST : 0x00U) |
+                     (flags.BEI ? CANSTAT_BERR : 0x00U) |
+                     ((flags.EI | flags.EPI) ? CANSTAT_EWRN : 0x00U) |
+                     (flags.ALI ? CANSTAT_BOFF : 0x00U));
+}
 
+static void status_handler(slcan_flags_t flags, void *context)
+{
+    int handle = (int)(intptr_t)context;
+    uint8_t old = STATUS(handle);       // bus status before the poll
+    uint8_t bits = map_flags(flags);    // bus status of the poll
+
+    // note: this function is called by the polling thread
+    set_status(handle, BUS_STATUS, bits);
+    if ((old & BUS_STATUS) == bits)
+        return;
+    // note: the flight recorder can only be changed if the CAN controller is in INIT mode
+    if (CHANNEL(handle).flight.recorder)
+        (void)recorder_trigger(CHANNEL(handle).flight.recorder, RECORDER_ON_STATUS);
+    // notify the application when the bus status has changed
+    if (CHANNEL(handle).polling.handler)
+        CHANNEL(handle).polling.handler(STATUS(handle), CHANNEL(handle).polling.context);
+}
+
+static slcan_attr_t* slcan_attr(const can_sio_attr_t *attr, slcan_attr_t *slcan)
+{
     assert(attr);
+    assert(slcan);
 
-    slcan.baudrate = attr->baudrate;    // in bits per second
+    slcan->baudrate = attr->baudrate;   // in bits per second
     switch (attr->bytesize) {
-    case CANSIO_5DATABITS: slcan.bytesize = BYTESIZE5; break;
-    case CANSIO_6DATABITS: slcan.bytesize = BYTESIZE6; break;
-    case CANSIO_7DATABITS: slcan.bytesize = BYTESIZE7; break;
-    default: slcan.bytesize = BYTESIZE8; break;
+    case CANSIO_5DATABITS: slcan->bytesize = BYTESIZE5; break;
+    case CANSIO_6DATABITS: slcan->bytesize = BYTESIZE6; break;
+    case CANSIO_7DATABITS: slcan->bytesize = BYTESIZE7; break;
+    default: slcan->bytesize = BYTESIZE8; break;
     }
     switch (attr->stopbits) {
-    case CANSIO_2STOPBITS: slcan.stopbits = STOPBITS2; break;
-    default: slcan.stopbits = STOPBITS1; break;
+    case CANSIO_2STOPBITS: slcan->stopbits = STOPBITS2; break;
+    default: slcan->stopbits = STOPBITS1; break;
     }
     switch (attr->parity) {
-    case CANSIO_ODDPARITY: slcan.parity = PARITYODD; break;
-    case CANSIO_EVENPARITY: slcan.parity = PARITYEVEN; break;
-    default: slcan.parity = PARITYNONE; break;
+    case CANSIO_ODDPARITY: slcan->parity = PARITYODD; break;
+    case CANSIO_EVENPARITY: slcan->parity = PARITYEVEN; break;
+    default: slcan->parity = PARITYNONE; break;
     }
-    return &slcan;
+    return slcan;
 }
 
 static int get_sio_attr(slcan_port_t port, can_sio_attr_t *attr)
@@ -957,21 +1843,21 @@ static int set_filter(int handle, uint64_t filter, bool xtd)
      * c) SJA1000 has only one pair of code and mask registers
      */
     if (!xtd) {
-        can[handle].filter.std.code = code;
-        can[handle].filter.std.mask = mask;
-        can[handle].filter.xtd.code = FILTER_XTD_CODE;
-        can[handle].filter.xtd.mask = FILTER_XTD_MASK;
+        CHANNEL(handle).filter.std.code = code;
+        CHANNEL(handle).filter.std.mask = mask;
+        CHANNEL(handle).filter.xtd.code = FILTER_XTD_CODE;
+        CHANNEL(handle).filter.xtd.mask = FILTER_XTD_MASK;
         // determine the ACn and AMn register
-        can[handle].filter.sja1000.code = (uint32_t)(code << 5);
-        can[handle].filter.sja1000.mask = (uint32_t)((~mask & CAN_MAX_STD_ID) << 5) | (uint32_t)0x1FU;
+        CHANNEL(handle).filter.sja1000.code = (uint32_t)(code << 5);
+        CHANNEL(handle).filter.sja1000.mask = (uint32_t)((~mask & CAN_MAX_STD_ID) << 5) | (uint32_t)0x1FU;
     } else {
-        can[handle].filter.std.code = FILTER_STD_CODE;
-        can[handle].filter.std.mask = FILTER_STD_MASK;
-        can[handle].filter.xtd.code = code;
-        can[handle].filter.xtd.mask = mask;
+        CHANNEL(handle).filter.std.code = FILTER_STD_CODE;
+        CHANNEL(handle).filter.std.mask = FILTER_STD_MASK;
+        CHANNEL(handle).filter.xtd.code = code;
+        CHANNEL(handle).filter.xtd.mask = mask;
         // determine the ACn and AMn register
-        can[handle].filter.sja1000.code = (uint32_t)(code << 3);
-        can[handle].filter.sja1000.mask = (uint32_t)((~mask & CAN_MAX_XTD_ID) << 3) | (uint32_t)0x7U;
+        CHANNEL(handle).filter.sja1000.code = (uint32_t)(code << 3);
+        CHANNEL(handle).filter.sja1000.mask = (uint32_t)((~mask & CAN_MAX_XTD_ID) << 3) | (uint32_t)0x7U;
     }
     return CANERR_NOERROR;
 }
@@ -981,13 +1867,435 @@ static int reset_filter(int handle)
     assert(IS_HANDLE_VALID(handle));    // just to make sure
 
     /* reset the acceptance filter for standard and extended identifier */
-    can[handle].filter.std.code = FILTER_STD_CODE;
-    can[handle].filter.std.mask = FILTER_STD_MASK;
-    can[handle].filter.xtd.code = FILTER_XTD_CODE;
-    can[handle].filter.xtd.mask = FILTER_XTD_MASK;
-    can[handle].filter.sja1000.code = FILTER_SJA1000_CODE;
-    can[handle].filter.sja1000.mask = FILTER_SJA1000_MASK;
+    CHANNEL(handle).filter.std.code = FILTER_STD_CODE;
+    CHANNEL(handle).filter.std.mask = FILTER_STD_MASK;
+    CHANNEL(handle).filter.xtd.code = FILTER_XTD_CODE;
+    CHANNEL(handle).filter.xtd.mask = FILTER_XTD_MASK;
+    CHANNEL(handle).filter.sja1000.code = FILTER_SJA1000_CODE;
+    CHANNEL(handle).filter.sja1000.mask = FILTER_SJA1000_MASK;
+
+    return CANERR_NOERROR;
+}
+
+static int get_busload(int handle, uint16_t *load)
+{
+    can_bitrate_t bitrate;              // bit-rate settings
+    can_speed_t speed;                  // transmission speed
+    int rc;                             // return value
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(load);
+
+    // note: the bit-rate is taken from the SJA1000 register,
+    //       even when it has been set from an index
+    if ((rc = btr_sja10002bitrate(CHANNEL(DEVICE(handle)).btr0btr1, &bitrate)) != CANERR_NOERROR)
+        return rc;
+    if ((rc = btr_bitrate2speed(&bitrate, &speed)) != CANERR_NOERROR)
+        return rc;
+    if (speed.nominal.speed < 1.0f)
+        return CANERR_BAUDRATE;
+    // bus load of received and sent frames (in [1/100 percent])
+    rc = slcan_bus_load(CHANNEL(handle).port, (uint32_t)speed.nominal.speed, load);
+    return slcan_error(rc);
+}
+
+static int set_policy(int handle, uint8_t policy, uint16_t timeout)
+{
+    int rc;                             // return value
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    switch (policy) {
+    case CANSIO_DROP_NEWEST: rc = slcan_queue_policy(CHANNEL(handle).port, SLCAN_DROP_NEWEST, 0U); break;
+    case CANSIO_DROP_OLDEST: rc = slcan_queue_policy(CHANNEL(handle).port, SLCAN_DROP_OLDEST, 0U); break;
+    case CANSIO_BOUNDED_BLOCK: rc = slcan_queue_policy(CHANNEL(handle).port, SLCAN_BOUNDED_BLOCK, timeout); break;
+    default: return CANERR_ILLPARA;
+    }
+    if ((rc = slcan_error(rc)) == CANERR_NOERROR) {
+        CHANNEL(handle).queue.policy = policy;
+        CHANNEL(handle).queue.timeout = timeout;
+    }
+    return rc;
+}
+
+static void trace_handler(const slcan_message_t *message, const struct timespec *timestamp, bool tx, void *context)
+{
+    int handle = (int)(intptr_t)context;
+    tracer_record_t record;             // trace record
+
+    // note: this function is called by the reception thread (received
+    //       messages) and by the sending thread (sent messages)
+    record.time = ((uint64_t)timestamp->tv_sec * 1000000000U) + (uint64_t)timestamp->tv_nsec;
+    record.can_id = message->can_id;    // note: same frame flags as SLCAN
+    record.can_dlc = message->can_dlc;
+    record.dir = tx ? TRACER_TX : TRACER_RX;
+    record.__res[0] = record.__res[1] = 0U;
+    memcpy(record.data, message->data, CAN_LEN_MAX);
+    // note: the trace handler is re-installed when the tracer or the recorder
+    //       changes, so both pointers are stable during this call
+    if (CHANNEL(handle).trace.tracer)
+        (void)tracer_put(CHANNEL(handle).trace.tracer, &record);
+    if (CHANNEL(handle).flight.recorder)
+        (void)recorder_put(CHANNEL(handle).flight.recorder, &record);
+    if (CHANNEL(handle).capture.capture && CHANNEL(handle).capture.decoded)
+        (void)capture_put_frame(CHANNEL(handle).capture.capture, &record);
+}
+
+static void capture_handler(const uint8_t *buffer, size_t nbytes, const struct timespec *timestamp, bool tx, void *context)
+{
+    uint64_t time = ((uint64_t)timestamp->tv_sec * 1000000000U) + (uint64_t)timestamp->tv_nsec;
+
+    // note: this function is called by the reception thread (received
+    //       data) and by the sending threads (sent data)
+    (void)capture_put((capture_t)context, buffer, nbytes, time, tx ? CAPTURE_TX : CAPTURE_RX);
+}
+
+static int set_tracing(int handle)
+{
+    int rc;                             // return value
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    // note: the trace handler is installed as long as there is a tracer or a recorder,
+    //       and the function returns when all calls of the old handler have finished
+    if (CHANNEL(handle).trace.tracer || CHANNEL(handle).flight.recorder ||
+        (CHANNEL(handle).capture.capture && CHANNEL(handle).capture.decoded))
+        rc = slcan_set_trace_handler(CHANNEL(handle).port, trace_handler, (void*)(intptr_t)handle);
+    else
+        rc = slcan_set_trace_handler(CHANNEL(handle).port, NULL, NULL);
+    return slcan_error(rc);
+}
+
+static int trace_format(int handle, uint8_t *format)
+{
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(format);
+
+    switch (CHANNEL(handle).trace.type) {
+    case CANPARA_TRACE_TYPE_BINARY: *format = TRACER_BINARY; break;
+    case CANPARA_TRACE_TYPE_LOGGER: *format = TRACER_CSV; break;
+    case CANPARA_TRACE_TYPE_VENDOR: *format = TRACER_VENDOR; break;
+    case CANSIO_TRACE_TYPE_CANDUMP: *format = TRACER_CANDUMP; break;
+    case CANSIO_TRACE_TYPE_ASC: *format = TRACER_ASC; break;
+    default: return CANERR_ILLPARA;
+    }
+    return CANERR_NOERROR;
+}
+
+static void trace_basename(int handle, const char *suffix, char *basename, size_t size)
+{
+    const char *device;                 // TTY device name (w/o path)
+    const char *separator;              // last path separator
+    time_t now;                         // current time
+    struct tm tm;                       // (local time)
+    size_t n;                           // string length
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(suffix);
+    assert(basename);
+
+    // file name: <folder>/[<yyyymmdd>_][<hhmmss>_]<tty><suffix>
+    device = CHANNEL(handle).name;
+    if ((separator = strrchr(device, '/')) != NULL)
+        device = separator + 1;
+    if ((separator = strrchr(device, '\\')) != NULL)
+        device = separator + 1;
+    n = (size_t)snprintf(basename, size, "%s/",
+                         CHANNEL(handle).trace.folder[0] ? CHANNEL(handle).trace.folder : ".");
+    if (CHANNEL(handle).trace.mode & (CANPARA_TRACE_MODE_PREFIX_DATE | CANPARA_TRACE_MODE_PREFIX_TIME)) {
+        now = time(NULL);
+#if defined(_WIN32) || defined(_WIN64)
+        (void)localtime_s(&tm, &now);
+#else
+        (void)localtime_r(&now, &tm);
+#endif
+        if (CHANNEL(handle).trace.mode & CANPARA_TRACE_MODE_PREFIX_DATE)
+            n += strftime(&basename[n], size - n, "%Y%m%d_", &tm);
+        if (CHANNEL(handle).trace.mode & CANPARA_TRACE_MODE_PREFIX_TIME)
+            n += strftime(&basename[n], size - n, "%H%M%S_", &tm);
+    }
+    (void)snprintf(&basename[n], size - n, "%s%s", device[0] ? device : "slcan", suffix);
+}
+
+static int start_trace(int handle)
+{
+    char basename[2 * CANPROP_MAX_BUFFER_SIZE];  // path and file name (w/o extension)
+    uint8_t format;                     // trace file format
+    uint8_t mode = TRACER_APPEND;       // trace file mode
+    uint64_t segment;                   // segment size in [byte]
+    tracer_t tracer;                    // trace file writer
+    int rc;                             // return value
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    if (CHANNEL(handle).trace.tracer)   // already recording
+        return CANERR_NOERROR;
+    if ((rc = trace_format(handle, &format)) != CANERR_NOERROR)
+        return rc;
+    if (CHANNEL(handle).trace.mode & CANPARA_TRACE_MODE_OVERWRITE)
+        mode |= TRACER_OVERWRITE;
+    if (CHANNEL(handle).trace.mode & CANPARA_TRACE_MODE_SEGMENTED)
+        mode |= TRACER_SEGMENTED;
+    segment = CHANNEL(handle).trace.size ? ((uint64_t)CHANNEL(handle).trace.size * CANPARA_TRACE_SIZE_10KB)
+                                         : (uint64_t)TRACE_SEGMENT_SIZE;
+    trace_basename(handle, "", basename, sizeof(basename));
+    // open the trace file and start recording
+    if ((tracer = tracer_create(basename, format, mode, segment)) == NULL)
+        return slcan_error(-1);         // errno is set in this case
+    CHANNEL(handle).trace.tracer = tracer;
+    if ((rc = set_tracing(handle)) != CANERR_NOERROR) {
+        CHANNEL(handle).trace.tracer = NULL;
+        (void)set_tracing(handle);
+        (void)tracer_destroy(tracer);
+        return rc;
+    }
+    return CANERR_NOERROR;
+}
+
+static int stop_trace(int handle)
+{
+    tracer_t tracer = CHANNEL(handle).trace.tracer;
+    int rc;                             // return value
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    if (!tracer)                        // not recording
+        return CANERR_NOERROR;
+    // note: the tracer is no longer used when the trace handler has been re-installed
+    CHANNEL(handle).trace.tracer = NULL;
+    (void)set_tracing(handle);
+    (void)tracer_filename(tracer, CHANNEL(handle).trace.file, CANPROP_MAX_BUFFER_SIZE);
+    // write all pending records and close the trace file
+    rc = tracer_destroy(tracer);
+    return slcan_error(rc);
+}
+
+static int start_recorder(int handle)
+{
+    char basename[2 * CANPROP_MAX_BUFFER_SIZE];  // path and file name (w/o extension)
+    recorder_t recorder;                // flight recorder
+    int rc;                             // return value
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    if (CHANNEL(handle).flight.recorder)  // already recording
+        return CANERR_NOERROR;
+    // note: the dump files are written to the trace file folder in the trace file format
+    if ((rc = trace_format(handle, &CHANNEL(handle).flight.attr.format)) != CANERR_NOERROR)
+        return rc;
+    trace_basename(handle, "_flight", basename, sizeof(basename));
+    // allocate the rings and start the dump thread
+    if ((recorder = recorder_create(basename, &CHANNEL(handle).flight.attr)) == NULL)
+        return slcan_error(-1);         // errno is set in this case
+    CHANNEL(handle).flight.recorder = recorder;
+    if ((rc = set_tracing(handle)) != CANERR_NOERROR) {
+        CHANNEL(handle).flight.recorder = NULL;
+        (void)set_tracing(handle);
+        (void)recorder_destroy(recorder);
+        return rc;
+    }
+    CHANNEL(handle).flight.dumps = 0U;
+    CHANNEL(handle).flight.ignored = 0U;
+    return CANERR_NOERROR;
+}
+
+static int stop_recorder(int handle)
+{
+    recorder_t recorder = CHANNEL(handle).flight.recorder;
+    int rc;                             // return value
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    if (!recorder)                      // not recording
+        return CANERR_NOERROR;
+    // note: the recorder is no longer used when the trace handler has been re-installed
+    CHANNEL(handle).flight.recorder = NULL;
+    (void)set_tracing(handle);
+    // dump a trigger in progress and release the rings
+    (void)recorder_flush(recorder);
+    (void)recorder_status(recorder, &CHANNEL(handle).flight.dumps, &CHANNEL(handle).flight.ignored);
+    (void)recorder_filename(recorder, CHANNEL(handle).flight.file, CANPROP_MAX_BUFFER_SIZE);
+    rc = recorder_destroy(recorder);
+    return slcan_error(rc);
+}
+
+static int start_capture(int handle)
+{
+    char basename[2 * CANPROP_MAX_BUFFER_SIZE];  // path and file name (w/o extension)
+    bool decoded = (CHANNEL(handle).capture.type == CANSIO_CAPTURE_SOCKETCAN);
+    capture_t capture;                  // pcapng file writer
+    int rc;                             // return value
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    if (CHANNEL(handle).capture.capture)  // already capturing
+        return CANERR_NOERROR;
+    // note: the pcapng file is written to the trace file folder
+    trace_basename(handle, "_capture", basename, sizeof(basename));
+    if ((capture = capture_create(basename, decoded ? CAPTURE_SOCKETCAN : CAPTURE_SERIAL)) == NULL)
+        return slcan_error(-1);         // errno is set in this case
+    CHANNEL(handle).capture.decoded = decoded;
+    CHANNEL(handle).capture.capture = capture;
+    // raw serial data by the capture handler, or decoded messages by the trace handler
+    if (!decoded)
+        rc = slcan_error(slcan_set_capture_handler(CHANNEL(handle).port, capture_handler, (void*)capture));
+    else
+        rc = set_tracing(handle);
+    if (rc != CANERR_NOERROR) {
+        CHANNEL(handle).capture.capture = NULL;
+        if (!decoded)
+            (void)slcan_set_capture_handler(CHANNEL(handle).port, NULL, NULL);
+        else
+            (void)set_tracing(handle);
+        (void)capture_destroy(capture);
+        return rc;
+    }
+    return CANERR_NOERROR;
+}
 
+static int stop_capture(int handle)
+{
+    capture_t capture = CHANNEL(handle).capture.capture;
+    int rc;                             // return value
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    if (!capture)                       // not capturing
+        return CANERR_NOERROR;
+    // note: the capture is no longer used when the handler has been removed (or re-installed)
+    CHANNEL(handle).capture.capture = NULL;
+    if (!CHANNEL(handle).capture.decoded)
+        (void)slcan_set_capture_handler(CHANNEL(handle).port, NULL, NULL);
+    else
+        (void)set_tracing(handle);
+    (void)capture_filename(capture, CHANNEL(handle).capture.file, CANPROP_MAX_BUFFER_SIZE);
+    (void)capture_status(capture, NULL, &CHANNEL(handle).capture.dropped);
+    // write all pending packets and close the pcapng file
+    rc = capture_destroy(capture);
+    return slcan_error(rc);
+}
+
+static uint32_t percentile(const uint64_t *histogram, uint64_t count, uint32_t max, uint32_t permille)
+{
+    uint64_t sum = 0U;                  // cumulative count
+    uint32_t bin;                       // timing error in [us]
+
+    assert(histogram);                  // just to make sure
+
+    // note: the last bin counts all timing errors beyond the histogram
+    for (bin = 0U; bin < REPLAY_HISTOGRAM; bin++) {
+        sum += histogram[bin];
+        if ((sum * 1000U) >= (count * permille))
+            return (bin < max) ? bin : max;
+    }
+    return max;
+}
+
+static int set_spill(int handle, const char *folder, uint32_t size)
+{
+    int rc;                             // return value
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(folder);
+
+    // note: an empty string selects the system's temporary folder
+    rc = slcan_queue_spill(CHANNEL(handle).port, folder[0] ? folder : NULL, size);
+    if ((rc = slcan_error(rc)) == CANERR_NOERROR) {
+        if (folder != CHANNEL(handle).queue.folder) {
+            strncpy(CHANNEL(handle).queue.folder, folder, CANPROP_MAX_BUFFER_SIZE);
+            CHANNEL(handle).queue.folder[CANPROP_MAX_BUFFER_SIZE - 1] = '\0';
+        }
+        CHANNEL(handle).queue.spill = size;
+    }
+    return rc;
+}
+
+static int set_reduction(int handle, uint8_t mode, uint16_t rate)
+{
+    uint8_t reduce = SLCAN_REDUCE_OFF;  // SLCAN reduction mode
+    int rc;                             // return value
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    if (mode & ~(CANSIO_REDUCE_CHANGE_ONLY | CANSIO_REDUCE_DECIMATE))
+        return CANERR_ILLPARA;
+    reduce |= (mode & CANSIO_REDUCE_CHANGE_ONLY) ? SLCAN_REDUCE_CHANGE_ONLY : 0U;
+    reduce |= (mode & CANSIO_REDUCE_DECIMATE) ? SLCAN_REDUCE_DECIMATE : 0U;
+    rc = slcan_reduction(CHANNEL(handle).port, reduce, rate);
+    if ((rc = slcan_error(rc)) == CANERR_NOERROR) {
+        CHANNEL(handle).queue.reduction = mode;
+        CHANNEL(handle).queue.rate = rate;
+    }
+    return rc;
+}
+
+static int refresh_identity(int handle)
+{
+    slcan_identity_t identity;          // device identity
+    int rc;                             // return value
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    // note: two round trips on the serial line (only on request)
+    rc = slcan_version_number(CHANNEL(handle).port, &identity.hardware, &identity.software);
+    if (rc < 0)
+        return slcan_error(rc);
+    rc = slcan_serial_number(CHANNEL(handle).port, &identity.serial);
+    identity.has_serial = (rc == 0) ? true : false;
+    if (!identity.has_serial)
+        identity.serial = 0U;
+    CHANNEL(handle).identity = identity;
+    CHANNEL(handle).identified = true;
+    return CANERR_NOERROR;
+}
+
+static int init_subscriber(int owner, uint8_t mode)
+{
+    int handle;                         // handle index
+
+    assert(IS_HANDLE_VALID(owner));     // just to make sure
+
+    if ((handle = new_handle(NULL)) == INVALID_HANDLE)
+        return CANERR_NOTINIT;          // no free handle found
+
+    // note: a subscriber shares the SLCAN port of the owner; it receives all
+    //       messages (through its acceptance filter) but cannot send any
+    strncpy(CHANNEL(handle).name, CHANNEL(owner).name, CANPROP_MAX_BUFFER_SIZE);
+    CHANNEL(handle).name[CANPROP_MAX_BUFFER_SIZE - 1] = '\0';
+    CHANNEL(handle).attr = CHANNEL(owner).attr;
+    CHANNEL(handle).mode.byte = mode;       // store selected operation mode
+    CHANNEL(handle).callback.handler = NULL;  // no reception callback
+    CHANNEL(handle).callback.context = NULL;
+    CHANNEL(handle).owner = owner;          // owner of the SLCAN port
+    CHANNEL(handle).reader = INVALID_HANDLE;
+    set_status(handle, 0xFFU, CANSTAT_RESET); // not subscribed yet
+    (void)reset_filter(handle);         // accept all messages
+    CHANNEL(handle).port = CHANNEL(owner).port; // the port of the owner
+    ATOMIC_SET(&CHANNEL(handle).state, HANDLE_OPENED);
+    return handle;                      // return the handle
+}
+
+static int start_subscriber(int handle)
+{
+    slcan_filter_t filter;              // acceptance filter
+    int rc;                             // return value
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(IS_SUBSCRIBER(handle));
+
+    filter.std_code = CHANNEL(handle).filter.std.code;
+    filter.std_mask = CHANNEL(handle).filter.std.mask;
+    filter.xtd_code = CHANNEL(handle).filter.xtd.code;
+    filter.xtd_mask = CHANNEL(handle).filter.xtd.mask;
+    if ((rc = slcan_subscribe(CHANNEL(handle).port, &filter)) < 0)
+        return slcan_error(rc);
+    CHANNEL(handle).reader = rc;
+    // clear old counters and status
+    ATOMIC_SET64(&CHANNEL(handle).counters.tx, 0U);
+    ATOMIC_SET64(&CHANNEL(handle).counters.rx, 0U);
+    ATOMIC_SET64(&CHANNEL(handle).counters.err, 0U);
+    // subscriber started!
+    set_status(handle, 0xFFU, 0x00U);
     return CANERR_NOERROR;
 }
 
@@ -1160,7 +2468,7 @@ static int lib_parameter(uint16_t param, void *value, size_t nbyte)
     case CANPROP_SET_FILTER_29BIT:      // set value for acceptance filter code and mask for 29-bit identifier (uint64_t)
     case CANPROP_SET_FILTER_RESET:      // reset acceptance filter code and mask to default values (NULL)
         // note: a device parameter requires a valid handle.
-        if (!init)
+        if (!ATOMIC_GET(&init))
             rc = CANERR_NOTINIT;
         else
             rc = CANERR_HANDLE;
@@ -1178,29 +2486,34 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
     can_bitrate_t bitrate;              // bit-rate settings
     can_speed_t speed;                  // current bus speed
     uint8_t status = 0u;                // status register
-    uint8_t load = 0u;                  // bus load
+    uint16_t load = 0u;                 // bus load
     uint8_t version_no = 0x00u;         // version number (8-bit)
     uint32_t serial_no = 0x00000000u;   // serial number (32-bit)
+    char folder[CANPROP_MAX_BUFFER_SIZE];  // spill file folder
+    size_t length = 0u;                 // string length
+    uint64_t suppressed = 0u;           // suppressed messages
 
     assert(IS_HANDLE_VALID(handle));    // just to make sure
 
     if (value == NULL) {                // check for null-pointer
         if ((param != CANPROP_SET_FIRST_CHANNEL) &&
             (param != CANPROP_SET_NEXT_CHANNEL) &&
-            (param != CANPROP_SET_FILTER_RESET))
+            (param != CANPROP_SET_FILTER_RESET) &&
+            (param != (CANPROP_SET_VENDOR_PROP + SLCAN_DEVICE_REFRESH)) &&
+            (param != (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_TRIGGER)))
             return CANERR_NULLPTR;
     }
     // query or modify a CAN interface property
     switch (param) {
     case CANPROP_GET_DEVICE_TYPE:       // device type of the CAN interface (int32_t)
         if (nbyte >= sizeof(int32_t)) {
-            *(int32_t*)value = (int32_t)can[handle].attr.protocol;
+            *(int32_t*)value = (int32_t)CHANNEL(handle).attr.protocol;
             rc = CANERR_NOERROR;
         }
         break;
     case CANPROP_GET_DEVICE_NAME:       // device name of the CAN interface (char[])
         if (nbyte >= 1u) {
-            strncpy((char*)value, can[handle].name, nbyte);
+            strncpy((char*)value, CHANNEL(handle).name, nbyte);
             ((char*)value)[(nbyte - 1)] = '\0';
             rc = CANERR_NOERROR;
         }
@@ -1221,12 +2534,12 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case CANPROP_GET_DEVICE_PARAM:      // device parameter of the CAN interface (can_sio_param_t)
         if (nbyte >= sizeof(can_sio_param_t)) {
-            ((can_sio_param_t*)value)->name = (char*)can[handle].name;
-            ((can_sio_param_t*)value)->attr.baudrate = can[handle].attr.baudrate;
-            ((can_sio_param_t*)value)->attr.bytesize = can[handle].attr.bytesize;
-            ((can_sio_param_t*)value)->attr.parity = can[handle].attr.parity;
-            ((can_sio_param_t*)value)->attr.stopbits = can[handle].attr.stopbits;
-            ((can_sio_param_t*)value)->attr.protocol = can[handle].attr.protocol;
+            ((can_sio_param_t*)value)->name = (char*)CHANNEL(handle).name;
+            ((can_sio_param_t*)value)->attr.baudrate = CHANNEL(handle).attr.baudrate;
+            ((can_sio_param_t*)value)->attr.bytesize = CHANNEL(handle).attr.bytesize;
+            ((can_sio_param_t*)value)->attr.parity = CHANNEL(handle).attr.parity;
+            ((can_sio_param_t*)value)->attr.stopbits = CHANNEL(handle).attr.stopbits;
+            ((can_sio_param_t*)value)->attr.protocol = CHANNEL(handle).attr.protocol;
             rc = CANERR_NOERROR;
         }
         break;
@@ -1238,13 +2551,13 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case CANPROP_GET_OP_MODE:           // active operation mode of the CAN controller (uint8_t)
         if (nbyte >= sizeof(uint8_t)) {
-            *(uint8_t*)value = (uint8_t)can[handle].mode.byte;
+            *(uint8_t*)value = (uint8_t)CHANNEL(handle).mode.byte;
             rc = CANERR_NOERROR;
         }
         break;
     case CANPROP_GET_BITRATE:           // active bit-rate of the CAN controller (can_bitrate_t)
         if (nbyte >= sizeof(can_bitrate_t)) {
-            if (((rc = can_bitrate(handle, &bitrate, NULL)) == CANERR_NOERROR) || (rc == CANERR_OFFLINE)) {
+            if (((rc = bitrate_channel(handle, &bitrate, NULL)) == CANERR_NOERROR) || (rc == CANERR_OFFLINE)) {
                 memcpy(value, &bitrate, sizeof(can_bitrate_t));
                 rc = CANERR_NOERROR;
             }
@@ -1252,7 +2565,7 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case CANPROP_GET_SPEED:             // active bus speed of the CAN controller (can_speed_t)
         if (nbyte >= sizeof(can_speed_t)) {
-            if (((rc = can_bitrate(handle, NULL, &speed)) == CANERR_NOERROR) || (rc == CANERR_OFFLINE)) {
+            if (((rc = bitrate_channel(handle, NULL, &speed)) == CANERR_NOERROR) || (rc == CANERR_OFFLINE)) {
                 memcpy(value, &speed, sizeof(can_speed_t));
                 rc = CANERR_NOERROR;
             }
@@ -1260,7 +2573,7 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case CANPROP_GET_STATUS:            // current status register of the CAN controller (uint8_t)
         if (nbyte >= sizeof(uint8_t)) {
-            if ((rc = can_status(handle, &status)) == CANERR_NOERROR) {
+            if ((rc = status_channel(handle, &status)) == CANERR_NOERROR) {
                 *(uint8_t*)value = (uint8_t)status;
                 rc = CANERR_NOERROR;
             }
@@ -1268,12 +2581,15 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case CANPROP_GET_BUSLOAD:           // current bus load of the CAN controller (uint16_t)
         if (nbyte >= sizeof(uint8_t)) {
-            if (((rc = can_busload(handle, &load, NULL)) == CANERR_NOERROR) || (rc == CANERR_OFFLINE)) {
+            if (!IS_STOPPED(handle))
+                rc = get_busload(handle, &load);
+            else
+                rc = CANERR_NOERROR;    // note: bus load is 0% when stopped
+            if (rc == CANERR_NOERROR) {
                 if (nbyte > sizeof(uint8_t))
-                    *(uint16_t*)value = (uint16_t)load * 100u;  // 0..10000 ==> 0.00%..100.00%
+                    *(uint16_t*)value = (uint16_t)load;                 // 0..10000 ==> 0.00%..100.00%
                 else
-                    *(uint8_t*)value = (uint8_t)load;           // 0..100% (note: legacy resolution)
-                rc = CANERR_NOERROR;
+                    *(uint8_t*)value = (uint8_t)((load + 50u) / 100u);  // 0..100% (note: legacy resolution)
             }
         }
         break;
@@ -1297,39 +2613,53 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case CANPROP_GET_TX_COUNTER:        // total number of sent messages (uint64_t)
         if (nbyte >= sizeof(uint64_t)) {
-            *(uint64_t*)value = (uint64_t)can[handle].counters.tx;
+            *(uint64_t*)value = ATOMIC_GET64(&CHANNEL(handle).counters.tx);
             rc = CANERR_NOERROR;
         }
         break;
     case CANPROP_GET_RX_COUNTER:        // total number of reveiced messages (uint64_t)
         if (nbyte >= sizeof(uint64_t)) {
-            *(uint64_t*)value = (uint64_t)can[handle].counters.rx;
+            // note: messages suppressed by the data reduction are counted too
+            (void)slcan_reduced(CHANNEL(handle).port, &suppressed);
+            *(uint64_t*)value = ATOMIC_GET64(&CHANNEL(handle).counters.rx) + suppressed;
             rc = CANERR_NOERROR;
         }
         break;
     case CANPROP_GET_ERR_COUNTER:       // total number of reveiced error frames (uint64_t)
         if (nbyte >= sizeof(uint64_t)) {
-            *(uint64_t*)value = (uint64_t)can[handle].counters.err;
+            *(uint64_t*)value = ATOMIC_GET64(&CHANNEL(handle).counters.err);
             rc = CANERR_NOERROR;
         }
         break;
     case CANPROP_GET_RCV_QUEUE_SIZE:    // maximum number of message the receive queue can hold (uint32_t)
-    case CANPROP_GET_RCV_QUEUE_HIGH:    // maximum number of message the receive queue has hold (uint32_t)
-    case CANPROP_GET_RCV_QUEUE_OVFL:    // overflow counter of the receive queue (uint64_t)
-        // note: cannot be determined
-        rc = CANERR_NOTSUPP;
-        break;
-    case CANPROP_GET_FILTER_11BIT:      // acceptance filter code and mask for 11-bit identifier (uint64_t)
-        if (nbyte >= sizeof(uint64_t)) {
-            *(uint64_t*)value = ((uint64_t)can[handle].filter.std.code << 32)
-                              | ((uint64_t)can[handle].filter.std.mask);
-            rc = CANERR_NOERROR;
+        if (nbyte >= sizeof(uint32_t)) {
+            if ((rc = slcan_queue_status(CHANNEL(handle).port, (uint32_t*)value, NULL, NULL)) < 0)
+                rc = slcan_error(rc);
+        }
+        break;
+    case CANPROP_GET_RCV_QUEUE_HIGH:    // maximum number of message the receive queue has hold (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if ((rc = slcan_queue_status(CHANNEL(handle).port, NULL, (uint32_t*)value, NULL)) < 0)
+                rc = slcan_error(rc);
+        }
+        break;
+    case CANPROP_GET_RCV_QUEUE_OVFL:    // overflow counter of the receive queue (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            if ((rc = slcan_queue_status(CHANNEL(handle).port, NULL, NULL, (uint64_t*)value)) < 0)
+                rc = slcan_error(rc);
+        }
+        break;
+    case CANPROP_GET_FILTER_11BIT:      // acceptance filter code and mask for 11-bit identifier (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            *(uint64_t*)value = ((uint64_t)CHANNEL(handle).filter.std.code << 32)
+                              | ((uint64_t)CHANNEL(handle).filter.std.mask);
+            rc = CANERR_NOERROR;
         }
         break;
     case CANPROP_GET_FILTER_29BIT:      // acceptance filter code and mask for 29-bit identifier (uint64_t)
         if (nbyte >= sizeof(uint64_t)) {
-            *(uint64_t*)value = ((uint64_t)can[handle].filter.xtd.code << 32)
-                              | ((uint64_t)can[handle].filter.xtd.mask);
+            *(uint64_t*)value = ((uint64_t)CHANNEL(handle).filter.xtd.code << 32)
+                              | ((uint64_t)CHANNEL(handle).filter.xtd.mask);
             rc = CANERR_NOERROR;
         }
         break;
@@ -1337,7 +2667,7 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         if (nbyte >= sizeof(uint64_t)) {
             if (!(*(uint64_t*)value & ~FILTER_STD_VALID_MASK)) {
                 // note: code and mask must not exceed 11-bit identifier
-                if (can[handle].status.can_stopped) {
+                if (IS_STOPPED(handle)) {
                     // note: set filter only if the CAN controller is in INIT mode
                     rc= set_filter(handle, *(uint64_t*)value, false);
                 }
@@ -1350,10 +2680,10 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case CANPROP_SET_FILTER_29BIT:      // set value for acceptance filter code and mask for 29-bit identifier (uint64_t)
         if (nbyte >= sizeof(uint64_t)) {
-            if (!(*(uint64_t*)value & ~FILTER_XTD_VALID_MASK) && !can[handle].mode.nxtd) {
+            if (!(*(uint64_t*)value & ~FILTER_XTD_VALID_MASK) && !CHANNEL(handle).mode.nxtd) {
                 // note: code and mask must not exceed 29-bit identifier and
                 //       extended frame format mode must not be suppressed
-                if (can[handle].status.can_stopped) {
+                if (IS_STOPPED(handle)) {
                     // note: set filter only if the CAN controller is in INIT mode
                     rc = set_filter(handle, *(uint64_t*)value, true);
                 }
@@ -1365,21 +2695,122 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         }
         break;
     case CANPROP_SET_FILTER_RESET:      // reset acceptance filter code and mask to default values (NULL)
-        if (can[handle].status.can_stopped) {
+        if (IS_STOPPED(handle)) {
             // note: reset filter only if the CAN controller is in INIT mode
             rc = reset_filter(handle);
         }
         else
             rc = CANERR_ONLINE;
         break;
+    case CANPROP_GET_TRACE_ACTIVE:      // trace file activation state: STOPPED/RUNNING (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            *(uint8_t*)value = CHANNEL(handle).trace.tracer ? CANPARA_TRACE_ON : CANPARA_TRACE_OFF;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_GET_TRACE_FOLDER:      // trace file folder location (char[])
+        if (nbyte >= 1u) {
+            strncpy((char*)value, CHANNEL(handle).trace.folder, nbyte);
+            ((char*)value)[(nbyte - 1)] = '\0';
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_GET_TRACE_TYPE:        // trace file type (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            *(uint8_t*)value = CHANNEL(handle).trace.type;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_GET_TRACE_MODE:        // trace file mode (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            *(uint16_t*)value = CHANNEL(handle).trace.mode;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_GET_TRACE_SIZE:        // trace file segment size in [10KB] (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            *(uint16_t*)value = CHANNEL(handle).trace.size;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_GET_TRACE_FILE:        // trace file name: directory + basename + extension (char[])
+        if (nbyte >= 1u) {
+            // note: the name of the current trace file, or of the last one
+            if (CHANNEL(handle).trace.tracer)
+                (void)tracer_filename(CHANNEL(handle).trace.tracer, (char*)value, nbyte);
+            else
+                strncpy((char*)value, CHANNEL(handle).trace.file, nbyte);
+            ((char*)value)[(nbyte - 1)] = '\0';
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_SET_TRACE_ACTIVE:      // start/stop trace file recording (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            if (*(uint8_t*)value == CANPARA_TRACE_ON)
+                rc = start_trace(handle);
+            else if (*(uint8_t*)value == CANPARA_TRACE_OFF)
+                rc = stop_trace(handle);
+            else
+                rc = CANERR_ILLPARA;
+        }
+        break;
+    case CANPROP_SET_TRACE_FOLDER:      // set trace file folder location (char[])
+        if (nbyte >= 1u) {
+            // note: the trace settings take effect with the next recording
+            if ((length = strnlen((char*)value, nbyte)) < CANPROP_MAX_BUFFER_SIZE) {
+                memcpy(CHANNEL(handle).trace.folder, value, length);
+                CHANNEL(handle).trace.folder[length] = '\0';
+                rc = CANERR_NOERROR;
+            }
+        }
+        break;
+    case CANPROP_SET_TRACE_TYPE:        // set trace file type (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            if ((*(uint8_t*)value == CANPARA_TRACE_TYPE_BINARY) ||
+                (*(uint8_t*)value == CANPARA_TRACE_TYPE_LOGGER) ||
+                (*(uint8_t*)value == CANPARA_TRACE_TYPE_VENDOR) ||
+                (*(uint8_t*)value == CANSIO_TRACE_TYPE_CANDUMP) ||
+                (*(uint8_t*)value == CANSIO_TRACE_TYPE_ASC)) {
+                CHANNEL(handle).trace.type = *(uint8_t*)value;
+                rc = CANERR_NOERROR;
+            }
+        }
+        break;
+    case CANPROP_SET_TRACE_MODE:        // set trace file mode (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            if (*(uint16_t*)value & CANPARA_TRACE_MODE_COMPRESSED)
+                rc = CANERR_NOTSUPP;
+            else if (!(*(uint16_t*)value & ~TRACE_MODE_SUPPORTED)) {
+                CHANNEL(handle).trace.mode = *(uint16_t*)value;
+                rc = CANERR_NOERROR;
+            }
+        }
+        break;
+    case CANPROP_SET_TRACE_SIZE:        // set trace file segment size in [10KB] (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            if (*(uint16_t*)value <= CANPARA_TRACE_SIZE_LIMIT) {
+                CHANNEL(handle).trace.size = *(uint16_t*)value;
+                rc = CANERR_NOERROR;
+            }
+        }
+        break;
     /* vendor-specific properties */
     case (CANPROP_GET_VENDOR_PROP + SLCAN_SERIAL_NUMBER):       // serial no (uint32_t)
         if (nbyte >= sizeof(uint32_t)) {
-            if ((rc = slcan_serial_number(can[handle].port, &serial_no)) == 0) {
+            // note: the device identity is cached by can_init (see SLCAN_DEVICE_REFRESH)
+            if (CHANNEL(handle).identified) {
+                if (CHANNEL(handle).identity.has_serial) {
+                    *(uint32_t*)value = CHANNEL(handle).identity.serial;
+                    rc = CANERR_NOERROR;
+                }
+                else
+                    rc = CANERR_NOTSUPP;
+            }
+            else if ((rc = slcan_serial_number(CHANNEL(handle).port, &serial_no)) == 0) {
                 *(uint32_t*)value = (uint32_t)serial_no;
                 rc = CANERR_NOERROR;
             }
-            else if (can[handle].attr.protocol == CANSIO_CANABLE) {
+            else if (CHANNEL(handle).attr.protocol == CANSIO_CANABLE) {
                 *(uint32_t*)value = (uint32_t)0x99999999;
                 rc = CANERR_NOERROR;
             }
@@ -1390,7 +2821,13 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case (CANPROP_GET_VENDOR_PROP + SLCAN_HARDWARE_VERSION):    // hardware version (uint16_t)
         if (nbyte >= sizeof(uint16_t)) {
-            if ((rc = slcan_version_number(can[handle].port, &version_no, NULL)) == 0) {
+            if (CHANNEL(handle).identified) {
+                version_no = CHANNEL(handle).identity.hardware;
+                rc = 0;
+            }
+            else
+                rc = slcan_version_number(CHANNEL(handle).port, &version_no, NULL);
+            if (rc == 0) {
                 *(uint16_t*)value = ((uint16_t)(version_no & 0xF0U) << 4)
                                   | ((uint16_t)version_no & 0xFU);
                 rc = CANERR_NOERROR;
@@ -1402,7 +2839,13 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case (CANPROP_GET_VENDOR_PROP + SLCAN_FIRMWARE_VERSION):    // firmware version (uint16_t)
         if (nbyte >= sizeof(uint16_t)) {
-            if ((rc = slcan_version_number(can[handle].port, NULL, &version_no)) == 0) {
+            if (CHANNEL(handle).identified) {
+                version_no = CHANNEL(handle).identity.software;
+                rc = 0;
+            }
+            else
+                rc = slcan_version_number(CHANNEL(handle).port, NULL, &version_no);
+            if (rc == 0) {
                 *(uint16_t*)value = ((uint16_t)(version_no & 0xF0U) << 4)
                                   | ((uint16_t)version_no & 0xFU);
                 rc = CANERR_NOERROR;
@@ -1412,6 +2855,396 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
             }
         }
         break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_DEVICE_REFRESH):     // re-read the device identity (NULL)
+        rc = refresh_identity(handle);
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE):     // receive queue size (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if ((rc = slcan_queue_status(CHANNEL(handle).port, (uint32_t*)value, NULL, NULL)) < 0)
+                rc = slcan_error(rc);
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE):     // set receive queue size (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if ((*(uint32_t*)value < 1U) || (*(uint32_t*)value > SLCAN_QUEUE_LIMIT))
+                rc = CANERR_ILLPARA;
+            else if (IS_STOPPED(handle)) {
+                // note: the queue can only be resized if the CAN controller is in INIT mode
+                if ((rc = slcan_queue_resize(CHANNEL(handle).port, *(uint32_t*)value)) < 0)
+                    rc = slcan_error(rc);
+            }
+            else
+                rc = CANERR_ONLINE;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_POLICY):   // receive queue overflow policy (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            *(uint8_t*)value = (uint8_t)CHANNEL(handle).queue.policy;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_POLICY):   // set receive queue overflow policy (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            rc = set_policy(handle, *(uint8_t*)value, CHANNEL(handle).queue.timeout);
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_TIMEOUT):  // max. blocking time in [ms] (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            *(uint16_t*)value = (uint16_t)CHANNEL(handle).queue.timeout;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_TIMEOUT):  // set max. blocking time in [ms] (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            if ((*(uint16_t*)value < 1U) || (*(uint16_t*)value >= 65535U))
+                rc = CANERR_ILLPARA;
+            else
+                rc = set_policy(handle, CHANNEL(handle).queue.policy, *(uint16_t*)value);
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_DROPPED_NEWEST): // number of received messages dropped (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            if ((rc = slcan_queue_drops(CHANNEL(handle).port, (uint64_t*)value, NULL, NULL)) < 0)
+                rc = slcan_error(rc);
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_DROPPED_OLDEST): // number of oldest messages dropped (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            if ((rc = slcan_queue_drops(CHANNEL(handle).port, NULL, (uint64_t*)value, NULL)) < 0)
+                rc = slcan_error(rc);
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_DROPPED_EXPIRED): // number of received messages dropped after blocking (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            if ((rc = slcan_queue_drops(CHANNEL(handle).port, NULL, NULL, (uint64_t*)value)) < 0)
+                rc = slcan_error(rc);
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_SPILL_FOLDER):   // folder for the spill file (char[])
+        if (nbyte >= 1u) {
+            strncpy((char*)value, CHANNEL(handle).queue.folder, nbyte);
+            ((char*)value)[(nbyte - 1)] = '\0';
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_SPILL_FOLDER):   // set folder for the spill file (char[])
+        if (nbyte >= 1u) {
+            if ((length = strnlen((char*)value, nbyte)) >= CANPROP_MAX_BUFFER_SIZE)
+                rc = CANERR_ILLPARA;
+            else if (IS_STOPPED(handle)) {
+                // note: an existing spill file is re-created in the new folder
+                memcpy(folder, value, length);
+                folder[length] = '\0';
+                rc = set_spill(handle, folder, CHANNEL(handle).queue.spill);
+            }
+            else
+                rc = CANERR_ONLINE;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_SPILL_SIZE):     // spill file size (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            *(uint32_t*)value = (uint32_t)CHANNEL(handle).queue.spill;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_SPILL_THRESHOLD): // spill threshold (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            *(uint32_t*)value = (uint32_t)CHANNEL(handle).queue.threshold;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_SPILL_THRESHOLD): // set spill threshold (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            // note: the threshold can be changed at any time (effective with the next message)
+            if ((rc = slcan_queue_threshold(CHANNEL(handle).port, *(uint32_t*)value)) < 0)
+                rc = slcan_error(rc);
+            else
+                CHANNEL(handle).queue.threshold = *(uint32_t*)value;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_MAILBOX):        // latest-value mailbox (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            *(uint8_t*)value = CHANNEL(handle).queue.mailbox ? 1U : 0U;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_MAILBOX):        // enable/disable latest-value mailbox (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            if (*(uint8_t*)value > 1U)
+                rc = CANERR_ILLPARA;
+            else if (IS_STOPPED(handle)) {
+                // note: the mailbox can only be changed if the CAN controller is in INIT mode
+                if ((rc = slcan_mailbox(CHANNEL(handle).port, *(uint8_t*)value ? true : false)) < 0)
+                    rc = slcan_error(rc);
+                else
+                    CHANNEL(handle).queue.mailbox = *(uint8_t*)value ? true : false;
+            }
+            else
+                rc = CANERR_ONLINE;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_REDUCTION):      // data reduction mode (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            *(uint8_t*)value = (uint8_t)CHANNEL(handle).queue.reduction;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_REDUCTION):      // set data reduction mode (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            if (IS_STOPPED(handle)) {
+                // note: the data reduction can only be changed if the CAN controller is in INIT mode
+                rc = set_reduction(handle, *(uint8_t*)value, CHANNEL(handle).queue.rate);
+            }
+            else
+                rc = CANERR_ONLINE;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_DECIMATION):     // decimation rate in [msg/s] per identifier (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            *(uint16_t*)value = (uint16_t)CHANNEL(handle).queue.rate;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_DECIMATION):     // set decimation rate in [msg/s] per identifier (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            if (*(uint16_t*)value < 1U)
+                rc = CANERR_ILLPARA;
+            else if (IS_STOPPED(handle)) {
+                // note: the data reduction can only be changed if the CAN controller is in INIT mode
+                rc = set_reduction(handle, CHANNEL(handle).queue.reduction, *(uint16_t*)value);
+            }
+            else
+                rc = CANERR_ONLINE;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_SUPPRESSED):     // number of received messages suppressed (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            if ((rc = slcan_reduced(CHANNEL(handle).port, (uint64_t*)value)) < 0)
+                rc = slcan_error(rc);
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_STATUS_POLLING):     // status polling interval in [ms] (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            *(uint16_t*)value = CHANNEL(handle).polling.interval;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_STATUS_POLLING):     // set status polling interval in [ms] (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            if ((*(uint16_t*)value > 0U) && (CHANNEL(handle).attr.protocol == CANSIO_CANABLE))
+                rc = CANERR_NOTSUPP;    // note: CANable devices have no status flags
+            else if (IS_STOPPED(handle)) {
+                // note: the status polling can only be changed if the CAN controller is in INIT mode
+                CHANNEL(handle).polling.interval = *(uint16_t*)value;
+                rc = CANERR_NOERROR;
+            }
+            else
+                rc = CANERR_ONLINE;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_ACTIVE):    // flight recorder: off/on (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            *(uint8_t*)value = CHANNEL(handle).flight.recorder ? 1U : 0U;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_ACTIVE):    // start/stop flight recorder (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            if (*(uint8_t*)value > 1U)
+                rc = CANERR_ILLPARA;
+            else if (IS_STOPPED(handle)) {
+                // note: the flight recorder can only be changed if the CAN controller is in INIT mode
+                rc = *(uint8_t*)value ? start_recorder(handle) : stop_recorder(handle);
+            }
+            else
+                rc = CANERR_ONLINE;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_FRAMES):    // pre-trigger window in [frames] (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            *(uint32_t*)value = CHANNEL(handle).flight.attr.frames;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_FRAMES):    // set pre-trigger window in [frames] (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            // note: the recorder settings take effect with the next activation
+            if ((*(uint32_t*)value > 0U) && (*(uint32_t*)value <= RECORDER_MAX_FRAMES)) {
+                CHANNEL(handle).flight.attr.frames = *(uint32_t*)value;
+                rc = CANERR_NOERROR;
+            }
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_TIME):      // pre-trigger window in [ms] (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            *(uint32_t*)value = CHANNEL(handle).flight.attr.time;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_TIME):      // set pre-trigger window in [ms] (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            CHANNEL(handle).flight.attr.time = *(uint32_t*)value;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_POST_FRAMES):  // post-trigger window in [frames] (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            *(uint32_t*)value = CHANNEL(handle).flight.attr.post_frames;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_POST_FRAMES):  // set post-trigger window in [frames] (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if (*(uint32_t*)value <= RECORDER_MAX_FRAMES) {
+                CHANNEL(handle).flight.attr.post_frames = *(uint32_t*)value;
+                rc = CANERR_NOERROR;
+            }
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_POST_TIME):    // post-trigger window in [ms] (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            *(uint32_t*)value = CHANNEL(handle).flight.attr.post_time;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_POST_TIME):    // set post-trigger window in [ms] (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            CHANNEL(handle).flight.attr.post_time = *(uint32_t*)value;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_EVENTS):    // trigger events (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            *(uint8_t*)value = CHANNEL(handle).flight.attr.events;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_EVENTS):    // set trigger events (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            if (!(*(uint8_t*)value & ~(CANSIO_TRIGGER_PATTERN | CANSIO_TRIGGER_ERROR | CANSIO_TRIGGER_STATUS))) {
+                // note: same bits as RECORDER_ON_PATTERN, RECORDER_ON_ERROR and RECORDER_ON_STATUS
+                CHANNEL(handle).flight.attr.events = *(uint8_t*)value;
+                rc = CANERR_NOERROR;
+            }
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_PATTERN):   // trigger pattern (can_trigger_pattern_t)
+        if (nbyte >= sizeof(can_trigger_pattern_t)) {
+            ((can_trigger_pattern_t*)value)->id = CHANNEL(handle).flight.attr.pattern.can_id;
+            ((can_trigger_pattern_t*)value)->id_mask = CHANNEL(handle).flight.attr.pattern.id_mask;
+            memcpy(((can_trigger_pattern_t*)value)->data, CHANNEL(handle).flight.attr.pattern.data, CAN_LEN_MAX);
+            memcpy(((can_trigger_pattern_t*)value)->data_mask, CHANNEL(handle).flight.attr.pattern.data_mask, CAN_LEN_MAX);
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_PATTERN):   // set trigger pattern (can_trigger_pattern_t)
+        if (nbyte >= sizeof(can_trigger_pattern_t)) {
+            // note: flag CANSIO_XTD_ID is the same as the frame flag of the trace records
+            CHANNEL(handle).flight.attr.pattern.can_id = ((can_trigger_pattern_t*)value)->id;
+            CHANNEL(handle).flight.attr.pattern.id_mask = ((can_trigger_pattern_t*)value)->id_mask;
+            memcpy(CHANNEL(handle).flight.attr.pattern.data, ((can_trigger_pattern_t*)value)->data, CAN_LEN_MAX);
+            memcpy(CHANNEL(handle).flight.attr.pattern.data_mask, ((can_trigger_pattern_t*)value)->data_mask, CAN_LEN_MAX);
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_TRIGGER):   // trigger a dump of the flight recorder (NULL)
+        if (CHANNEL(handle).flight.recorder) {
+            rc = recorder_trigger(CHANNEL(handle).flight.recorder, RECORDER_ON_REQUEST);
+            rc = slcan_error(rc);
+        }
+        else
+            rc = CANERR_NOTINIT;        // note: the flight recorder is off
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_DUMPS):     // number of dumps written (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if (CHANNEL(handle).flight.recorder)
+                (void)recorder_status(CHANNEL(handle).flight.recorder, (uint32_t*)value, NULL);
+            else
+                *(uint32_t*)value = CHANNEL(handle).flight.dumps;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_IGNORED):   // number of triggers ignored (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if (CHANNEL(handle).flight.recorder)
+                (void)recorder_status(CHANNEL(handle).flight.recorder, NULL, (uint32_t*)value);
+            else
+                *(uint32_t*)value = CHANNEL(handle).flight.ignored;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RECORDER_FILE):      // name of the last dump file (char[])
+        if (nbyte >= 1u) {
+            // note: the name of the last dump file of the current recorder, or of the last one
+            if (CHANNEL(handle).flight.recorder)
+                (void)recorder_filename(CHANNEL(handle).flight.recorder, (char*)value, nbyte);
+            else
+                strncpy((char*)value, CHANNEL(handle).flight.file, nbyte);
+            ((char*)value)[(nbyte - 1)] = '\0';
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_CAPTURE_ACTIVE):     // packet capture: off/on (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            *(uint8_t*)value = CHANNEL(handle).capture.capture ? 1U : 0U;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_CAPTURE_ACTIVE):     // start/stop packet capture (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            if (*(uint8_t*)value == 1U)
+                rc = start_capture(handle);
+            else if (*(uint8_t*)value == 0U)
+                rc = stop_capture(handle);
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_CAPTURE_TYPE):       // content of the pcapng file (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            *(uint8_t*)value = CHANNEL(handle).capture.type;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_CAPTURE_TYPE):       // set content of the pcapng file (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            // note: the capture settings take effect with the next capture
+            if ((*(uint8_t*)value == CANSIO_CAPTURE_SERIAL) ||
+                (*(uint8_t*)value == CANSIO_CAPTURE_SOCKETCAN)) {
+                CHANNEL(handle).capture.type = *(uint8_t*)value;
+                rc = CANERR_NOERROR;
+            }
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_CAPTURE_FILE):       // name of the current or last pcapng file (char[])
+        if (nbyte >= 1u) {
+            if (CHANNEL(handle).capture.capture)
+                (void)capture_filename(CHANNEL(handle).capture.capture, (char*)value, nbyte);
+            else
+                strncpy((char*)value, CHANNEL(handle).capture.file, nbyte);
+            ((char*)value)[(nbyte - 1)] = '\0';
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_CAPTURE_DROPPED):    // number of packets dropped (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            if (CHANNEL(handle).capture.capture)
+                (void)capture_status(CHANNEL(handle).capture.capture, NULL, (uint64_t*)value);
+            else
+                *(uint64_t*)value = CHANNEL(handle).capture.dropped;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_SPILL_SIZE):     // set spill file size (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if (*(uint32_t*)value > SLCAN_SPILL_LIMIT)
+                rc = CANERR_ILLPARA;
+            else if (IS_STOPPED(handle)) {
+                // note: the spill file can only be changed if the CAN controller is in INIT mode
+                rc = set_spill(handle, CHANNEL(handle).queue.folder, *(uint32_t*)value);
+            }
+            else
+                rc = CANERR_ONLINE;
+        }
+        break;
     default:
         rc = lib_parameter(param, value, nbyte);   // library properties (see lib_parameter)
         break;
@@ -1419,6 +3252,86 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
     return rc;
 }
 
+static int sub_parameter(int handle, uint16_t param, void *value, size_t nbyte)
+{
+    int rc = CANERR_ILLPARA;            // suppose an invalid parameter
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(IS_SUBSCRIBER(handle));
+
+    if (value == NULL) {                // check for null-pointer
+        if ((param != CANPROP_SET_FILTER_RESET) &&
+            (param != (CANPROP_SET_VENDOR_PROP + SLCAN_DEVICE_REFRESH)) &&
+            (param != (CANPROP_SET_VENDOR_PROP + SLCAN_RECORDER_TRIGGER)))
+            return CANERR_NULLPTR;
+    }
+    // note: a subscriber has its own mode, status, counters, acceptance filter
+    //       and receive queue (i.e. its position in the broadcast ring); all
+    //       other properties are read from the owner of the SLCAN port
+    switch (param) {
+    case CANPROP_GET_OP_MODE:           // active operation mode of the CAN controller (uint8_t)
+    case CANPROP_GET_TX_COUNTER:        // total number of sent messages (uint64_t)
+    case CANPROP_GET_ERR_COUNTER:       // total number of reveiced error frames (uint64_t)
+    case CANPROP_GET_FILTER_11BIT:      // acceptance filter code and mask for 11-bit identifier (uint64_t)
+    case CANPROP_GET_FILTER_29BIT:      // acceptance filter code and mask for 29-bit identifier (uint64_t)
+    case CANPROP_SET_FILTER_11BIT:      // set value for acceptance filter code and mask for 11-bit identifier (uint64_t)
+    case CANPROP_SET_FILTER_29BIT:      // set value for acceptance filter code and mask for 29-bit identifier (uint64_t)
+    case CANPROP_SET_FILTER_RESET:      // reset acceptance filter code and mask to default values (NULL)
+        rc = drv_parameter(handle, param, value, nbyte);
+        break;
+    case CANPROP_GET_STATUS:            // current status register of the CAN controller (uint8_t)
+        if (nbyte >= sizeof(uint8_t))
+            rc = status_channel(handle, (uint8_t*)value);
+        break;
+    case CANPROP_GET_RX_COUNTER:        // total number of reveiced messages (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            *(uint64_t*)value = ATOMIC_GET64(&CHANNEL(handle).counters.rx);
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_GET_RCV_QUEUE_SIZE:    // maximum number of message the receive queue can hold (uint32_t)
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE):
+        if (nbyte >= sizeof(uint32_t)) {
+            if (!IS_STOPPED(handle))
+                rc = slcan_error(slcan_subscriber_status(CHANNEL(handle).port, CHANNEL(handle).reader, (uint32_t*)value, NULL, NULL));
+            else
+                rc = CANERR_OFFLINE;    // note: not subscribed when stopped
+        }
+        break;
+    case CANPROP_GET_RCV_QUEUE_HIGH:    // maximum number of message the receive queue has hold (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if (!IS_STOPPED(handle))
+                rc = slcan_error(slcan_subscriber_status(CHANNEL(handle).port, CHANNEL(handle).reader, NULL, (uint32_t*)value, NULL));
+            else
+                rc = CANERR_OFFLINE;    // note: not subscribed when stopped
+        }
+        break;
+    case CANPROP_GET_RCV_QUEUE_OVFL:    // overflow counter of the receive queue (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            if (!IS_STOPPED(handle))
+                rc = slcan_error(slcan_subscriber_status(CHANNEL(handle).port, CHANNEL(handle).reader, NULL, NULL, (uint64_t*)value));
+            else
+                rc = CANERR_OFFLINE;    // note: not subscribed when stopped
+        }
+        break;
+    case CANPROP_SET_TRACE_ACTIVE:      // start/stop trace file recording (uint8_t)
+    case CANPROP_SET_TRACE_FOLDER:      // set trace file folder location (char[])
+    case CANPROP_SET_TRACE_TYPE:        // set trace file type (uint8_t)
+    case CANPROP_SET_TRACE_MODE:        // set trace file mode (uint16_t)
+    case CANPROP_SET_TRACE_SIZE:        // set trace file segment size in [10KB] (uint16_t)
+        rc = CANERR_NOTSUPP;            // note: the trace is recorded by the owner
+        break;
+    default:
+        if ((param >= CANPROP_SET_VENDOR_PROP) &&
+            (param < (CANPROP_SET_VENDOR_PROP + CANPROP_VENDOR_PROP_RANGE)))
+            rc = CANERR_NOTSUPP;        // settings belong to the owner
+        else
+            rc = drv_parameter(CHANNEL(handle).owner, param, value, nbyte);
+        break;
+    }
+    return rc;
+}
+
 /*  -----------  revision control  ---------------------------------------
  */
 EXPORT
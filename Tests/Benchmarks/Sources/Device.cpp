@@ -0,0 +1,162 @@
+//
+//  Device.cpp
+//  SerialCAN Benchmarks
+//  Bart Simpson didn't do it
+//
+#include "Device.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <poll.h>
+
+CDevice::CDevice() {
+    m_nMaster = -1;
+    m_nSlave = -1;
+    m_szName[0] = '\0';
+    m_bRunning = false;
+    m_u32Delay = 0U;
+    m_u32Latency = 0U;
+    m_u8Flags = 0x00U;
+    m_u64Commands = 0U;
+    (void)pthread_mutex_init(&m_Mutex, NULL);
+}
+
+CDevice::~CDevice() {
+    Close();
+    (void)pthread_mutex_destroy(&m_Mutex);
+}
+
+bool CDevice::Open() {
+    struct termios attr;
+    char *name;
+
+    if (m_nMaster >= 0)
+        return false;
+    // create a pseudo-terminal
+    if ((m_nMaster = posix_openpt(O_RDWR | O_NOCTTY)) < 0)
+        return false;
+    if ((grantpt(m_nMaster) < 0) || (unlockpt(m_nMaster) < 0) ||
+        ((name = ptsname(m_nMaster)) == NULL)) {
+        (void)close(m_nMaster);
+        m_nMaster = -1;
+        return false;
+    }
+    strncpy(m_szName, name, sizeof(m_szName));
+    m_szName[sizeof(m_szName) - 1] = '\0';
+    // note: the slave side is kept open (and raw) by the device, so that
+    //       the host can open and close it without hanging up the master
+    if ((m_nSlave = open(m_szName, O_RDWR | O_NOCTTY)) < 0) {
+        (void)close(m_nMaster);
+        m_nMaster = -1;
+        return false;
+    }
+    if (tcgetattr(m_nSlave, &attr) == 0) {
+        cfmakeraw(&attr);
+        (void)tcsetattr(m_nSlave, TCSANOW, &attr);
+    }
+    // start the reception loop (command interpreter)
+    m_bRunning = true;
+    if (pthread_create(&m_Thread, NULL, ReceptionLoop, (void*)this) != 0) {
+        m_bRunning = false;
+        (void)close(m_nSlave);
+        (void)close(m_nMaster);
+        m_nSlave = m_nMaster = -1;
+        return false;
+    }
+    return true;
+}
+
+void CDevice::Close() {
+    if (m_nMaster < 0)
+        return;
+    m_bRunning = false;
+    (void)pthread_join(m_Thread, NULL);
+    (void)close(m_nSlave);
+    (void)close(m_nMaster);
+    m_nSlave = m_nMaster = -1;
+}
+
+bool CDevice::SendMessage(uint32_t id, bool xtd, uint8_t dlc, const uint8_t *data) {
+    char buffer[32];
+    int n;
+
+    if (dlc > 8U)
+        return false;
+    if (!xtd)
+        n = snprintf(buffer, sizeof(buffer), "t%03X%X", (unsigned)(id & 0x7FFU), (unsigned)dlc);
+    else
+        n = snprintf(buffer, sizeof(buffer), "T%08X%X", (unsigned)(id & 0x1FFFFFFFU), (unsigned)dlc);
+    for (uint8_t i = 0U; i < dlc; i++)
+        n += snprintf(&buffer[n], sizeof(buffer) - (size_t)n, "%02X", data ? (unsigned)data[i] : 0U);
+    buffer[n++] = '\r';
+    return Write(buffer, (size_t)n);
+}
+
+bool CDevice::Write(const char *buffer, size_t nbytes) {
+    ssize_t n = 0;
+    bool ok = true;
+
+    // note: responses and messages must not be interleaved
+    (void)pthread_mutex_lock(&m_Mutex);
+    while (ok && (nbytes > 0U)) {
+        if ((n = write(m_nMaster, buffer, nbytes)) < 0)
+            ok = (errno == EINTR) || (errno == EAGAIN);
+        else {
+            buffer += n;
+            nbytes -= (size_t)n;
+        }
+    }
+    (void)pthread_mutex_unlock(&m_Mutex);
+    return ok;
+}
+
+void CDevice::Respond(const char *request, size_t nbytes) {
+    char flags[8];
+
+    if (m_u32Delay)
+        (void)usleep((useconds_t)m_u32Delay);
+    m_u64Commands = m_u64Commands + 1U;
+    switch ((nbytes > 0U) ? request[0] : '\r') {
+    case 'V': (void)Write("V1010\r", 6); break;
+    case 'N': (void)Write("N4711\r", 6); break;
+    case 'F': (void)snprintf(flags, sizeof(flags), "F%02X\r", m_u8Flags); (void)Write(flags, 4); break;
+    case 't': case 'r': (void)Write("z\r", 2); break;
+    case 'T': case 'R': (void)Write("Z\r", 2); break;
+    default: (void)Write("\r", 1); break;
+    }
+}
+
+void *CDevice::ReceptionLoop(void *arg) {
+    CDevice *device = (CDevice*)arg;
+    struct pollfd fds;
+    char request[64];
+    size_t index = 0U;
+    char buffer[256];
+    ssize_t n;
+
+    fds.fd = device->m_nMaster;
+    fds.events = POLLIN;
+    while (device->m_bRunning) {
+        if (poll(&fds, 1, 10) <= 0)
+            continue;
+        if ((n = read(device->m_nMaster, buffer, sizeof(buffer))) <= 0)
+            continue;
+        // note: the link latency is spent once per transfer (e.g. USB frame),
+        //       the response delay once per command (command processing)
+        if (device->m_u32Latency)
+            (void)usleep((useconds_t)device->m_u32Latency);
+        for (ssize_t i = 0; i < n; i++) {
+            if (buffer[i] == '\r') {
+                device->Respond(request, index);
+                index = 0U;
+            } else if (index < sizeof(request))
+                request[index++] = buffer[i];
+        }
+    }
+    return NULL;
+}
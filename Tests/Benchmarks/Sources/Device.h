@@ -0,0 +1,55 @@
+//
+//  Device.h
+//  SerialCAN Benchmarks
+//  Bart Simpson didn't do it
+//
+#ifndef DEVICE_H_INCLUDED
+#define DEVICE_H_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+// note: an SLCAN device emulated on a pseudo-terminal (POSIX only).
+//       All commands are acknowledged by [CR], requests for the
+//       version number ('V') and the serial number ('N') are answered
+//       with fixed values, the status flags ('F') with the value set by
+//       the test (default 00). Messages written
+//       by the host are confirmed by 'z' or 'Z' respectively.
+//       A response delay can be set per command and a link latency
+//       per transfer (i.e. per chunk of bytes read from the host).
+//
+class CDevice {
+public:
+    CDevice();
+    virtual ~CDevice();
+
+    bool Open();
+    void Close();
+
+    const char *GetName() const { return m_szName; }
+    uint64_t GetCommands() const { return m_u64Commands; }
+
+    void SetResponseDelay(uint32_t usec) { m_u32Delay = usec; }
+    void SetLinkLatency(uint32_t usec) { m_u32Latency = usec; }
+    void SetStatusFlags(uint8_t flags) { m_u8Flags = flags; }
+
+    bool SendMessage(uint32_t id, bool xtd, uint8_t dlc, const uint8_t *data);
+private:
+    int m_nMaster;
+    int m_nSlave;
+    char m_szName[64];
+    pthread_t m_Thread;
+    pthread_mutex_t m_Mutex;
+    volatile bool m_bRunning;
+    volatile uint32_t m_u32Delay;
+    volatile uint32_t m_u32Latency;
+    volatile uint8_t m_u8Flags;
+    volatile uint64_t m_u64Commands;
+
+    bool Write(const char *buffer, size_t nbytes);
+    void Respond(const char *request, size_t nbytes);
+    static void *ReceptionLoop(void *arg);
+};
+
+#endif // DEVICE_H_INCLUDED
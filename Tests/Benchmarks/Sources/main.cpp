@@ -0,0 +1,561 @@
+//
+//  main.cpp
+//  SerialCAN Benchmarks
+//  Bart Simpson didn't do it
+//
+#include "can_api.h"
+#include "SerialCAN_Defines.h"
+#include "can_msg.h"
+#include "logger.h"
+#include "eventlog.h"
+#include "Device.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <inttypes.h>
+
+#define DEFAULT_FRAMES  10000U
+#define DEFAULT_GAP     1000U  // [usec]
+#define DRAIN_TIMEOUT   1000U  // [msec]
+#define DEFAULT_CHANNELS  16U
+#define DEFAULT_LATENCY   1000U  // [usec]
+#define MAX_CHANNELS    256U
+#define DEFAULT_CALLS   200U   // [calls] (at 100Hz)
+#define DEFAULT_POLLING 100U   // [msec]
+#define HEALTH_PERIOD   10000U  // [usec]
+#define DEFAULT_MESSAGES  1000000U
+#define FORMAT_RATE     5000U  // [msg/s]
+#define FORMAT_ROUNDS   5U     // [rounds] (the best one counts)
+#define DEFAULT_EVENTS  100000U
+#define LOGGER_BURST    2000U  // [calls] (less than the event log can take)
+#define LOGGER_PAUSE    20000U // [usec] (the writer thread catches up)
+#define LOGGER_FILE     "slc_bench.log"
+
+#define OPTION_NO   (0)
+#define OPTION_YES  (1)
+
+#define MODE_CALLBACK  (0)
+#define MODE_READ      (1)
+
+static void sigterm(int signo);
+
+static uint64_t get_nsec(void);
+static int latency(int mode, uint32_t frames, uint32_t gap);
+static int startup(bool parallel, uint32_t channels, uint32_t link);
+static void *bring_up(void *arg);
+static int health(uint16_t polling, uint32_t calls, uint32_t link);
+static int formatter(msg_fmt_timestamp_t stamp, msg_fmt_time_t format, bool cached, uint32_t messages);
+static int debugger(bool deferred, uint32_t events);
+static void status_callback(uint8_t status, void *context);
+static void record(const can_message_t *message);
+static void rx_callback(const can_message_t *message, void *context);
+static void *rx_reader(void *arg);
+static void statistics(const char *title, uint64_t *values, uint32_t count, uint32_t expected, const char *unit = "messages");
+
+static volatile int running = 1;
+
+static int handle = -1;
+static uint64_t *sent = NULL;
+static uint64_t *delay = NULL;
+static volatile uint32_t received = 0U;
+static uint32_t numFrames = 0U;
+static volatile uint64_t notified = 0U;
+
+int main(int argc, const char * argv[]) {
+    uint32_t frames = DEFAULT_FRAMES;
+    uint32_t gap = DEFAULT_GAP;
+    uint32_t channels = DEFAULT_CHANNELS;
+    uint32_t link = DEFAULT_LATENCY;
+    uint32_t calls = DEFAULT_CALLS;
+    uint32_t polling = DEFAULT_POLLING;
+    uint32_t messages = DEFAULT_MESSAGES;
+    uint32_t events = DEFAULT_EVENTS;
+    int option_latency = OPTION_NO;
+    int option_startup = OPTION_NO;
+    int option_status = OPTION_NO;
+    int option_format = OPTION_NO;
+    int option_logger = OPTION_NO;
+    int rc = 0;
+
+    for (int i = 1, opt = 0; i < argc; i++) {
+        /* benchmarks */
+        if (!strcmp(argv[i], "LATENCY")) option_latency = OPTION_YES;
+        if (!strcmp(argv[i], "STARTUP")) option_startup = OPTION_YES;
+        if (!strcmp(argv[i], "STATUS")) option_status = OPTION_YES;
+        if (!strcmp(argv[i], "FORMAT")) option_format = OPTION_YES;
+        if (!strcmp(argv[i], "LOGGER")) option_logger = OPTION_YES;
+        /* parameters */
+        if (!strncmp(argv[i], "N:", 2) && sscanf(argv[i], "N:%i", &opt) == 1 && (opt > 0)) frames = (uint32_t)opt;
+        if (!strncmp(argv[i], "GAP:", 4) && sscanf(argv[i], "GAP:%i", &opt) == 1 && (opt >= 0)) gap = (uint32_t)opt;
+        if (!strncmp(argv[i], "CH:", 3) && sscanf(argv[i], "CH:%i", &opt) == 1 && (opt > 0) && (opt <= (int)MAX_CHANNELS)) channels = (uint32_t)opt;
+        if (!strncmp(argv[i], "LINK:", 5) && sscanf(argv[i], "LINK:%i", &opt) == 1 && (opt >= 0)) link = (uint32_t)opt;
+        if (!strncmp(argv[i], "CALLS:", 6) && sscanf(argv[i], "CALLS:%i", &opt) == 1 && (opt > 0)) calls = (uint32_t)opt;
+        if (!strncmp(argv[i], "POLL:", 5) && sscanf(argv[i], "POLL:%i", &opt) == 1 && (opt > 0) && (opt <= 65535)) polling = (uint32_t)opt;
+        if (!strncmp(argv[i], "MSG:", 4) && sscanf(argv[i], "MSG:%i", &opt) == 1 && (opt > 0)) messages = events = (uint32_t)opt;
+    }
+    fprintf(stdout, ">>> %s\n", can_version());
+    if ((signal(SIGINT, sigterm) == SIG_ERR) ||
+        (signal(SIGHUP, sigterm) == SIG_ERR) ||
+        (signal(SIGTERM, sigterm) == SIG_ERR)) {
+        perror("+++ error");
+        return errno;
+    }
+    if (!option_latency && !option_startup && !option_status && !option_format && !option_logger) {
+        fprintf(stdout, "Usage: %s LATENCY [N:<frames>] [GAP:<usec>]\n", argv[0]);
+        fprintf(stdout, "       %s STARTUP [CH:<channels>] [LINK:<usec>]\n", argv[0]);
+        fprintf(stdout, "       %s STATUS [CALLS:<calls>] [POLL:<msec>] [LINK:<usec>]\n", argv[0]);
+        fprintf(stdout, "       %s FORMAT [MSG:<messages>]\n", argv[0]);
+        fprintf(stdout, "       %s LOGGER [MSG:<messages>]\n", argv[0]);
+        return 1;
+    }
+    /* latency: reception thread to application (callback vs. can_read) */
+    if (option_latency && running) {
+        fprintf(stdout, ">>> Latency from reception to application (%" PRIu32 " frames, gap %" PRIu32 "us)\n", frames, gap);
+        if ((rc = latency(MODE_CALLBACK, frames, gap)) == 0)
+            rc = latency(MODE_READ, frames, gap);
+    }
+    /* startup: time until all channels are online (can_init + can_start) */
+    if (option_startup && running && (rc == 0)) {
+        fprintf(stdout, ">>> Startup time of %" PRIu32 " channels (link latency %" PRIu32 "us)\n", channels, link);
+        if ((rc = startup(false, channels, link)) == 0)
+            rc = startup(true, channels, link);
+    }
+    /* status: health loop at 100Hz (can_status with and without polling) */
+    if (option_status && running && (rc == 0)) {
+        fprintf(stdout, ">>> Health loop of %" PRIu32 " calls at 100Hz (link latency %" PRIu32 "us)\n", calls, link);
+        if ((rc = health(0U, calls, link)) == 0)
+            rc = health((uint16_t)polling, calls, link);
+    }
+    /* format: message formatter with the different time-stamp formats (w/o and w/ time cache) */
+    if (option_format && running && (rc == 0)) {
+        fprintf(stdout, ">>> Message formatter (%" PRIu32 " messages at %u msg/s, best of %u rounds)\n", messages, FORMAT_RATE, FORMAT_ROUNDS);
+        static const struct { msg_fmt_timestamp_t stamp; msg_fmt_time_t format; } modes[] = {
+            { MSG_FMT_TIMESTAMP_ZERO, MSG_FMT_TIME_SEC },
+            { MSG_FMT_TIMESTAMP_ABSOLUTE, MSG_FMT_TIME_HHMMSS },
+            { MSG_FMT_TIMESTAMP_RELATIVE, MSG_FMT_TIME_HHMMSS },
+            { MSG_FMT_TIMESTAMP_ZERO, MSG_FMT_TIME_HHMMSS },
+            { MSG_FMT_TIMESTAMP_ABSOLUTE, MSG_FMT_TIME_DJD }
+        };
+        for (size_t i = 0U; (i < (sizeof(modes) / sizeof(modes[0]))) && running && (rc == 0); i++) {
+            if ((rc = formatter(modes[i].stamp, modes[i].format, false, messages)) == 0)
+                rc = formatter(modes[i].stamp, modes[i].format, true, messages);
+        }
+    }
+    /* logger: debug messages into the log file (log_printf vs. evlog_write) */
+    if (option_logger && running && (rc == 0)) {
+        fprintf(stdout, ">>> Debug messages into a log file (%" PRIu32 " messages in bursts of %u)\n", events, LOGGER_BURST);
+        if ((rc = debugger(false, events)) == 0)
+            rc = debugger(true, events);
+    }
+    return rc;
+}
+
+static int latency(int mode, uint32_t frames, uint32_t gap) {
+    CDevice device;
+    can_sio_param_t param;
+    can_bitrate_t bitrate;
+    pthread_t reader;
+    uint8_t data[8] = { 0 };
+    uint64_t start;
+    int rc;
+
+    if (!(sent = (uint64_t*)calloc(frames, sizeof(uint64_t))) ||
+        !(delay = (uint64_t*)calloc(frames, sizeof(uint64_t)))) {
+        fprintf(stderr, "+++ error: out of memory\n");
+        free(sent); sent = NULL;
+        return -1;
+    }
+    numFrames = frames;
+    received = 0U;
+    /* SLCAN device emulated on a pseudo-terminal */
+    if (!device.Open()) {
+        perror("+++ error: pseudo-terminal");
+        free(sent); free(delay);
+        return -1;
+    }
+    param.name = (char*)device.GetName();
+    param.attr.baudrate = CANSIO_BD57600;
+    param.attr.bytesize = CANSIO_8DATABITS;
+    param.attr.parity = CANSIO_NOPARITY;
+    param.attr.stopbits = CANSIO_1STOPBIT;
+    param.attr.protocol = CANSIO_LAWICEL;
+    if ((handle = can_init(0, CANMODE_DEFAULT, (void*)&param)) < 0) {
+        fprintf(stderr, "+++ error: can_init returned %i\n", handle);
+        device.Close();
+        free(sent); free(delay);
+        return handle;
+    }
+    if (mode == MODE_CALLBACK) {
+        if ((rc = can_callback(handle, rx_callback, NULL)) != CANERR_NOERROR) {
+            fprintf(stderr, "+++ error: can_callback returned %i\n", rc);
+            goto end;
+        }
+    }
+    bitrate.index = CANBTR_INDEX_250K;
+    if ((rc = can_start(handle, &bitrate)) != CANERR_NOERROR) {
+        fprintf(stderr, "+++ error: can_start returned %i\n", rc);
+        goto end;
+    }
+    if ((mode == MODE_READ) && (pthread_create(&reader, NULL, rx_reader, NULL) != 0)) {
+        perror("+++ error: reader thread");
+        rc = -1;
+        goto end;
+    }
+    /* inject the messages (with the sequence number in the payload) */
+    for (uint32_t i = 0U; (i < frames) && running; i++) {
+        data[0] = (uint8_t)(i >> 24);
+        data[1] = (uint8_t)(i >> 16);
+        data[2] = (uint8_t)(i >> 8);
+        data[3] = (uint8_t)(i >> 0);
+        sent[i] = get_nsec();
+        (void)device.SendMessage(0x100U, false, 8U, data);
+        if (gap)
+            (void)usleep((useconds_t)gap);
+    }
+    /* wait until all messages have been received (or drain timeout) */
+    start = get_nsec();
+    while ((received < frames) && running && ((get_nsec() - start) < (DRAIN_TIMEOUT * 1000000ULL)))
+        (void)usleep(1000U);
+    if (mode == MODE_READ) {
+        running = running ? 2 : 0;
+        (void)pthread_join(reader, NULL);
+        running = running ? 1 : 0;
+    }
+    statistics((mode == MODE_CALLBACK) ? "callback (can_callback)" : "wakeup   (can_read)", delay, received, frames);
+end:
+    (void)can_reset(handle);
+    (void)can_exit(handle);
+    device.Close();
+    free(sent); sent = NULL;
+    free(delay); delay = NULL;
+    return rc;
+}
+
+typedef struct {                        // channel to bring up:
+    CDevice *device;                    //   emulated SLCAN device
+    int handle;                         //   CAN API handle (or error)
+    int rc;                             //   result of can_start
+    bool thread;                        //   started in its own thread
+} channel_t;
+
+static int startup(bool parallel, uint32_t channels, uint32_t link) {
+    CDevice *devices = new CDevice[channels];
+    channel_t *channel = new channel_t[channels];
+    pthread_t *threads = new pthread_t[channels];
+    uint64_t start, stop;
+    uint64_t commands = 0U;
+    uint32_t online = 0U;
+    int rc = 0;
+
+    /* SLCAN devices emulated on pseudo-terminals */
+    for (uint32_t i = 0U; i < channels; i++) {
+        if (!devices[i].Open()) {
+            perror("+++ error: pseudo-terminal");
+            rc = -1;
+            goto end;
+        }
+        devices[i].SetLinkLatency(link);
+        channel[i].device = &devices[i];
+        channel[i].handle = CANERR_FATAL;
+        channel[i].rc = CANERR_FATAL;
+        channel[i].thread = false;
+    }
+    /* bring up all channels (one after the other, or all at once) */
+    start = get_nsec();
+    if (parallel) {
+        for (uint32_t i = 0U; i < channels; i++)
+            channel[i].thread = (pthread_create(&threads[i], NULL, bring_up, (void*)&channel[i]) == 0);
+        for (uint32_t i = 0U; i < channels; i++)
+            if (channel[i].thread)
+                (void)pthread_join(threads[i], NULL);
+            else
+                (void)bring_up((void*)&channel[i]);
+    } else {
+        for (uint32_t i = 0U; i < channels; i++)
+            (void)bring_up((void*)&channel[i]);
+    }
+    stop = get_nsec();
+    for (uint32_t i = 0U; i < channels; i++) {
+        if ((channel[i].handle >= 0) && (channel[i].rc == CANERR_NOERROR))
+            online++;
+        commands += devices[i].GetCommands();
+    }
+    fprintf(stdout, "    %s: %.1f [ms] until all channels online (%" PRIu32 " of %" PRIu32 " channels, %.1f commands per channel)\n",
+            parallel ? "parallel  " : "sequential", (double)(stop - start) / 1000000.0, online, channels,
+            (double)commands / (double)channels);
+    if (online != channels)
+        rc = -1;
+end:
+    (void)can_exit(CANEXIT_ALL);
+    for (uint32_t i = 0U; i < channels; i++)
+        devices[i].Close();
+    delete[] threads;
+    delete[] channel;
+    delete[] devices;
+    return rc;
+}
+
+static void *bring_up(void *arg) {
+    channel_t *channel = (channel_t*)arg;
+    can_sio_param_t param;
+    can_bitrate_t bitrate;
+
+    param.name = (char*)channel->device->GetName();
+    param.attr.baudrate = CANSIO_BD57600;
+    param.attr.bytesize = CANSIO_8DATABITS;
+    param.attr.parity = CANSIO_NOPARITY;
+    param.attr.stopbits = CANSIO_1STOPBIT;
+    param.attr.protocol = CANSIO_LAWICEL;
+    if ((channel->handle = can_init(0, CANMODE_DEFAULT, (void*)&param)) >= 0) {
+        bitrate.index = CANBTR_INDEX_250K;
+        channel->rc = can_start(channel->handle, &bitrate);
+    }
+    return NULL;
+}
+
+static int health(uint16_t polling, uint32_t calls, uint32_t link) {
+    CDevice device;
+    can_sio_param_t param;
+    can_bitrate_t bitrate;
+    uint64_t *duration = NULL;
+    uint64_t changed = 0U, detected = 0U;
+    uint64_t commands;
+    uint8_t status;
+    char title[64];
+    int rc;
+
+    if (!(duration = (uint64_t*)calloc(calls, sizeof(uint64_t)))) {
+        fprintf(stderr, "+++ error: out of memory\n");
+        return -1;
+    }
+    notified = 0U;
+    /* SLCAN device emulated on a pseudo-terminal */
+    if (!device.Open()) {
+        perror("+++ error: pseudo-terminal");
+        free(duration);
+        return -1;
+    }
+    device.SetLinkLatency(link);
+    param.name = (char*)device.GetName();
+    param.attr.baudrate = CANSIO_BD57600;
+    param.attr.bytesize = CANSIO_8DATABITS;
+    param.attr.parity = CANSIO_NOPARITY;
+    param.attr.stopbits = CANSIO_1STOPBIT;
+    param.attr.protocol = CANSIO_LAWICEL;
+    if ((handle = can_init(0, CANMODE_DEFAULT, (void*)&param)) < 0) {
+        fprintf(stderr, "+++ error: can_init returned %i\n", handle);
+        device.Close();
+        free(duration);
+        return handle;
+    }
+    if ((rc = can_property(handle, CANPROP_SET_VENDOR_PROP + SLCAN_STATUS_POLLING, (void*)&polling, sizeof(uint16_t))) != CANERR_NOERROR) {
+        fprintf(stderr, "+++ error: can_property returned %i\n", rc);
+        goto end;
+    }
+    if ((rc = can_status_callback(handle, status_callback, NULL)) != CANERR_NOERROR) {
+        fprintf(stderr, "+++ error: can_status_callback returned %i\n", rc);
+        goto end;
+    }
+    bitrate.index = CANBTR_INDEX_250K;
+    if ((rc = can_start(handle, &bitrate)) != CANERR_NOERROR) {
+        fprintf(stderr, "+++ error: can_start returned %i\n", rc);
+        goto end;
+    }
+    /* health loop: the bus status changes to warning level halfway */
+    commands = device.GetCommands();
+    for (uint32_t i = 0U; (i < calls) && running; i++) {
+        if (i == (calls / 2U)) {
+            device.SetStatusFlags(0x20U);  // EI: error warning
+            changed = get_nsec();
+        }
+        uint64_t start = get_nsec();
+        if ((rc = can_status(handle, &status)) != CANERR_NOERROR) {
+            fprintf(stderr, "+++ error: can_status returned %i\n", rc);
+            goto end;
+        }
+        duration[i] = get_nsec() - start;
+        if (changed && !detected && (status & CANSTAT_EWRN))
+            detected = get_nsec();
+        (void)usleep(HEALTH_PERIOD);
+    }
+    commands = device.GetCommands() - commands;
+    (void)snprintf(title, sizeof(title), polling ? "polling %ums" : "no polling", polling);
+    statistics(title, duration, calls, calls, "calls");
+    fprintf(stdout, "      %.1f commands per second, warning level seen by can_status after %.1f [ms]",
+            (double)commands / ((double)calls * (double)HEALTH_PERIOD / 1000000.0),
+            detected ? (double)(detected - changed) / 1000000.0 : -1.0);
+    if (notified)
+        fprintf(stdout, ", notified after %.1f [ms]", (double)(notified - changed) / 1000000.0);
+    fprintf(stdout, "\n");
+end:
+    (void)can_reset(handle);
+    (void)can_exit(handle);
+    device.Close();
+    free(duration);
+    return rc;
+}
+
+static void status_callback(uint8_t status, void *context) {
+    /* note: called by the polling thread */
+    if ((status & CANSTAT_EWRN) && !notified)
+        notified = get_nsec();
+    (void)context;
+}
+
+static void record(const can_message_t *message) {
+    uint64_t now = get_nsec();
+    uint32_t i;
+
+    if (message->dlc < 4U)
+        return;
+    i = ((uint32_t)message->data[0] << 24) | ((uint32_t)message->data[1] << 16)
+      | ((uint32_t)message->data[2] << 8) | ((uint32_t)message->data[3] << 0);
+    if ((i < numFrames) && (received < numFrames))
+        delay[received++] = now - sent[i];
+}
+
+static void rx_callback(const can_message_t *message, void *context) {
+    /* note: called by the reception thread, must not block */
+    record(message);
+    (void)context;
+}
+
+static void *rx_reader(void *arg) {
+    can_message_t message;
+
+    while (running == 1) {
+        if (can_read(handle, &message, 100U) == CANERR_NOERROR)
+            record(&message);
+    }
+    (void)arg;
+    return NULL;
+}
+
+static int formatter(msg_fmt_timestamp_t stamp, msg_fmt_time_t format, bool cached, uint32_t messages) {
+    msg_fmt_options_t options;
+    msg_message_t message;
+    struct timespec now;
+    char line[256];
+    uint64_t start, stop, best = UINT64_MAX;
+    uint64_t length = 0U;
+
+    /* default formatter options with the given time-stamp format */
+    (void)msg_set_fmt_time_stamp(stamp);
+    (void)msg_set_fmt_time_format(format);
+    (void)msg_set_fmt_time_usec(MSG_FMT_OPTION_ON);
+    /* messages with ascending time-stamps (FORMAT_RATE messages per second) */
+    memset(&message, 0, sizeof(msg_message_t));
+    message.id = 0x123U;
+    message.dlc = 8U;
+    for (int i = 0; i < 8; i++)
+        message.data[i] = (uint8_t)(0x11U * (i + 1));
+    (void)clock_gettime(CLOCK_REALTIME, &now);
+    for (uint32_t round = 0U; (round < FORMAT_ROUNDS) && running; round++) {
+        (void)msg_get_fmt_options(&options);
+        message.timestamp.tv_sec = now.tv_sec;
+        message.timestamp.tv_nsec = 0;
+        length = 0U;
+        start = get_nsec();
+        for (uint32_t i = 0U; i < messages; i++) {
+            /* baseline: the time of day is rendered for each message */
+            if (!cached)
+                options.cache.valid = 0;
+            int n = msg_format_message_r(line, sizeof(line), &options, &message, MSG_RX_MESSAGE, (msg_counter_t)i, 0);
+            if (n < 0) {
+                perror("+++ error: formatter");
+                return -1;
+            }
+            length += (uint64_t)n;
+            message.timestamp.tv_nsec += 1000000000L / FORMAT_RATE;
+            if (message.timestamp.tv_nsec >= 1000000000L) {
+                message.timestamp.tv_nsec -= 1000000000L;
+                message.timestamp.tv_sec += 1;
+            }
+        }
+        stop = get_nsec();
+        if ((stop - start) < best)
+            best = stop - start;
+    }
+    fprintf(stdout, "    %-4s %-4s %-8s: %.1f [ns] per message (%.1f characters per message)\n",
+            (stamp == MSG_FMT_TIMESTAMP_ABSOLUTE) ? "ABS" : (stamp == MSG_FMT_TIMESTAMP_RELATIVE) ? "REL" : "ZERO",
+            (format == MSG_FMT_TIME_HHMMSS) ? "TIME" : (format == MSG_FMT_TIME_DJD) ? "DJD" : "SEC",
+            cached ? "cached" : "uncached",
+            (double)best / (double)messages, (double)length / (double)messages);
+    return 0;
+}
+
+static int debugger(bool deferred, uint32_t events) {
+    uint64_t start, elapsed = 0U;
+    uint64_t written = 0U, dropped = 0U;
+    uint32_t i = 0U, n;
+
+    if (log_init(LOGGER_FILE) < 0) {
+        perror("+++ error: logger");
+        return -1;
+    }
+    /* note: the time between the bursts is not counted */
+    while ((i < events) && running) {
+        n = ((events - i) < LOGGER_BURST) ? (events - i) : LOGGER_BURST;
+        start = get_nsec();
+        if (deferred) {
+            for (uint32_t j = 0U; j < n; j++)
+                (void)evlog_write("slcan_read_message (%i)\n", (int)(i + j));
+        } else {
+            for (uint32_t j = 0U; j < n; j++)
+                (void)log_printf("slcan_read_message (%i)\n", (int)(i + j));
+        }
+        elapsed += get_nsec() - start;
+        i += n;
+        (void)usleep(LOGGER_PAUSE);
+    }
+    /* note: the pending debug messages are written when the log file is closed */
+    (void)log_exit();
+    (void)evlog_status(&written, &dropped);
+    (void)remove(LOGGER_FILE);
+    if (deferred)
+        fprintf(stdout, "    evlog_write: %.1f [ns] per call (%" PRIu64 " written, %" PRIu64 " dropped)\n",
+                (double)elapsed / (double)i, written, dropped);
+    else
+        fprintf(stdout, "    log_printf : %.1f [ns] per call\n", (double)elapsed / (double)i);
+    return 0;
+}
+
+static int compare(const void *lhs, const void *rhs) {
+    uint64_t a = *(const uint64_t*)lhs;
+    uint64_t b = *(const uint64_t*)rhs;
+    return (a < b) ? -1 : (a > b) ? 1 : 0;
+}
+
+static void statistics(const char *title, uint64_t *values, uint32_t count, uint32_t expected, const char *unit) {
+    uint64_t sum = 0U;
+
+    if (!count) {
+        fprintf(stdout, "    %s: no %s\n", title, unit);
+        return;
+    }
+    qsort(values, count, sizeof(uint64_t), compare);
+    for (uint32_t i = 0U; i < count; i++)
+        sum += values[i];
+    fprintf(stdout, "    %s: min %.1f, avg %.1f, p50 %.1f, p99 %.1f, max %.1f [us] (%" PRIu32 " of %" PRIu32 " %s)\n",
+            title, (double)values[0] / 1000.0, (double)sum / (double)count / 1000.0,
+            (double)values[count / 2U] / 1000.0, (double)values[((uint64_t)count * 99U) / 100U] / 1000.0,
+            (double)values[count - 1U] / 1000.0, count, expected, unit);
+}
+
+static uint64_t get_nsec(void) {
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+static void sigterm(int signo) {
+    running = 0;
+    (void)signo;
+}
@@ -0,0 +1,358 @@
+//
+//  main.cpp
+//  SerialCAN Trace File Tests
+//  Bart Simpson didn't do it
+//
+#include "tracer.h"
+#include "tracefile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#define TRACE_NAME      "slc_trace"
+#define TRACE_FILE      "slc_trace.bin"
+#define TRUNC_FILE      "slc_trace_cut.bin"
+#define TRACE_RECORDS   20000U  // [records] (several blocks)
+#define TRACE_BATCH     2000U   // [records] (one direction per batch)
+#define TRACE_PAUSE     100000U // [usec] (the writer thread catches up)
+#define TRACE_GAP       5000000000ULL  // [nsec] (delta does not fit into 32 bits)
+#define TRACE_START     1697123456000000000ULL  // [nsec] (since the epoch)
+#define TRACE_IDS       37U     // [identifiers] (standard and extended)
+
+#define CHECK(cond)  do { if (!(cond)) { fprintf(stderr, "+++ failed: %s (line %i)\n", #cond, __LINE__); failed++; } } while (0)
+
+static int failed = 0;
+
+static tracer_record_t *expected = NULL;
+
+static void make_records(uint32_t count);
+static int write_trace(uint32_t count);
+static bool same_record(const tracer_record_t *record, uint32_t index);
+static uint32_t first_at(uint64_t time, uint32_t count);
+static uint32_t next_with(uint32_t can_id, uint32_t from, uint32_t count);
+static void test_read_all(void);
+static void test_seek_time(void);
+static void test_seek_id(void);
+static void test_truncated(void);
+static size_t file_size(const char *filename);
+static int copy_file(const char *source, const char *target, size_t length);
+
+int main(int argc, const char * argv[]) {
+    (void)argc;
+    (void)argv;
+
+    fprintf(stdout, ">>> Trace file round-trip (%u records)\n", TRACE_RECORDS);
+    if ((expected = (tracer_record_t*)calloc(TRACE_RECORDS, sizeof(tracer_record_t))) == NULL) {
+        perror("+++ error");
+        return 1;
+    }
+    make_records(TRACE_RECORDS);
+    if (write_trace(TRACE_RECORDS) < 0) {
+        free(expected);
+        return 1;
+    }
+    test_read_all();
+    test_seek_time();
+    test_seek_id();
+    test_truncated();
+    (void)unlink(TRACE_FILE);
+    (void)unlink(TRUNC_FILE);
+    free(expected);
+    fprintf(stdout, "%s\n", failed ? "+++ FAILED" : ">>> PASSED");
+    return failed ? 1 : 0;
+}
+
+static void make_records(uint32_t count) {
+    uint64_t time = TRACE_START;
+    uint32_t seed = 4711U;
+
+    // records with ascending time-stamps (pseudo-random deltas), identifiers and payload
+    for (uint32_t i = 0U; i < count; i++) {
+        seed = seed * 1103515245U + 12345U;
+        time += (uint64_t)((seed >> 8) % 2000000U) + 1U;
+        if (i == (count / 2U))
+            time += TRACE_GAP;
+        expected[i].time = time;
+        expected[i].can_id = (seed >> 4) % TRACE_IDS;
+        if (expected[i].can_id % 3U)
+            expected[i].can_id |= TRACER_XTD_FRAME;
+        if ((seed % 11U) == 0U)
+            expected[i].can_id |= TRACER_RTR_FRAME;
+        expected[i].can_dlc = (uint8_t)(seed % 9U);
+        expected[i].dir = ((i / TRACE_BATCH) % 2U) ? TRACER_TX : TRACER_RX;
+        for (int j = 0; j < 8; j++)
+            expected[i].data[j] = (j < expected[i].can_dlc) ? (uint8_t)(seed >> (j * 3)) : 0U;
+    }
+}
+
+static int write_trace(uint32_t count) {
+    tracer_t tracer;
+    uint64_t written = 0U, dropped = 0U;
+
+    (void)unlink(TRACE_FILE);
+    if ((tracer = tracer_create(TRACE_NAME, TRACER_BINARY, TRACER_OVERWRITE, 0U)) == NULL) {
+        perror("+++ error: tracer_create");
+        return -1;
+    }
+    // note: the rings of both directions are merged by the writer thread,
+    //       so each batch is in one direction and is written before the next
+    for (uint32_t i = 0U; i < count; i++) {
+        if (tracer_put(tracer, &expected[i]) < 0) {
+            perror("+++ error: tracer_put");
+            (void)tracer_destroy(tracer);
+            return -1;
+        }
+        if ((i % TRACE_BATCH) == (TRACE_BATCH - 1U))
+            usleep(TRACE_PAUSE);
+    }
+    (void)tracer_status(tracer, &written, &dropped);
+    if (tracer_destroy(tracer) < 0) {
+        perror("+++ error: tracer_destroy");
+        return -1;
+    }
+    if (dropped) {
+        fprintf(stderr, "+++ error: %" PRIu64 " records dropped\n", dropped);
+        return -1;
+    }
+    return 0;
+}
+
+static bool same_record(const tracer_record_t *record, uint32_t index) {
+    const tracer_record_t *expect = &expected[index];
+
+    return (record->time == expect->time) && (record->can_id == expect->can_id) &&
+           (record->can_dlc == expect->can_dlc) && (record->dir == expect->dir) &&
+           (memcmp(record->data, expect->data, 8U) == 0);
+}
+
+static uint32_t first_at(uint64_t time, uint32_t count) {
+    uint32_t i;
+
+    for (i = 0U; (i < count) && (expected[i].time < time); i++)
+        ;
+    return i;
+}
+
+static uint32_t next_with(uint32_t can_id, uint32_t from, uint32_t count) {
+    uint32_t i;
+
+    for (i = from; (i < count) && ((expected[i].can_id & TRACEFILE_ID_MASK) != (can_id & TRACEFILE_ID_MASK)); i++)
+        ;
+    return i;
+}
+
+static void test_read_all(void) {
+    tracefile_t reader;
+    tracer_record_t record;
+    uint64_t records = 0U, first = 0U, last = 0U;
+    uint32_t i, errors = 0U;
+
+    // block scanner and delta decoding: all records in their order
+    fprintf(stdout, "    read all records\n");
+    reader = tracefile_open(TRACE_FILE);
+    CHECK(reader != NULL);
+    if (!reader)
+        return;
+    CHECK(tracefile_info(reader, &records, &first, &last) == 0);
+    CHECK(records == TRACE_RECORDS);
+    CHECK(first == expected[0].time);
+    CHECK(last == expected[TRACE_RECORDS - 1U].time);
+    for (i = 0U; tracefile_read(reader, &record) == 0; i++) {
+        if ((i >= TRACE_RECORDS) || !same_record(&record, i))
+            errors++;
+    }
+    CHECK(errno == ENOMSG);
+    CHECK(i == TRACE_RECORDS);
+    CHECK(errors == 0U);
+    CHECK(tracefile_close(reader) == 0);
+}
+
+static void test_seek_time(void) {
+    tracefile_t reader;
+    tracer_record_t record;
+    uint32_t i, index, errors = 0U;
+    uint64_t time;
+
+    // binary search in the block directory and the time index,
+    // then the time-stamp of the record from the deltas
+    fprintf(stdout, "    seek by time\n");
+    reader = tracefile_open(TRACE_FILE);
+    CHECK(reader != NULL);
+    if (!reader)
+        return;
+    for (i = 0U; i < TRACE_RECORDS; i += 97U) {
+        // exactly the time of a record, and just after the previous one
+        for (int k = 0; k < 2; k++) {
+            time = k ? (expected[i].time - 1U) : expected[i].time;
+            index = first_at(time, TRACE_RECORDS);
+            if ((tracefile_seek_time(reader, time) < 0) ||
+                (tracefile_read(reader, &record) < 0) || !same_record(&record, index))
+                errors++;
+        }
+    }
+    CHECK(errors == 0U);
+    // the first record in the block after the time gap
+    time = expected[TRACE_RECORDS / 2U].time - (TRACE_GAP / 2U);
+    CHECK(tracefile_seek_time(reader, time) == 0);
+    CHECK((tracefile_read(reader, &record) == 0) && same_record(&record, TRACE_RECORDS / 2U));
+    // before the first and after the last record
+    CHECK(tracefile_seek_time(reader, 0U) == 0);
+    CHECK((tracefile_read(reader, &record) == 0) && same_record(&record, 0U));
+    CHECK(tracefile_seek_time(reader, expected[TRACE_RECORDS - 1U].time + 1U) < 0);
+    CHECK(errno == ENOMSG);
+    CHECK(tracefile_read(reader, &record) < 0);
+    CHECK(tracefile_close(reader) == 0);
+}
+
+static void test_seek_id(void) {
+    tracefile_t reader;
+    tracer_record_t record;
+    uint32_t can_id, index, errors = 0U;
+
+    // identifier directory and position index: all records of each identifier
+    fprintf(stdout, "    seek by identifier\n");
+    reader = tracefile_open(TRACE_FILE);
+    CHECK(reader != NULL);
+    if (!reader)
+        return;
+    for (uint32_t id = 0U; id < TRACE_IDS; id++) {
+        can_id = id | ((id % 3U) ? TRACER_XTD_FRAME : 0U);
+        CHECK(tracefile_seek_time(reader, 0U) == 0);
+        for (index = next_with(can_id, 0U, TRACE_RECORDS); index < TRACE_RECORDS;
+             index = next_with(can_id, index + 1U, TRACE_RECORDS)) {
+            if ((tracefile_seek_id(reader, can_id) < 0) ||
+                (tracefile_read(reader, &record) < 0) || !same_record(&record, index))
+                errors++;
+        }
+        // no more records with this identifier
+        if ((tracefile_seek_id(reader, can_id) == 0) || (errno != ENOMSG))
+            errors++;
+    }
+    CHECK(errors == 0U);
+    // from a position in the middle of a block (after a seek by time)
+    CHECK(tracefile_seek_time(reader, expected[12345U].time) == 0);
+    can_id = expected[12345U + 7U].can_id;
+    index = next_with(can_id, 12345U, TRACE_RECORDS);
+    CHECK(tracefile_seek_id(reader, can_id) == 0);
+    CHECK((tracefile_read(reader, &record) == 0) && same_record(&record, index));
+    // the same identifier in the other format is not found
+    CHECK(tracefile_seek_time(reader, 0U) == 0);
+    CHECK(tracefile_seek_id(reader, 3U | TRACER_XTD_FRAME) < 0);
+    CHECK(errno == ENOMSG);
+    CHECK(tracefile_seek_time(reader, 0U) == 0);
+    CHECK(tracefile_seek_id(reader, TRACE_IDS + 1U) < 0);
+    CHECK(errno == ENOMSG);
+    CHECK(tracefile_close(reader) == 0);
+}
+
+static void test_truncated(void) {
+    const tracefile_block_t *header;
+    tracefile_t reader;
+    tracer_record_t record;
+    uint64_t records = 0U, last = 0U;
+    uint32_t i, n, count = 0U, errors = 0U;
+    size_t length, offset, previous = 0U;
+    uint8_t *buffer;
+    FILE *fp;
+
+    // an incomplete block at the end of the file is ignored
+    fprintf(stdout, "    open a truncated file\n");
+    length = file_size(TRACE_FILE);
+    CHECK(length > sizeof(tracefile_header_t));
+    if ((buffer = (uint8_t*)malloc(length)) == NULL)
+        return;
+    if ((fp = fopen(TRACE_FILE, "rb")) != NULL) {
+        CHECK(fread(buffer, 1U, length, fp) == length);
+        (void)fclose(fp);
+    }
+    // the offset of the last block and the number of records before it
+    for (offset = sizeof(tracefile_header_t); offset < length; offset += header->size) {
+        header = (const tracefile_block_t*)&buffer[offset];
+        if (!header->size)
+            break;
+        previous = offset;
+        count += header->records;
+    }
+    header = (const tracefile_block_t*)&buffer[previous];
+    count -= header->records;
+    length = previous + (header->size / 2U);
+    free(buffer);
+    CHECK(copy_file(TRACE_FILE, TRUNC_FILE, length) == 0);
+    reader = tracefile_open(TRUNC_FILE);
+    CHECK(reader != NULL);
+    if (reader) {
+        CHECK(tracefile_info(reader, &records, NULL, &last) == 0);
+        CHECK(records == count);
+        CHECK(last == expected[count - 1U].time);
+        for (i = 0U; tracefile_read(reader, &record) == 0; i++) {
+            if ((i >= count) || !same_record(&record, i))
+                errors++;
+        }
+        CHECK(i == count);
+        CHECK(errors == 0U);
+        // the identifier directory has no entries of the incomplete block
+        CHECK(tracefile_seek_time(reader, 0U) == 0);
+        for (i = 0U; tracefile_seek_id(reader, expected[count].can_id) == 0; i++)
+            CHECK(tracefile_read(reader, &record) == 0);
+        for (n = 0U, offset = next_with(expected[count].can_id, 0U, count); offset < count;
+             n++, offset = next_with(expected[count].can_id, (uint32_t)offset + 1U, count))
+            ;
+        CHECK(i == n);
+        CHECK(tracefile_close(reader) == 0);
+    }
+    // only the file header (no block)
+    CHECK(copy_file(TRACE_FILE, TRUNC_FILE, sizeof(tracefile_header_t) + 8U) == 0);
+    reader = tracefile_open(TRUNC_FILE);
+    CHECK(reader != NULL);
+    if (reader) {
+        CHECK((tracefile_info(reader, &records, NULL, NULL) == 0) && (records == 0U));
+        CHECK(tracefile_read(reader, &record) < 0);
+        CHECK(errno == ENOMSG);
+        CHECK(tracefile_seek_id(reader, expected[0].can_id) < 0);
+        CHECK(tracefile_close(reader) == 0);
+    }
+    // not even the file header
+    CHECK(copy_file(TRACE_FILE, TRUNC_FILE, sizeof(tracefile_header_t) - 1U) == 0);
+    CHECK(tracefile_open(TRUNC_FILE) == NULL);
+    CHECK(errno == EBADMSG);
+}
+
+static size_t file_size(const char *filename) {
+    FILE *fp;
+    long size = 0L;
+
+    if ((fp = fopen(filename, "rb")) != NULL) {
+        if (fseek(fp, 0L, SEEK_END) == 0)
+            size = ftell(fp);
+        (void)fclose(fp);
+    }
+    return (size > 0L) ? (size_t)size : 0U;
+}
+
+static int copy_file(const char *source, const char *target, size_t length) {
+    FILE *in, *out;
+    char buffer[4096];
+    size_t n;
+    int res = 0;
+
+    if ((in = fopen(source, "rb")) == NULL)
+        return -1;
+    if ((out = fopen(target, "wb")) == NULL) {
+        (void)fclose(in);
+        return -1;
+    }
+    while (length && ((n = fread(buffer, 1U, (length < sizeof(buffer)) ? length : sizeof(buffer), in)) > 0U)) {
+        if (fwrite(buffer, 1U, n, out) != n) {
+            res = -1;
+            break;
+        }
+        length -= n;
+    }
+    (void)fclose(in);
+    (void)fclose(out);
+    return res;
+}
@@ -1023,6 +1023,77 @@
 }
 #endif
 
+// @xctest TC04.11: Read a CAN message with a time-out in microseconds (SerialCAN)
+//
+// @expected: CANERR_RX_EMPTY, but not before the time-out has elapsed
+//
+#if (SERIAL_CAN_SUPPORTED != 0)
+- (void)testReadWithTimeoutInMicroseconds {
+    can_bitrate_t bitrate = { TEST_BTRINDEX };
+    can_status_t status = { CANSTAT_RESET };
+    can_message_t message = {};
+    int handle = INVALID_HANDLE;
+    int rc = CANERR_FATAL;
+
+    CTimer lower = CTimer();
+    CTimer upper = CTimer();
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    handle = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle);
+    // @- get status of DUT1 and check to be in INIT state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertTrue(status.can_stopped);
+    // @- start DUT1 with configured bit-rate settings
+    rc = can_start(handle, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- get status of DUT1 and check to be in RUNNING state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertFalse(status.can_stopped);
+    // @test:
+    // @note: the upper bound allows for 5ms scheduling latency.
+    // @- try to read a message from DUT1 with time-out 0 (returns immediately)
+    upper.Restart(5U * CTimer::MSEC);
+    rc = can_read_us(handle, &message, 0U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    XCTAssertFalse(upper.Timeout());
+    // @- try to read a message from DUT1 with time-out 2500us
+    lower.Restart(2500U * CTimer::USEC);
+    upper.Restart((2500U * CTimer::USEC) + (5U * CTimer::MSEC));
+    rc = can_read_us(handle, &message, 2500U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    XCTAssertTrue(lower.Timeout());
+    XCTAssertFalse(upper.Timeout());
+    // @- try to read a message from DUT1 with time-out 500us (less than 1ms)
+    lower.Restart(500U * CTimer::USEC);
+    upper.Restart((500U * CTimer::USEC) + (5U * CTimer::MSEC));
+    rc = can_read_us(handle, &message, 500U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    XCTAssertTrue(lower.Timeout());
+    XCTAssertFalse(upper.Timeout());
+    // @- get status of DUT1 and check to be in RUNNING state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertFalse(status.can_stopped);
+    // @- check if bit CANSTAT_RX_EMPTY is set in status register
+    XCTAssertTrue(status.receiver_empty);
+    // @post:
+    // @- stop/reset DUT1
+    rc = can_reset(handle);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- get status of DUT1 and check to be in INIT state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertTrue(status.can_stopped);
+    // @- tear down DUT1
+    rc = can_exit(handle);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @end.
+}
+#endif
+
 @end
 
 // $Id: test_can_read.mm 1341 2024-06-15 16:43:48Z makemake $  Copyright (c) UV Software, Berlin //
@@ -0,0 +1,186 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You
+//  can choose between one of them if you use CAN API V3 in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  CAN API V3 is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+//
+#import "Settings.h"
+#import "can_api.h"
+#import <XCTest/XCTest.h>
+
+#ifndef CAN_FD_SUPPORTED
+#define CAN_FD_SUPPORTED  FEATURE_SUPPORTED
+#warning CAN_FD_SUPPORTED not set, default=FEATURE_SUPPORTED
+#endif
+
+//  Settings for the trace file replay:
+#define REPLAY_FOLDER  "/tmp"  /// trace file folder
+#define REPLAY_PAUSE   1000U   /// pause between two bursts (in [ms])
+
+@interface test_can_replay : XCTestCase
+
+@end
+
+@implementation test_can_replay
+
+- (void)setUp {
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    (void)can_exit(CANKILL_ALL);
+}
+
+// @xctest TC21.0: Replay a trace file (sunnyday scenario)
+//
+// @expected: CANERR_NOERROR
+//
+// - (void)testSunnydayScenario {
+//     // @test:
+//     // @todo: insert coin here
+//     // @end.
+// }
+
+// @xctest TC21.1: Abort the replay of a trace file by calling can_kill
+//
+// @expected: CANERR_VENDOR (aborted), and not all messages are sent
+//
+- (void)testAbortReplayWithKill {
+    can_bitrate_t bitrate = { TEST_BTRINDEX };
+    can_status_t status = { CANSTAT_RESET };
+    char filename[CANPROP_MAX_BUFFER_SIZE] = "";
+    uint16_t mode = CANPARA_TRACE_MODE_OVERWRITE;
+    uint8_t type = CANPARA_TRACE_TYPE_BINARY;
+    uint8_t active = CANPARA_TRACE_OFF;
+    int handle = INVALID_HANDLE;
+    int handle2 = INVALID_HANDLE;
+    int rc = CANERR_FATAL;
+
+    __block can_replay_stats_t stats = {};
+    __block int replay = CANERR_FATAL;
+    dispatch_group_t group = dispatch_group_create();
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    handle = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle);
+    // @- start DUT1 with configured bit-rate settings
+    rc = can_start(handle, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- get status of DUT1 and check to be in RUNNING state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertFalse(status.can_stopped);
+    // @- start a binary trace file recording on DUT1
+    rc = can_property(handle, CANPROP_SET_TRACE_FOLDER, (void*)REPLAY_FOLDER, sizeof(REPLAY_FOLDER));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_property(handle, CANPROP_SET_TRACE_TYPE, (void*)&type, sizeof(uint8_t));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_property(handle, CANPROP_SET_TRACE_MODE, (void*)&mode, sizeof(uint16_t));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    active = CANPARA_TRACE_ON;
+    rc = can_property(handle, CANPROP_SET_TRACE_ACTIVE, (void*)&active, sizeof(uint8_t));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- receive two bursts of frames from DUT2 with a pause in between
+    CTester tester;
+    XCTAssertEqual(TEST_FRAMES, tester.ReceiveSomeFrames(handle, DUT2, TEST_FRAMES));
+    CTimer::Delay(REPLAY_PAUSE * CTimer::MSEC);
+    XCTAssertEqual(TEST_FRAMES, tester.ReceiveSomeFrames(handle, DUT2, TEST_FRAMES));
+    // @- stop the trace file recording and get the name of the trace file
+    active = CANPARA_TRACE_OFF;
+    rc = can_property(handle, CANPROP_SET_TRACE_ACTIVE, (void*)&active, sizeof(uint8_t));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_property(handle, CANPROP_GET_TRACE_FILE, (void*)filename, CANPROP_MAX_BUFFER_SIZE);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertNotEqual('\0', filename[0]);
+    // @- initialize DUT2 with configured settings (to acknowledge the replay)
+    handle2 = can_init(DUT2, TEST_CANMODE, TEST_PARAM(PAR2));
+    XCTAssertLessThanOrEqual(0, handle2);
+    // @- start DUT2 with configured bit-rate settings
+    rc = can_start(handle2, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @test:
+    // @- replay the trace file with the original timing on DUT1 (in the background)
+    const char *file = filename;
+    dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+        replay = can_replay(handle, file, CANSIO_REPLAY_ORIGINAL, &stats);
+    });
+    // @- abort the replay within the pause between the two bursts
+    CTimer::Delay((REPLAY_PAUSE / 10U) * CTimer::MSEC);
+    rc = can_kill(handle);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- wait for the replay to return
+    // @note: the replay waits in slices, so it returns without waiting for the next message.
+    XCTAssertEqual(0, dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 5LL * NSEC_PER_SEC)));
+    XCTAssertEqual(CANERR_VENDOR, replay);
+    // @- check the replay statistics (only the first burst is sent)
+    XCTAssertLessThanOrEqual((uint64_t)(2 * TEST_FRAMES), stats.records);
+    XCTAssertLessThan(stats.sent, stats.records);
+    XCTAssertLessThan(stats.duration, (uint64_t)(REPLAY_PAUSE / 2U) * 1000U);
+    // @- get status of DUT1 and check to be still in RUNNING state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertFalse(status.can_stopped);
+    // @post:
+    // @- remove the trace file
+    (void)remove(filename);
+    // @- tear down DUT2
+    rc = can_exit(handle2);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- stop/reset DUT1
+    rc = can_reset(handle);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- get status of DUT1 and check to be in INIT state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertTrue(status.can_stopped);
+    // @- tear down DUT1
+    rc = can_exit(handle);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @end.
+}
+
+@end
+
+// $Id: test_can_replay.mm 1341 2024-06-15 16:43:48Z makemake $  Copyright (c) UV Software, Berlin //
@@ -517,6 +517,86 @@
 // @note: already covered by TC04.8 (Read a CAN message from reception queue after overrun)
 //}
 
+// @xctest TC09.15: Install a status handler with status polling (SerialCAN)
+//
+// @expected CANERR_NOERROR when stopped, CANERR_ONLINE when started and CANERR_NOTSUPP for a subscriber
+//
+#if (SERIAL_CAN_SUPPORTED != 0) && (TEST_PROTOCOL1 == 0)
+static void status_handler(uint8_t status, void *context) {
+    (void)status;
+    if (context)
+        (*(int*)context)++;
+}
+
+- (void)testStatusHandlerWithPolling {
+    can_bitrate_t bitrate = { TEST_BTRINDEX };
+    can_status_t status = { CANSTAT_RESET };
+    uint16_t interval = 100U;
+    int handle = INVALID_HANDLE;
+    int subscriber = INVALID_HANDLE;
+    int rc = CANERR_FATAL;
+    int calls = 0;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    handle = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle);
+    // @- get status of DUT1 and check to be in INIT state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertTrue(status.can_stopped);
+    // @test:
+    // @- install a status handler on DUT1 when CAN controller not started
+    rc = can_status_callback(handle, status_handler, (void*)&calls);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- enable the status polling of DUT1 (100ms)
+    rc = can_property(handle, CANPROP_SET_VENDOR_PROP + SLCAN_STATUS_POLLING, (void*)&interval, sizeof(uint16_t));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- start DUT1 with configured bit-rate settings
+    rc = can_start(handle, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- try to change the status handler when CAN controller started
+    rc = can_status_callback(handle, NULL, NULL);
+    XCTAssertEqual(CANERR_ONLINE, rc);
+    // @- get status of DUT1 (from the last poll) and check to be in RUNNING state
+    CTimer::Delay(3U * interval * CTimer::MSEC);
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertFalse(status.can_stopped);
+    // @- try to install a status handler on a subscriber of DUT1
+    subscriber = can_init(DUT1, TEST_CANMODE | CANMODE_SHRD, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, subscriber);
+    rc = can_status_callback(subscriber, status_handler, (void*)&calls);
+    XCTAssertEqual(CANERR_NOTSUPP, rc);
+    rc = can_exit(subscriber);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- send and receive some frames to/from DUT2 (optional)
+#if (SEND_TEST_FRAMES != 0)
+    CTester tester;
+    XCTAssertEqual(TEST_FRAMES, tester.SendSomeFrames(handle, DUT2, TEST_FRAMES));
+    XCTAssertEqual(TEST_FRAMES, tester.ReceiveSomeFrames(handle, DUT2, TEST_FRAMES));
+    // @- get status of DUT1 and check to be in RUNNING state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertFalse(status.can_stopped);
+#endif
+    // @- stop/reset DUT1
+    rc = can_reset(handle);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- remove the status handler when CAN controller stopped
+    rc = can_status_callback(handle, NULL, NULL);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @post:
+    // @- get status of DUT1 and check to be in INIT state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertTrue(status.can_stopped);
+    // @- tear down DUT1
+    rc = can_exit(handle);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @end.
+}
+#endif
+
 @end
 
 // $Id: test_can_status.mm 1341 2024-06-15 16:43:48Z makemake $  Copyright (c) UV Software, Berlin //
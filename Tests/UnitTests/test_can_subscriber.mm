@@ -0,0 +1,243 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You
+//  can choose between one of them if you use CAN API V3 in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  CAN API V3 is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+//
+#import "Settings.h"
+#import "can_api.h"
+#import <XCTest/XCTest.h>
+
+#ifndef CAN_FD_SUPPORTED
+#define CAN_FD_SUPPORTED  FEATURE_SUPPORTED
+#warning CAN_FD_SUPPORTED not set, default=FEATURE_SUPPORTED
+#endif
+
+@interface test_can_subscriber : XCTestCase
+
+@end
+
+@implementation test_can_subscriber
+
+- (void)setUp {
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    (void)can_exit(CANKILL_ALL);
+}
+
+// @xctest TC20.0: Shared access to a CAN channel (sunnyday scenario)
+//
+// @expected: CANERR_NOERROR
+//
+// - (void)testSunnydayScenario {
+//     // @test:
+//     // @todo: insert coin here
+//     // @end.
+// }
+
+// @xctest TC20.1: Open, read and close a subscriber while the owner stays open
+//
+// @expected: CANERR_NOERROR
+//
+- (void)testSubscriberWhileOwnerOpen {
+    can_bitrate_t bitrate = { TEST_BTRINDEX };
+    can_status_t status = { CANSTAT_RESET };
+    can_message_t message = {};
+    int handle = INVALID_HANDLE;
+    int subscriber = INVALID_HANDLE;
+    int rc = CANERR_FATAL;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    handle = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle);
+    // @- get status of DUT1 and check to be in INIT state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertTrue(status.can_stopped);
+    // @- start DUT1 with configured bit-rate settings
+    rc = can_start(handle, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- get status of DUT1 and check to be in RUNNING state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertFalse(status.can_stopped);
+    // @test:
+    // @- open DUT1 a second time with shared access
+    subscriber = can_init(DUT1, TEST_CANMODE | CANMODE_SHRD, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, subscriber);
+    XCTAssertNotEqual(handle, subscriber);
+    // @- get status of the subscriber and check to be in INIT state
+    rc = can_status(subscriber, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertTrue(status.can_stopped);
+    // @- start the subscriber (the bit-rate belongs to the owner)
+    rc = can_start(subscriber, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- get status of the subscriber and check to be in RUNNING state
+    rc = can_status(subscriber, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertFalse(status.can_stopped);
+    // @- try to read a message from the subscriber when there is none
+    rc = can_read(subscriber, &message, 0U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @- try to send a message with the subscriber (read-only)
+    message.id = 0x100U;
+    message.dlc = 0U;
+    rc = can_write(subscriber, &message, 0U);
+    XCTAssertEqual(CANERR_NOTSUPP, rc);
+#if (SEND_TEST_FRAMES != 0)
+    // @- receive some frames from DUT2 with the owner
+    CTester tester;
+    XCTAssertEqual(TEST_FRAMES, tester.ReceiveSomeFrames(handle, DUT2, TEST_FRAMES));
+    // @- read the same frames from the subscriber
+    CTimer timer = CTimer((uint32_t)TEST_FRAMES * 100U * CTimer::MSEC);
+    int n = 0;
+    while ((n < TEST_FRAMES) && !timer.Timeout()) {
+        memset(&message, 0, sizeof(can_message_t));
+        rc = can_read(subscriber, &message, 100U);
+        if ((rc == CANERR_NOERROR) && !message.sts) {
+            XCTAssertEqual(0x200U, message.id);
+            n++;
+        }
+    }
+    XCTAssertEqual(TEST_FRAMES, n);
+    // @- try to read a message from the subscriber when there is none
+    rc = can_read(subscriber, &message, 0U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+#endif
+    // @- tear down the subscriber
+    rc = can_exit(subscriber);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- check the subscriber handle to be closed
+    rc = can_status(subscriber, &status.byte);
+    XCTAssertEqual(CANERR_HANDLE, rc);
+    // @- get status of DUT1 and check to be still in RUNNING state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertFalse(status.can_stopped);
+    // @- send and receive some frames to/from DUT2 (optional)
+#if (SEND_TEST_FRAMES != 0)
+    XCTAssertEqual(TEST_FRAMES, tester.SendSomeFrames(handle, DUT2, TEST_FRAMES));
+    XCTAssertEqual(TEST_FRAMES, tester.ReceiveSomeFrames(handle, DUT2, TEST_FRAMES));
+    // @- get status of DUT1 and check to be in RUNNING state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertFalse(status.can_stopped);
+#endif
+    // @post:
+    // @- stop/reset DUT1
+    rc = can_reset(handle);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- get status of DUT1 and check to be in INIT state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertTrue(status.can_stopped);
+    // @- tear down DUT1
+    rc = can_exit(handle);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @end.
+}
+
+// @xctest TC20.2: Tear down the owner of a CAN channel with an open subscriber
+//
+// @expected: CANERR_NOERROR, and the subscriber is closed
+//
+- (void)testOwnerExitClosesSubscriber {
+    can_bitrate_t bitrate = { TEST_BTRINDEX };
+    can_status_t status = { CANSTAT_RESET };
+    can_message_t message = {};
+    int handle = INVALID_HANDLE;
+    int subscriber = INVALID_HANDLE;
+    int rc = CANERR_FATAL;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    handle = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle);
+    // @- start DUT1 with configured bit-rate settings
+    rc = can_start(handle, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- get status of DUT1 and check to be in RUNNING state
+    rc = can_status(handle, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertFalse(status.can_stopped);
+    // @- open DUT1 a second time with shared access
+    subscriber = can_init(DUT1, TEST_CANMODE | CANMODE_SHRD, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, subscriber);
+    // @- start the subscriber (the bit-rate belongs to the owner)
+    rc = can_start(subscriber, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- get status of the subscriber and check to be in RUNNING state
+    rc = can_status(subscriber, &status.byte);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertFalse(status.can_stopped);
+    // @test:
+    // @- tear down DUT1 (the owner)
+    rc = can_exit(handle);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @note: the library is not initialized anymore when all handles are closed.
+    // @- check the subscriber handle to be closed
+    rc = can_status(subscriber, &status.byte);
+    XCTAssertEqual(CANERR_NOTINIT, rc);
+    // @- try to read a message from the subscriber
+    rc = can_read(subscriber, &message, 0U);
+    XCTAssertEqual(CANERR_NOTINIT, rc);
+    // @- try to tear down the subscriber
+    rc = can_exit(subscriber);
+    XCTAssertEqual(CANERR_NOTINIT, rc);
+    // @post:
+    // @- DUT1 can be opened again (not in use anymore)
+    handle = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle);
+    // @- tear down DUT1
+    rc = can_exit(handle);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @end.
+}
+
+@end
+
+// $Id: test_can_subscriber.mm 1341 2024-06-15 16:43:48Z makemake $  Copyright (c) UV Software, Berlin //
@@ -32,6 +32,7 @@
 #define CAN_FD_SUPPORTED  0  // set to non-zero once CAN FD is supported
 #endif
 #define SERIAL_CAN_SUPPORTED  1  // requires additional parameter (COM port)
+#define CAN_TRACE_SUPPORTED  2  // trace file in binary, CSV or vendor format
 
 #define MONITOR_INTERFACE "CAN-over-Serial-Line Interfaces"
 #define MONITOR_COPYRIGHT "2007,2012-2024 by Uwe Vogt, UV Software, Berlin"
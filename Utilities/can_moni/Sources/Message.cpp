@@ -85,3 +85,7 @@ bool CCanMessage::SetAsciiFormat(EFormatOption option) {
 bool CCanMessage::SetWraparound(EFormatWraparound option) {
     return msg_set_fmt_wraparound((msg_fmt_wraparound_t) option) ? true : false;
 }
+
+bool CCanMessage::SetOutputFormat(EFormatOutput option) {
+    return msg_set_format((msg_format_t) option) ? true : false;
+}
@@ -77,12 +77,19 @@ public:
         OptionWraparound32 = CANPARA_WRAPAROUND_32,
         OptionWraparound64 = CANPARA_WRAPAROUND_64
     };
+    enum EFormatOutput {
+        OptionDefault = CANPARA_FORMAT_DEFAULT,
+        OptionCandump = CANPARA_FORMAT_CANDUMP,
+        OptionAsc = CANPARA_FORMAT_ASC,
+        OptionCsv = CANPARA_FORMAT_CSV
+    };
     typedef can_message_t TCanMessage;
     static bool SetTimestampFormat(EFormatTimestamp option);
     static bool SetIdentifierFormat(EFormatNumber option);
     static bool SetDataFormat(EFormatNumber option);
     static bool SetAsciiFormat(EFormatOption option);
     static bool SetWraparound(EFormatWraparound option);
+    static bool SetOutputFormat(EFormatOutput option);
     static bool Format(TCanMessage message, uint64_t counter, char *string, size_t length);
 };
 /// \}
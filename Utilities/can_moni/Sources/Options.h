@@ -76,6 +76,8 @@ struct SOptions {
         eTraceOff,
         eTraceBinary,
         eTraceLogger,
+        eTraceCandump,
+        eTraceAsc,
         eTraceVendor
     } m_eTraceMode;
 #endif
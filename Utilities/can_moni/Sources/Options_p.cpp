@@ -113,6 +113,7 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
 #if (CAN_FD_SUPPORTED != 0)
     int optFmtWrap = 0;
 #endif
+    int optFmtOutput = 0;
     int optExclude = 0;
 #if (CAN_TRACE_SUPPORTED != 0)
     int optTraceMode = 0;
@@ -134,11 +135,13 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
     CCanMessage::EFormatNumber fmtModeData = CCanMessage::OptionHex;
     CCanMessage::EFormatOption fmtModeAscii = CCanMessage::OptionOn;
     CCanMessage::EFormatWraparound fmtWraparound = CCanMessage::OptionWraparoundNo;
+    CCanMessage::EFormatOutput fmtOutput = CCanMessage::OptionDefault;
     (void)CCanMessage::SetTimestampFormat(fmtModeTime);
     (void)CCanMessage::SetIdentifierFormat(fmtModeId);
     (void)CCanMessage::SetDataFormat(fmtModeData);
     (void)CCanMessage::SetAsciiFormat(fmtModeAscii);
     (void)CCanMessage::SetWraparound(fmtWraparound);
+    (void)CCanMessage::SetOutputFormat(fmtOutput);
 
     // command-line options
     int show_version = 0;
@@ -163,6 +166,7 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
         {"ascii", required_argument, 0, 'a'},
         {"wrap", required_argument, 0, 'w'},
         {"wraparound", required_argument, 0, 'w'},
+        {"format", required_argument, 0, 'f'},
         {"exclude", required_argument, 0, 'x'},
         {"script", required_argument, 0, 's'},
         {"trace", required_argument, 0, 'y'},
@@ -191,9 +195,9 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
 #endif
     // (2) scan command-line for options
 #if (OPTION_CANAPI_LIBRARY != 0)
-    while ((opt = getopt_long(argc, (char * const *)argv, "b:vp:z:m:t:i:d:a:w:x:s:y:lLTh", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, (char * const *)argv, "b:vp:z:m:t:i:d:a:w:f:x:s:y:lLTh", long_options, NULL)) != -1) {
 #else
-    while ((opt = getopt_long(argc, (char * const *)argv, "b:vz:m:t:i:d:a:w:x:s:y:lLTj:h", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, (char * const *)argv, "b:vz:m:t:i:d:a:w:f:x:s:y:lLTj:h", long_options, NULL)) != -1) {
 #endif
         switch (opt) {
         /* option '--baudrate=<baudrate>' (-b) */
@@ -483,6 +487,10 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
                 m_eTraceMode = SOptions::eTraceBinary;
             else if (!strcasecmp(optarg, "CSV") || !strcasecmp(optarg, "logger") || !strcasecmp(optarg, "log"))
                 m_eTraceMode = SOptions::eTraceLogger;
+            else if (!strcasecmp(optarg, "CANDUMP"))
+                m_eTraceMode = SOptions::eTraceCandump;
+            else if (!strcasecmp(optarg, "ASC") || !strcasecmp(optarg, "Vector"))
+                m_eTraceMode = SOptions::eTraceAsc;
             else if (!strcasecmp(optarg, "TRC") || !strcasecmp(optarg, "vendor"))
                 m_eTraceMode = SOptions::eTraceVendor;
 #endif
@@ -623,6 +631,36 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
             }
             break;
 #endif
+        /* option '--format=(DEFAULT|CANDUMP|ASC|CSV)' (-f) */
+        case 'f':
+            if (optFmtOutput++) {
+                fprintf(err, "%s: duplicated option `--format' (%c)\n", m_szBasename, opt);
+                return 1;
+            }
+            if (optarg == NULL) {
+                fprintf(err, "%s: missing argument for option `--format' (%c)\n", m_szBasename, opt);
+                return 1;
+            }
+            if (!strcasecmp(optarg, "DEFAULT") || !strcasecmp(optarg, "d"))
+                fmtOutput = CCanMessage::OptionDefault;
+            else if (!strcasecmp(optarg, "CANDUMP") || !strcasecmp(optarg, "LOG"))
+                fmtOutput = CCanMessage::OptionCandump;
+            else if (!strcasecmp(optarg, "ASC") || !strcasecmp(optarg, "Vector"))
+                fmtOutput = CCanMessage::OptionAsc;
+            else if (!strcasecmp(optarg, "CSV"))
+                fmtOutput = CCanMessage::OptionCsv;
+            else {
+                fprintf(err, "%s: illegal argument for option `--format' (%c)\n", m_szBasename, opt);
+                return 1;
+            }
+            if (!CCanMessage::SetOutputFormat(fmtOutput)) {
+                fprintf(err, "%s: illegal argument for option `--format' (%c)\n", m_szBasename, opt);
+                return 1;
+            }
+            /* note: candump logs have absolute time-stamps (unless option `--time' is given) */
+            if ((fmtOutput == CCanMessage::OptionCandump) && !optFmtTime)
+                (void)CCanMessage::SetTimestampFormat(CCanMessage::OptionAbsolute);
+            break;
         /* option '--exclude=[~]<id-list>' (-x) */
         case 'x':
             if (optExclude++) {
@@ -801,6 +839,7 @@ void SOptions::ShowUsage(FILE* stream, bool args) {
 #if (CAN_FD_SUPPORTED != 0)
     fprintf(stream, " -w, --wrap=(NO|8|10|16|32|64)        wraparound after n data bytes (default=NO)\n");
 #endif
+    fprintf(stream, " -f, --format=(DEFAULT|CANDUMP|ASC|CSV) output format of the messages (default=DEFAULT)\n");
     fprintf(stream, " -x, --exclude=[~]<id-list>           exclude CAN-IDs: <id-list> = <id>[-<id>]{,<id>[-<id>]}\n");
     fprintf(stream, "     --code=<id>                      acceptance code for 11-bit IDs (default=0x%03x)\n", CANACC_CODE_11BIT);
     fprintf(stream, "     --mask=<id>                      acceptance mask for 11-bit IDs (default=0x%03x)\n", CANACC_MASK_11BIT);
@@ -823,8 +862,10 @@ void SOptions::ShowUsage(FILE* stream, bool args) {
     fprintf(stream, " -b, --baudrate=<baudrate>            CAN bit-timing in kbps (default=250), or\n");
     fprintf(stream, "     --bitrate=<bit-rate>             CAN bit-rate settings (as key/value list)\n");
     fprintf(stream, " -v, --verbose                        show detailed bit-rate settings\n");
-#if (CAN_TRACE_SUPPORTED != 0)
+#if (CAN_TRACE_SUPPORTED == 1)
     fprintf(stream, " -y, --trace=(ON|OFF)                 write a trace file (default=OFF)\n");
+#elif (CAN_TRACE_SUPPORTED != 0)
+    fprintf(stream, " -y, --trace=(BIN|CSV|CANDUMP|ASC|TRC) write a trace file (default=OFF)\n");
 #endif
 #if (SERIAL_CAN_SUPPORTED != 0)
     fprintf(stream, " -z, --protocol=(Lawicel|CANable)     select SLCAN protocol (default=Lawicel)\n");
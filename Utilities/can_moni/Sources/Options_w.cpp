@@ -73,31 +73,33 @@ extern "C" {
 #define MODE_ASCII_CHR    24
 #define WRAPAROUND_STR    25
 #define WRAPAROUND_CHR    26
-#define EXCLUDE_STR       27
-#define EXCLUDE_CHR       28
-#define STD_CODE_STR      29
-#define STD_MASK_CHR      30
-#define XTD_CODE_STR      31
-#define XTD_MASK_CHR      32
-#define SCRIPT_STR        33
-#define SCRIPT_CHR        34
-#define TRACEFILE_STR     35
-#define TRACEFILE_CHR     36
-#define LISTBITRATES_STR  37
-#define LISTBOARDS_STR    38
-#define LISTBOARDS_CHR    39
-#define TESTBOARDS_STR    40
-#define TESTBOARDS_CHR    41
-#define PROTOCOL_STR      42
-#define PROTOCOL_CHR      43
-#define JSON_STR          44
-#define JSON_CHR          45
-#define HELP              46
-#define QUESTION_MARK     47
-#define ABOUT             48
-#define CHARACTER_MJU     49
-#define VERSION           50
-#define MAX_OPTIONS       51
+#define FORMAT_STR        27
+#define FORMAT_CHR        28
+#define EXCLUDE_STR       29
+#define EXCLUDE_CHR       30
+#define STD_CODE_STR      31
+#define STD_MASK_CHR      32
+#define XTD_CODE_STR      33
+#define XTD_MASK_CHR      34
+#define SCRIPT_STR        35
+#define SCRIPT_CHR        36
+#define TRACEFILE_STR     37
+#define TRACEFILE_CHR     38
+#define LISTBITRATES_STR  39
+#define LISTBOARDS_STR    40
+#define LISTBOARDS_CHR    41
+#define TESTBOARDS_STR    42
+#define TESTBOARDS_CHR    43
+#define PROTOCOL_STR      44
+#define PROTOCOL_CHR      45
+#define JSON_STR          46
+#define JSON_CHR          47
+#define HELP              48
+#define QUESTION_MARK     49
+#define ABOUT             50
+#define CHARACTER_MJU     51
+#define VERSION           52
+#define MAX_OPTIONS       53
 
 static char* option[MAX_OPTIONS] = {
     (char*)"BAUDRATE", (char*)"bd",
@@ -114,6 +116,7 @@ static char* option[MAX_OPTIONS] = {
     (char*)"DATA", (char*)"d",
     (char*)"ASCII", (char*)"a",
     (char*)"WARAPAROUND", (char*)"w",
+    (char*)"FORMAT", (char*)"f",
     (char*)"EXCLUDE", (char*)"x",
     (char*)"CODE", (char*)"MASK",
     (char*)"XTD-CODE", (char*)"XTD-MASK",
@@ -202,6 +205,7 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
 #if (CAN_FD_SUPPORTED != 0)
     int optFmtWrap = 0;
 #endif
+    int optFmtOutput = 0;
     int optExclude = 0;
 #if (CAN_TRACE_SUPPORTED != 0)
     int optTraceMode = 0;
@@ -223,11 +227,13 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
     CCanMessage::EFormatNumber fmtModeData = CCanMessage::OptionHex;
     CCanMessage::EFormatOption fmtModeAscii = CCanMessage::OptionOn;
     CCanMessage::EFormatWraparound fmtWraparound = CCanMessage::OptionWraparoundNo;
+    CCanMessage::EFormatOutput fmtOutput = CCanMessage::OptionDefault;
     (void)CCanMessage::SetTimestampFormat(fmtModeTime);
     (void)CCanMessage::SetIdentifierFormat(fmtModeId);
     (void)CCanMessage::SetDataFormat(fmtModeData);
     (void)CCanMessage::SetAsciiFormat(fmtModeAscii);
     (void)CCanMessage::SetWraparound(fmtWraparound);
+    (void)CCanMessage::SetOutputFormat(fmtOutput);
 
     // (0) sanity check
     if ((argc <= 0) || (argv == NULL))
@@ -587,6 +593,10 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
                 m_eTraceMode = SOptions::eTraceBinary;
             else if (!strcasecmp(optarg, "CSV") || !strcasecmp(optarg, "logger") || !strcasecmp(optarg, "log"))
                 m_eTraceMode = SOptions::eTraceLogger;
+            else if (!strcasecmp(optarg, "CANDUMP"))
+                m_eTraceMode = SOptions::eTraceCandump;
+            else if (!strcasecmp(optarg, "ASC") || !strcasecmp(optarg, "Vector"))
+                m_eTraceMode = SOptions::eTraceAsc;
             else if (!strcasecmp(optarg, "TRC") || !strcasecmp(optarg, "vendor"))
                 m_eTraceMode = SOptions::eTraceVendor;
 #endif
@@ -732,6 +742,37 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
             }
             break;
 #endif
+        /* option '--format=(DEFAULT|CANDUMP|ASC|CSV)' (-f) */
+        case FORMAT_STR:
+        case FORMAT_CHR:
+            if ((optFmtOutput++)) {
+                fprintf(err, "%s: duplicated option /FORMAT\n", m_szBasename);
+                return 1;
+            }
+            if ((optarg = getOptionParameter()) == NULL) {
+                fprintf(err, "%s: missing argument for option /FORMAT\n", m_szBasename);
+                return 1;
+            }
+            if (!strcasecmp(optarg, "DEFAULT") || !strcasecmp(optarg, "d"))
+                fmtOutput = CCanMessage::OptionDefault;
+            else if (!strcasecmp(optarg, "CANDUMP") || !strcasecmp(optarg, "LOG"))
+                fmtOutput = CCanMessage::OptionCandump;
+            else if (!strcasecmp(optarg, "ASC") || !strcasecmp(optarg, "Vector"))
+                fmtOutput = CCanMessage::OptionAsc;
+            else if (!strcasecmp(optarg, "CSV"))
+                fmtOutput = CCanMessage::OptionCsv;
+            else {
+                fprintf(err, "%s: illegal argument for option /FORMAT\n", m_szBasename);
+                return 1;
+            }
+            if (!CCanMessage::SetOutputFormat(fmtOutput)) {
+                fprintf(err, "%s: illegal argument for option /FORMAT\n", m_szBasename);
+                return 1;
+            }
+            /* note: candump logs have absolute time-stamps (unless option /TIME is given) */
+            if ((fmtOutput == CCanMessage::OptionCandump) && !optFmtTime)
+                (void)CCanMessage::SetTimestampFormat(CCanMessage::OptionAbsolute);
+            break;
         /* option '--exclude=[~]<id-list>' (-x) */
         case EXCLUDE_STR:
         case EXCLUDE_CHR:
@@ -899,6 +940,7 @@ void SOptions::ShowUsage(FILE* stream, bool args) {
 #if (CAN_FD_SUPPORTED != 0)
     fprintf(stream, "  /Wraparound:(No|8|10|16|32|64)      wraparound after n data bytes (default=NO)\n");
 #endif
+    fprintf(stream, "  /Format:(DEFAULT|CANDUMP|ASC|CSV)   output format of the messages (default=DEFAULT)\n");
     fprintf(stream, "  /eXclude:[~]<id-list>               exclude CAN-IDs: <id-list> = <id>[-<id>]{,<id>[-<id>]}\n");
     fprintf(stream, "  /CODE:<id>                          acceptance code for 11-bit IDs (default=0x%03lx)\n", CANACC_CODE_11BIT);
     fprintf(stream, "  /MASK:<id>                          acceptance mask for 11-bit IDs (default=0x%03lx)\n", CANACC_MASK_11BIT);
@@ -924,8 +966,10 @@ void SOptions::ShowUsage(FILE* stream, bool args) {
 #if (SERIAL_CAN_SUPPORTED != 0)
     fprintf(stream, "  /PRotocol:(Lawicel|CANable)         select SLCAN protocol (default=Lawicel)\n");
 #endif
-#if (CAN_TRACE_SUPPORTED != 0)
+#if (CAN_TRACE_SUPPORTED == 1)
     fprintf(stream, "  /TRaCe:(ON|OFF)                     write a trace file (default=OFF)\n");
+#elif (CAN_TRACE_SUPPORTED != 0)
+    fprintf(stream, "  /TRaCe:(BIN|CSV|CANDUMP|ASC|TRC)    write a trace file (default=OFF)\n");
 #endif
 #if (CAN_FD_SUPPORTED != 0)
     fprintf(stream, "  /LIST-BITRATES[:(2.0|FDf[+BRS])]    list standard bit-rate settings and exit\n");
@@ -0,0 +1,186 @@
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  CAN Monitor for generic Interfaces (CAN API V3)
+//
+//  Copyright (c) 2007,2012-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include "Output.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <unistd.h>
+#endif
+
+CMessageOutput::CMessageOutput() {
+    m_Batches = new SBatch[QUEUE_BATCHES];
+    m_Buffer = new char[BUFFER_SIZE];
+    m_nHead = m_nTail = 0U;
+    m_Batches[m_nTail].count = 0U;
+    m_Batches[m_nTail].dropped = 0U;
+    m_u64Pending = m_u64Dropped = 0U;
+    m_fStop = false;
+    m_fIdle = false;
+    memset(&m_Options, 0, sizeof(msg_fmt_options_t));
+}
+
+CMessageOutput::~CMessageOutput() {
+    Stop();
+    delete[] m_Buffer;
+    delete[] m_Batches;
+}
+
+bool CMessageOutput::Start() {
+    if (m_Thread.joinable())
+        return false;
+    // note: the formatter options are taken over when the thread is started
+    (void)msg_get_fmt_options(&m_Options);
+    // note: the output thread writes to the file descriptor directly
+    fflush(stdout);
+    // file header of the output format (if any)
+    int length = msg_format_header_r(m_Buffer, BUFFER_SIZE, &m_Options);
+    if (length > 0)
+        (void)Write(m_Buffer, ((size_t)length < BUFFER_SIZE) ? (size_t)length : (BUFFER_SIZE - 1U));
+    m_fStop = false;
+    try {
+        m_Thread = std::thread(&CMessageOutput::OutputLoop, this);
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+void CMessageOutput::Stop() {
+    if (!m_Thread.joinable())
+        return;
+    Flush(true);
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_fStop = true;
+    }
+    m_Condition.notify_one();
+    m_Thread.join();
+    // file footer of the output format (if any)
+    int length = msg_format_footer_r(m_Buffer, BUFFER_SIZE, &m_Options);
+    if (length > 0)
+        (void)Write(m_Buffer, ((size_t)length < BUFFER_SIZE) ? (size_t)length : (BUFFER_SIZE - 1U));
+    // messages dropped after the last hand-over
+    if (m_u64Pending)
+        fprintf(stderr, "+++ warning: %" PRIu64 " message(s) dropped (output too slow)\n", m_u64Pending);
+    m_u64Pending = 0U;
+}
+
+void CMessageOutput::Put(const can_message_t &message, uint64_t counter) {
+    // note: the batch at the tail belongs to the reader, no lock required
+    SBatch *batch = &m_Batches[m_nTail];
+    batch->frames[batch->count].message = message;
+    batch->frames[batch->count].counter = counter;
+    if (++batch->count == BATCH_FRAMES)
+        Flush(true);
+}
+
+void CMessageOutput::Flush(bool force) {
+    bool notify = false;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        SBatch *batch = &m_Batches[m_nTail];
+        if (!batch->count)
+            return;
+        if (!force && !m_fIdle)
+            return;  // keep on collecting while the output thread is busy
+        size_t next = (m_nTail + 1U) % QUEUE_BATCHES;
+        if (next != m_nHead) {
+            // hand over the batch with the number of messages dropped before
+            batch->dropped = m_u64Pending;
+            m_u64Pending = 0U;
+            m_nTail = next;
+            m_fIdle = false;  // until the output thread is waiting again
+            notify = true;
+        } else {
+            // queue full: drop the batch, the output thread is behind
+            m_u64Pending += batch->count;
+            m_u64Dropped += batch->count;
+        }
+        m_Batches[m_nTail].count = 0U;
+        m_Batches[m_nTail].dropped = 0U;
+    }
+    if (notify)
+        m_Condition.notify_one();
+}
+
+uint64_t CMessageOutput::Dropped() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_u64Dropped;
+}
+
+void CMessageOutput::OutputLoop() {
+    for (;;) {
+        SBatch *batch = NULL;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_fIdle = true;
+            m_Condition.wait(lock, [this] { return (m_nHead != m_nTail) || m_fStop; });
+            m_fIdle = false;
+            if (m_nHead == m_nTail)
+                break;  // stopped and all batches written
+            batch = &m_Batches[m_nHead];
+        }
+        // format the whole batch into the buffer (one line per message)
+        size_t length = 0U;
+        for (size_t i = 0U; i < batch->count; i++) {
+            if ((BUFFER_SIZE - length) < (MSG_STRING_LENGTH + 1U)) {
+                (void)Write(m_Buffer, length);
+                length = 0U;
+            }
+            int n = msg_format_message_r(&m_Buffer[length], BUFFER_SIZE - length - 1U, &m_Options,
+                                         &batch->frames[i].message, MSG_RX_MESSAGE, batch->frames[i].counter, 0);
+            if ((n > 0) && ((size_t)n < (BUFFER_SIZE - length - 1U))) {
+                length += (size_t)n;
+                m_Buffer[length++] = '\n';
+            }
+        }
+        // one system call per batch
+        (void)Write(m_Buffer, length);
+        if (batch->dropped)
+            fprintf(stderr, "+++ warning: %" PRIu64 " message(s) dropped (output too slow)\n", batch->dropped);
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_nHead = (m_nHead + 1U) % QUEUE_BATCHES;
+        }
+    }
+}
+
+bool CMessageOutput::Write(const char *buffer, size_t length) {
+#if !defined(_WIN32) && !defined(_WIN64)
+    while (length > 0U) {
+        ssize_t n = write(STDOUT_FILENO, buffer, length);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        buffer += n;
+        length -= (size_t)n;
+    }
+    return true;
+#else
+    if (length && (fwrite(buffer, 1, length, stdout) != length))
+        return false;
+    return (fflush(stdout) == 0);
+#endif
+}
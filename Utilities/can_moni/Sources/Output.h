@@ -0,0 +1,87 @@
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  CAN Monitor for generic Interfaces (CAN API V3)
+//
+//  Copyright (c) 2007,2012-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef OUTPUT_H_INCLUDED
+#define OUTPUT_H_INCLUDED
+
+#include "CANAPI_Types.h"
+#include "can_msg.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/// \name   Message Output
+/// \brief  Batched output of received CAN messages.
+/// \note   The reception loop (reader) collects the messages in batches and
+///         hands them over to an output thread, which formats a whole batch
+///         into one buffer and writes it with a single system call. A batch
+///         is handed over when it is full or when the output thread is idle,
+///         so the batches grow with the load. If the output cannot keep up,
+///         complete batches are dropped and reported instead of stalling the
+///         reader (and overflowing the receive queue).
+/// \{
+class CMessageOutput {
+public:
+    static const size_t BATCH_FRAMES = 256U;  // max. number of messages per batch
+    static const size_t QUEUE_BATCHES = 64U;  // number of batches in the queue
+    static const size_t BUFFER_SIZE = 256U * 1024U;  // size of the output buffer
+private:
+    struct SFrame {
+        can_message_t message;  // received CAN message
+        uint64_t counter;  // its message number
+    };
+    struct SBatch {
+        SFrame frames[BATCH_FRAMES];  // messages of the batch
+        size_t count;  // number of messages
+        uint64_t dropped;  // messages dropped before this batch
+    };
+    SBatch *m_Batches;  // batch queue (ring, one batch is being filled)
+    size_t m_nHead;  // next batch to be written (output thread)
+    size_t m_nTail;  // batch being filled (reader)
+    uint64_t m_u64Pending;  // messages dropped since the last hand-over
+    uint64_t m_u64Dropped;  // total number of dropped messages
+    bool m_fStop;  // flag: stop the output thread
+    bool m_fIdle;  // flag: output thread is waiting for a batch
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    std::thread m_Thread;
+    msg_fmt_options_t m_Options;  // formatter options (output thread only)
+    char *m_Buffer;  // output buffer (output thread only)
+public:
+    CMessageOutput();
+    virtual ~CMessageOutput();
+
+    bool Start();  // start the output thread
+    void Stop();  // hand over, write the remaining batches and stop
+
+    void Put(const can_message_t &message, uint64_t counter);  // add a message to the current batch
+    void Flush(bool force = false);  // hand over the current batch (if the output thread is idle)
+
+    uint64_t Dropped();  // total number of dropped messages
+private:
+    void OutputLoop();
+    static bool Write(const char *buffer, size_t length);
+};
+/// \}
+
+#endif // OUTPUT_H_INCLUDED
@@ -20,6 +20,7 @@
 #include "Driver.h"
 #include "Options.h"
 #include "Message.h"
+#include "Output.h"
 #include "Timer.h"
 #if (SERIAL_CAN_SUPPORTED != 0)
 #include "SerialCAN_Defines.h"
@@ -55,6 +56,7 @@
 #endif
 
 #define MAX_ID  (CAN_MAX_STD_ID + 1)
+#define OUTPUT_LATENCY  100U  // max. delay of a partial batch [ms]
 
 static int get_exclusion(const char* arg);
 
@@ -325,6 +327,14 @@ int main(int argc, const char* argv[]) {
             case SOptions::eTraceLogger:
                 property[0] = CANPARA_TRACE_TYPE_LOGGER;
                 break;
+#if (SERIAL_CAN_SUPPORTED != 0)
+            case SOptions::eTraceCandump:
+                property[0] = CANSIO_TRACE_TYPE_CANDUMP;
+                break;
+            case SOptions::eTraceAsc:
+                property[0] = CANSIO_TRACE_TYPE_ASC;
+                break;
+#endif
             case SOptions::eTraceBinary:
             default:
                 property[0] = CANPARA_TRACE_TYPE_BINARY;
@@ -685,23 +695,42 @@ bool CCanDevice::WriteJsonFile(const char* filename) {
 #endif
 
 /*  Reception loop: count received CAN messages until Ctrl-C
+ *  - the reader drains the receive queue in batches, the output thread
+ *    formats and writes them (one write per batch)
  */
 uint64_t CCanDevice::ReceptionLoop() {
     CANAPI_Message_t message;
     uint64_t frames = 0U;
+    size_t n;
 
-    char string[CANPROP_MAX_STRING_LENGTH+1];
-    memset(string, 0, CANPROP_MAX_STRING_LENGTH+1);
+    CMessageOutput output;
 
     fprintf(stderr, "\nPress ^C to abort.\n\n");
+    if (!output.Start()) {
+        fprintf(stderr, "+++ error: output thread could not be started\n");
+        return frames;
+    }
     while(running) {
-        if (ReadMessage(message) == CCanApi::NoError) {
-            if ((((message.id < MAX_ID) && can_id[message.id]) || ((message.id >= MAX_ID) && can_id_xtd))) {
-                (void)CCanMessage::Format(message, ++frames, string, CANPROP_MAX_STRING_LENGTH);
-                fprintf(stdout, "%s\n", string);
-            }
+        if (ReadMessage(message, OUTPUT_LATENCY) == CCanApi::NoError) {
+            /* - take all messages already received (without waiting) */
+            n = 0U;
+            do {
+                if ((((message.id < MAX_ID) && can_id[message.id]) || ((message.id >= MAX_ID) && can_id_xtd))) {
+                    output.Put(message, ++frames);
+                }
+            } while ((++n < CMessageOutput::BATCH_FRAMES) && running &&
+                     (ReadMessage(message, 0U) == CCanApi::NoError));
+            /* - hand them over to the output thread (if idle) */
+            output.Flush();
+        }
+        else {
+            /* - nothing received: hand over the rest */
+            output.Flush(true);
         }
     }
+    output.Stop();
+    if (output.Dropped())
+        fprintf(stderr, "+++ warning: %" PRIu64 " of %" PRIu64 " message(s) dropped (output too slow)\n", output.Dropped(), frames);
     fprintf(stdout, "\n");
     return frames;
 }
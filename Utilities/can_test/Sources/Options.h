@@ -55,7 +55,8 @@ struct SOptions {
         RxMODE = (0),
         TxMODE = (1),
         TxFRAMES = (2),
-        TxRANDOM = (3)
+        TxRANDOM = (3),
+        TxREPLAY = (4)
     };
     // attributes
     char* m_szBasename;
@@ -87,6 +88,10 @@ struct SOptions {
     uint32_t m_nTxCanId;
     uint8_t m_nTxCanDlc;
     bool m_fTxXtdId;
+#if (SERIAL_CAN_SUPPORTED != 0)
+    char* m_szReplayFile;
+    uint16_t m_nReplaySpeed;
+#endif
 #if (CAN_TRACE_SUPPORTED != 0)
     enum {
         eTraceOff,
@@ -95,6 +95,10 @@ SOptions::SOptions() {
     m_nTxCanId = (uint32_t)DEFAULT_CAN_ID;
     m_nTxCanDlc = (uint8_t)DEFAULT_LENGTH;
     m_fTxXtdId = false;
+#if (SERIAL_CAN_SUPPORTED != 0)
+    m_szReplayFile = (char*)NULL;
+    m_nReplaySpeed = (uint16_t)CANSIO_REPLAY_ORIGINAL;
+#endif
     m_fListBitrates = false;
     m_fListBoards = false;
     m_fTestBoards = false;
@@ -128,6 +132,11 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
     int optDlc = 0;
     int optId = 0;
     int optXtd = 0;
+#if (SERIAL_CAN_SUPPORTED != 0)
+    int optReplay = 0;
+    int optSpeed = 0;
+    double dblarg;
+#endif
 #if (CAN_TRACE_SUPPORTED != 0)
     int optTraceMode = 0;
 #endif
@@ -172,6 +181,10 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
         {"id", required_argument, 0, 'i'},
         {"xtd", no_argument, 0, 'e'},
         {"extended", no_argument, 0, 'e'},
+#if (SERIAL_CAN_SUPPORTED != 0)
+        {"replay", required_argument, 0, 'P'},
+        {"speed", required_argument, 0, 'Q'},
+#endif
         {"trace", required_argument, 0, 'y'},
         {"list-bitrates", optional_argument, 0, 'l'},
 #if (OPTION_CANAPI_LIBRARY != 0)
@@ -706,6 +719,44 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
             }
             m_fTxXtdId = true;
             break;
+#if (SERIAL_CAN_SUPPORTED != 0)
+        /* option '--replay=<filename>' */
+        case 'P':
+            if (optReplay++) {
+                fprintf(err, "%s: duplicated option `--replay'\n", m_szBasename);
+                return 1;
+            }
+            if ((optarg == NULL) || (*optarg == '\0')) {
+                fprintf(err, "%s: missing argument for option `--replay'\n", m_szBasename);
+                return 1;
+            }
+            m_szReplayFile = optarg;
+            m_TestMode = SOptions::TxREPLAY;
+            break;
+        /* option '--speed=(<factor>|MAX)' */
+        case 'Q':
+            if (optSpeed++) {
+                fprintf(err, "%s: duplicated option `--speed'\n", m_szBasename);
+                return 1;
+            }
+            if (optarg == NULL) {
+                fprintf(err, "%s: missing argument for option `--speed'\n", m_szBasename);
+                return 1;
+            }
+            if (!strcasecmp(optarg, "MAX") || !strcasecmp(optarg, "ASAP"))
+                m_nReplaySpeed = (uint16_t)CANSIO_REPLAY_ASAP;
+            else if (sscanf(optarg, "%lf", &dblarg) != 1) {
+                fprintf(err, "%s: illegal argument for option `--speed'\n", m_szBasename);
+                return 1;
+            }
+            else if ((dblarg < 0.01) || (655.35 < dblarg)) {
+                fprintf(err, "%s: illegal argument for option `--speed'\n", m_szBasename);
+                return 1;
+            }
+            else  /* speed factor in [%] */
+                m_nReplaySpeed = (uint16_t)((dblarg * 100.0) + 0.5);
+            break;
+#endif
         /* option '--list-bitrates[=(2.0|FDF[+BRS])]' */
         case 'l':
             if (optListBitrates++) {
@@ -930,6 +981,10 @@ void SOptions::ShowUsage(FILE* stream, bool args) {
     fprintf(stream, " -t, --transmit=<time>                send messages for the given time in seconds, or\n");
     fprintf(stream, " -f, --frames=<number>,               alternatively send the given number of messages, or\n");
     fprintf(stream, "     --random=<number>                optionally with random cycle time and data length\n");
+#if (SERIAL_CAN_SUPPORTED != 0)
+    fprintf(stream, "     --replay=<filename>              alternatively send the messages of a trace file\n");
+    fprintf(stream, "     --speed=(<factor>|MAX)           with original timing times factor (default=1)\n");
+#endif
     fprintf(stream, " -c, --cycle=<cycle>                  cycle time in milliseconds (default=0) or\n");
     fprintf(stream, " -u, --usec=<cycle>                   cycle time in microseconds (default=0)\n");
     fprintf(stream, " -d, --dlc=<length>                   send messages of given length (default=8)\n");
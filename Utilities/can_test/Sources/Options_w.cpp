@@ -80,37 +80,39 @@ extern "C" {
 #define FRAMES_CHR        30
 #define RANDOM_STR        31
 #define RANDOM_CHR        32
-#define CYCLE_STR         33
-#define CYCLE_CHR         34
-#define USEC_STR          35
-#define USEC_CHR          36
-#define DLC_STR           37
-#define DLC_CHR           38
-#define DLC_LEN           39
-#define CAN_STR           40
-#define CAN_CHR           41
-#define CAN_ID            42
-#define COB_ID            43
-#define XTD_ID            44
-#define EXT_STR           45
-#define EXT_CHR           46
-#define TRACEFILE_STR     47
-#define TRACEFILE_CHR     48
-#define LISTBITRATES_STR  49
-#define LISTBOARDS_STR    50
-#define LISTBOARDS_CHR    51
-#define TESTBOARDS_STR    52
-#define TESTBOARDS_CHR    53
-#define PROTOCOL_STR      54
-#define PROTOCOL_CHR      55
-#define JSON_STR          56
-#define JSON_CHR          57
-#define HELP              58
-#define QUESTION_MARK     59
-#define ABOUT             60
-#define CHARACTER_MJU     61
-#define VERSION           62
-#define MAX_OPTIONS       63
+#define REPLAY_STR        33
+#define SPEED_STR         34
+#define CYCLE_STR         35
+#define CYCLE_CHR         36
+#define USEC_STR          37
+#define USEC_CHR          38
+#define DLC_STR           39
+#define DLC_CHR           40
+#define DLC_LEN           41
+#define CAN_STR           42
+#define CAN_CHR           43
+#define CAN_ID            44
+#define COB_ID            45
+#define XTD_ID            46
+#define EXT_STR           47
+#define EXT_CHR           48
+#define TRACEFILE_STR     49
+#define TRACEFILE_CHR     50
+#define LISTBITRATES_STR  51
+#define LISTBOARDS_STR    52
+#define LISTBOARDS_CHR    53
+#define TESTBOARDS_STR    54
+#define TESTBOARDS_CHR    55
+#define PROTOCOL_STR      56
+#define PROTOCOL_CHR      57
+#define JSON_STR          58
+#define JSON_CHR          59
+#define HELP              60
+#define QUESTION_MARK     61
+#define ABOUT             62
+#define CHARACTER_MJU     63
+#define VERSION           64
+#define MAX_OPTIONS       65
 
 static char* option[MAX_OPTIONS] = {
     (char*)"BAUDRATE", (char*)"bd",
@@ -130,6 +132,8 @@ static char* option[MAX_OPTIONS] = {
     (char*)"TRANSMIT", (char*)"tx",
     (char*)"FRAMES", (char*)"fr",
     (char*)"RANDOM", (char*)"rand",
+    (char*)"REPLAY",
+    (char*)"SPEED",
     (char*)"CYCLE", (char*)"c",
     (char*)"USEC", (char*)"u",
     (char*)"DLC", (char*)"d", (char*)"DATA",
@@ -196,6 +200,10 @@ SOptions::SOptions() {
     m_nTxCanId = (uint32_t)DEFAULT_CAN_ID;
     m_nTxCanDlc = (uint8_t)DEFAULT_LENGTH;
     m_fTxXtdId = false;
+#if (SERIAL_CAN_SUPPORTED != 0)
+    m_szReplayFile = (char*)NULL;
+    m_nReplaySpeed = (uint16_t)CANSIO_REPLAY_ORIGINAL;
+#endif
     m_fListBitrates = false;
     m_fListBoards = false;
     m_fTestBoards = false;
@@ -231,6 +239,11 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
     int optDlc = 0;
     int optId = 0;
     int optXtd = 0;
+#if (SERIAL_CAN_SUPPORTED != 0)
+    int optReplay = 0;
+    int optSpeed = 0;
+    double dblarg;
+#endif
 #if (CAN_TRACE_SUPPORTED != 0)
     int optTraceMode = 0;
 #endif
@@ -728,6 +741,44 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
             m_nTxFrames = (uint64_t)intarg;
             m_TestMode = ETestMode::TxRANDOM;
             break;
+#if (SERIAL_CAN_SUPPORTED != 0)
+        /* option '--replay=<filename>' */
+        case REPLAY_STR:
+            if ((optReplay++)) {
+                fprintf(err, "%s: duplicated option /REPLAY\n", m_szBasename);
+                return 1;
+            }
+            if (((optarg = getOptionParameter()) == NULL) || (*optarg == '\0')) {
+                fprintf(err, "%s: missing argument for option /REPLAY\n", m_szBasename);
+                return 1;
+            }
+            m_szReplayFile = optarg;
+            m_TestMode = ETestMode::TxREPLAY;
+            break;
+        /* option '--speed=(<factor>|MAX)' */
+        case SPEED_STR:
+            if ((optSpeed++)) {
+                fprintf(err, "%s: duplicated option /SPEED\n", m_szBasename);
+                return 1;
+            }
+            if ((optarg = getOptionParameter()) == NULL) {
+                fprintf(err, "%s: missing argument for option /SPEED\n", m_szBasename);
+                return 1;
+            }
+            if (!strcasecmp(optarg, "MAX") || !strcasecmp(optarg, "ASAP"))
+                m_nReplaySpeed = (uint16_t)CANSIO_REPLAY_ASAP;
+            else if (sscanf_s(optarg, "%lf", &dblarg) != 1) {
+                fprintf(err, "%s: illegal argument for option /SPEED\n", m_szBasename);
+                return 1;
+            }
+            else if ((dblarg < 0.01) || (655.35 < dblarg)) {
+                fprintf(err, "%s: illegal argument for option /SPEED\n", m_szBasename);
+                return 1;
+            }
+            else  /* speed factor in [%] */
+                m_nReplaySpeed = (uint16_t)((dblarg * 100.0) + 0.5);
+            break;
+#endif
         /* option '--cycle=<msec>' (-c) */
         case CYCLE_STR:
         case CYCLE_CHR:
@@ -1045,6 +1096,10 @@ void SOptions::ShowUsage(FILE* stream, bool args) {
     fprintf(stream, "  /TRANSMIT:<time> | /TX=<time>       send messages for the given time in seconds, or\n");
     fprintf(stream, "  /FRames:<frames>                    alternatively send the given number of messages, or\n");
     fprintf(stream, "  /RANDom:<frames>                    optionally with random cycle time and data length\n");
+#if (SERIAL_CAN_SUPPORTED != 0)
+    fprintf(stream, "  /REPLAY:<filename>                  alternatively send the messages of a trace file\n");
+    fprintf(stream, "  /SPEED:(<factor>|MAX)               with original timing times factor (default=1)\n");
+#endif
     fprintf(stream, "  /Cycle:<msec>                       cycle time in milliseconds (default=0), or\n");
     fprintf(stream, "  /Usec:<usec>                        cycle time in microseconds (default=0)\n");
     fprintf(stream, "  /Dlc:<length>                       send messages of given length (default=8)\n");
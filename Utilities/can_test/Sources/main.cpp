@@ -59,6 +59,9 @@ public:
     uint64_t ReceiverTest(bool checkCounter = false, uint64_t expectedNumber = 0U, bool stopOnError = false);
     uint64_t TransmitterTest(time_t duration, CANAPI_OpMode_t opMode, uint32_t id = 0x100U, bool xtd = false, uint8_t dlc = 0U, uint64_t delay = 0U, uint64_t offset = 0U);
     uint64_t TransmitterTest(uint64_t count, CANAPI_OpMode_t opMode, bool random = false, uint32_t id = 0x100U, bool xtd = false, uint8_t dlc = 0U, uint64_t delay = 0U, uint64_t offset = 0U);
+#if (SERIAL_CAN_SUPPORTED != 0)
+    uint64_t ReplayTest(const char* filename, uint16_t speed = CANSIO_REPLAY_ORIGINAL);
+#endif
 public:
     int ListCanDevices(void);
     int TestCanDevices(CANAPI_OpMode_t opMode);
@@ -339,6 +342,11 @@ int main(int argc, const char* argv[]) {
     case SOptions::TxRANDOM: /* transmitter test (random) */
         (void)canDevice.TransmitterTest(opts.m_nTxFrames, opts.m_OpMode, true, opts.m_nTxCanId, opts.m_fTxXtdId, opts.m_nTxCanDlc, opts.m_nTxDelay, opts.m_nStartNumber);
         break;
+#if (SERIAL_CAN_SUPPORTED != 0)
+    case SOptions::TxREPLAY: /* transmitter test (trace file) */
+        (void)canDevice.ReplayTest(opts.m_szReplayFile, opts.m_nReplaySpeed);
+        break;
+#endif
     case SOptions::RxMODE:   /* receiver test (abort with Ctrl+C) */
     default:
         (void)canDevice.ReceiverTest(opts.m_fCheckNumber, opts.m_nStartNumber, opts.m_fStopOnError);
@@ -849,6 +857,48 @@ retry_tx_test:
     CTimer::Delay(1U * CTimer::SEC);  /* afterburner */
     return frames;}
 
+#if (SERIAL_CAN_SUPPORTED != 0)
+/*  Job - replay test :
+ *  - send the messages of a trace file (binary format)
+ *  - with the original timing of the recording times speed factor
+ *  - show the timing error percentiles (not for speed MAX)
+ */
+uint64_t CCanDevice::ReplayTest(const char* filename, uint16_t speed) {
+    can_replay_stats_t stats;
+    CANAPI_Return_t retVal;
+
+    memset(&stats, 0, sizeof(can_replay_stats_t));
+
+    fprintf(stderr, "\nPress ^C to abort.\n");
+    fprintf(stdout, "\nReplaying trace file...");
+    fflush (stdout);
+    retVal = ReplayTrace(filename, speed, stats);
+    if ((retVal != CCanApi::NoError) && !running) {
+        fprintf(stdout, "STOP!\n\n");
+    }
+    else if (retVal != CCanApi::NoError) {
+        fprintf(stdout, "FAILED!\n");
+        fprintf(stderr, "+++ error: trace file could not be replayed (%i)\n", retVal);
+        return stats.sent;
+    }
+    else {
+        fprintf(stdout, "OK!\n\n");
+    }
+    fprintf(stdout, "Record(s)=%" PRIu64 "\n", stats.records);
+    fprintf(stdout, "Message(s)=%" PRIu64 "\n", stats.sent);
+    fprintf(stdout, "Error(s)=%" PRIu64 "\n", stats.failed);
+    fprintf(stdout, "Skipped=%" PRIu64 "\n", stats.skipped);
+    fprintf(stdout, "Time=%.3fsec\n", (double)stats.duration / 1000000.0);
+    if (speed != CANSIO_REPLAY_ASAP) {
+        fprintf(stdout, "Speed=%.2f\n", (double)speed / 100.0);
+        fprintf(stdout, "Timing error (mean/p50/p90/p99/p99.9/max)=%" PRIu32 "/%" PRIu32 "/%" PRIu32 "/%" PRIu32 "/%" PRIu32 "/%" PRIu32 "usec\n",
+                stats.mean, stats.p50, stats.p90, stats.p99, stats.p999, stats.max);
+    }
+    fprintf(stdout, "\n");
+    return stats.sent;
+}
+#endif
+
 /*  Job - receiver test :
  *  - check for consequtive up counting numbers Y/N
  *  - first number to be check (if checkCounter = Y)